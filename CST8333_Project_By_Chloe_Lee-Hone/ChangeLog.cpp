@@ -0,0 +1,260 @@
+/**
+* @file				ChangeLog.cpp
+* @author			Chloe Lee-Hone<leeh0002@algonquinlive.com>
+* @version			1.0
+* @section			This file contains the ChangeLog class, which keeps the undo/redo history of changes made through RecordService.
+*					This project contains information licensed under the Open Government Licence  Canada [1][2]. Code structure was informed by the provided example written by Stanley Pieda for CST8333 [3].
+*
+* Student Name:     Chloe Lee-Hone
+* Student Number:   041023578
+* Course:           CST8333_350: Programming Language Research Project
+* Professor:        Reg Dyer
+* Date:             05/06/2023
+*
+* References:
+* [1]   T. B. of C. Secretariat and T. B. S. of C. Open Government, Open Government Licence - Canada. http://open.canada.ca/en/open-government-licence-canada (accessed May 11, 2023).
+* [2]	T. B. of C. Secretariat and Open Government Portal, Vegetables in cold and common storage, Oct. 10, 2008. https://open.canada.ca/data/en/dataset/473f9524-45f8-47d0-9a12-537bb7704089 (accessed May 16, 2023).
+* [3]	S. Pieda, CST8333 19F Practical Project 2 Example Layered. Algonquin College, Algonquin College, Jun. 07, 2022. [Online]. Available: https://brightspace.algonquincollege.com/d2l/le/content/543581/viewContent/8322468/View
+*/
+
+#include "ChangeLog.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+#include "doctest.h"
+
+/**
+ * @brief Records an insert, keeping a copy of the record so the insert can be redone
+ * @param recordId the new record's id
+ * @param slot the record's slot in the vector
+ * @param compactionCount RecordService's compaction counter
+ * @param record the inserted record
+*/
+void ChangeLog::recordInsert(RecordId recordId, std::uint32_t slot, std::uint64_t compactionCount, const RecordDTO &record) {
+	recordRecordChange(ChangeKind::Insert, recordId, slot, compactionCount, record);
+}
+
+/**
+ * @brief Records a delete, keeping a copy of the record so the delete can be undone
+ * @param recordId the deleted record's id
+ * @param slot the record's slot in the vector, which holds a tombstone until the next compaction
+ * @param compactionCount RecordService's compaction counter
+ * @param record the deleted record
+*/
+void ChangeLog::recordDelete(RecordId recordId, std::uint32_t slot, std::uint64_t compactionCount, const RecordDTO &record) {
+	recordRecordChange(ChangeKind::Delete, recordId, slot, compactionCount, record);
+}
+
+/**
+ * @brief Records an insert or delete. The record's columns are appended to the arena in file order.
+*/
+void ChangeLog::recordRecordChange(ChangeKind kind, RecordId recordId, std::uint32_t slot, std::uint64_t compactionCount, const RecordDTO &record) {
+	discardRedo();
+	std::uint64_t offset = ChangeLog::spilledBytes + ChangeLog::arena.size();
+	for (const ColumnInfo &columnInfo : RECORD_COLUMNS) {
+		appendValue(record.get(columnInfo.column));
+	}
+	pushChange(Change{ recordId, 0, compactionCount, slot, 0, kind, RecordColumn::RefDate, true }, offset);
+}
+
+/**
+ * @brief Records an edit to one column. Only the column's old and new values are kept.
+ * @param recordId the edited record's id
+ * @param column the edited column
+ * @param oldValue the column's value before the edit
+ * @param newValue the column's value after the edit
+*/
+void ChangeLog::recordUpdate(RecordId recordId, RecordColumn column, std::string_view oldValue, std::string_view newValue) {
+	discardRedo();
+	std::uint64_t offset = ChangeLog::spilledBytes + ChangeLog::arena.size();
+	appendValue(oldValue);
+	appendValue(newValue);
+	pushChange(Change{ recordId, 0, 0, 0, 0, ChangeKind::Update, column, true }, offset);
+}
+
+/**
+ * @brief Reads back the record an Insert or Delete kept
+ * @param change the change
+ * @return a copy of the record
+*/
+RecordDTO ChangeLog::readRecord(const Change &change) const {
+	std::vector<std::string> values = readValues(change);
+	RecordDTO record{};
+	for (std::size_t i = 0; i < RECORD_COLUMNS.size(); i++) {
+		record.set(RECORD_COLUMNS[i].column, std::move(values[i]));
+	}
+	return record;
+}
+
+/**
+ * @brief Reads back the value an Update changed from or to
+ * @param change the change
+ * @param isNewValue true for the value after the edit, false for the value before it
+ * @return the value
+*/
+std::string ChangeLog::readValue(const Change &change, bool isNewValue) const {
+	return std::move(readValues(change)[isNewValue ? 1 : 0]);
+}
+
+/**
+ * @brief Forgets every change
+*/
+void ChangeLog::clear() {
+	ChangeLog::changes.clear();
+	ChangeLog::cursor = 0;
+	ChangeLog::arena.clear();
+	ChangeLog::spilledBytes = 0;
+}
+
+/**
+ * @brief Lets the arena spill its oldest bytes to a file instead of growing past a limit. Call before any change is recorded.
+ * @param path the file to spill to. It is replaced.
+ * @param maxMemoryBytes the most arena bytes kept in memory
+*/
+void ChangeLog::enableSpill(std::string path, std::size_t maxMemoryBytes) {
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (!file) {
+		throw std::runtime_error("Could not create the change log's spill file " + path + ".");
+	}
+	ChangeLog::spillPath = std::move(path);
+	ChangeLog::maxMemoryBytes = maxMemoryBytes;
+}
+
+/**
+ * @brief Drops the undone changes and their bytes, since a new change makes them impossible to redo
+*/
+void ChangeLog::discardRedo() {
+	if (ChangeLog::cursor == ChangeLog::changes.size()) {
+		return;
+	}
+
+	std::uint64_t end = ChangeLog::changes[ChangeLog::cursor].offset;
+	ChangeLog::changes.resize(ChangeLog::cursor);
+	if (end >= ChangeLog::spilledBytes) {
+		ChangeLog::arena.resize(static_cast<std::size_t>(end - ChangeLog::spilledBytes));
+	}
+	else {
+		// The spill file's bytes past this point are overwritten by the next spill
+		ChangeLog::arena.clear();
+		ChangeLog::spilledBytes = end;
+	}
+}
+
+/**
+ * @brief Appends a value to the arena as a 4-byte length followed by its bytes
+*/
+void ChangeLog::appendValue(std::string_view value) {
+	std::uint32_t length = static_cast<std::uint32_t>(value.size());
+	char lengthBytes[sizeof(length)];
+	std::memcpy(lengthBytes, &length, sizeof(length));
+	ChangeLog::arena.append(lengthBytes, sizeof(length));
+	ChangeLog::arena.append(value);
+}
+
+/**
+ * @brief Adds a change whose values were appended from offset to the end of the arena. If the arena is then over its limit,
+ * everything but the newest half of the limit is written to the spill file.
+*/
+void ChangeLog::pushChange(Change change, std::uint64_t offset) {
+	change.offset = offset;
+	change.size = static_cast<std::uint32_t>(ChangeLog::spilledBytes + ChangeLog::arena.size() - offset);
+	change.isGroupStart = !ChangeLog::isGroupOpen || ChangeLog::isGroupEmpty;
+	ChangeLog::isGroupEmpty = false;
+	ChangeLog::changes.push_back(change);
+	ChangeLog::cursor = ChangeLog::changes.size();
+
+	if (ChangeLog::spillPath.empty() || ChangeLog::arena.size() <= ChangeLog::maxMemoryBytes) {
+		return;
+	}
+	std::size_t spillSize = ChangeLog::arena.size() - ChangeLog::maxMemoryBytes / 2;
+	std::fstream file(ChangeLog::spillPath, std::ios::in | std::ios::out | std::ios::binary);
+	file.seekp(static_cast<std::streamoff>(ChangeLog::spilledBytes));
+	file.write(ChangeLog::arena.data(), static_cast<std::streamsize>(spillSize));
+	if (!file) {
+		throw std::runtime_error("Could not write the change log's spill file " + ChangeLog::spillPath + ".");
+	}
+	ChangeLog::arena.erase(0, spillSize);
+	ChangeLog::spilledBytes += spillSize;
+}
+
+/**
+ * @brief Reads bytes from the arena. The part before spilledBytes is read from the spill file.
+*/
+std::string ChangeLog::readBytes(std::uint64_t offset, std::size_t size) const {
+	std::string bytes(size, '\0');
+	std::size_t fileSize = offset < ChangeLog::spilledBytes ? static_cast<std::size_t>(std::min<std::uint64_t>(size, ChangeLog::spilledBytes - offset)) : 0;
+
+	if (fileSize > 0) {
+		std::ifstream file(ChangeLog::spillPath, std::ios::binary);
+		file.seekg(static_cast<std::streamoff>(offset));
+		file.read(bytes.data(), static_cast<std::streamsize>(fileSize));
+		if (!file) {
+			throw std::runtime_error("Could not read the change log's spill file " + ChangeLog::spillPath + ".");
+		}
+	}
+	std::memcpy(bytes.data() + fileSize, ChangeLog::arena.data() + (offset + fileSize - ChangeLog::spilledBytes), size - fileSize);
+	return bytes;
+}
+
+/**
+ * @brief Splits a change's bytes back into its length-prefixed values
+*/
+std::vector<std::string> ChangeLog::readValues(const Change &change) const {
+	std::string bytes = readBytes(change.offset, change.size);
+	std::vector<std::string> values{};
+
+	for (std::size_t position = 0; position < bytes.size();) {
+		std::uint32_t length{ 0 };
+		std::memcpy(&length, bytes.data() + position, sizeof(length));
+		position += sizeof(length);
+		values.emplace_back(bytes, position, length);
+		position += length;
+	}
+	return values;
+}
+
+TEST_CASE("Test that the change log undoes and redoes in order") {
+	RecordDTO record("2024-01", "Quebec", "", "Carrots", "", "", "", "", "", "v1", "", "5", "", "", "", "");
+	ChangeLog changeLog{};
+	changeLog.recordInsert(7, 3, 0, record);
+	changeLog.recordUpdate(7, RecordColumn::Value, "5", "12");
+
+	REQUIRE(changeLog.canUndo());
+	ChangeLog::Change update = changeLog.undo();
+	CHECK(update.kind == ChangeLog::ChangeKind::Update);
+	CHECK(changeLog.readValue(update, false) == "5");
+	CHECK(changeLog.readValue(update, true) == "12");
+
+	ChangeLog::Change insert = changeLog.undo();
+	CHECK_FALSE(changeLog.canUndo());
+	CHECK(insert.slot == 3);
+	CHECK(changeLog.readRecord(insert).getGeo() == "Quebec");
+
+	/* Redoing the insert and then making a new change drops the undone update */
+	CHECK(changeLog.redo().kind == ChangeLog::ChangeKind::Insert);
+	changeLog.recordDelete(7, 3, 0, record);
+	CHECK_FALSE(changeLog.canRedo());
+	CHECK(changeLog.size() == 2);
+}
+
+TEST_CASE("Test that spilled changes are read back from disk") {
+	const std::string spillPath{ "ChangeLogTest.spill" };
+	ChangeLog changeLog{};
+	changeLog.enableSpill(spillPath, 256);
+
+	for (int i = 0; i < 100; i++) {
+		changeLog.recordUpdate(static_cast<ChangeLog::RecordId>(i), RecordColumn::Value, std::to_string(i), std::to_string(i + 1));
+	}
+	CHECK(changeLog.memoryBytes() <= 256);
+
+	/* The first change is only on disk, but undoes like any other */
+	std::string oldestValue{};
+	while (changeLog.canUndo()) {
+		oldestValue = changeLog.readValue(changeLog.undo(), false);
+	}
+	CHECK(oldestValue == "0");
+	std::remove(spillPath.c_str());
+}
@@ -0,0 +1,196 @@
+/**
+* @file				ChangeLog.h
+* @author			Chloe Lee-Hone<leeh0002@algonquinlive.com>
+* @version			1.0
+* @section			Header file for the ChangeLog class, the undo/redo history of changes made through RecordService.
+*					This project contains information licensed under the Open Government Licence  Canada [1][2]. Code structure was informed by the provided example written by Stanley Pieda for CST8333 [3].
+*
+* Student Name:     Chloe Lee-Hone
+* Student Number:   041023578
+* Course:           CST8333_350: Programming Language Research Project
+* Professor:        Reg Dyer
+* Date:             05/06/2023
+*
+* References:
+* [1]   T. B. of C. Secretariat and T. B. S. of C. Open Government, Open Government Licence - Canada. http://open.canada.ca/en/open-government-licence-canada (accessed May 11, 2023).
+* [2]	T. B. of C. Secretariat and Open Government Portal, Vegetables in cold and common storage, Oct. 10, 2008. https://open.canada.ca/data/en/dataset/473f9524-45f8-47d0-9a12-537bb7704089 (accessed May 16, 2023).
+* [3]	S. Pieda, CST8333 19F Practical Project 2 Example Layered. Algonquin College, Algonquin College, Jun. 07, 2022. [Online]. Available: https://brightspace.algonquincollege.com/d2l/le/content/543581/viewContent/8322468/View
+*/
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "RecordColumn.h"
+#include "RecordDTO.h"
+#include "doctest.h"
+
+#ifndef CHANGE_LOG_H
+#define CHANGE_LOG_H
+
+/**
+ * @brief Records every change to the records as the information needed to reverse it, so a mistaken edit or delete can be
+ * undone without reloading the data set. Changes before the cursor can be undone and changes after it redone; recording a
+ * new change discards the ones after the cursor.
+ * 
+ * Each change is a fixed-size entry; the values it needs are appended to one byte arena. Once the arena grows past a limit,
+ * its oldest bytes can be spilled to a file and read back only if the history is undone that far.
+*/
+class ChangeLog
+{
+public:
+	/** @brief The same id as RecordService::RecordId */
+	using RecordId = std::uint64_t;
+
+	/** @brief The kind of change an entry records */
+	enum class ChangeKind : std::uint8_t { Insert, Update, Delete };
+
+	/** @brief One change. The bytes at [offset, offset + size) of the arena hold its values. */
+	struct Change {
+		RecordId recordId;
+		/** @brief the arena offset of the change's values */
+		std::uint64_t offset;
+		/** @brief the value of RecordService's compaction counter when the change was made. The record's slot is only valid while it is unchanged. */
+		std::uint64_t compactionCount;
+		/** @brief the record's slot in the vector when the change was made */
+		std::uint32_t slot;
+		std::uint32_t size;
+		ChangeKind kind;
+		/** @brief the column an Update changed */
+		RecordColumn column;
+		/** @brief false for every change of a group but the first, so the group is undone and redone as one */
+		bool isGroupStart;
+	};
+
+	/**
+	 * @brief Records an insert, keeping a copy of the record so the insert can be redone
+	 * @param recordId the new record's id
+	 * @param slot the record's slot in the vector
+	 * @param compactionCount RecordService's compaction counter
+	 * @param record the inserted record
+	*/
+	void recordInsert(RecordId recordId, std::uint32_t slot, std::uint64_t compactionCount, const RecordDTO &record);
+
+	/**
+	 * @brief Records a delete, keeping a copy of the record so the delete can be undone
+	 * @param recordId the deleted record's id
+	 * @param slot the record's slot in the vector, which holds a tombstone until the next compaction
+	 * @param compactionCount RecordService's compaction counter
+	 * @param record the deleted record
+	*/
+	void recordDelete(RecordId recordId, std::uint32_t slot, std::uint64_t compactionCount, const RecordDTO &record);
+
+	/**
+	 * @brief Records an edit to one column
+	 * @param recordId the edited record's id
+	 * @param column the edited column
+	 * @param oldValue the column's value before the edit
+	 * @param newValue the column's value after the edit
+	*/
+	void recordUpdate(RecordId recordId, RecordColumn column, std::string_view oldValue, std::string_view newValue);
+
+	/** @return true if there is a change to undo */
+	bool canUndo() const { return cursor > 0; }
+
+	/** @return true if there is an undone change to redo */
+	bool canRedo() const { return cursor < changes.size(); }
+
+	/** @return true if the next change to redo belongs to the same group as the change just redone */
+	bool canRedoInGroup() const { return canRedo() && !changes[cursor].isGroupStart; }
+
+	/** @brief Starts a group. The changes recorded until endGroup() are undone and redone together. */
+	void beginGroup() { isGroupOpen = true; isGroupEmpty = true; }
+
+	/** @brief Ends the group started by beginGroup() */
+	void endGroup() { isGroupOpen = false; }
+
+	/**
+	 * @brief Moves the cursor back over the latest change. Call only if canUndo().
+	 * @return the change to reverse
+	*/
+	const Change &undo() { return changes[--cursor]; }
+
+	/**
+	 * @brief Moves the cursor forward over the next undone change. Call only if canRedo().
+	 * @return the change to apply again
+	*/
+	const Change &redo() { return changes[cursor++]; }
+
+	/**
+	 * @brief Reads back the record an Insert or Delete kept
+	 * @param change the change
+	 * @return a copy of the record
+	*/
+	RecordDTO readRecord(const Change &change) const;
+
+	/**
+	 * @brief Reads back the value an Update changed from or to
+	 * @param change the change
+	 * @param isNewValue true for the value after the edit, false for the value before it
+	 * @return the value
+	*/
+	std::string readValue(const Change &change, bool isNewValue) const;
+
+	/** @brief Forgets every change */
+	void clear();
+
+	/**
+	 * @brief Lets the arena spill its oldest bytes to a file instead of growing past a limit
+	 * @param path the file to spill to. It is replaced.
+	 * @param maxMemoryBytes the most arena bytes kept in memory
+	*/
+	void enableSpill(std::string path, std::size_t maxMemoryBytes);
+
+	/** @return the number of changes, undone ones included */
+	std::size_t size() const { return changes.size(); }
+
+	/** @return the number of arena bytes held in memory */
+	std::size_t memoryBytes() const { return arena.size(); }
+
+private:
+	std::vector<Change> changes{};
+	/** @brief the number of changes that can be undone. changes[cursor] is the next change to redo. */
+	std::size_t cursor{ 0 };
+	/** @brief the arena bytes still in memory, starting at offset spilledBytes */
+	std::string arena{};
+	/** @brief the number of arena bytes written to the spill file */
+	std::uint64_t spilledBytes{ 0 };
+	std::string spillPath{};
+	std::size_t maxMemoryBytes{ std::numeric_limits<std::size_t>::max() };
+	bool isGroupOpen{ false };
+	bool isGroupEmpty{ false };
+
+	/**
+	 * @brief Drops the undone changes and their bytes, since a new change makes them impossible to redo
+	*/
+	void discardRedo();
+
+	/**
+	 * @brief Appends a length-prefixed value to the arena
+	*/
+	void appendValue(std::string_view value);
+
+	/**
+	 * @brief Adds a change whose values were appended from offset to the end of the arena, then spills the arena if it is over its limit
+	*/
+	void pushChange(Change change, std::uint64_t offset);
+
+	/**
+	 * @brief Records an insert or delete
+	*/
+	void recordRecordChange(ChangeKind kind, RecordId recordId, std::uint32_t slot, std::uint64_t compactionCount, const RecordDTO &record);
+
+	/**
+	 * @brief Reads bytes from the arena, from the spill file for the part that was spilled
+	*/
+	std::string readBytes(std::uint64_t offset, std::size_t size) const;
+
+	/**
+	 * @brief Splits a change's bytes back into its length-prefixed values
+	*/
+	std::vector<std::string> readValues(const Change &change) const;
+};
+#endif // !CHANGE_LOG_H
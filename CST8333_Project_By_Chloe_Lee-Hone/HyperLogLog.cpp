@@ -0,0 +1,121 @@
+/**
+* @file				HyperLogLog.cpp
+* @author			Chloe Lee-Hone<leeh0002@algonquinlive.com>
+* @version			1.0
+* @section			This file contains the HyperLogLog class, a fixed-size sketch that estimates how many distinct values it has seen.
+*					This project contains information licensed under the Open Government Licence  Canada [1][2]. Code structure was informed by the provided example written by Stanley Pieda for CST8333 [3].
+*
+* Student Name:     Chloe Lee-Hone
+* Student Number:   041023578
+* Course:           CST8333_350: Programming Language Research Project
+* Professor:        Reg Dyer
+* Date:             05/06/2023
+*
+* References:
+* [1]   T. B. of C. Secretariat and T. B. S. of C. Open Government, Open Government Licence - Canada. http://open.canada.ca/en/open-government-licence-canada (accessed May 11, 2023).
+* [2]	T. B. of C. Secretariat and Open Government Portal, Vegetables in cold and common storage, Oct. 10, 2008. https://open.canada.ca/data/en/dataset/473f9524-45f8-47d0-9a12-537bb7704089 (accessed May 16, 2023).
+* [3]	S. Pieda, CST8333 19F Practical Project 2 Example Layered. Algonquin College, Algonquin College, Jun. 07, 2022. [Online]. Available: https://brightspace.algonquincollege.com/d2l/le/content/543581/viewContent/8322468/View
+*/
+
+#include "HyperLogLog.h"
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+/** @brief The number of registers */
+static constexpr std::size_t REGISTER_COUNT = std::size_t{ 1 } << HyperLogLog::PRECISION;
+
+/**
+ * @brief Creates a sketch that has seen no values
+*/
+HyperLogLog::HyperLogLog() : registers(REGISTER_COUNT, 0) {}
+
+/**
+ * @brief Hashes a value with 64-bit FNV-1a followed by a bit mixer, so every bit of the hash depends on every byte. The hash is
+ * the same on every platform, unlike std::hash.
+ * @param value the value
+ * @return the hash
+*/
+std::uint64_t HyperLogLog::hashOf(std::string_view value) {
+	std::uint64_t hash = 14695981039346656037ULL;
+	for (char character : value) {
+		hash = (hash ^ static_cast<unsigned char>(character)) * 1099511628211ULL;
+	}
+	hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebULL;
+	return hash ^ (hash >> 31);
+}
+
+/**
+ * @brief Adds a value. Adding a value again leaves the sketch unchanged.
+ * @param value the value
+*/
+void HyperLogLog::add(std::string_view value) {
+	std::uint64_t hash = hashOf(value);
+	std::size_t index = static_cast<std::size_t>(hash >> (64 - PRECISION));
+	std::uint64_t rest = hash << PRECISION;
+
+	// The rank is the position of the first 1 bit after the register bits, or one past the end if they are all 0
+	std::uint8_t rank = 1;
+	while (rank <= 64 - PRECISION && (rest & (std::uint64_t{ 1 } << 63)) == 0) {
+		rank++;
+		rest <<= 1;
+	}
+	HyperLogLog::registers[index] = std::max(HyperLogLog::registers[index], rank);
+}
+
+/**
+ * @brief Adds every value another sketch has seen
+ * @param other the other sketch
+*/
+void HyperLogLog::merge(const HyperLogLog &other) {
+	for (std::size_t i = 0; i < REGISTER_COUNT; i++) {
+		HyperLogLog::registers[i] = std::max(HyperLogLog::registers[i], other.registers[i]);
+	}
+}
+
+/**
+ * @return the estimated number of distinct values added
+*/
+std::size_t HyperLogLog::estimate() const {
+	const double registerCount = static_cast<double>(REGISTER_COUNT);
+	double inverseSum{ 0 };
+	std::size_t emptyCount{ 0 };
+	for (std::uint8_t rank : HyperLogLog::registers) {
+		inverseSum += std::ldexp(1.0, -rank);
+		emptyCount += rank == 0 ? 1 : 0;
+	}
+
+	double alpha = 0.7213 / (1 + 1.079 / registerCount);
+	double estimate = alpha * registerCount * registerCount / inverseSum;
+	// Below 2.5 values per register the raw estimate is biased, and counting the empty registers is more accurate
+	if (estimate <= 2.5 * registerCount && emptyCount > 0) {
+		estimate = registerCount * std::log(registerCount / static_cast<double>(emptyCount));
+	}
+	return static_cast<std::size_t>(std::llround(estimate));
+}
+
+TEST_CASE("Test that HyperLogLog estimates distinct counts and merges sketches") {
+	HyperLogLog empty{};
+	CHECK(empty.estimate() == 0);
+
+	HyperLogLog small{};
+	for (int repeat = 0; repeat < 3; repeat++) {
+		for (const char *province : { "Quebec", "Ontario", "Manitoba", "Alberta", "Canada" }) {
+			small.add(province);
+		}
+	}
+	CHECK(small.estimate() == 5);
+
+	/* Two halves of 200000 values, overlapping by 50000, are sketched apart and merged */
+	HyperLogLog first{};
+	HyperLogLog second{};
+	for (int i = 0; i < 125000; i++) {
+		first.add("v" + std::to_string(i));
+		second.add("v" + std::to_string(i + 75000));
+	}
+	first.merge(second);
+	double estimate = static_cast<double>(first.estimate());
+	CHECK(estimate > 200000 * 0.95);
+	CHECK(estimate < 200000 * 1.05);
+}
@@ -0,0 +1,75 @@
+/**
+* @file				HyperLogLog.h
+* @author			Chloe Lee-Hone<leeh0002@algonquinlive.com>
+* @version			1.0
+* @section			Header file for the HyperLogLog class, a fixed-size sketch that estimates how many distinct values it has seen.
+*					This project contains information licensed under the Open Government Licence  Canada [1][2]. Code structure was informed by the provided example written by Stanley Pieda for CST8333 [3].
+*
+* Student Name:     Chloe Lee-Hone
+* Student Number:   041023578
+* Course:           CST8333_350: Programming Language Research Project
+* Professor:        Reg Dyer
+* Date:             05/06/2023
+*
+* References:
+* [1]   T. B. of C. Secretariat and T. B. S. of C. Open Government, Open Government Licence - Canada. http://open.canada.ca/en/open-government-licence-canada (accessed May 11, 2023).
+* [2]	T. B. of C. Secretariat and Open Government Portal, Vegetables in cold and common storage, Oct. 10, 2008. https://open.canada.ca/data/en/dataset/473f9524-45f8-47d0-9a12-537bb7704089 (accessed May 16, 2023).
+* [3]	S. Pieda, CST8333 19F Practical Project 2 Example Layered. Algonquin College, Algonquin College, Jun. 07, 2022. [Online]. Available: https://brightspace.algonquincollege.com/d2l/le/content/543581/viewContent/8322468/View
+*/
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "doctest.h"
+
+#ifndef HYPER_LOG_LOG_H
+#define HYPER_LOG_LOG_H
+
+/**
+ * @brief Estimates the number of distinct values added to it in a fixed 4 KiB, however many values there are. Each value is hashed;
+ * the first bits of the hash pick one of the registers, which keeps the longest run of leading zeros seen in the rest. Long runs
+ * are rare, so the registers together estimate the number of distinct hashes, with a typical error of 1.6%. Small counts are
+ * estimated from the number of empty registers instead, which is nearly exact.
+ *
+ * Sketches built from different values, such as on separate threads, are combined with merge() into the sketch of all the values.
+ * A value cannot be taken out again.
+*/
+class HyperLogLog
+{
+public:
+	/** @brief The number of hash bits that pick a register. 2^PRECISION registers are kept. */
+	static constexpr unsigned PRECISION = 12;
+
+	/** @brief Creates a sketch that has seen no values */
+	HyperLogLog();
+
+	/**
+	 * @brief Adds a value. Adding a value again leaves the sketch unchanged.
+	 * @param value the value
+	*/
+	void add(std::string_view value);
+
+	/**
+	 * @brief Adds every value another sketch has seen
+	 * @param other the other sketch
+	*/
+	void merge(const HyperLogLog &other);
+
+	/** @return the estimated number of distinct values added */
+	std::size_t estimate() const;
+
+private:
+	/** @brief the longest run of leading zeros, plus one, seen by each register */
+	std::vector<std::uint8_t> registers;
+
+	/**
+	 * @brief Hashes a value with 64-bit FNV-1a followed by a bit mixer, so every bit of the hash depends on every byte. The hash is
+	 * the same on every platform, unlike std::hash.
+	 * @param value the value
+	 * @return the hash
+	*/
+	static std::uint64_t hashOf(std::string_view value);
+};
+#endif // !HYPER_LOG_LOG_H
@@ -0,0 +1,75 @@
+/**
+* @file				InlineString.h
+* @author			Chloe Lee-Hone<leeh0002@algonquinlive.com>
+* @version			1.0
+* @section			Header-only fixed-width string stored inside the object that owns it. Used by RecordDTO for short codes so they do not need a heap allocation.
+*					This project contains information licensed under the Open Government Licence  Canada [1][2]. Code structure was informed by the provided example written by Stanley Pieda for CST8333 [3].
+*
+* Student Name:     Chloe Lee-Hone
+* Student Number:   041023578
+* Course:           CST8333_350: Programming Language Research Project
+* Professor:        Reg Dyer
+* Date:             05/06/2023
+*
+* References:
+* [1]   T. B. of C. Secretariat and T. B. S. of C. Open Government, Open Government Licence - Canada. http://open.canada.ca/en/open-government-licence-canada (accessed May 11, 2023).
+* [2]	T. B. of C. Secretariat and Open Government Portal, Vegetables in cold and common storage, Oct. 10, 2008. https://open.canada.ca/data/en/dataset/473f9524-45f8-47d0-9a12-537bb7704089 (accessed May 16, 2023).
+* [3]	S. Pieda, CST8333 19F Practical Project 2 Example Layered. Algonquin College, Algonquin College, Jun. 07, 2022. [Online]. Available: https://brightspace.algonquincollege.com/d2l/le/content/543581/viewContent/8322468/View
+*/
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#ifndef INLINE_STRING_H
+#define INLINE_STRING_H
+
+/**
+ * @brief Stores up to Capacity characters in place. A value that does not fit is not stored here at all: the owner keeps it
+ * elsewhere and calls markSpilled(), so the object stays Capacity + 1 bytes regardless of what the user types.
+*/
+template <std::size_t Capacity>
+class InlineString {
+	static_assert(Capacity < 255, "the length byte reserves 255 to mark a spilled value");
+
+private:
+	/** @brief the value's characters. Not null-terminated. */
+	char characters[Capacity]{};
+	/** @brief the number of characters in use, or SPILLED */
+	std::uint8_t length{ 0 };
+
+	static constexpr std::uint8_t SPILLED = 255;
+
+public:
+	/**
+	 * @brief Checks whether a value can be stored in place
+	 * @param value the value to check
+	 * @return true if the value is at most Capacity characters long
+	*/
+	static constexpr bool fits(std::string_view value) { return value.size() <= Capacity; }
+
+	/**
+	 * @brief Copies a value into place. The caller must check fits() first.
+	 * @param value the new value
+	*/
+	void assign(std::string_view value) {
+		std::memcpy(characters, value.data(), value.size());
+		length = static_cast<std::uint8_t>(value.size());
+	}
+
+	/** @brief Records that the value is stored outside this object */
+	void markSpilled() { length = SPILLED; }
+
+	/** @brief Empties the value, including one marked spilled */
+	void clear() { length = 0; }
+
+	/** @return true if the value is stored outside this object */
+	bool isSpilled() const { return length == SPILLED; }
+
+	/** @return a view of the in-place value. Empty if the value is spilled. */
+	std::string_view view() const { return isSpilled() ? std::string_view{} : std::string_view{ characters, length }; }
+};
+
+#endif // !INLINE_STRING_H
@@ -0,0 +1,299 @@
+/**
+* @file				MaterializedAggregate.cpp
+* @author			Chloe Lee-Hone<leeh0002@algonquinlive.com>
+* @version			1.0
+* @section			This file contains the MaterializedAggregate class used by RecordService to keep group-by results up to date as records change.
+*					This project contains information licensed under the Open Government Licence  Canada [1][2]. Code structure was informed by the provided example written by Stanley Pieda for CST8333 [3].
+*
+* Student Name:     Chloe Lee-Hone
+* Student Number:   041023578
+* Course:           CST8333_350: Programming Language Research Project
+* Professor:        Reg Dyer
+* Date:             05/06/2023
+*
+* References:
+* [1]   T. B. of C. Secretariat and T. B. S. of C. Open Government, Open Government Licence - Canada. http://open.canada.ca/en/open-government-licence-canada (accessed May 11, 2023).
+* [2]	T. B. of C. Secretariat and Open Government Portal, Vegetables in cold and common storage, Oct. 10, 2008. https://open.canada.ca/data/en/dataset/473f9524-45f8-47d0-9a12-537bb7704089 (accessed May 16, 2023).
+* [3]	S. Pieda, CST8333 19F Practical Project 2 Example Layered. Algonquin College, Algonquin College, Jun. 07, 2022. [Online]. Available: https://brightspace.algonquincollege.com/d2l/le/content/543581/viewContent/8322468/View
+*/
+
+#include "MaterializedAggregate.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include "ParallelRange.h"
+#include "doctest.h"
+
+/**
+ * @brief Creates an empty, stale aggregate
+ * @param keys the columns to group by
+ * @param aggregates the summaries to keep for each group
+*/
+MaterializedAggregate::MaterializedAggregate(std::vector<GroupKey> keys, std::vector<Aggregate> aggregates)
+	: keys{ std::move(keys) }, aggregates{ std::move(aggregates) } {}
+
+/**
+ * @return true if this aggregate answers the group-by given by keys and aggregates
+*/
+bool MaterializedAggregate::isFor(const std::vector<GroupKey> &keys, const std::vector<Aggregate> &aggregates) const {
+	return MaterializedAggregate::keys == keys && MaterializedAggregate::aggregates == aggregates;
+}
+
+/**
+ * @brief Checks whether changing a column can change this aggregate
+ * @param column the changed column
+ * @return true if the column is a group key or a summarized column
+*/
+bool MaterializedAggregate::dependsOn(RecordColumn column) const {
+	return std::any_of(keys.begin(), keys.end(), [column](const GroupKey &key) { return key.column == column; })
+		|| std::any_of(aggregates.begin(), aggregates.end(), [column](const Aggregate &aggregate) { return aggregate.column == column; });
+}
+
+/**
+ * @brief Rebuilds the state from rowCount records. Chunks of records are aggregated on separate threads and then merged.
+ * @param recordList the records
+ * @param rowCount the number of records to aggregate
+ * @param rowAt a callable taking a position below rowCount and returning its row in recordList
+*/
+template <typename RowAt>
+void MaterializedAggregate::buildRows(const std::vector<RecordDTO> &recordList, std::size_t rowCount, const RowAt &rowAt) {
+	std::vector<MaterializedAggregate> chunkAggregates(parallelChunkCount(rowCount), MaterializedAggregate{ keys, aggregates });
+
+	forEachChunk(rowCount, [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+		MaterializedAggregate &chunkAggregate = chunkAggregates[chunk];
+		chunkAggregate.isOutOfDate = false;
+		for (std::size_t i = begin; i < end; i++) {
+			chunkAggregate.add(recordList[rowAt(i)]);
+		}
+	});
+
+	groups = std::move(chunkAggregates.front().groups);
+	for (std::size_t chunk = 1; chunk < chunkAggregates.size(); chunk++) {
+		merge(chunkAggregates[chunk]);
+	}
+	isOutOfDate = false;
+}
+
+/**
+ * @brief Rebuilds the state from every record
+ * @param recordList the records
+*/
+void MaterializedAggregate::build(const std::vector<RecordDTO> &recordList) {
+	buildRows(recordList, recordList.size(), [](std::size_t i) { return i; });
+}
+
+/**
+ * @brief Rebuilds the state from the selected records, such as the live ones
+ * @param recordList the records
+ * @param rows the rows to aggregate
+*/
+void MaterializedAggregate::build(const std::vector<RecordDTO> &recordList, const std::vector<RecordIndex::RowId> &rows) {
+	buildRows(recordList, rows.size(), [&rows](std::size_t i) { return rows[i]; });
+}
+
+/**
+ * @brief Adds a record's contribution to its group
+ * @param record a record that was inserted, or the new state of an edited record
+*/
+void MaterializedAggregate::add(const RecordDTO &record) {
+	if (isOutOfDate) return;
+
+	std::string encoded{};
+	RecordAggregator::appendGroupKey(encoded, record, keys);
+	auto [position, isNew] = groups.try_emplace(std::move(encoded));
+	GroupState &group = position->second;
+	if (isNew) {
+		for (const GroupKey &key : keys) {
+			group.keys.emplace_back(RecordAggregator::groupValue(record, key));
+		}
+		group.summaries.resize(aggregates.size());
+	}
+	group.recordCount++;
+
+	for (std::size_t a = 0; a < aggregates.size(); a++) {
+		SummaryState &summary = group.summaries[a];
+		std::string_view value = record.get(aggregates[a].column);
+		double number = readNumericValue(value);
+
+		summary.count += value.empty() ? 0 : 1;
+		if (aggregates[a].function == AggregateFunction::CountDistinct && !value.empty()) {
+			summary.distinctCounts[std::string{ value }]++;
+		}
+		if (!std::isnan(number)) {
+			summary.min = summary.numberCount == 0 ? number : std::min(summary.min, number);
+			summary.max = summary.numberCount == 0 ? number : std::max(summary.max, number);
+			summary.sum += number;
+			summary.numberCount++;
+		}
+	}
+}
+
+/**
+ * @brief Subtracts a record's contribution from its group. Removing a group's current minimum or maximum marks the
+ * aggregate stale when it keeps a Min or Max, since the next smallest or largest value is not known.
+ * @param record a record about to be deleted, or the old state of a record about to be edited
+*/
+void MaterializedAggregate::remove(const RecordDTO &record) {
+	if (isOutOfDate) return;
+
+	std::string encoded{};
+	RecordAggregator::appendGroupKey(encoded, record, keys);
+	auto position = groups.find(encoded);
+	if (position == groups.end()) {
+		isOutOfDate = true;
+		return;
+	}
+	GroupState &group = position->second;
+
+	for (std::size_t a = 0; a < aggregates.size(); a++) {
+		SummaryState &summary = group.summaries[a];
+		AggregateFunction function = aggregates[a].function;
+		std::string_view value = record.get(aggregates[a].column);
+		double number = readNumericValue(value);
+
+		summary.count -= value.empty() ? 0 : 1;
+		if (function == AggregateFunction::CountDistinct && !value.empty()) {
+			auto distinct = summary.distinctCounts.find(std::string{ value });
+			if (distinct != summary.distinctCounts.end() && --distinct->second == 0) {
+				summary.distinctCounts.erase(distinct);
+			}
+		}
+		if (!std::isnan(number)) {
+			summary.numberCount--;
+			// Starting again from zero keeps rounding errors from piling up in groups that empty out
+			summary.sum = summary.numberCount == 0 ? 0 : summary.sum - number;
+			bool isExtremeRemoved = (function == AggregateFunction::Min && number <= summary.min)
+				|| (function == AggregateFunction::Max && number >= summary.max);
+			if (isExtremeRemoved && summary.numberCount > 0) {
+				isOutOfDate = true;
+			}
+		}
+	}
+
+	if (--group.recordCount == 0) {
+		groups.erase(position);
+	}
+}
+
+/**
+ * @brief Merges another aggregate's groups, built from different records, into this one
+*/
+void MaterializedAggregate::merge(MaterializedAggregate &other) {
+	for (auto &[encoded, otherGroup] : other.groups) {
+		auto [position, isNew] = groups.try_emplace(encoded);
+		GroupState &group = position->second;
+		if (isNew) {
+			group = std::move(otherGroup);
+			continue;
+		}
+
+		group.recordCount += otherGroup.recordCount;
+		for (std::size_t a = 0; a < aggregates.size(); a++) {
+			SummaryState &summary = group.summaries[a];
+			SummaryState &otherSummary = otherGroup.summaries[a];
+			if (otherSummary.numberCount > 0) {
+				summary.min = summary.numberCount == 0 ? otherSummary.min : std::min(summary.min, otherSummary.min);
+				summary.max = summary.numberCount == 0 ? otherSummary.max : std::max(summary.max, otherSummary.max);
+			}
+			summary.sum += otherSummary.sum;
+			summary.numberCount += otherSummary.numberCount;
+			summary.count += otherSummary.count;
+			for (auto &[value, count] : otherSummary.distinctCounts) {
+				summary.distinctCounts[value] += count;
+			}
+		}
+	}
+}
+
+/**
+ * @brief Reads the current result. Costs one step per group, whatever the number of records.
+ * @return one row per group, in ascending key order
+*/
+GroupByResult MaterializedAggregate::result() const {
+	constexpr double NO_VALUE = std::numeric_limits<double>::quiet_NaN();
+	GroupByResult result{ keys, aggregates, {} };
+	result.groups.reserve(groups.size());
+
+	for (const auto &[encoded, group] : groups) {
+		GroupRow row{ group.keys, {} };
+		for (std::size_t a = 0; a < aggregates.size(); a++) {
+			const SummaryState &summary = group.summaries[a];
+			switch (aggregates[a].function) {
+			case AggregateFunction::Count:			row.values.push_back(static_cast<double>(summary.count));					break;
+			case AggregateFunction::CountDistinct:	row.values.push_back(static_cast<double>(summary.distinctCounts.size()));	break;
+			case AggregateFunction::Sum:			row.values.push_back(summary.numberCount == 0 ? NO_VALUE : summary.sum);	break;
+			case AggregateFunction::Min:			row.values.push_back(summary.numberCount == 0 ? NO_VALUE : summary.min);	break;
+			case AggregateFunction::Max:			row.values.push_back(summary.numberCount == 0 ? NO_VALUE : summary.max);	break;
+			default:	row.values.push_back(summary.numberCount == 0 ? NO_VALUE : summary.sum / summary.numberCount);			break;
+			}
+		}
+		result.groups.push_back(std::move(row));
+	}
+	std::sort(result.groups.begin(), result.groups.end(), [](const GroupRow &first, const GroupRow &second) {
+		return first.keys < second.keys;
+	});
+	return result;
+}
+
+/**
+ * @brief Compares two results cell by cell, treating NaN as equal to NaN
+*/
+static bool isSameResult(const GroupByResult &first, const GroupByResult &second) {
+	if (first.groups.size() != second.groups.size()) return false;
+	for (std::size_t i = 0; i < first.groups.size(); i++) {
+		if (first.groups[i].keys != second.groups[i].keys) return false;
+		for (std::size_t a = 0; a < first.groups[i].values.size(); a++) {
+			double firstValue = first.groups[i].values[a];
+			double secondValue = second.groups[i].values[a];
+			if (firstValue != secondValue && !(std::isnan(firstValue) && std::isnan(secondValue))) return false;
+		}
+	}
+	return true;
+}
+
+TEST_CASE("Test that incremental updates match a group-by computed from scratch") {
+	const char *provinces[] = { "Quebec", "Ontario", "Manitoba" };
+	std::vector<RecordDTO> recordList(30000);
+	for (std::size_t row = 0; row < recordList.size(); row++) {
+		recordList[row].setGeo(provinces[row % 3]);
+		recordList[row].setVector("v" + std::to_string(row % 7));
+		recordList[row].setValue(std::to_string(1 + row % 40));
+	}
+
+	std::vector<GroupKey> keys{ { RecordColumn::Geo } };
+	std::vector<Aggregate> decomposable{ { AggregateFunction::Sum }, { AggregateFunction::Count }, { AggregateFunction::Average },
+		{ AggregateFunction::CountDistinct, RecordColumn::Vector } };
+	MaterializedAggregate totals{ keys, decomposable };
+	MaterializedAggregate extremes{ keys, { { AggregateFunction::Min }, { AggregateFunction::Max } } };
+	totals.build(recordList);
+	extremes.build(recordList);
+
+	/* Insert a record with a new province, then move one record to another province and give it a new value */
+	RecordDTO newRecord{};
+	newRecord.setGeo("Yukon");
+	newRecord.setValue("7");
+	totals.add(newRecord);
+	extremes.add(newRecord);
+	recordList.push_back(newRecord);
+
+	totals.remove(recordList[4]);
+	extremes.remove(recordList[4]);
+	recordList[4].setGeo("Quebec");
+	recordList[4].setValue("1000");
+	totals.add(recordList[4]);
+	extremes.add(recordList[4]);
+
+	CHECK_FALSE(totals.isStale());
+	CHECK_FALSE(extremes.isStale());
+	CHECK(isSameResult(totals.result(), RecordAggregator::groupBy(recordList, keys, decomposable)));
+	CHECK(extremes.result().groups[2].values[1] == 1000);
+
+	/* Deleting Yukon's only record removes the group; deleting Quebec's maximum cannot be undone incrementally */
+	totals.remove(recordList.back());
+	extremes.remove(recordList.back());
+	CHECK(totals.result().groups.size() == 3);
+	CHECK_FALSE(extremes.isStale());
+	extremes.remove(recordList[4]);
+	CHECK(extremes.isStale());
+}
@@ -0,0 +1,137 @@
+/**
+* @file				MaterializedAggregate.h
+* @author			Chloe Lee-Hone<leeh0002@algonquinlive.com>
+* @version			1.0
+* @section			Header file for the MaterializedAggregate class, a group-by result kept up to date as records change.
+*					This project contains information licensed under the Open Government Licence  Canada [1][2]. Code structure was informed by the provided example written by Stanley Pieda for CST8333 [3].
+*
+* Student Name:     Chloe Lee-Hone
+* Student Number:   041023578
+* Course:           CST8333_350: Programming Language Research Project
+* Professor:        Reg Dyer
+* Date:             05/06/2023
+*
+* References:
+* [1]   T. B. of C. Secretariat and T. B. S. of C. Open Government, Open Government Licence - Canada. http://open.canada.ca/en/open-government-licence-canada (accessed May 11, 2023).
+* [2]	T. B. of C. Secretariat and Open Government Portal, Vegetables in cold and common storage, Oct. 10, 2008. https://open.canada.ca/data/en/dataset/473f9524-45f8-47d0-9a12-537bb7704089 (accessed May 16, 2023).
+* [3]	S. Pieda, CST8333 19F Practical Project 2 Example Layered. Algonquin College, Algonquin College, Jun. 07, 2022. [Online]. Available: https://brightspace.algonquincollege.com/d2l/le/content/543581/viewContent/8322468/View
+*/
+
+#pragma once
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "RecordAggregator.h"
+#include "RecordColumn.h"
+#include "RecordDTO.h"
+#include "RecordIndex.h"
+#include "doctest.h"
+
+#ifndef MATERIALIZED_AGGREGATE_H
+#define MATERIALIZED_AGGREGATE_H
+
+/**
+ * @brief Keeps the running state of a group-by so the result can be read again without scanning the records. When a record is
+ * added, removed or edited, only its group changes: its old contribution is subtracted and its new one added, at a cost that
+ * does not depend on the number of records.
+ *
+ * Sum, Count, Average and CountDistinct (kept as a count per distinct value) can always be updated this way. Min and Max
+ * cannot undo the removal of the value that is currently the minimum or maximum, so such a removal marks the aggregate stale and
+ * the next read rebuilds it.
+*/
+class MaterializedAggregate
+{
+public:
+	/**
+	 * @brief Creates an empty, stale aggregate
+	 * @param keys the columns to group by
+	 * @param aggregates the summaries to keep for each group
+	*/
+	MaterializedAggregate(std::vector<GroupKey> keys, std::vector<Aggregate> aggregates);
+
+	/** @return true if this aggregate answers the group-by given by keys and aggregates */
+	bool isFor(const std::vector<GroupKey> &keys, const std::vector<Aggregate> &aggregates) const;
+
+	/** @return true if a change could not be applied incrementally, so build() must run before the result is read */
+	bool isStale() const { return isOutOfDate; }
+
+	/** @brief Marks the aggregate stale, such as after the records are reloaded */
+	void invalidate() { isOutOfDate = true; }
+
+	/**
+	 * @brief Rebuilds the state from every record. Chunks of records are aggregated on separate threads and then merged.
+	 * @param recordList the records
+	*/
+	void build(const std::vector<RecordDTO> &recordList);
+
+	/**
+	 * @brief Rebuilds the state from the selected records, such as the live ones
+	 * @param recordList the records
+	 * @param rows the rows to aggregate
+	*/
+	void build(const std::vector<RecordDTO> &recordList, const std::vector<RecordIndex::RowId> &rows);
+
+	/**
+	 * @brief Checks whether changing a column can change this aggregate
+	 * @param column the changed column
+	 * @return true if the column is a group key or a summarized column
+	*/
+	bool dependsOn(RecordColumn column) const;
+
+	/**
+	 * @brief Adds a record's contribution to its group
+	 * @param record a record that was inserted, or the new state of an edited record
+	*/
+	void add(const RecordDTO &record);
+
+	/**
+	 * @brief Subtracts a record's contribution from its group
+	 * @param record a record about to be deleted, or the old state of a record about to be edited
+	*/
+	void remove(const RecordDTO &record);
+
+	/**
+	 * @brief Reads the current result. The aggregate must not be stale.
+	 * @return one row per group, in ascending key order
+	*/
+	GroupByResult result() const;
+
+private:
+	/** @brief The running state of one summary in one group */
+	struct SummaryState {
+		double sum{ 0 };
+		double min{ 0 };
+		double max{ 0 };
+		/** @brief the number of values that were numbers */
+		std::uint64_t numberCount{ 0 };
+		/** @brief the number of non-empty values */
+		std::uint64_t count{ 0 };
+		/** @brief how many times each non-empty value occurs. Kept only for CountDistinct. */
+		std::unordered_map<std::string, std::uint64_t> distinctCounts{};
+	};
+
+	/** @brief A group's key values, its number of records and the state of each summary */
+	struct GroupState {
+		std::vector<std::string> keys{};
+		std::uint64_t recordCount{ 0 };
+		std::vector<SummaryState> summaries{};
+	};
+
+	std::vector<GroupKey> keys{};
+	std::vector<Aggregate> aggregates{};
+	/** @brief each group, found by its RecordAggregator::appendGroupKey() encoding */
+	std::unordered_map<std::string, GroupState> groups{};
+	bool isOutOfDate{ true };
+
+	/** @brief Merges another aggregate's groups, built from different records, into this one */
+	void merge(MaterializedAggregate &other);
+
+	/**
+	 * @brief Rebuilds the state from rowCount records
+	 * @param rowAt a callable taking a position below rowCount and returning its row in recordList
+	*/
+	template <typename RowAt>
+	void buildRows(const std::vector<RecordDTO> &recordList, std::size_t rowCount, const RowAt &rowAt);
+};
+#endif // !MATERIALIZED_AGGREGATE_H
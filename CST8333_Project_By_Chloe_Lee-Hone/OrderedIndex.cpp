@@ -0,0 +1,177 @@
+/**
+* @file				OrderedIndex.cpp
+* @author			Chloe Lee-Hone<leeh0002@algonquinlive.com>
+* @version			1.0
+* @section			This file contains the OrderedIndex class used by RecordService to serve records sorted by date and province.
+*					This project contains information licensed under the Open Government Licence  Canada [1][2]. Code structure was informed by the provided example written by Stanley Pieda for CST8333 [3].
+*
+* Student Name:     Chloe Lee-Hone
+* Student Number:   041023578
+* Course:           CST8333_350: Programming Language Research Project
+* Professor:        Reg Dyer
+* Date:             05/06/2023
+*
+* References:
+* [1]   T. B. of C. Secretariat and T. B. S. of C. Open Government, Open Government Licence - Canada. http://open.canada.ca/en/open-government-licence-canada (accessed May 11, 2023).
+* [2]	T. B. of C. Secretariat and Open Government Portal, Vegetables in cold and common storage, Oct. 10, 2008. https://open.canada.ca/data/en/dataset/473f9524-45f8-47d0-9a12-537bb7704089 (accessed May 16, 2023).
+* [3]	S. Pieda, CST8333 19F Practical Project 2 Example Layered. Algonquin College, Algonquin College, Jun. 07, 2022. [Online]. Available: https://brightspace.algonquincollege.com/d2l/le/content/543581/viewContent/8322468/View
+*/
+
+#include "OrderedIndex.h"
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+#include <random>
+#include "doctest.h"
+
+/**
+ * @brief Replaces the permutation with one covering every row of the list
+ * @param recordList the records, where row i is recordList[i]
+*/
+void OrderedIndex::build(const std::vector<RecordDTO> &recordList) {
+	order.resize(recordList.size());
+	std::iota(order.begin(), order.end(), RowId{ 0 });
+	std::sort(order.begin(), order.end(), [&recordList](RowId first, RowId second) { return isBefore(recordList, first, second); });
+}
+
+/**
+ * @brief Adds a row in key order. Call after the record is in the list.
+ * @param recordList the records, including the new one
+ * @param row the new row
+*/
+void OrderedIndex::insert(const std::vector<RecordDTO> &recordList, RowId row) {
+	auto position = std::lower_bound(order.begin(), order.end(), row,
+		[&recordList](RowId entry, RowId newRow) { return isBefore(recordList, entry, newRow); });
+	order.insert(position, row);
+}
+
+/**
+ * @brief Removes a row. Call while the record still holds the key it was inserted with.
+ * @param recordList the records
+ * @param row the row to remove
+*/
+void OrderedIndex::erase(const std::vector<RecordDTO> &recordList, RowId row) {
+	auto position = std::lower_bound(order.begin(), order.end(), row,
+		[&recordList](RowId entry, RowId erasedRow) { return isBefore(recordList, entry, erasedRow); });
+	if (position != order.end() && *position == row) {
+		order.erase(position);
+	}
+}
+
+/**
+ * @brief Places many rows at once: rows whose keys changed are taken out and merged back in at their new positions,
+ * and new rows are merged in
+ * @param recordList the records, holding the rows' current keys
+ * @param rows the changed and new rows, each listed once. Reordered by the call.
+*/
+void OrderedIndex::placeBatch(const std::vector<RecordDTO> &recordList, std::vector<RowId> &rows) {
+	std::vector<char> isPlaced(recordList.size(), false);
+	for (RowId row : rows) {
+		isPlaced[row] = true;
+	}
+	order.erase(std::remove_if(order.begin(), order.end(), [&isPlaced](RowId row) { return isPlaced[row] != 0; }), order.end());
+
+	auto isRowBefore = [&recordList](RowId first, RowId second) { return isBefore(recordList, first, second); };
+	std::sort(rows.begin(), rows.end(), isRowBefore);
+	std::vector<RowId> merged{};
+	merged.reserve(order.size() + rows.size());
+	std::merge(order.begin(), order.end(), rows.begin(), rows.end(), std::back_inserter(merged), isRowBefore);
+	order.swap(merged);
+}
+
+/**
+ * @brief Moves every row to its new position after the vector was compacted, and drops the rows that were removed
+ * @param newRows the new position of each old row, or RecordIndex::NO_ROW for a removed row
+*/
+void OrderedIndex::renumber(const std::vector<RowId> &newRows) {
+	std::size_t kept{ 0 };
+	for (RowId row : order) {
+		if (newRows[row] != RecordIndex::NO_ROW) {
+			order[kept++] = newRows[row];
+		}
+	}
+	order.resize(kept);
+}
+
+/**
+ * @brief Returns the first rows in key order
+ * @param count the number of rows wanted
+ * @param isDescending true to start from the largest key
+ * @return at most count rows
+*/
+std::vector<OrderedIndex::RowId> OrderedIndex::first(std::size_t count, bool isDescending) const {
+	count = std::min(count, order.size());
+	if (isDescending) {
+		return std::vector<RowId>(order.rbegin(), order.rbegin() + count);
+	}
+	return std::vector<RowId>(order.begin(), order.begin() + count);
+}
+
+/**
+ * @brief Orders two rows by REF_DATE, then GEO, then row
+ * @return true if row first comes before row second
+*/
+bool OrderedIndex::isBefore(const std::vector<RecordDTO> &recordList, RowId first, RowId second) {
+	const RecordDTO &firstRecord = recordList[first];
+	const RecordDTO &secondRecord = recordList[second];
+
+	int dateComparison = firstRecord.get<RecordColumn::RefDate>().compare(secondRecord.get<RecordColumn::RefDate>());
+	if (dateComparison != 0) return dateComparison < 0;
+	int geoComparison = firstRecord.get<RecordColumn::Geo>().compare(secondRecord.get<RecordColumn::Geo>());
+	if (geoComparison != 0) return geoComparison < 0;
+	return first < second;
+}
+
+TEST_CASE("Test that the ordered index matches a full sort after inserts, edits and deletes") {
+	const char *provinces[] = { "Quebec", "Ontario", "Alberta", "Manitoba" };
+	std::mt19937 random{ 8333 };
+	std::vector<RecordDTO> recordList{};
+	OrderedIndex orderedIndex{};
+
+	for (int i = 0; i < 500; i++) {
+		RecordDTO record{};
+		record.setRefDate("19" + std::to_string(70 + random() % 10) + "-0" + std::to_string(1 + random() % 9));
+		record.setGeo(provinces[random() % 4]);
+		recordList.push_back(record);
+	}
+	orderedIndex.build(recordList);
+
+	/* Insert a record */
+	recordList.push_back(recordList[7]);
+	orderedIndex.insert(recordList, static_cast<OrderedIndex::RowId>(recordList.size() - 1));
+
+	/* Edit a record: remove it under its old key and add it back under the new one */
+	orderedIndex.erase(recordList, 3);
+	recordList[3].setRefDate("1969-12");
+	orderedIndex.insert(recordList, 3);
+
+	/* Delete a record and compact the vector */
+	std::vector<OrderedIndex::RowId> newRows(recordList.size());
+	std::iota(newRows.begin(), newRows.end(), OrderedIndex::RowId{ 0 });
+	for (std::size_t row = 11; row < newRows.size(); row++) newRows[row]--;
+	newRows[10] = RecordIndex::NO_ROW;
+	recordList.erase(recordList.begin() + 10);
+	orderedIndex.renumber(newRows);
+
+	/* Edit several records and append two more, then place them all at once */
+	recordList[20].setGeo("Yukon");
+	recordList[40].setRefDate("1985-01");
+	recordList.push_back(recordList[2]);
+	recordList.push_back(recordList[5]);
+	std::vector<OrderedIndex::RowId> changedRows{ 40, 20, static_cast<OrderedIndex::RowId>(recordList.size() - 2), static_cast<OrderedIndex::RowId>(recordList.size() - 1) };
+	orderedIndex.placeBatch(recordList, changedRows);
+
+	std::vector<OrderedIndex::RowId> expected(recordList.size());
+	std::iota(expected.begin(), expected.end(), OrderedIndex::RowId{ 0 });
+	std::sort(expected.begin(), expected.end(), [&recordList](OrderedIndex::RowId first, OrderedIndex::RowId second) {
+		int dateComparison = recordList[first].getRefDate().compare(recordList[second].getRefDate());
+		if (dateComparison != 0) return dateComparison < 0;
+		int geoComparison = recordList[first].getGeo().compare(recordList[second].getGeo());
+		if (geoComparison != 0) return geoComparison < 0;
+		return first < second;
+	});
+
+	CHECK(orderedIndex.first(recordList.size(), false) == expected);
+	CHECK(recordList[orderedIndex.first(1, false).front()].getRefDate() == "1969-12");
+	CHECK(orderedIndex.first(3, true) == std::vector<OrderedIndex::RowId>(expected.rbegin(), expected.rbegin() + 3));
+}
@@ -0,0 +1,96 @@
+/**
+* @file				OrderedIndex.h
+* @author			Chloe Lee-Hone<leeh0002@algonquinlive.com>
+* @version			1.0
+* @section			Header file for the OrderedIndex class, which keeps the rows ordered by (REF_DATE, GEO) without moving the records.
+*					This project contains information licensed under the Open Government Licence  Canada [1][2]. Code structure was informed by the provided example written by Stanley Pieda for CST8333 [3].
+*
+* Student Name:     Chloe Lee-Hone
+* Student Number:   041023578
+* Course:           CST8333_350: Programming Language Research Project
+* Professor:        Reg Dyer
+* Date:             05/06/2023
+*
+* References:
+* [1]   T. B. of C. Secretariat and T. B. S. of C. Open Government, Open Government Licence - Canada. http://open.canada.ca/en/open-government-licence-canada (accessed May 11, 2023).
+* [2]	T. B. of C. Secretariat and Open Government Portal, Vegetables in cold and common storage, Oct. 10, 2008. https://open.canada.ca/data/en/dataset/473f9524-45f8-47d0-9a12-537bb7704089 (accessed May 16, 2023).
+* [3]	S. Pieda, CST8333 19F Practical Project 2 Example Layered. Algonquin College, Algonquin College, Jun. 07, 2022. [Online]. Available: https://brightspace.algonquincollege.com/d2l/le/content/543581/viewContent/8322468/View
+*/
+
+#pragma once
+#include <cstddef>
+#include <vector>
+#include "RecordDTO.h"
+#include "RecordIndex.h"
+#include "doctest.h"
+
+#ifndef ORDERED_INDEX_H
+#define ORDERED_INDEX_H
+
+/**
+ * @brief A sorted permutation of the rows: order[i] is the row with the i-th smallest (REF_DATE, GEO) key. Rows with equal keys
+ * are ordered by row, so every entry has a unique position that a binary search can find. The records never move; inserts,
+ * edits and deletes adjust the permutation with one binary search and one shift of 4-byte row ids.
+*/
+class OrderedIndex
+{
+public:
+	using RowId = RecordIndex::RowId;
+
+	/**
+	 * @brief Replaces the permutation with one covering every row of the list
+	 * @param recordList the records, where row i is recordList[i]
+	*/
+	void build(const std::vector<RecordDTO> &recordList);
+
+	/**
+	 * @brief Adds a row in key order. Call after the record is in the list.
+	 * @param recordList the records, including the new one
+	 * @param row the new row
+	*/
+	void insert(const std::vector<RecordDTO> &recordList, RowId row);
+
+	/**
+	 * @brief Removes a row. Call while the record still holds the key it was inserted with, that is before it is edited or erased.
+	 * @param recordList the records
+	 * @param row the row to remove
+	*/
+	void erase(const std::vector<RecordDTO> &recordList, RowId row);
+
+	/**
+	 * @brief Places many rows at once: rows whose keys changed are taken out and merged back in at their new positions,
+	 * and new rows are merged in. Costs one pass over the permutation plus a sort of the rows, however many there are.
+	 * @param recordList the records, holding the rows' current keys
+	 * @param rows the changed and new rows, each listed once. Reordered by the call.
+	*/
+	void placeBatch(const std::vector<RecordDTO> &recordList, std::vector<RowId> &rows);
+
+	/**
+	 * @brief Moves every row to its new position after the vector was compacted, and drops the rows that were removed.
+	 * Compaction keeps the rows in order, so rows with equal keys stay ordered by row.
+	 * @param newRows the new position of each old row, or RecordIndex::NO_ROW for a removed row
+	*/
+	void renumber(const std::vector<RowId> &newRows);
+
+	/**
+	 * @brief Returns the first rows in key order
+	 * @param count the number of rows wanted
+	 * @param isDescending true to start from the largest key
+	 * @return at most count rows. Costs O(count).
+	*/
+	std::vector<RowId> first(std::size_t count, bool isDescending) const;
+
+	/** @return the number of rows in the permutation */
+	std::size_t size() const { return order.size(); }
+
+private:
+	/** @brief the rows in ascending key order */
+	std::vector<RowId> order{};
+
+	/**
+	 * @brief Orders two rows by REF_DATE, then GEO, then row
+	 * @return true if row first comes before row second
+	*/
+	static bool isBefore(const std::vector<RecordDTO> &recordList, RowId first, RowId second);
+};
+#endif // !ORDERED_INDEX_H
@@ -0,0 +1,117 @@
+/**
+* @file				ParallelRange.h
+* @author			Chloe Lee-Hone<leeh0002@algonquinlive.com>
+* @version			1.0
+* @section			Header-only helper that splits a range of rows into chunks and processes the chunks on separate threads with std::async.
+*					This project contains information licensed under the Open Government Licence  Canada [1][2]. Code structure was informed by the provided example written by Stanley Pieda for CST8333 [3].
+*
+* Student Name:     Chloe Lee-Hone
+* Student Number:   041023578
+* Course:           CST8333_350: Programming Language Research Project
+* Professor:        Reg Dyer
+* Date:             05/06/2023
+*
+* References:
+* [1]   T. B. of C. Secretariat and T. B. S. of C. Open Government, Open Government Licence - Canada. http://open.canada.ca/en/open-government-licence-canada (accessed May 11, 2023).
+* [2]	T. B. of C. Secretariat and Open Government Portal, Vegetables in cold and common storage, Oct. 10, 2008. https://open.canada.ca/data/en/dataset/473f9524-45f8-47d0-9a12-537bb7704089 (accessed May 16, 2023).
+* [3]	S. Pieda, CST8333 19F Practical Project 2 Example Layered. Algonquin College, Algonquin College, Jun. 07, 2022. [Online]. Available: https://brightspace.algonquincollege.com/d2l/le/content/543581/viewContent/8322468/View
+*/
+
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <future>
+#include <iterator>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifndef PARALLEL_RANGE_H
+#define PARALLEL_RANGE_H
+
+/** @brief Ranges with fewer rows than this per thread are processed on the calling thread. Starting a thread costs more than scanning them. */
+inline constexpr std::size_t MIN_ROWS_PER_THREAD = 16384;
+
+/**
+ * @brief Decides how many chunks a range of rows is split into
+ * @param rowCount the number of rows to process
+ * @return at least 1, and at most the number of hardware threads
+*/
+inline std::size_t parallelChunkCount(std::size_t rowCount) {
+	std::size_t threadCount = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+	std::size_t usefulChunks = std::max<std::size_t>(1, rowCount / MIN_ROWS_PER_THREAD);
+	return std::min(threadCount, usefulChunks);
+}
+
+/**
+ * @brief Splits [0, rowCount) into parallelChunkCount(rowCount) contiguous chunks of nearly equal size
+ * @param rowCount the number of rows to split
+ * @return the chunk boundaries: chunk i covers [boundaries[i], boundaries[i + 1])
+*/
+inline std::vector<std::size_t> chunkBoundaries(std::size_t rowCount) {
+	std::size_t chunkCount = parallelChunkCount(rowCount);
+	std::vector<std::size_t> boundaries(chunkCount + 1);
+
+	for (std::size_t chunk = 0; chunk <= chunkCount; chunk++) {
+		boundaries[chunk] = rowCount * chunk / chunkCount;
+	}
+	return boundaries;
+}
+
+/**
+ * @brief Splits [0, rowCount) as chunkBoundaries() does and calls work(begin, end, chunk) for each chunk.
+ * Chunk 0 covers the lowest rows, so merging per-chunk results in chunk order keeps row order. The first chunk runs on the
+ * calling thread and the rest run as std::async tasks. Returns once every chunk is done; an exception thrown by any chunk is rethrown.
+ * @param rowCount the number of rows to process
+ * @param work a callable taking (std::size_t begin, std::size_t end, std::size_t chunk)
+*/
+template <typename Work>
+void forEachChunk(std::size_t rowCount, Work &&work) {
+	std::vector<std::size_t> boundaries = chunkBoundaries(rowCount);
+
+	std::vector<std::future<void>> futures{};
+	for (std::size_t chunk = 1; chunk + 1 < boundaries.size(); chunk++) {
+		std::size_t begin = boundaries[chunk];
+		std::size_t end = boundaries[chunk + 1];
+		futures.push_back(std::async(std::launch::async, [&work, begin, end, chunk]() { work(begin, end, chunk); }));
+	}
+
+	work(boundaries[0], boundaries[1], std::size_t{ 0 });
+	for (std::future<void> &future : futures) {
+		future.get();
+	}
+}
+
+/**
+ * @brief Hash-partitions the entries made from [0, rowCount) in two passes, so no two threads share a container. The first pass
+ * calls emit(row, add) for each row of each chunk, and emit calls add(hash, entry) for every entry the row makes; the entry is
+ * filed under partition hash % parallelChunkCount(rowCount). The second pass reuses the chunking only to run one task per
+ * partition, calling consume(partition, entries) with the partition's entries in ascending row order.
+ * @param rowCount the number of rows to process
+ * @param emit a callable taking (std::size_t row, add), where add is a callable taking (std::size_t hash, Entry entry)
+ * @param consume a callable taking (std::size_t partition, std::vector<Entry> &entries)
+*/
+template <typename Entry, typename Emit, typename Consume>
+void forEachPartition(std::size_t rowCount, Emit &&emit, Consume &&consume) {
+	std::size_t partitionCount = parallelChunkCount(rowCount);
+
+	// chunkPartitions[chunk][partition] holds the chunk's entries that hash to the partition
+	std::vector<std::vector<std::vector<Entry>>> chunkPartitions(partitionCount, std::vector<std::vector<Entry>>(partitionCount));
+	forEachChunk(rowCount, [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+		std::vector<std::vector<Entry>> &output = chunkPartitions[chunk];
+		auto add = [&output, partitionCount](std::size_t hash, Entry entry) { output[hash % partitionCount].push_back(std::move(entry)); };
+		for (std::size_t row = begin; row < end; row++) {
+			emit(row, add);
+		}
+	});
+
+	forEachChunk(rowCount, [&](std::size_t, std::size_t, std::size_t partition) {
+		std::vector<Entry> entries = std::move(chunkPartitions[0][partition]);
+		for (std::size_t chunk = 1; chunk < partitionCount; chunk++) {
+			std::move(chunkPartitions[chunk][partition].begin(), chunkPartitions[chunk][partition].end(), std::back_inserter(entries));
+		}
+		consume(partition, entries);
+	});
+}
+
+#endif // !PARALLEL_RANGE_H
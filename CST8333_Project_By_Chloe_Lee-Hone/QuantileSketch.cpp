@@ -0,0 +1,211 @@
+/**
+* @file				QuantileSketch.cpp
+* @author			Chloe Lee-Hone<leeh0002@algonquinlive.com>
+* @version			1.0
+* @section			This file contains the QuantileSketch class, a bounded-size sketch that estimates percentiles of the numbers added to it.
+*					This project contains information licensed under the Open Government Licence  Canada [1][2]. Code structure was informed by the provided example written by Stanley Pieda for CST8333 [3].
+*
+* Student Name:     Chloe Lee-Hone
+* Student Number:   041023578
+* Course:           CST8333_350: Programming Language Research Project
+* Professor:        Reg Dyer
+* Date:             05/06/2023
+*
+* References:
+* [1]   T. B. of C. Secretariat and T. B. S. of C. Open Government, Open Government Licence - Canada. http://open.canada.ca/en/open-government-licence-canada (accessed May 11, 2023).
+* [2]	T. B. of C. Secretariat and Open Government Portal, Vegetables in cold and common storage, Oct. 10, 2008. https://open.canada.ca/data/en/dataset/473f9524-45f8-47d0-9a12-537bb7704089 (accessed May 16, 2023).
+* [3]	S. Pieda, CST8333 19F Practical Project 2 Example Layered. Algonquin College, Algonquin College, Jun. 07, 2022. [Online]. Available: https://brightspace.algonquincollege.com/d2l/le/content/543581/viewContent/8322468/View
+*/
+
+#include "QuantileSketch.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+/** @brief The capacity of each level relative to the one above it */
+static constexpr double LEVEL_RATIO = 2.0 / 3.0;
+/** @brief The smallest capacity a level can have. Compacting fewer than two numbers would move nothing. */
+static constexpr std::size_t MIN_LEVEL_CAPACITY = 2;
+
+/**
+ * @brief Checks a percentile's fraction
+ * @param fraction the percentile as a fraction
+ * @return the rank of the percentile among count numbers, from 1
+ * @throws std::invalid_argument if the fraction is not between 0 and 1
+*/
+static std::uint64_t nearestRank(double fraction, std::uint64_t count) {
+	if (!(fraction >= 0 && fraction <= 1)) {
+		throw std::invalid_argument("A percentile must be between 0 and 1.");
+	}
+	return std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(fraction * static_cast<double>(count))));
+}
+
+/**
+ * @brief Creates a sketch that has seen no numbers
+ * @param accuracy the capacity of the top level. The sketch keeps about three times as many numbers.
+*/
+QuantileSketch::QuantileSketch(std::size_t accuracy) : accuracy{ std::max(accuracy, MIN_LEVEL_CAPACITY) } {}
+
+/**
+ * @return the number of numbers a level holds before it is compacted
+*/
+std::size_t QuantileSketch::levelCapacity(std::size_t level) const {
+	std::size_t depth = QuantileSketch::levels.size() - 1 - level;
+	double capacity = std::ceil(static_cast<double>(QuantileSketch::accuracy) * std::pow(LEVEL_RATIO, static_cast<double>(depth)));
+	return std::max(static_cast<std::size_t>(capacity), MIN_LEVEL_CAPACITY);
+}
+
+/**
+ * @return the number of numbers the sketch keeps
+*/
+std::size_t QuantileSketch::retainedCount() const {
+	std::size_t retained{ 0 };
+	for (const std::vector<double> &level : QuantileSketch::levels) {
+		retained += level.size();
+	}
+	return retained;
+}
+
+/**
+ * @brief Adds a number
+ * @param value the number
+*/
+void QuantileSketch::add(double value) {
+	QuantileSketch::levels.front().push_back(value);
+	QuantileSketch::totalCount++;
+	if (QuantileSketch::levels.front().size() >= levelCapacity(0)) {
+		compress();
+	}
+}
+
+/**
+ * @brief Adds every number another sketch has seen
+ * @param other the other sketch
+*/
+void QuantileSketch::merge(const QuantileSketch &other) {
+	if (other.levels.size() > QuantileSketch::levels.size()) {
+		QuantileSketch::levels.resize(other.levels.size());
+	}
+	for (std::size_t level = 0; level < other.levels.size(); level++) {
+		QuantileSketch::levels[level].insert(QuantileSketch::levels[level].end(), other.levels[level].begin(), other.levels[level].end());
+	}
+	QuantileSketch::totalCount += other.totalCount;
+	compress();
+}
+
+/**
+ * @brief Compacts every full level, from the bottom up, until none is full
+*/
+void QuantileSketch::compress() {
+	// Adding a level shrinks the capacities below it, so the levels are checked again until a pass compacts nothing
+	bool isCompacted{ true };
+	while (isCompacted) {
+		isCompacted = false;
+		for (std::size_t level = 0; level < QuantileSketch::levels.size(); level++) {
+			if (QuantileSketch::levels[level].size() >= levelCapacity(level)) {
+				compactLevel(level);
+				isCompacted = true;
+			}
+		}
+	}
+}
+
+/**
+ * @brief Sorts a level and moves every other number up a level. With an odd count, the largest number stays.
+ * @param level the level to compact
+*/
+void QuantileSketch::compactLevel(std::size_t level) {
+	if (level + 1 == QuantileSketch::levels.size()) {
+		QuantileSketch::levels.emplace_back();
+	}
+	std::vector<double> &numbers = QuantileSketch::levels[level];
+	std::vector<double> &above = QuantileSketch::levels[level + 1];
+	std::sort(numbers.begin(), numbers.end());
+
+	std::size_t pairedCount = numbers.size() - numbers.size() % 2;
+	for (std::size_t i = QuantileSketch::isOddCompaction ? 1 : 0; i < pairedCount; i += 2) {
+		above.push_back(numbers[i]);
+	}
+	QuantileSketch::isOddCompaction = !QuantileSketch::isOddCompaction;
+	numbers.erase(numbers.begin(), numbers.begin() + static_cast<std::ptrdiff_t>(pairedCount));
+}
+
+/**
+ * @brief Estimates a percentile, using the nearest-rank definition: the smallest number at least a given fraction of the numbers
+ * are less than or equal to
+ * @param fraction the percentile as a fraction, such as 0.95 for the 95th
+ * @return the estimated percentile, or NaN if no numbers were added
+ * @throws std::invalid_argument if the fraction is not between 0 and 1
+*/
+double QuantileSketch::quantile(double fraction) const {
+	std::uint64_t rank = nearestRank(fraction, QuantileSketch::totalCount);
+	if (QuantileSketch::totalCount == 0) {
+		return std::numeric_limits<double>::quiet_NaN();
+	}
+
+	std::vector<std::pair<double, std::uint64_t>> weighted{};
+	weighted.reserve(retainedCount());
+	for (std::size_t level = 0; level < QuantileSketch::levels.size(); level++) {
+		for (double value : QuantileSketch::levels[level]) {
+			weighted.emplace_back(value, std::uint64_t{ 1 } << level);
+		}
+	}
+	std::sort(weighted.begin(), weighted.end());
+
+	std::uint64_t cumulativeWeight{ 0 };
+	for (const std::pair<double, std::uint64_t> &entry : weighted) {
+		cumulativeWeight += entry.second;
+		if (cumulativeWeight >= rank) {
+			return entry.first;
+		}
+	}
+	return weighted.back().first;
+}
+
+/**
+ * @brief Finds the nearest-rank percentile of numbers exactly, for comparison with quantile()
+ * @param values the numbers. They are reordered.
+ * @param fraction the percentile as a fraction, such as 0.95 for the 95th
+ * @return the percentile, or NaN if there are no numbers
+ * @throws std::invalid_argument if the fraction is not between 0 and 1
+*/
+double QuantileSketch::exactQuantile(std::vector<double> &values, double fraction) {
+	std::uint64_t rank = nearestRank(fraction, values.size());
+	if (values.empty()) {
+		return std::numeric_limits<double>::quiet_NaN();
+	}
+	auto nth = values.begin() + static_cast<std::ptrdiff_t>(rank - 1);
+	std::nth_element(values.begin(), nth, values.end());
+	return *nth;
+}
+
+TEST_CASE("Test that quantile sketches stay small and estimate percentiles close to the exact ones") {
+	QuantileSketch small{};
+	std::vector<double> smallValues{ 5, 1, 4, 2, 3 };
+	for (double value : smallValues) {
+		small.add(value);
+	}
+	/* Every number is still kept, so the estimates are exact */
+	CHECK(small.quantile(0.5) == QuantileSketch::exactQuantile(smallValues, 0.5));
+	CHECK(small.quantile(0) == 1);
+	CHECK(small.quantile(1) == 5);
+	CHECK(std::isnan(QuantileSketch{}.quantile(0.95)));
+	CHECK_THROWS_AS(small.quantile(1.5), std::invalid_argument);
+
+	/* 0..199999 in a scrambled order, split over two sketches that are then merged */
+	const std::uint64_t COUNT = 200000;
+	QuantileSketch first{};
+	QuantileSketch second{};
+	for (std::uint64_t i = 0; i < COUNT; i++) {
+		double value = static_cast<double>((i * 7919) % COUNT);
+		(i % 2 == 0 ? first : second).add(value);
+	}
+	first.merge(second);
+	CHECK(first.count() == COUNT);
+	CHECK(first.retainedCount() < 4 * QuantileSketch::DEFAULT_ACCURACY);
+	for (double fraction : { 0.05, 0.5, 0.95 }) {
+		CHECK(std::abs(first.quantile(fraction) - fraction * COUNT) < 0.02 * COUNT);
+	}
+}
@@ -0,0 +1,106 @@
+/**
+* @file				QuantileSketch.h
+* @author			Chloe Lee-Hone<leeh0002@algonquinlive.com>
+* @version			1.0
+* @section			Header file for the QuantileSketch class, a bounded-size sketch that estimates percentiles of the numbers added to it.
+*					This project contains information licensed under the Open Government Licence  Canada [1][2]. Code structure was informed by the provided example written by Stanley Pieda for CST8333 [3].
+*
+* Student Name:     Chloe Lee-Hone
+* Student Number:   041023578
+* Course:           CST8333_350: Programming Language Research Project
+* Professor:        Reg Dyer
+* Date:             05/06/2023
+*
+* References:
+* [1]   T. B. of C. Secretariat and T. B. S. of C. Open Government, Open Government Licence - Canada. http://open.canada.ca/en/open-government-licence-canada (accessed May 11, 2023).
+* [2]	T. B. of C. Secretariat and Open Government Portal, Vegetables in cold and common storage, Oct. 10, 2008. https://open.canada.ca/data/en/dataset/473f9524-45f8-47d0-9a12-537bb7704089 (accessed May 16, 2023).
+* [3]	S. Pieda, CST8333 19F Practical Project 2 Example Layered. Algonquin College, Algonquin College, Jun. 07, 2022. [Online]. Available: https://brightspace.algonquincollege.com/d2l/le/content/543581/viewContent/8322468/View
+*/
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "doctest.h"
+
+#ifndef QUANTILE_SKETCH_H
+#define QUANTILE_SKETCH_H
+
+/**
+ * @brief Estimates percentiles, such as the 95th percentile of VALUE, while keeping only a few hundred of the numbers added to it.
+ * This is a KLL sketch: the numbers are kept in levels, where a number on level h stands for 2^h of the original numbers. When
+ * a level fills up it is sorted and every other number moves up a level, alternating between the odd and even positions.
+ * Lower levels get smaller capacities, so most numbers kept are on the top levels. The estimated rank of a number is off by
+ * about 1% of the count with the default accuracy. Until the first level fills up every number is kept, and estimates are exact.
+ *
+ * Sketches built from different numbers, such as on separate threads, are combined with merge(). A number cannot be taken out again.
+*/
+class QuantileSketch
+{
+public:
+	/** @brief The capacity of the top level, which sets the sketch's accuracy and size */
+	static constexpr std::size_t DEFAULT_ACCURACY = 200;
+
+	/**
+	 * @brief Creates a sketch that has seen no numbers
+	 * @param accuracy the capacity of the top level. The sketch keeps about three times as many numbers.
+	*/
+	explicit QuantileSketch(std::size_t accuracy = DEFAULT_ACCURACY);
+
+	/**
+	 * @brief Adds a number
+	 * @param value the number
+	*/
+	void add(double value);
+
+	/**
+	 * @brief Adds every number another sketch has seen
+	 * @param other the other sketch
+	*/
+	void merge(const QuantileSketch &other);
+
+	/**
+	 * @brief Estimates a percentile, using the nearest-rank definition: the smallest number at least a given fraction of the numbers
+	 * are less than or equal to
+	 * @param fraction the percentile as a fraction, such as 0.95 for the 95th
+	 * @return the estimated percentile, or NaN if no numbers were added
+	 * @throws std::invalid_argument if the fraction is not between 0 and 1
+	*/
+	double quantile(double fraction) const;
+
+	/** @return the number of numbers added */
+	std::uint64_t count() const { return totalCount; }
+
+	/** @return the number of numbers the sketch keeps */
+	std::size_t retainedCount() const;
+
+	/**
+	 * @brief Finds the nearest-rank percentile of numbers exactly, for comparison with quantile()
+	 * @param values the numbers. They are reordered.
+	 * @param fraction the percentile as a fraction, such as 0.95 for the 95th
+	 * @return the percentile, or NaN if there are no numbers
+	 * @throws std::invalid_argument if the fraction is not between 0 and 1
+	*/
+	static double exactQuantile(std::vector<double> &values, double fraction);
+
+private:
+	std::size_t accuracy;
+	std::uint64_t totalCount{ 0 };
+	/** @brief levels[h] holds the kept numbers that each stand for 2^h numbers */
+	std::vector<std::vector<double>> levels{ std::vector<double>{} };
+	/** @brief whether the next compaction keeps the numbers at odd positions */
+	bool isOddCompaction{ false };
+
+	/** @return the number of numbers a level holds before it is compacted */
+	std::size_t levelCapacity(std::size_t level) const;
+
+	/** @brief Compacts every full level, from the bottom up, until none is full */
+	void compress();
+
+	/**
+	 * @brief Sorts a level and moves every other number up a level. With an odd count, the largest number stays.
+	 * @param level the level to compact
+	*/
+	void compactLevel(std::size_t level);
+};
+#endif // !QUANTILE_SKETCH_H
@@ -0,0 +1,343 @@
+/**
+* @file				RecordAggregator.cpp
+* @author			Chloe Lee-Hone<leeh0002@algonquinlive.com>
+* @version			1.0
+* @section			This file contains the RecordAggregator class used by RecordService to total record values by group.
+*					This project contains information licensed under the Open Government Licence  Canada [1][2]. Code structure was informed by the provided example written by Stanley Pieda for CST8333 [3].
+*
+* Student Name:     Chloe Lee-Hone
+* Student Number:   041023578
+* Course:           CST8333_350: Programming Language Research Project
+* Professor:        Reg Dyer
+* Date:             05/06/2023
+*
+* References:
+* [1]   T. B. of C. Secretariat and T. B. S. of C. Open Government, Open Government Licence - Canada. http://open.canada.ca/en/open-government-licence-canada (accessed May 11, 2023).
+* [2]	T. B. of C. Secretariat and Open Government Portal, Vegetables in cold and common storage, Oct. 10, 2008. https://open.canada.ca/data/en/dataset/473f9524-45f8-47d0-9a12-537bb7704089 (accessed May 16, 2023).
+* [3]	S. Pieda, CST8333 19F Practical Project 2 Example Layered. Algonquin College, Algonquin College, Jun. 07, 2022. [Online]. Available: https://brightspace.algonquincollege.com/d2l/le/content/543581/viewContent/8322468/View
+*/
+
+#include "RecordAggregator.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include "ParallelRange.h"
+#include "doctest.h"
+
+/** @brief The running summary of one aggregate in one group */
+struct AggregateState {
+	double sum{ 0 };
+	double min{ std::numeric_limits<double>::infinity() };
+	double max{ -std::numeric_limits<double>::infinity() };
+	/** @brief the number of values that were numbers */
+	std::uint64_t numberCount{ 0 };
+	/** @brief the number of non-empty values */
+	std::uint64_t count{ 0 };
+	std::unordered_set<std::string> distinctValues{};
+};
+
+/** @brief A group's key values and the running summary of each aggregate */
+struct GroupState {
+	std::vector<std::string> keys{};
+	std::vector<AggregateState> states{};
+};
+
+/** @brief One thread's groups. Each group is found by its encoded key, so a row costs one hash lookup. */
+struct GroupTable {
+	std::unordered_map<std::string, std::size_t> positions{};
+	std::vector<GroupState> groups{};
+};
+
+/**
+ * @brief Reads the part of a record's column that a key groups by
+ * @param record the record
+ * @param key the group key
+ * @return the whole value, or its first prefixLength characters
+*/
+std::string_view RecordAggregator::groupValue(const RecordDTO &record, const GroupKey &key) {
+	std::string_view value = record.get(key.column);
+	return key.prefixLength == 0 ? value : value.substr(0, key.prefixLength);
+}
+
+/**
+ * @brief Encodes a record's group keys as one hash key. A whole dictionary column is encoded as its 4-byte code, which is
+ * the same in every thread; any other key is encoded as its text followed by a zero byte.
+ * @param encoded the string to append the key to
+ * @param record the record
+ * @param keys the group keys
+*/
+void RecordAggregator::appendGroupKey(std::string &encoded, const RecordDTO &record, const std::vector<GroupKey> &keys) {
+	for (const GroupKey &key : keys) {
+		if (key.prefixLength == 0 && columnInfo(key.column).storage == ColumnStorage::Dictionary) {
+			std::uint32_t code = record.code(key.column);
+			char bytes[sizeof(code)];
+			std::memcpy(bytes, &code, sizeof(code));
+			encoded.append(bytes, sizeof(code));
+		}
+		else {
+			encoded += groupValue(record, key);
+			encoded += '\0';
+		}
+	}
+}
+
+/**
+ * @brief Adds a record's value to one aggregate's running summary
+*/
+static void accumulate(AggregateState &state, const Aggregate &aggregate, const RecordDTO &record) {
+	std::string_view value = record.get(aggregate.column);
+
+	if (aggregate.function == AggregateFunction::Count) {
+		state.count += value.empty() ? 0 : 1;
+	}
+	else if (aggregate.function == AggregateFunction::CountDistinct) {
+		if (!value.empty()) state.distinctValues.emplace(value);
+	}
+	else {
+		double number = readNumericValue(value);
+		if (!std::isnan(number)) {
+			state.sum += number;
+			state.min = std::min(state.min, number);
+			state.max = std::max(state.max, number);
+			state.numberCount++;
+		}
+	}
+}
+
+/**
+ * @brief Adds one thread's running summary of a group to another's
+*/
+static void mergeState(AggregateState &state, AggregateState &other) {
+	state.sum += other.sum;
+	state.min = std::min(state.min, other.min);
+	state.max = std::max(state.max, other.max);
+	state.numberCount += other.numberCount;
+	state.count += other.count;
+	if (state.distinctValues.size() < other.distinctValues.size()) {
+		std::swap(state.distinctValues, other.distinctValues);
+	}
+	state.distinctValues.insert(other.distinctValues.begin(), other.distinctValues.end());
+}
+
+/**
+ * @brief Turns a running summary into the aggregate's result
+ * @return the result, or NaN where a numeric summary saw no numbers
+*/
+static double finish(const AggregateState &state, AggregateFunction function) {
+	constexpr double NO_VALUE = std::numeric_limits<double>::quiet_NaN();
+	switch (function) {
+	case AggregateFunction::Count:			return static_cast<double>(state.count);
+	case AggregateFunction::CountDistinct:	return static_cast<double>(state.distinctValues.size());
+	case AggregateFunction::Sum:			return state.numberCount == 0 ? NO_VALUE : state.sum;
+	case AggregateFunction::Min:			return state.numberCount == 0 ? NO_VALUE : state.min;
+	case AggregateFunction::Max:			return state.numberCount == 0 ? NO_VALUE : state.max;
+	default:								return state.numberCount == 0 ? NO_VALUE : state.sum / state.numberCount;
+	}
+}
+
+/**
+ * @brief Groups rowCount rows, where rowAt(i) gives the i-th row to group. Each chunk fills its own GroupTable on its own
+ * thread; the tables are then merged into the first one.
+*/
+template <typename RowAt>
+static GroupByResult groupRows(const std::vector<RecordDTO> &recordList, std::size_t rowCount, const RowAt &rowAt,
+	const std::vector<GroupKey> &keys, const std::vector<Aggregate> &aggregates) {
+	std::vector<GroupTable> tables(parallelChunkCount(rowCount));
+
+	forEachChunk(rowCount, [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+		GroupTable &table = tables[chunk];
+		std::string encoded{};
+
+		for (std::size_t i = begin; i < end; i++) {
+			const RecordDTO &record = recordList[rowAt(i)];
+			encoded.clear();
+			RecordAggregator::appendGroupKey(encoded, record, keys);
+
+			auto [position, isNew] = table.positions.try_emplace(encoded, table.groups.size());
+			if (isNew) {
+				GroupState group{};
+				for (const GroupKey &key : keys) {
+					group.keys.emplace_back(RecordAggregator::groupValue(record, key));
+				}
+				group.states.resize(aggregates.size());
+				table.groups.push_back(std::move(group));
+			}
+
+			GroupState &group = table.groups[position->second];
+			for (std::size_t a = 0; a < aggregates.size(); a++) {
+				accumulate(group.states[a], aggregates[a], record);
+			}
+		}
+	});
+
+	GroupTable &merged = tables.front();
+	for (std::size_t chunk = 1; chunk < tables.size(); chunk++) {
+		for (auto &[encoded, chunkPosition] : tables[chunk].positions) {
+			GroupState &chunkGroup = tables[chunk].groups[chunkPosition];
+			auto [position, isNew] = merged.positions.try_emplace(encoded, merged.groups.size());
+			if (isNew) {
+				merged.groups.push_back(std::move(chunkGroup));
+				continue;
+			}
+			GroupState &group = merged.groups[position->second];
+			for (std::size_t a = 0; a < aggregates.size(); a++) {
+				mergeState(group.states[a], chunkGroup.states[a]);
+			}
+		}
+	}
+
+	GroupByResult result{ keys, aggregates, {} };
+	result.groups.reserve(merged.groups.size());
+	for (GroupState &group : merged.groups) {
+		GroupRow row{ std::move(group.keys), {} };
+		for (std::size_t a = 0; a < aggregates.size(); a++) {
+			row.values.push_back(finish(group.states[a], aggregates[a].function));
+		}
+		result.groups.push_back(std::move(row));
+	}
+	std::sort(result.groups.begin(), result.groups.end(), [](const GroupRow &first, const GroupRow &second) {
+		return first.keys < second.keys;
+	});
+	return result;
+}
+
+/**
+ * @brief Groups every record
+ * @param recordList the records
+ * @param keys the columns to group by. With no keys, every record is in one group.
+ * @param aggregates the summaries to compute for each group
+ * @return one row per group, in ascending key order
+*/
+GroupByResult RecordAggregator::groupBy(const std::vector<RecordDTO> &recordList, const std::vector<GroupKey> &keys, const std::vector<Aggregate> &aggregates) {
+	return groupRows(recordList, recordList.size(), [](std::size_t i) { return i; }, keys, aggregates);
+}
+
+/**
+ * @brief Groups the selected records, such as the rows a RecordFilter matched
+ * @param recordList the records
+ * @param rows the rows to group
+ * @param keys the columns to group by. With no keys, every selected record is in one group.
+ * @param aggregates the summaries to compute for each group
+ * @return one row per group, in ascending key order
+*/
+GroupByResult RecordAggregator::groupBy(const std::vector<RecordDTO> &recordList, const std::vector<RowId> &rows, const std::vector<GroupKey> &keys, const std::vector<Aggregate> &aggregates) {
+	return groupRows(recordList, rows.size(), [&rows](std::size_t i) { return rows[i]; }, keys, aggregates);
+}
+
+/**
+ * @brief Writes a summary value as table text
+ * @param value the value
+ * @return the value with up to 15 significant digits, or an empty string for NaN
+*/
+std::string formatAggregateValue(double value) {
+	std::ostringstream text{};
+	if (!std::isnan(value)) {
+		text.precision(15);
+		text << value;
+	}
+	return text.str();
+}
+
+/**
+ * @brief Names the result's columns, such as GEO or SUM(VALUE)
+ * @return one name per key, then one per aggregate
+*/
+std::vector<std::string> GroupByResult::headers() const {
+	static const char *FUNCTION_NAMES[] = { "SUM", "COUNT", "MIN", "MAX", "AVG", "COUNT_DISTINCT" };
+	std::vector<std::string> names{};
+
+	for (const GroupKey &key : keys) {
+		std::string name{ columnInfo(key.column).header };
+		if (key.prefixLength != 0) {
+			name += " (first " + std::to_string(key.prefixLength) + ")";
+		}
+		names.push_back(std::move(name));
+	}
+	for (const Aggregate &aggregate : aggregates) {
+		names.push_back(std::string{ FUNCTION_NAMES[static_cast<int>(aggregate.function)] } + "(" + columnInfo(aggregate.column).header + ")");
+	}
+	return names;
+}
+
+/**
+ * @brief Lays the result out as text for display or export. Summaries with no value are left blank.
+ * @return the headers, then one row of cells per group
+*/
+std::vector<std::vector<std::string>> GroupByResult::toTable() const {
+	std::vector<std::vector<std::string>> table{ headers() };
+
+	for (const GroupRow &group : groups) {
+		std::vector<std::string> cells = group.keys;
+		for (double value : group.values) {
+			cells.push_back(formatAggregateValue(value));
+		}
+		table.push_back(std::move(cells));
+	}
+	return table;
+}
+
+TEST_CASE("Test that a parallel group-by matches totals computed row by row") {
+	const char *provinces[] = { "Quebec", "Ontario", "Manitoba" };
+	std::vector<RecordDTO> recordList(60000);
+	for (std::size_t row = 0; row < recordList.size(); row++) {
+		recordList[row].setGeo(provinces[row % 3]);
+		recordList[row].setRefDate(std::to_string(1970 + row % 5) + "-0" + std::to_string(1 + row % 7));
+		recordList[row].setVector("v" + std::to_string(row % 11));
+		if (row % 4 != 0) recordList[row].setValue(std::to_string(row % 100));
+	}
+
+	std::vector<GroupKey> keys{ { RecordColumn::Geo }, { RecordColumn::RefDate, GroupKey::YEAR_LENGTH } };
+	std::vector<Aggregate> aggregates{ { AggregateFunction::Sum }, { AggregateFunction::Count }, { AggregateFunction::Min },
+		{ AggregateFunction::Max }, { AggregateFunction::Average }, { AggregateFunction::CountDistinct, RecordColumn::Vector } };
+	GroupByResult result = RecordAggregator::groupBy(recordList, keys, aggregates);
+
+	REQUIRE(result.groups.size() == 15);
+	CHECK(result.groups.front().keys == std::vector<std::string>{ "Manitoba", "1970" });
+
+	/* Recompute one group the slow way */
+	double sum{ 0 }, count{ 0 }, min{ 1000 }, max{ -1 };
+	for (std::size_t row = 0; row < recordList.size(); row++) {
+		if (row % 3 == 1 && row % 5 == 2 && row % 4 != 0) {
+			double value = static_cast<double>(row % 100);
+			sum += value;
+			count++;
+			min = std::min(min, value);
+			max = std::max(max, value);
+		}
+	}
+	const GroupRow &ontario1972 = *std::find_if(result.groups.begin(), result.groups.end(), [](const GroupRow &group) {
+		return group.keys == std::vector<std::string>{ "Ontario", "1972" };
+	});
+	CHECK(ontario1972.values[0] == sum);
+	CHECK(ontario1972.values[1] == count);
+	CHECK(ontario1972.values[2] == min);
+	CHECK(ontario1972.values[3] == max);
+	CHECK(ontario1972.values[4] == doctest::Approx(sum / count));
+	CHECK(ontario1972.values[5] == 11);
+}
+
+TEST_CASE("Test that group-by results lay out as a table") {
+	std::vector<RecordDTO> recordList(3);
+	recordList[0].setGeo("Canada");
+	recordList[0].setValue("10");
+	recordList[1].setGeo("Canada");
+	recordList[1].setValue("2.5");
+	recordList[2].setGeo("Yukon");
+
+	/* Only rows 0 and 2 are selected, and Yukon has no numbers to average */
+	GroupByResult result = RecordAggregator::groupBy(recordList, std::vector<RecordAggregator::RowId>{ 0, 2 }, { { RecordColumn::Geo } },
+		{ { AggregateFunction::Average }, { AggregateFunction::Count } });
+	std::vector<std::vector<std::string>> table = result.toTable();
+
+	REQUIRE(table.size() == 3);
+	CHECK(table[0] == std::vector<std::string>{ "GEO", "AVG(VALUE)", "COUNT(VALUE)" });
+	CHECK(table[1] == std::vector<std::string>{ "Canada", "10", "1" });
+	CHECK(table[2] == std::vector<std::string>{ "Yukon", "", "0" });
+}
@@ -0,0 +1,145 @@
+/**
+* @file				RecordAggregator.h
+* @author			Chloe Lee-Hone<leeh0002@algonquinlive.com>
+* @version			1.0
+* @section			Header file for the RecordAggregator class, which totals record values by group.
+*					This project contains information licensed under the Open Government Licence  Canada [1][2]. Code structure was informed by the provided example written by Stanley Pieda for CST8333 [3].
+*
+* Student Name:     Chloe Lee-Hone
+* Student Number:   041023578
+* Course:           CST8333_350: Programming Language Research Project
+* Professor:        Reg Dyer
+* Date:             05/06/2023
+*
+* References:
+* [1]   T. B. of C. Secretariat and T. B. S. of C. Open Government, Open Government Licence - Canada. http://open.canada.ca/en/open-government-licence-canada (accessed May 11, 2023).
+* [2]	T. B. of C. Secretariat and Open Government Portal, Vegetables in cold and common storage, Oct. 10, 2008. https://open.canada.ca/data/en/dataset/473f9524-45f8-47d0-9a12-537bb7704089 (accessed May 16, 2023).
+* [3]	S. Pieda, CST8333 19F Practical Project 2 Example Layered. Algonquin College, Algonquin College, Jun. 07, 2022. [Online]. Available: https://brightspace.algonquincollege.com/d2l/le/content/543581/viewContent/8322468/View
+*/
+
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "RecordColumn.h"
+#include "RecordDTO.h"
+#include "RecordIndex.h"
+#include "doctest.h"
+
+#ifndef RECORD_AGGREGATOR_H
+#define RECORD_AGGREGATOR_H
+
+/** @brief The summaries a group-by can compute over a column */
+enum class AggregateFunction { Sum, Count, Min, Max, Average, CountDistinct };
+
+/**
+ * @brief One column to group by. A prefix length groups by the start of the value instead, so { RefDate, YEAR_LENGTH } groups by year.
+*/
+struct GroupKey {
+	/** @brief The length of the year at the start of a REF_DATE */
+	static constexpr std::size_t YEAR_LENGTH = 4;
+
+	/** @brief the column to group by */
+	RecordColumn column;
+	/** @brief the number of leading characters to group by, or 0 for the whole value */
+	std::size_t prefixLength{ 0 };
+};
+
+inline bool operator==(const GroupKey &first, const GroupKey &second) {
+	return first.column == second.column && first.prefixLength == second.prefixLength;
+}
+
+/**
+ * @brief One summary to compute for each group. Sum, Min, Max and Average read the column as a number and skip values that are
+ * empty or not numbers. Count counts the non-empty values and CountDistinct the different non-empty values.
+*/
+struct Aggregate {
+	/** @brief the summary to compute */
+	AggregateFunction function;
+	/** @brief the column to summarize */
+	RecordColumn column{ RecordColumn::Value };
+};
+
+inline bool operator==(const Aggregate &first, const Aggregate &second) {
+	return first.function == second.function && first.column == second.column;
+}
+
+/** @brief One group of a group-by: its key values and its summaries, in the order they were asked for */
+struct GroupRow {
+	std::vector<std::string> keys{};
+	/** @brief NaN where a Min, Max or Average had no numbers to summarize */
+	std::vector<double> values{};
+};
+
+/** @brief The result of a group-by, with one row per group in ascending key order */
+struct GroupByResult {
+	std::vector<GroupKey> keys{};
+	std::vector<Aggregate> aggregates{};
+	std::vector<GroupRow> groups{};
+
+	/**
+	 * @brief Names the result's columns, such as GEO or SUM(VALUE)
+	 * @return one name per key, then one per aggregate
+	*/
+	std::vector<std::string> headers() const;
+
+	/**
+	 * @brief Lays the result out as text for display or export
+	 * @return the headers, then one row of cells per group
+	*/
+	std::vector<std::vector<std::string>> toTable() const;
+};
+
+/**
+ * @brief Writes a summary value as table text
+ * @param value the value
+ * @return the value with up to 15 significant digits, or an empty string for NaN
+*/
+std::string formatAggregateValue(double value);
+
+/**
+ * @brief Computes group-by summaries over the records. Each thread aggregates its own chunk of rows into its own hash table,
+ * with no locking, and the tables are merged once every thread is done.
+*/
+class RecordAggregator
+{
+public:
+	using RowId = RecordIndex::RowId;
+
+	/**
+	 * @brief Groups every record
+	 * @param recordList the records
+	 * @param keys the columns to group by. With no keys, every record is in one group.
+	 * @param aggregates the summaries to compute for each group
+	 * @return one row per group, in ascending key order
+	*/
+	static GroupByResult groupBy(const std::vector<RecordDTO> &recordList, const std::vector<GroupKey> &keys, const std::vector<Aggregate> &aggregates);
+
+	/**
+	 * @brief Groups the selected records, such as the rows a RecordFilter matched
+	 * @param recordList the records
+	 * @param rows the rows to group
+	 * @param keys the columns to group by. With no keys, every selected record is in one group.
+	 * @param aggregates the summaries to compute for each group
+	 * @return one row per group, in ascending key order
+	*/
+	static GroupByResult groupBy(const std::vector<RecordDTO> &recordList, const std::vector<RowId> &rows, const std::vector<GroupKey> &keys, const std::vector<Aggregate> &aggregates);
+
+	/**
+	 * @brief Reads the part of a record's column that a key groups by
+	 * @param record the record
+	 * @param key the group key
+	 * @return the whole value, or its first prefixLength characters
+	*/
+	static std::string_view groupValue(const RecordDTO &record, const GroupKey &key);
+
+	/**
+	 * @brief Encodes a record's group keys as one hash key, equal for two records exactly when their keys are
+	 * @param encoded the string to append the key to
+	 * @param record the record
+	 * @param keys the group keys
+	*/
+	static void appendGroupKey(std::string &encoded, const RecordDTO &record, const std::vector<GroupKey> &keys);
+};
+#endif // !RECORD_AGGREGATOR_H
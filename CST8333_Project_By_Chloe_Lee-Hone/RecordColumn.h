@@ -0,0 +1,183 @@
+/**
+* @file				RecordColumn.h
+* @author			Chloe Lee-Hone<leeh0002@algonquinlive.com>
+* @version			1.0
+* @section			Header-only description of the data set's 16 columns. The RecordDTO, the RecordDAO's parser and serializer and the console's prompts are all driven by this table.
+*					This project contains information licensed under the Open Government Licence  Canada [1][2]. Code structure was informed by the provided example written by Stanley Pieda for CST8333 [3].
+*
+* Student Name:     Chloe Lee-Hone
+* Student Number:   041023578
+* Course:           CST8333_350: Programming Language Research Project
+* Professor:        Reg Dyer
+* Date:             05/06/2023
+*
+* References:
+* [1]   T. B. of C. Secretariat and T. B. S. of C. Open Government, Open Government Licence - Canada. http://open.canada.ca/en/open-government-licence-canada (accessed May 11, 2023).
+* [2]	T. B. of C. Secretariat and Open Government Portal, Vegetables in cold and common storage, Oct. 10, 2008. https://open.canada.ca/data/en/dataset/473f9524-45f8-47d0-9a12-537bb7704089 (accessed May 16, 2023).
+* [3]	S. Pieda, CST8333 19F Practical Project 2 Example Layered. Algonquin College, Algonquin College, Jun. 07, 2022. [Online]. Available: https://brightspace.algonquincollege.com/d2l/le/content/543581/viewContent/8322468/View
+*/
+
+#pragma once
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <limits>
+#include <string_view>
+#include <type_traits>
+
+#ifndef RECORD_COLUMN_H
+#define RECORD_COLUMN_H
+
+/**
+ * @brief Identifies one of the data set's columns. The enumerators are in the same order as the columns in the CSV file.
+*/
+enum class RecordColumn : int {
+	RefDate,
+	Geo,
+	Dguid,
+	ProductType,
+	StorageType,
+	Uom,
+	UomId,
+	ScalarFactor,
+	ScalarId,
+	Vector,
+	Coordinate,
+	Value,
+	Status,
+	Symbol,
+	Terminated,
+	Decimals
+};
+
+/**
+ * @brief How RecordDTO stores a column. Chosen from the shape of the data in 32100260.csv.
+*/
+enum class ColumnStorage {
+	/** Short codes (dates, values, ids), kept in a fixed-width buffer inside the record */
+	Inline,
+	/** Low-cardinality text, kept as a code into a StringDictionary shared by all records */
+	Dictionary,
+	/** Columns that are empty on almost every row, kept in a side allocation that most records never make */
+	Cold
+};
+
+/**
+ * @brief Describes how one column is named in the CSV file and in the console, and how it is stored.
+*/
+struct ColumnInfo {
+	/** @brief the column this entry describes */
+	RecordColumn column;
+	/** @brief the column's header in the original CSV file */
+	const char *header;
+	/** @brief the name shown to the user in menus and prompts */
+	const char *label;
+	/** @brief the padded label used by RecordDTO::printRecord() */
+	const char *printLabel;
+	/** @brief how RecordDTO stores the column */
+	ColumnStorage storage;
+	/** @brief true if the column holds numbers, which sort and compare by value rather than as text */
+	bool isNumeric;
+};
+
+/** @brief The number of columns in the data set */
+inline constexpr std::size_t RECORD_COLUMN_COUNT = 16;
+
+/** @brief The data set's columns, in file order. Index i describes the column with the value static_cast<RecordColumn>(i). */
+inline constexpr std::array<ColumnInfo, RECORD_COLUMN_COUNT> RECORD_COLUMNS{ {
+	{ RecordColumn::RefDate,		"REF_DATE",			"Ref Date",					"RefDate:\t\t",					ColumnStorage::Inline,		false },
+	{ RecordColumn::Geo,			"GEO",				"Geo",						"Geo:\t\t\t",					ColumnStorage::Dictionary,	false },
+	{ RecordColumn::Dguid,			"DGUID",			"DGUID",					"DGUID:\t\t\t",					ColumnStorage::Cold,		false },
+	{ RecordColumn::ProductType,	"Type of product",	"Product Type",				"Product Type:\t\t",			ColumnStorage::Dictionary,	false },
+	{ RecordColumn::StorageType,	"Type of storage",	"Storage Type",				"Storage Type:\t\t",			ColumnStorage::Dictionary,	false },
+	{ RecordColumn::Uom,			"UOM",				"Unit of Measurement",		"Unit of Measurement:\t",		ColumnStorage::Dictionary,	false },
+	{ RecordColumn::UomId,			"UOM_ID",			"Unit of Measurement ID",	"Unit of Measurement ID: ",		ColumnStorage::Inline,		true },
+	{ RecordColumn::ScalarFactor,	"SCALAR_FACTOR",	"Scalar Factor",			"Scalar Factor:\t\t",			ColumnStorage::Dictionary,	false },
+	{ RecordColumn::ScalarId,		"SCALAR_ID",		"Scalar Factor ID",			"Scalar ID:\t\t",				ColumnStorage::Inline,		true },
+	{ RecordColumn::Vector,			"VECTOR",			"Vector",					"Vector:\t\t\t",				ColumnStorage::Inline,		false },
+	{ RecordColumn::Coordinate,		"COORDINATE",		"Coordinate",				"Coordinate:\t\t",				ColumnStorage::Inline,		false },
+	{ RecordColumn::Value,			"VALUE",			"Value",					"Value:\t\t\t",					ColumnStorage::Inline,		true },
+	{ RecordColumn::Status,			"STATUS",			"Status",					"Status:\t\t\t",				ColumnStorage::Cold,		false },
+	{ RecordColumn::Symbol,			"SYMBOL",			"Symbol",					"Symbol:\t\t\t",				ColumnStorage::Cold,		false },
+	{ RecordColumn::Terminated,		"TERMINATED",		"Terminated",				"Terminated:\t\t",				ColumnStorage::Cold,		false },
+	{ RecordColumn::Decimals,		"DECIMALS",			"Decimals",					"Decimals:\t\t",				ColumnStorage::Inline,		true }
+} };
+
+/** @brief Separates the cells of a key built from several columns. The unit separator control character never appears in the CSV data. */
+inline constexpr char KEY_SEPARATOR = '\x1f';
+
+/**
+ * @brief Converts a column to its position in the CSV file
+ * @param column the column
+ * @return the column's zero-based position
+*/
+constexpr std::size_t columnIndex(RecordColumn column) {
+	return static_cast<std::size_t>(column);
+}
+
+/**
+ * @brief Looks up a column's description
+ * @param column the column
+ * @return the column's entry in RECORD_COLUMNS
+*/
+constexpr const ColumnInfo &columnInfo(RecordColumn column) {
+	return RECORD_COLUMNS[columnIndex(column)];
+}
+
+/**
+ * @brief Reads a numeric column's value as a number
+ * @param value the whole text of the value
+ * @return the number, or NaN if the value is empty or not a number. NaN fails every comparison, so such values drop out of ranges and totals.
+*/
+inline double readNumericValue(std::string_view value) {
+	double number{ 0 };
+	std::from_chars_result result = std::from_chars(value.data(), value.data() + value.size(), number);
+	if (value.empty() || result.ec != std::errc{} || result.ptr != value.data() + value.size()) {
+		return std::numeric_limits<double>::quiet_NaN();
+	}
+	return number;
+}
+
+/** @brief A column known at compile time. Passed to the visitor given to visitColumn(). */
+template <RecordColumn Column>
+using ColumnConstant = std::integral_constant<RecordColumn, Column>;
+
+/**
+ * @brief Turns a column chosen at run time into a compile-time constant, so the visitor is instantiated once per column
+ * and can use column-specific code such as RecordDTO::get<Column>() without a switch in its inner loop.
+ * @param column the column chosen at run time
+ * @param visitor a generic callable taking a ColumnConstant
+ * @return whatever the visitor returns
+*/
+template <typename Visitor>
+constexpr decltype(auto) visitColumn(RecordColumn column, Visitor &&visitor) {
+	switch (column) {
+	case RecordColumn::RefDate:			return visitor(ColumnConstant<RecordColumn::RefDate>{});
+	case RecordColumn::Geo:				return visitor(ColumnConstant<RecordColumn::Geo>{});
+	case RecordColumn::Dguid:			return visitor(ColumnConstant<RecordColumn::Dguid>{});
+	case RecordColumn::ProductType:		return visitor(ColumnConstant<RecordColumn::ProductType>{});
+	case RecordColumn::StorageType:		return visitor(ColumnConstant<RecordColumn::StorageType>{});
+	case RecordColumn::Uom:				return visitor(ColumnConstant<RecordColumn::Uom>{});
+	case RecordColumn::UomId:			return visitor(ColumnConstant<RecordColumn::UomId>{});
+	case RecordColumn::ScalarFactor:	return visitor(ColumnConstant<RecordColumn::ScalarFactor>{});
+	case RecordColumn::ScalarId:		return visitor(ColumnConstant<RecordColumn::ScalarId>{});
+	case RecordColumn::Vector:			return visitor(ColumnConstant<RecordColumn::Vector>{});
+	case RecordColumn::Coordinate:		return visitor(ColumnConstant<RecordColumn::Coordinate>{});
+	case RecordColumn::Value:			return visitor(ColumnConstant<RecordColumn::Value>{});
+	case RecordColumn::Status:			return visitor(ColumnConstant<RecordColumn::Status>{});
+	case RecordColumn::Symbol:			return visitor(ColumnConstant<RecordColumn::Symbol>{});
+	case RecordColumn::Terminated:		return visitor(ColumnConstant<RecordColumn::Terminated>{});
+	default:							return visitor(ColumnConstant<RecordColumn::Decimals>{});
+	}
+}
+
+/** Checks at compile time that every entry sits at the index of the column it describes */
+constexpr bool isColumnTableOrdered() {
+	for (std::size_t i = 0; i < RECORD_COLUMNS.size(); i++) {
+		if (columnIndex(RECORD_COLUMNS[i].column) != i) return false;
+	}
+	return true;
+}
+static_assert(isColumnTableOrdered(), "RECORD_COLUMNS must list the columns in RecordColumn order");
+
+#endif // !RECORD_COLUMN_H
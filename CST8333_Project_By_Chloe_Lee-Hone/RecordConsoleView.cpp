@@ -21,8 +21,14 @@
 #include "doctest.h"
 #include <thread>
 #include <iostream>
+#include <algorithm>
 #include <fstream>
+#include <functional>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
 #include <type_traits>
+#include <utility>
 
 const std::string INVALID_INPUT = "Invalid option was selected. Returning to main menu.\n";
 
@@ -53,7 +59,14 @@ void RecordConsoleView::showMenu() {
 */
 void RecordConsoleView::printMainMenuOptions() {
 	std::cout << "\nStudent Name: Chloe Lee-Hone" << std::endl;
-	std::cout << "Please select one of the following options by typing its corresponding number:\n1. Display record(s)\n2. Create a new record\n3. Edit a record\n4. Delete a record\n5. Save changes to file\n6. Reload all records\n7. Sort records by date and province\n8. Exit program" << std::endl << std::flush;
+	if (!RecordConsoleView::recordService.isLoaded()) {
+		LoadProgress progress = RecordConsoleView::recordService.loadProgress();
+		std::cout << "Records are loading in the background (" << progress.recordCount << " read so far). Options that need every record will wait for them." << std::endl;
+	}
+	else if (!RecordConsoleView::recordService.getLoadError().empty()) {
+		std::cout << "The records could not be loaded. " << RecordConsoleView::recordService.getLoadError() << " Choose " << RELOAD_RECORDS << " to try again." << std::endl;
+	}
+	std::cout << "Please select one of the following options by typing its corresponding number:\n1. Display record(s)\n2. Create a new record\n3. Edit a record\n4. Delete a record\n5. Save changes to file\n6. Reload all records\n7. Sort records by date and province\n8. Summarize values by group\n9. Build a pivot table\n10. Undo the last change\n11. Redo the last undone change\n12. Find duplicate records\n13. Merge revisions from a CSV file\n14. Join with another table\n15. Search records by text\n16. Estimate statistics\n17. Exit program" << std::endl << std::flush;
 }
 
 /**
@@ -83,6 +96,33 @@ void RecordConsoleView::processMainResponse(int userResponse) {
 	case RecordConsoleView::SORT_RECORDS:
 		RecordConsoleView::processSortSelection();
 		break;
+	case RecordConsoleView::SUMMARIZE_RECORDS:
+		RecordConsoleView::printGroupOptions();
+		break;
+	case RecordConsoleView::PIVOT_RECORDS:
+		RecordConsoleView::printPivotOptions();
+		break;
+	case RecordConsoleView::UNDO_CHANGE:
+		RecordConsoleView::undoChange();
+		break;
+	case RecordConsoleView::REDO_CHANGE:
+		RecordConsoleView::redoChange();
+		break;
+	case RecordConsoleView::FIND_DUPLICATES:
+		RecordConsoleView::printDuplicates();
+		break;
+	case RecordConsoleView::MERGE_FILE:
+		RecordConsoleView::printMergeOptions();
+		break;
+	case RecordConsoleView::JOIN_TABLE:
+		RecordConsoleView::printJoinOptions();
+		break;
+	case RecordConsoleView::SEARCH_TEXT:
+		RecordConsoleView::printSearchOptions();
+		break;
+	case RecordConsoleView::ESTIMATE_STATISTICS:
+		RecordConsoleView::printStatisticOptions();
+		break;
 	case RecordConsoleView::EXIT_PROGRAM:
 		RecordConsoleView::isContinue = false;
 		break;
@@ -105,11 +145,11 @@ void RecordConsoleView::printRecords() {
 	if (userResponse == PRINT_ONE_RECORD) {
 		int recordId{};
 		
-		std::cout << "\nPlease enter the record number you would like to view. Must be between 1 and 100:" << std::endl;
+		std::cout << "\nPlease enter the record number you would like to view. Record numbers do not change when other records are deleted:" << std::endl;
 		std::cin >> recordId;
 		std::cin.ignore();
 
-		if (recordId > 100 || recordId < 1) {
+		if (recordId < 1 || !RecordConsoleView::recordService.hasRecord(recordId - 1)) {
 			std::cout << INVALID_INPUT << "\n" << std::endl;
 		}
 		else {
@@ -127,9 +167,8 @@ void RecordConsoleView::printRecords() {
 
 		// Input validation ensures a valid number passed to the for-loop 
 		if (isValidRecord(numberOfRecords)) {
-			std::vector<RecordDTO> topRecords = RecordConsoleView::recordService.getTopRecords(numberOfRecords);
-			for (int i = 0; i < topRecords.size(); i++) {
-				topRecords.at(i).printRecord();
+			for (const RecordDTO &record : RecordConsoleView::recordService.getPage(0, numberOfRecords)) {
+				record.printRecord();
 			}
 		}
 		else {
@@ -137,7 +176,13 @@ void RecordConsoleView::printRecords() {
 		}
 	}
 	else if (userResponse == PRINT_MOST_RECENT) {
-		RecordConsoleView::recordService.getAllRecords().back().printRecord();
+		RecordPage lastPage = RecordConsoleView::recordService.getPage(RecordConsoleView::recordService.recordCount() - 1, 1);
+		if (lastPage.empty()) {
+			std::cout << "There are no records to display.\n" << std::endl;
+		}
+		else {
+			lastPage.back().printRecord();
+		}
 	}
 	else {
 		std::cout << INVALID_INPUT << std::endl;
@@ -154,63 +199,28 @@ void RecordConsoleView::printSortedRecords(std::vector<RecordDTO> sortedRecords,
  * @brief Creates a RecordDTO object based on a user's input. Adds the RecordDTO to the vector stored in memory. 
 */
 void RecordConsoleView::createRecord() {
-	std::string refDate{};
-	std::string geo{};
-	std::string dguid{};
-	std::string productType{};
-	std::string storageType{};
-	std::string uom{};
-	std::string uomId{};
-	std::string scalarFactor{};
-	std::string scalarId{};
-	std::string vector{};
-	std::string coordinate{};
-	std::string value{};
-	std::string status{};
-	std::string symbol{};
-	std::string terminated{};
-	std::string decimals{};
+	RecordDTO newRecord{};
 	
 	std::cout << "To create a record, please enter the answers to the following questions:" << std::endl;
-	std::cout << "Ref Date: ";
-	std::getline (std::cin, refDate);
-	std::cout << "Geo: ";
-	std::getline (std::cin, geo);
-	std::cout << "DGUID: ";
-	std::getline (std::cin, dguid);
-	std::cout << "Product Type: ";
-	std::getline (std::cin, productType);
-	std::cout << "Storage Type: ";
-	std::getline (std::cin, storageType);
-	std::cout << "Unit of Measurement: ";
-	std::getline (std::cin, uom);
-	std::cout << "Unit of Measurement's ID: ";
-	std::getline (std::cin, uomId);
-	std::cout << "Scalar Factor: ";
-	std::getline (std::cin, scalarFactor);
-	std::cout << "Scalar Factor ID: ";
-	std::getline (std::cin, scalarId);
-	std::cout << "Vector: ";
-	std::getline (std::cin, vector);
-	std::cout << "Coordinate: ";
-	std::getline (std::cin, coordinate);
-	std::cout << "Value: ";
-	std::getline (std::cin, value);
-	std::cout << "Status: ";
-	std::getline (std::cin, status);
-	std::cout << "Symbol: ";
-	std::getline (std::cin, symbol);
-	std::cout << "Terminated: ";
-	std::getline (std::cin, terminated);
-	std::cout << "Decimals: ";
-	std::getline (std::cin, decimals);
-
-	RecordConsoleView::recordService.insertRecord(RecordDTO(refDate, geo, dguid, productType, storageType, uom, uomId, scalarFactor, scalarId, vector, coordinate, value, status, symbol, terminated, decimals));
-	std::cout << "\nA new record was successfully created.\n" << std::endl;
+	for (const ColumnInfo &columnInfo : RECORD_COLUMNS) {
+		std::string answer{};
+		std::cout << columnInfo.label << ": ";
+		std::getline (std::cin, answer);
+		newRecord.set(columnInfo.column, std::move(answer));
+	}
+
+	try {
+		RecordConsoleView::recordService.insertRecord(std::move(newRecord));
+		std::cout << "\nA new record was successfully created.\n" << std::endl;
+	}
+	catch (const std::invalid_argument &error) {
+		std::cout << "\nThe record was not created. " << error.what() << "\n" << std::endl;
+	}
 }
 
 /**
- * @brief Updates a specific RecordDTO based on user input. Currently only allows one value to be edited per command. 
+ * @brief Updates a specific RecordDTO based on user input. Every value edited in one command is committed together, so
+ * a single undo reverses all of them.
 */
 void RecordConsoleView::printUpdateOptions() {
 	int recordId{};
@@ -220,19 +230,40 @@ void RecordConsoleView::printUpdateOptions() {
 	std::cin >> recordId;
 	std::cin.ignore();
 
-	if (isValidRecord(recordId)) {
+	if (recordId > 0 && RecordConsoleView::recordService.hasRecord(recordId - 1)) {
 		// The user doesn't know the vector's index starts at 0. If they enter 1, they likely want to access the first record. 
 		// The recordId must be decremented to access the corresponding RecordDTO in the vector. 
 		recordId -= 1;
-		std::cout << "Which value would you like to edit?\n1. Ref Date\n2. Geo\n3. DGUID\n4. Product Type\n5. Storage Type\n6. Unit of Measurement\n7. Unit of Measurement ID\n8. Scalar Factor\n9. Scalar Factor ID\n10. Vector\n11. Coordinate\n12. Vaule\n13. Status\n14. Symbol\n15. Terminated\n16. Decimals" << std::endl;
-		std::cin >> userSelection;
-		std::cin.ignore();
+		RecordTransaction transaction{};
+		int editAnother{ 1 };
+		while (editAnother == 1) {
+			std::cout << "Which value would you like to edit?";
+			for (std::size_t i = 0; i < RECORD_COLUMNS.size(); i++) {
+				std::cout << "\n" << i + 1 << ". " << RECORD_COLUMNS[i].label;
+			}
+			std::cout << std::endl;
+			std::cin >> userSelection;
+			std::cin.ignore();
+
+			if (!isValidSelection(userSelection)) {
+				std::cout << INVALID_INPUT << std::endl;
+				break;
+			}
+			RecordConsoleView::processUpdateSelection(transaction, recordId, userSelection);
 
-		if (isValidSelection(userSelection)) {
-			RecordConsoleView::processUpdateSelection(recordId, userSelection);
+			std::cout << "Would you like to edit another value of this record? Enter 0 for 'No', 1 for 'Yes'" << std::endl;
+			std::cin >> editAnother;
+			std::cin.ignore();
 		}
-		else {
-			std::cout << INVALID_INPUT << std::endl;
+
+		if (!transaction.empty()) {
+			try {
+				RecordConsoleView::recordService.commitTransaction(std::move(transaction));
+				std::cout << "\nThe record was successfully updated.\n" << std::endl;
+			}
+			catch (const std::invalid_argument &error) {
+				std::cout << "\nThe record was not updated. " << error.what() << "\n" << std::endl;
+			}
 		}
 	}
 	else {
@@ -241,98 +272,24 @@ void RecordConsoleView::printUpdateOptions() {
 }
 
 /**
- * @brief Uses an instance of RecordService to process the selected edit on a given record.
- * @param recordId The RecordDTO's index in the vector stored in memory
+ * @brief Asks for the new value of the selected field and stages the edit in a transaction.
+ * @param transaction the transaction the edit is added to
+ * @param recordId The record's id
  * @param userSelection The RecordDTO's instance variable to be edited
 */
-void RecordConsoleView::processUpdateSelection(int recordId, int userSelection) {
+void RecordConsoleView::processUpdateSelection(RecordTransaction &transaction, int recordId, int userSelection) {
 	std::string newValue{};
 
-	switch (userSelection) {
-	case 1:
-		std::cout << "Please enter the new ref date:" << std::endl;
-		std::getline (std::cin, newValue);
-		RecordConsoleView::recordService.getRecord(recordId).setRefDate(newValue);
-		break;
-	case 2:
-		std::cout << "Please enter the new Geo:" << std::endl;
-		std::getline (std::cin, newValue);
-		RecordConsoleView::recordService.getRecord(recordId).setGeo(newValue);
-		break;
-	case 3: 
-		std::cout << "Please enter the new DGUID:" << std::endl;
-		std::getline (std::cin, newValue);
-		RecordConsoleView::recordService.getRecord(recordId).setDguid(newValue);
-		break;
-	case 4:
-		std::cout << "Please enter the new Product Type:" << std::endl;
-		std::getline (std::cin, newValue);
-		RecordConsoleView::recordService.getRecord(recordId).setRefDate(newValue);
-		break;
-	case 5:
-		std::cout << "Please enter the new Storage Type:" << std::endl;
-		std::getline (std::cin, newValue);
-		RecordConsoleView::recordService.getRecord(recordId).setStorageType(newValue);
-		break;
-	case 6:
-		std::cout << "Please enter the new Unit of Measurement:" << std::endl;
-		std::getline (std::cin, newValue);
-		RecordConsoleView::recordService.getRecord(recordId).setUom(newValue);
-		break;
-	case 7:
-		std::cout << "Please enter the new Unit of Measurement ID:" << std::endl;
-		std::getline (std::cin, newValue);
-		RecordConsoleView::recordService.getRecord(recordId).setUomId(newValue);
-		break;
-	case 8:
-		std::cout << "Please enter the new Scalar Factor:" << std::endl;
-		std::getline (std::cin, newValue);
-		RecordConsoleView::recordService.getRecord(recordId).setScalarFactor(newValue);
-		break;
-	case 9:
-		std::cout << "Please enter the new Scalar ID:" << std::endl;
-		std::getline (std::cin, newValue);
-		RecordConsoleView::recordService.getRecord(recordId).setScalarId(newValue);
-		break;
-	case 10:
-		std::cout << "Please enter the new Vector:" << std::endl;
-		std::getline (std::cin, newValue);
-		RecordConsoleView::recordService.getRecord(recordId).setVector(newValue);
-		break;
-	case 11:
-		std::cout << "Please enter the new Coordinate:" << std::endl;
-		std::getline (std::cin, newValue);
-		RecordConsoleView::recordService.getRecord(recordId).setCoordinate(newValue);
-		break;
-	case 12:
-		std::cout << "Please enter the new Value:" << std::endl;
-		std::getline(std::cin, newValue);
-		RecordConsoleView::recordService.getRecord(recordId).setValue(newValue);
-		break;
-	case 13: 
-		std::cout << "Please enter the new Status:" << std::endl;
-		std::getline(std::cin, newValue);
-		RecordConsoleView::recordService.getRecord(recordId).setStatus(newValue);
-		break;
-	case 14:
-		std::cout << "Please enter the new Symbol:" << std::endl;
-		std::getline(std::cin, newValue);
-		RecordConsoleView::recordService.getRecord(recordId).setSymbol(newValue);
-		break;
-	case 15:
-		std::cout << "Please enter the new Terminated:" << std::endl;
-		std::getline(std::cin, newValue);
-		RecordConsoleView::recordService.getRecord(recordId).setTerminated(newValue);
-		break;
-	case 16: 
-		std::cout << "Please enter the new Decimals:" << std::endl;
-		std::getline(std::cin, newValue);
-		RecordConsoleView::recordService.getRecord(recordId).setDecimals(newValue);
-		break;
-	default:
+	if (!isValidSelection(userSelection)) {
 		std::cout << "Invalid option was selected. Returning to menu.\n" << std::endl;
-		break;
-	} 
+		return;
+	}
+
+	// Menu options are numbered from 1 in RECORD_COLUMNS order
+	const ColumnInfo &columnInfo = RECORD_COLUMNS[userSelection - 1];
+	std::cout << "Please enter the new " << columnInfo.label << ":" << std::endl;
+	std::getline(std::cin, newValue);
+	transaction.updateRecord(recordId, columnInfo.column, std::move(newValue));
 }
 
 /**
@@ -342,7 +299,7 @@ void RecordConsoleView::printDeleteOptions() {
 	int recordId{};
 	int userSelection{};
 
-	std::cout << "To delete a record, please enter the ID (1-100) of the record you would like to remove: " << std::endl;
+	std::cout << "To delete a record, please enter the ID of the record you would like to remove: " << std::endl;
 	std::cin >> recordId;
 	// Users will likely start indexing at 1, not 0
 	recordId -= 1;
@@ -364,6 +321,10 @@ void RecordConsoleView::processDeleteSelection(int recordId, int userSelection)
 	case(0):
 		break;
 	case(1):
+		if (recordId < 0 || !RecordConsoleView::recordService.hasRecord(recordId)) {
+			std::cout << INVALID_INPUT << std::endl;
+			break;
+		}
 		RecordConsoleView::deleteRecord(recordId);
 		break;
 	default:
@@ -397,7 +358,9 @@ void RecordConsoleView::printSaveOptions() {
  * @param newFileName The file's name
 */
 void RecordConsoleView::writeToFile(std::string newFileName) {
-	std::thread writeThread(&RecordService::writeToFile, recordService, newFileName);
+	// The thread writes the current snapshot, so records edited while it runs are left out of the file and nothing is copied up front
+	RecordConsoleView::recordService.whenLoaded().get();
+	std::thread writeThread(&RecordService::writeSnapshotToFile, recordService.snapshot(), newFileName);
 	writeThread.detach();
 	std::cout << "\nNew file was successfully written to disk" << std::endl;
 }
@@ -406,8 +369,370 @@ void RecordConsoleView::writeToFile(std::string newFileName) {
  * @brief Uses an instance of the RecordService class to reload the original dataset by communicating with the Persistence layer. 
 */
 void RecordConsoleView::reloadData() {
-	RecordConsoleView::recordService.reloadData();
-	std::cout << "Record data was reloaded\n" << std::endl;
+	bool hadUniqueKey = RecordConsoleView::recordService.hasUniqueKey();
+	if (RecordConsoleView::recordService.reloadData()) {
+		std::cout << "Record data was reloaded\n" << std::endl;
+		if (hadUniqueKey && !RecordConsoleView::recordService.hasUniqueKey()) {
+			std::cout << "The reloaded records share REF_DATE and VECTOR combinations, so duplicates are no longer refused. Choose "
+				<< FIND_DUPLICATES << " to list them.\n" << std::endl;
+		}
+	}
+	else {
+		std::cout << "Record data could not be loaded. " << RecordConsoleView::recordService.getLoadError() << "\n" << std::endl;
+	}
+}
+
+/**
+ * @brief Reverses the latest change to the records, or reports that there is none
+*/
+void RecordConsoleView::undoChange() {
+	if (RecordConsoleView::recordService.undo()) {
+		std::cout << "The last change was undone\n" << std::endl;
+	}
+	else {
+		std::cout << "There is no change to undo\n" << std::endl;
+	}
+}
+
+/**
+ * @brief Applies the latest undone change again, or reports that there is none
+*/
+void RecordConsoleView::redoChange() {
+	if (RecordConsoleView::recordService.redo()) {
+		std::cout << "The last undone change was applied again\n" << std::endl;
+	}
+	else {
+		std::cout << "There is no change to redo\n" << std::endl;
+	}
+}
+
+/**
+ * @brief Reports the records that share a REF_DATE and VECTOR, and offers to refuse such duplicates from now on
+*/
+void RecordConsoleView::printDuplicates() {
+	std::vector<RecordService::DuplicateRecords> duplicates = RecordConsoleView::recordService.findDuplicates();
+	for (const RecordService::DuplicateRecords &duplicate : duplicates) {
+		std::cout << duplicate.key << ":";
+		for (RecordService::RecordId recordId : duplicate.recordIds) {
+			// Record numbers are shown from 1, as in the rest of the menu
+			std::cout << " #" << recordId + 1;
+		}
+		std::cout << "\n";
+	}
+	std::cout << duplicates.size() << " duplicated REF_DATE and VECTOR combinations were found.\n" << std::endl;
+
+	if (!duplicates.empty() || RecordConsoleView::recordService.hasUniqueKey()) {
+		return;
+	}
+	int userSelection{};
+	std::cout << "Would you like new and edited records to be refused when they duplicate one? Enter 0 for 'No', 1 for 'Yes'" << std::endl;
+	std::cin >> userSelection;
+	std::cin.ignore();
+	if (userSelection == 1) {
+		RecordConsoleView::recordService.enableUniqueKey();
+		std::cout << "Duplicates will be refused.\n" << std::endl;
+	}
+}
+
+/**
+ * @brief Prompts the user for a revised CSV file and merges it into the records, keeping local changes the file does not touch
+*/
+void RecordConsoleView::printMergeOptions() {
+	std::string filePath{};
+	std::cout << "Please enter the path of the CSV file containing the revised records, including the file extension: " << std::endl;
+	std::getline(std::cin, filePath);
+
+	try {
+		RecordService::MergeResult result = RecordConsoleView::recordService.mergeFromFile(filePath);
+		std::cout << "\n" << result.insertedCount << " records were added, " << result.updatedCount << " were updated and "
+			<< result.unchangedCount << " were already up to date. The merge can be reversed with undo.\n" << std::endl;
+	}
+	catch (const std::exception &error) {
+		std::cout << "\nThe file was not merged. " << error.what() << "\n" << std::endl;
+	}
+}
+
+/**
+ * @brief Prompts the user for another table, the columns to join on and the join type, then either shows the first joined rows or
+ * writes the whole join to a file
+*/
+void RecordConsoleView::printJoinOptions() {
+	const std::size_t PREVIEW_ROWS = 10;
+	std::string filePath{};
+	std::cout << "Please enter the path of the CSV file containing the table to join with, including the file extension: " << std::endl;
+	std::getline(std::cin, filePath);
+
+	TableDTO table{};
+	try {
+		table = RecordConsoleView::recordService.loadTable(filePath);
+	}
+	catch (const std::exception &error) {
+		std::cout << "\nThe table could not be read. " << error.what() << "\n" << std::endl;
+		return;
+	}
+
+	std::string answer{};
+	JoinSpec spec{};
+	std::cout << "The table has " << table.rowCount() << " rows. To join on other columns than REF_DATE and GEO, enter their numbers, separated by spaces."
+		<< " The table must have columns with the same headers. Press Enter to keep REF_DATE and GEO:";
+	for (std::size_t i = 0; i < RECORD_COLUMNS.size(); i++) {
+		std::cout << "\n" << i + 1 << ". " << RECORD_COLUMNS[i].label;
+	}
+	std::cout << std::endl;
+	std::getline(std::cin, answer);
+
+	std::istringstream selections{ answer };
+	int selection{};
+	if (selections >> selection) {
+		spec.recordKeys.clear();
+		spec.tableKeys.clear();
+		do {
+			if (!isValidSelection(selection)) {
+				std::cout << INVALID_INPUT << std::endl;
+				return;
+			}
+			spec.recordKeys.push_back(RECORD_COLUMNS[selection - 1].column);
+			spec.tableKeys.emplace_back(RECORD_COLUMNS[selection - 1].header);
+		} while (selections >> selection);
+	}
+
+	std::cout << "Please enter 0 to keep only the records that match the table, or 1 to keep every record:" << std::endl;
+	std::getline(std::cin, answer);
+	if (isInvalid(answer)) {
+		std::cout << INVALID_INPUT << std::endl;
+		return;
+	}
+	spec.type = answer == "1" ? JoinType::Left : JoinType::Inner;
+
+	std::string newFileName{};
+	std::cout << "To write the join to a file, enter the new file's name without the file extension. Press Enter to see its first rows instead:" << std::endl;
+	std::getline(std::cin, newFileName);
+
+	try {
+		if (!newFileName.empty()) {
+			std::size_t writtenCount = RecordConsoleView::recordService.writeJoinToFile(table, spec, newFileName);
+			std::cout << "\n" << writtenCount << " joined rows were successfully written to disk\n" << std::endl;
+			return;
+		}
+
+		TableDTO joined = RecordConsoleView::recordService.joinTable(table, spec);
+		std::vector<TableDTO::Row> preview{ joined.getHeaders() };
+		std::size_t previewCount = std::min(PREVIEW_ROWS, joined.rowCount());
+		preview.insert(preview.end(), joined.getRows().begin(), joined.getRows().begin() + previewCount);
+		printTable(preview);
+		std::cout << joined.rowCount() << " joined row(s)\n" << std::endl;
+	}
+	catch (const std::invalid_argument &error) {
+		std::cout << "\nThe tables were not joined. " << error.what() << "\n" << std::endl;
+	}
+	catch (const std::runtime_error &error) {
+		std::cout << "\nThe join was not saved. " << error.what() << "\n" << std::endl;
+	}
+}
+
+/**
+ * @brief Prompts the user for a column and a piece of text, then shows the first records whose column contains the text, or starts
+ * with it if the text ends with '*'
+*/
+void RecordConsoleView::printSearchOptions() {
+	const std::size_t PREVIEW_RECORDS = 10;
+	std::string answer{};
+	int selection{};
+	std::cout << "Please enter the number of the column to search:";
+	for (std::size_t i = 0; i < RECORD_COLUMNS.size(); i++) {
+		std::cout << "\n" << i + 1 << ". " << RECORD_COLUMNS[i].label;
+	}
+	std::cout << std::endl;
+	std::cin >> selection;
+	std::cin.ignore();
+	if (!isValidSelection(selection)) {
+		std::cout << INVALID_INPUT << std::endl;
+		return;
+	}
+
+	std::cout << "Please enter the text to look for. Case is ignored. End it with '*' to only find values that start with it:" << std::endl;
+	std::getline(std::cin, answer);
+	TextMatch match = TextMatch::Contains;
+	if (!answer.empty() && answer.back() == '*') {
+		answer.pop_back();
+		match = TextMatch::Prefix;
+	}
+
+	std::vector<RecordService::RecordId> recordIds = RecordConsoleView::recordService.searchText(RECORD_COLUMNS[selection - 1].column, answer, match);
+	for (std::size_t i = 0; i < recordIds.size() && i < PREVIEW_RECORDS; i++) {
+		// Record numbers are shown from 1, as in the rest of the menu
+		std::cout << "Record #" << recordIds[i] + 1 << ":\n";
+		RecordConsoleView::recordService.getRecord(recordIds[i]).printRecord();
+	}
+	std::cout << recordIds.size() << " matching record(s) were found.\n" << std::endl;
+}
+
+/**
+ * @brief Prompts the user for a percentile, then prints the number of series and the percentile of VALUE overall and by province,
+ * either estimated from the sketches kept in memory or computed exactly from every record
+*/
+void RecordConsoleView::printStatisticOptions() {
+	double percentile{};
+	std::string answer{};
+	std::cout << "Please enter the percentile of VALUE to find, from 0 to 100:" << std::endl;
+	std::cin >> percentile;
+	std::cin.ignore();
+	std::cout << "Please enter 0 for instant estimates, or 1 to compute the statistics exactly from every record:" << std::endl;
+	std::getline(std::cin, answer);
+	if (isInvalid(answer)) {
+		std::cout << INVALID_INPUT << std::endl;
+		return;
+	}
+	bool isExact = answer == "1";
+
+	try {
+		double fraction = percentile / 100;
+		std::map<std::string, double> byProvince = RecordConsoleView::recordService.estimateQuantiles(RecordColumn::Geo, fraction, isExact);
+		std::vector<std::vector<std::string>> table{ { "GEO", "VALUE" } };
+		for (const auto &province : byProvince) {
+			table.push_back({ province.first, formatAggregateValue(province.second) });
+		}
+		std::cout << "\nSeries (VECTOR): " << RecordConsoleView::recordService.estimateDistinctCount(RecordColumn::Vector, isExact)
+			<< "\nPercentile " << percentile << " of VALUE: " << formatAggregateValue(RecordConsoleView::recordService.estimateQuantile(fraction, isExact)) << "\n";
+		printTable(table);
+		std::cout << std::endl;
+	}
+	catch (const std::invalid_argument &error) {
+		std::cout << "\n" << error.what() << "\n" << std::endl;
+	}
+}
+
+/**
+ * @brief Prompts the user for the columns to group by, then prints the count, total, average, minimum and maximum VALUE of each group
+ * and offers to save them to a file
+*/
+void RecordConsoleView::printGroupOptions() {
+	std::string answer{};
+	std::vector<GroupKey> keys{};
+
+	std::cout << "To summarize values by group, enter the numbers of the columns to group by, separated by spaces:";
+	std::cout << "\n" << GROUP_BY_YEAR << ". Year";
+	for (std::size_t i = 0; i < RECORD_COLUMNS.size(); i++) {
+		std::cout << "\n" << i + 1 << ". " << RECORD_COLUMNS[i].label;
+	}
+	std::cout << std::endl;
+	std::getline(std::cin, answer);
+
+	std::istringstream selections{ answer };
+	int selection{};
+	while (selections >> selection) {
+		if (selection == GROUP_BY_YEAR) {
+			keys.push_back(GroupKey{ RecordColumn::RefDate, GroupKey::YEAR_LENGTH });
+		}
+		else if (isValidSelection(selection)) {
+			keys.push_back(GroupKey{ RECORD_COLUMNS[selection - 1].column });
+		}
+		else {
+			std::cout << INVALID_INPUT << std::endl;
+			return;
+		}
+	}
+	if (keys.empty()) {
+		std::cout << INVALID_INPUT << std::endl;
+		return;
+	}
+
+	GroupByResult result = RecordConsoleView::recordService.getCachedGroups(keys, { { AggregateFunction::Count }, { AggregateFunction::Sum },
+		{ AggregateFunction::Average }, { AggregateFunction::Min }, { AggregateFunction::Max } });
+	printTable(result.toTable());
+	std::cout << result.groups.size() << " group(s)" << std::endl;
+
+	std::string newFileName{};
+	std::cout << "\nTo save this summary, enter the new file's name without the file extension. Press Enter to skip:" << std::endl;
+	std::getline(std::cin, newFileName);
+	if (!newFileName.empty()) {
+		try {
+			RecordConsoleView::recordService.writeGroupsToFile(result, newFileName);
+			std::cout << "\nSummary was successfully written to disk" << std::endl;
+		}
+		catch (const std::runtime_error &error) {
+			std::cout << "\nSummary was not saved. " << error.what() << std::endl;
+		}
+	}
+}
+
+/**
+ * @brief Prompts the user for a pivot's rows, columns and period, then prints the total VALUE of each cell and offers to save the table to a file
+*/
+void RecordConsoleView::printPivotOptions() {
+	PivotSpec spec{};
+	int rowSelection{};
+	int columnSelection{};
+	int periodSelection{};
+
+	std::cout << "To build a pivot table of total values, choose its rows and columns from these columns:";
+	for (std::size_t i = 0; i < RECORD_COLUMNS.size(); i++) {
+		if (RECORD_COLUMNS[i].storage == ColumnStorage::Dictionary) {
+			std::cout << "\n" << i + 1 << ". " << RECORD_COLUMNS[i].label;
+		}
+	}
+	std::cout << "\nPlease enter the number of the column for the table's rows, then the number for its columns:" << std::endl;
+	std::cin >> rowSelection >> columnSelection;
+	std::cout << "Please enter 0 for one table, 1 for a table per month, or 2 for a table per year:" << std::endl;
+	std::cin >> periodSelection;
+	std::cin.ignore();
+
+	bool isValidAxis = isValidSelection(rowSelection) && isValidSelection(columnSelection)
+		&& RECORD_COLUMNS[rowSelection - 1].storage == ColumnStorage::Dictionary
+		&& RECORD_COLUMNS[columnSelection - 1].storage == ColumnStorage::Dictionary;
+	if (!isValidAxis || periodSelection < 0 || periodSelection > 2) {
+		std::cout << INVALID_INPUT << std::endl;
+		return;
+	}
+	spec.rowColumn = RECORD_COLUMNS[rowSelection - 1].column;
+	spec.columnColumn = RECORD_COLUMNS[columnSelection - 1].column;
+	spec.period = static_cast<PivotPeriod>(periodSelection);
+
+	PivotTable table{};
+	try {
+		table = RecordConsoleView::recordService.pivotRecords(spec);
+	}
+	catch (const std::invalid_argument &error) {
+		std::cout << "\nThe pivot table was not built. " << error.what() << "\n" << std::endl;
+		return;
+	}
+	printTable(table.toTable());
+
+	std::string newFileName{};
+	std::cout << "\nTo save this table, enter the new file's name without the file extension. Press Enter to skip:" << std::endl;
+	std::getline(std::cin, newFileName);
+	if (!newFileName.empty()) {
+		try {
+			RecordConsoleView::recordService.writePivotToFile(table, newFileName);
+			std::cout << "\nTable was successfully written to disk" << std::endl;
+		}
+		catch (const std::runtime_error &error) {
+			std::cout << "\nTable was not saved. " << error.what() << std::endl;
+		}
+	}
+}
+
+/**
+ * @brief Prints rows of text as a table with aligned columns
+ * @param table the rows to print, headers first
+*/
+void RecordConsoleView::printTable(const std::vector<std::vector<std::string>> &table) {
+	std::vector<std::size_t> widths{};
+
+	for (const std::vector<std::string> &row : table) {
+		widths.resize(std::max(widths.size(), row.size()), 0);
+		for (std::size_t i = 0; i < row.size(); i++) {
+			widths[i] = std::max(widths[i], row[i].size());
+		}
+	}
+
+	std::cout << std::endl;
+	for (const std::vector<std::string> &row : table) {
+		for (std::size_t i = 0; i < row.size(); i++) {
+			std::cout << std::left << std::setw(static_cast<int>(widths[i]) + 2) << row[i];
+		}
+		std::cout << std::right << std::endl;
+	}
 }
 
 /**
@@ -466,10 +791,7 @@ bool RecordConsoleView::isInvalid(std::string orderSelection) {
  * @return the specifie number of RecordDTOs in the specified sorting order
 */
 std::vector<RecordDTO> RecordConsoleView::sortRecords(int numRecords, int order) {
-	std::vector<RecordDTO> sortedRecords = recordService.sortRecords(order);
-	sortedRecords.resize(numRecords);
-
-	return sortedRecords;
+	return recordService.getSortedRecords(numRecords, order);
 }
 
 /*
@@ -479,7 +801,7 @@ TEST_CASE("Test thread's writing functionality") {
 	RecordService recordService {};
 	std::string newFileName = "Testing_Thread_Writing_Functionality";
 
-	std::thread writeThread(&RecordService::writeToFile, recordService, newFileName);
+	std::thread writeThread(&RecordService::writeToFile, std::ref(recordService), newFileName);
 	writeThread.join();
 
 	newFileName.append(".csv");
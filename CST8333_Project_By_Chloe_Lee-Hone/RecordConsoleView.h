@@ -36,7 +36,17 @@ private:
 	static const int SAVE_CHANGES			= 5;
 	static const int RELOAD_RECORDS			= 6;
 	static const int SORT_RECORDS			= 7;
-	static const int EXIT_PROGRAM			= 8;
+	static const int SUMMARIZE_RECORDS		= 8;
+	static const int PIVOT_RECORDS			= 9;
+	static const int UNDO_CHANGE			= 10;
+	static const int REDO_CHANGE			= 11;
+	static const int FIND_DUPLICATES		= 12;
+	static const int MERGE_FILE				= 13;
+	static const int JOIN_TABLE				= 14;
+	static const int SEARCH_TEXT			= 15;
+	static const int ESTIMATE_STATISTICS	= 16;
+	static const int EXIT_PROGRAM			= 17;
+	static const int GROUP_BY_YEAR			= 0;
 	static const int PRINT_ONE_RECORD		= 1;
 	static const int PRINT_MULTIPLE_RECORDS = 2;
 	static const int PRINT_MOST_RECENT		= 3;
@@ -69,6 +79,42 @@ public:
 	*/
 	void reloadData();
 
+	/**
+	 * @brief Reverses the latest change to the records, or reports that there is none
+	*/
+	void undoChange();
+
+	/**
+	 * @brief Applies the latest undone change again, or reports that there is none
+	*/
+	void redoChange();
+
+	/**
+	 * @brief Reports the records that share a REF_DATE and VECTOR, and offers to refuse such duplicates from now on
+	*/
+	void printDuplicates();
+
+	/**
+	 * @brief Prompts the user for a revised CSV file and merges it into the records, keeping local changes the file does not touch
+	*/
+	void printMergeOptions();
+
+	/**
+	 * @brief Prompts the user for another table and the columns to join on, then shows the first joined rows or writes the join to a file
+	*/
+	void printJoinOptions();
+
+	/**
+	 * @brief Prompts the user for a column and a piece of text, then shows the first records whose column contains the text
+	*/
+	void printSearchOptions();
+
+	/**
+	 * @brief Prompts the user for a percentile, then prints the number of series and the percentile of VALUE overall and by province,
+	 * either estimated or computed exactly
+	*/
+	void printStatisticOptions();
+
 	/**
 	 * @brief Prompts the user to enter a file name. This file name will be used to write the vector.
 	*/
@@ -92,16 +138,18 @@ public:
 	void createRecord();
 
 	/**
-	 * @brief Updates a specific RecordDTO based on user input. Currently only allows one value to be edited per command.
+	 * @brief Updates a specific RecordDTO based on user input. Every value edited in one command is committed together, so
+	 * a single undo reverses all of them.
 	*/
 	void printUpdateOptions();
 
 	/**
-	 * @brief Uses an instance of RecordService to process the selected edit on a given record.
-	 * @param recordId The RecordDTO's index in the vector stored in memory
+	 * @brief Asks for the new value of the selected field and stages the edit in a transaction.
+	 * @param transaction the transaction the edit is added to
+	 * @param recordId The record's id
 	 * @param userSelection The RecordDTO's instance variable to be edited
 	*/
-	void processUpdateSelection(int recordId, int userSelection);
+	void processUpdateSelection(RecordTransaction &transaction, int recordId, int userSelection);
 
 	/**
 	 * @brief Prints the options to guide the user through the process of deleting a RecordDTO from the vector stored in memory
@@ -134,6 +182,23 @@ public:
 	*/
 	std::vector<RecordDTO> sortRecords(int numRecords, int order);
 
+	/**
+	 * @brief Prompts the user for the columns to group by, then prints the count, total, average, minimum and maximum VALUE of each group
+	 * and offers to save them to a file
+	*/
+	void printGroupOptions();
+
+	/**
+	 * @brief Prompts the user for a pivot's rows, columns and period, then prints the total VALUE of each cell and offers to save the table to a file
+	*/
+	void printPivotOptions();
+
+	/**
+	 * @brief Prints rows of text as a table with aligned columns
+	 * @param table the rows to print, headers first
+	*/
+	void printTable(const std::vector<std::vector<std::string>> &table);
+
 	/**
 	 * @brief Checks that the Record selected by the user exists in the vector of RecordDTOs
 	 * @param input the index in the vector containing the user's chosen RecordDTO
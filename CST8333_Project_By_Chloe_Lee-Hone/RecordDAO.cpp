@@ -27,32 +27,90 @@
 #include <sstream>
 #include <thread>
 #include <future>
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include "ParallelRange.h"
 #include "doctest.h"
 
 const std::string ORIGINAL_FILE_PATH = "32100260.csv";
 
-RecordDAO::RecordDAO() {}
+RecordDAO::RecordDAO() : dataSetPath{ ORIGINAL_FILE_PATH } {}
+
+/**
+ * @brief Creates an accessor that reads the data set from another file, such as a test file
+ * @param dataSetPath the data set's path
+*/
+RecordDAO::RecordDAO(std::string dataSetPath) : dataSetPath{ std::move(dataSetPath) } {}
 
 /**
  * @brief Retrieves records from CSV file and returns a list of 100 RecordDTO objects. Used in the main method to print results.
+ * Only the rows up to the 100th record are read and parsed.
  * @param filepath is the path to the file containing the CSV data set
  * @return a vector of RecordDTO objects
 */
 std::vector<RecordDTO> RecordDAO::getAllRecords() {
-	// Loads the dataset
-	std::future<std::vector<std::string>> future = std::async(std::launch::async, &RecordDAO::openFile, this);
-	std::vector<std::string> lines = future.get();
-
-	/** Stores each cell's data, which is then used to create a RecordDTO object */
-	std::future<std::vector<std::string>> future2 = std::async(std::launch::async, &RecordDAO::parseRecords, this, lines);
-	std::vector<std::string> data = future2.get();
+	std::vector<RecordDTO> recordList{};
+	readAllRecordsInBatches(MAX_LIST_SIZE, [&recordList](std::vector<RecordDTO> &&batch, std::size_t, std::size_t) {
+		std::move(batch.begin(), batch.end(), std::back_inserter(recordList));
+	});
+	return recordList;
+}
 
-	std::future<std::vector<RecordDTO>> future3 = std::async(std::launch::async, &RecordDAO::createRecordDtoList, this, data);
-	std::vector<RecordDTO> recordList = future3.get();
+/**
+ * @brief Reads the same records as getAllRecords(), but hands them over a batch at a time as the file is read, so a caller can
+ * use the first records before the rest are parsed. The header row is skipped, and reading stops once MAX_LIST_SIZE records are read.
+ * @param batchSize the most records in one batch
+ * @param onBatch called on the reading thread with each batch, in file order
+ * @throws std::runtime_error if the file cannot be opened
+*/
+void RecordDAO::readAllRecordsInBatches(std::size_t batchSize, const RecordBatchCallback &onBatch) {
+	/** Performs the CSV input operation [4] */
+	std::ifstream records{};
+	records.open(RecordDAO::dataSetPath, std::ifstream::in);
+	if (!records.is_open()) {
+		throw std::runtime_error("The file " + RecordDAO::dataSetPath + " could not be opened.");
+	}
+	records.seekg(0, std::ios::end);
+	std::size_t totalBytes = static_cast<std::size_t>(std::max<std::streamoff>(records.tellg(), 0));
+	records.seekg(0, std::ios::beg);
 
-	recordList = removeHeaders(recordList);
+	std::size_t remaining = MAX_LIST_SIZE;
+	std::vector<std::string> lines{};
+	std::vector<std::string> cells{};
+	auto sendBatch = [&]() {
+		std::streamoff position = records.tellg();
+		std::size_t bytesRead = position < 0 ? totalBytes : static_cast<std::size_t>(position);
+		remaining -= lines.size();
+		std::vector<RecordDTO> batch(lines.size());
+		for (std::size_t i = 0; i < lines.size(); i++) {
+			parseRecordLine(lines[i], cells, batch[i]);
+		}
+		onBatch(std::move(batch), bytesRead, totalBytes);
+		lines.clear();
+	};
 
-	return trimList(recordList, MAX_LIST_SIZE);
+	// The first non-empty row holds the headers, as removeHeaders() expects
+	std::string line{};
+	bool isHeaderSkipped{ false };
+	while (remaining > 0 && std::getline(records, line)) {
+		if (line.empty() || line == "\r") {
+			continue;
+		}
+		if (!isHeaderSkipped) {
+			isHeaderSkipped = true;
+			continue;
+		}
+		lines.push_back(std::move(line));
+		if (lines.size() == std::min(batchSize, remaining)) {
+			sendBatch();
+		}
+	}
+	if (!lines.empty()) {
+		sendBatch();
+	}
 }
 
 /**
@@ -60,17 +118,30 @@ std::vector<RecordDTO> RecordDAO::getAllRecords() {
  * @return A vector containing the CSV file's rows
 */
 std::vector<std::string> RecordDAO::openFile() {
+	return readLines(RecordDAO::dataSetPath);
+}
+
+/**
+ * @brief Reads a CSV file into a vector of Strings. Each index value represents one row in the CSV file.
+ * @param filePath the file to read
+ * @return A vector containing the CSV file's rows
+ * @throws std::runtime_error if the file cannot be opened
+*/
+std::vector<std::string> RecordDAO::readLines(const std::string &filePath) {
 	std::vector<std::string> lines{};
 
 	/** Performs the CSV input operation [4] */
 	std::ifstream records{};
 
 	try {
-		records.open(ORIGINAL_FILE_PATH, std::ifstream::in);
+		records.open(filePath, std::ifstream::in);
 	}
 	catch (std::ifstream::failure) {
 		throw "Reading the file path caused an error.";
 	}
+	if (!records.is_open()) {
+		throw std::runtime_error("The file " + filePath + " could not be opened.");
+	}
 
 	/**
 	 * The CSV's lines are first placed into a vector. It was necessary to to this in two steps, because we can't split on both
@@ -91,6 +162,120 @@ std::vector<std::string> RecordDAO::openFile() {
 	return lines;
 }
 
+/**
+ * @brief Checks whether a CSV row is the data set's header row, which may start with a UTF-8 byte order mark
+ * @param line the row
+ * @return true if the row's first cell is the REF_DATE header
+*/
+static bool isHeaderLine(const std::string &line) {
+	std::string_view cells{ line };
+	if (cells.substr(0, 3) == "\xEF\xBB\xBF") cells.remove_prefix(3);
+	if (!cells.empty() && cells.front() == '"') cells.remove_prefix(1);
+	return cells.substr(0, std::string_view{ columnInfo(RecordColumn::RefDate).header }.size()) == columnInfo(RecordColumn::RefDate).header;
+}
+
+/**
+ * @brief Splits one CSV row into its cells. Commas inside quotes do not split, the quotes around each cell are removed and a
+ * doubled quote inside a quoted cell becomes a single quote.
+ * @param line the row
+ * @param cells the vector the row's cells are added to
+*/
+static void splitCsvLine(const std::string &line, std::vector<std::string> &cells) {
+	// Stores the cell data value, which is used to construct the RecordDTo object
+	std::string dataPoint{ "" };
+	bool isInQuotes{ false };
+
+	for (std::size_t i = 0; i < line.size(); i++) {
+		char character = line[i];
+
+		if (character == '"') {
+			if (isInQuotes && i + 1 < line.size() && line[i + 1] == '"') {
+				dataPoint += '"';
+				i++;
+			}
+			else {
+				isInQuotes = !isInQuotes;
+			}
+		}
+		else if (character == ',' && !isInQuotes) {
+			cells.push_back(std::move(dataPoint));
+			dataPoint.clear();
+		}
+		else if (character != '\r') {
+			dataPoint += character;
+		}
+	}
+	cells.push_back(std::move(dataPoint));
+}
+
+/**
+ * @brief Reads every record of a CSV file laid out like the data set, such as a newer release of it or a file written
+ * by writeToFile(). Unlike getAllRecords(), the list is not trimmed. A header row is skipped if the file has one.
+ * Chunks of the file's rows are parsed on separate threads, each row on its own, so the records do not depend on how the rows are chunked.
+ * @param filePath the file to read
+ * @return the file's records, in file order
+ * @throws std::runtime_error if the file cannot be opened or any row does not have exactly one cell per column
+*/
+std::vector<RecordDTO> RecordDAO::readRecordsFromFile(const std::string &filePath) {
+	std::vector<std::string> lines = readLines(filePath);
+	std::size_t firstLine = !lines.empty() && isHeaderLine(lines.front()) ? 1 : 0;
+	std::size_t lineCount = lines.size() - firstLine;
+
+	std::vector<std::vector<RecordDTO>> chunkRecords(parallelChunkCount(lineCount));
+	std::vector<std::vector<std::size_t>> chunkBadRows(chunkRecords.size());
+	forEachChunk(lineCount, [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+		std::vector<std::string> cells{};
+		chunkRecords[chunk].reserve(end - begin);
+		for (std::size_t position = firstLine + begin; position < firstLine + end; position++) {
+			if (lines[position].empty() || lines[position] == "\r") {
+				continue;
+			}
+			RecordDTO recordDto{};
+			if (!parseRecordLine(lines[position], cells, recordDto)) {
+				// Rows are numbered from 1, counting the header row, as in a spreadsheet
+				chunkBadRows[chunk].push_back(position + 1);
+			}
+			chunkRecords[chunk].push_back(std::move(recordDto));
+		}
+	});
+
+	std::vector<std::size_t> badRows{};
+	for (const std::vector<std::size_t> &rows : chunkBadRows) {
+		badRows.insert(badRows.end(), rows.begin(), rows.end());
+	}
+	if (!badRows.empty()) {
+		throw std::runtime_error("The file " + filePath + " has " + std::to_string(badRows.size()) + " row(s) without exactly "
+			+ std::to_string(RecordDAO::NUM_OF_COLUMNS) + " cells, starting with row " + std::to_string(badRows.front()) + ".");
+	}
+
+	std::vector<RecordDTO> recordList = std::move(chunkRecords.front());
+	for (std::size_t chunk = 1; chunk < chunkRecords.size(); chunk++) {
+		std::move(chunkRecords[chunk].begin(), chunkRecords[chunk].end(), std::back_inserter(recordList));
+	}
+	return recordList;
+}
+
+/**
+ * @brief Creates a RecordDTO from one CSV row laid out like the data set. A short row leaves its last columns empty and a long
+ * row loses its extra cells, as in readTableFromFile().
+ * @param line the row
+ * @param cells a buffer for the row's cells, reused from row to row
+ * @param record the record the row's cells are moved into
+ * @return true if the row had exactly one cell per column
+*/
+bool RecordDAO::parseRecordLine(const std::string &line, std::vector<std::string> &cells, RecordDTO &record) {
+	cells.clear();
+	splitCsvLine(line, cells);
+	bool isComplete = cells.size() == RECORD_COLUMN_COUNT;
+	cells.resize(RECORD_COLUMN_COUNT);
+
+	/** The cells are in RECORD_COLUMNS order, so cell j of a row belongs to column j. */
+	for (const ColumnInfo &columnInfo : RECORD_COLUMNS) {
+		record.set(columnInfo.column, std::move(cells[columnIndex(columnInfo.column)]));
+	}
+	return isComplete;
+}
+
 /**
  * @brief Creates vector of RecordDTO instances
  * @param data A vector of strings containing the data used to create RecordDTO objects
@@ -99,30 +284,17 @@ std::vector<std::string> RecordDAO::openFile() {
 std::vector<RecordDTO> RecordDAO::createRecordDtoList(std::vector<std::string> data) {
 	/** Stores all RecordDTO objects, and is iterated over in the main method */
 	std::vector<RecordDTO> recordList{};
-	/** Index starts at 1, because otherwise the modulo check will return true when i = 0, and an out of bounds exception will be thrown */
-	for (int i = 1; i < data.size(); i++) {
-		if (i % RecordDAO::NUM_OF_COLUMNS == 0) {
-			RecordDTO recordDto{};
+	recordList.reserve(data.size() / RecordDAO::NUM_OF_COLUMNS);
 
-			recordDto.setRefDate(data.at(i - 16));
-			recordDto.setGeo(data.at(i - 15));
-			recordDto.setDguid(data.at(i - 14));
-			recordDto.setProductType(data.at(i - 13));
-			recordDto.setStorageType(data.at(i - 12));
-			recordDto.setUom(data.at(i - 11));
-			recordDto.setUomId(data.at(i - 10));
-			recordDto.setScalarFactor(data.at(i - 9));
-			recordDto.setScalarId(data.at(i - 8));
-			recordDto.setVector(data.at(i - 7));
-			recordDto.setCoordinate(data.at(i - 6));
-			recordDto.setValue(data.at(i - 5));
-			recordDto.setStatus(data.at(i - 4));
-			recordDto.setSymbol(data.at(i - 3));
-			recordDto.setTerminated(data.at(i - 2));
-			recordDto.setDecimals(data.at(i - 1));
-
-			recordList.push_back(recordDto);
+	/** Each run of NUM_OF_COLUMNS cells is one row. The cells are in RECORD_COLUMNS order, so cell j of a row belongs to column j. */
+	for (std::size_t rowStart = 0; rowStart + RecordDAO::NUM_OF_COLUMNS <= data.size(); rowStart += RecordDAO::NUM_OF_COLUMNS) {
+		RecordDTO recordDto{};
+
+		for (const ColumnInfo &columnInfo : RECORD_COLUMNS) {
+			recordDto.set(columnInfo.column, std::move(data[rowStart + columnIndex(columnInfo.column)]));
 		}
+
+		recordList.push_back(std::move(recordDto));
 	}
 	return recordList;
 }
@@ -151,30 +323,79 @@ std::vector<RecordDTO> RecordDAO::trimList(std::vector<RecordDTO> recordList, in
 }
 
 /**
- * @brief Splits each record string into multiple parts using the comma delimiter
+ * @brief Splits each record string into multiple parts using the comma delimiter. Commas inside quotes do not split, and the quotes around each cell are removed.
  * @param lines contains the records as comma-separated strings
  * @return a vector of strings. Each string represents one cell of data. Used to create RecordDTO objects.
 */
 std::vector<std::string> RecordDAO::parseRecords(std::vector<std::string> lines) {
 	std::vector<std::string> data{};
-	// Iterate through each string, which corresponds to one entire record, and split on comma
+	data.reserve(lines.size() * RecordDAO::NUM_OF_COLUMNS);
 
-	try {
-		for (int j = 0; j < lines.size(); j++) {
-			std::stringstream stringStream{ lines.at(j) };
-			// Stores the cell data value, which is used to construct the RecordDTo object
-			std::string dataPoint{ "" };
-
-			// Split the record string using the comma delimiter
-			while (std::getline(stringStream, dataPoint, ',')) {
-				data.push_back(dataPoint);
+	// Iterate through each string, which corresponds to one entire record, and split on every comma that is not inside quotes.
+	for (const std::string &line : lines) {
+		if (line.empty() || line == "\r") {
+			continue;
+		}
+		splitCsvLine(line, data);
+	}
+	return data;
+}
+
+/**
+ * @brief Reads a CSV file with any columns, such as another Statistics Canada table to join with the records. The first row is
+ * taken as the headers. Every row is given exactly one cell per header, so a short row is padded with empty cells and a long
+ * row loses its extra cells. Chunks of the file's rows are parsed on separate threads.
+ * @param filePath the file to read
+ * @return the table, in file order
+ * @throws std::runtime_error if the file cannot be opened
+*/
+TableDTO RecordDAO::readTableFromFile(const std::string &filePath) {
+	std::vector<std::string> lines = readLines(filePath);
+	if (lines.empty()) {
+		return TableDTO{};
+	}
+
+	std::string_view headerLine{ lines.front() };
+	if (headerLine.substr(0, 3) == "\xEF\xBB\xBF") headerLine.remove_prefix(3);
+	std::vector<std::string> headers{};
+	splitCsvLine(std::string{ headerLine }, headers);
+
+	std::size_t lineCount = lines.size() - 1;
+	std::vector<std::vector<TableDTO::Row>> chunkRows(parallelChunkCount(lineCount));
+	forEachChunk(lineCount, [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+		chunkRows[chunk].reserve(end - begin);
+		for (std::size_t position = begin; position < end; position++) {
+			const std::string &line = lines[position + 1];
+			if (line.empty() || line == "\r") {
+				continue;
 			}
+			TableDTO::Row row{};
+			row.reserve(headers.size());
+			splitCsvLine(line, row);
+			row.resize(headers.size());
+			chunkRows[chunk].push_back(std::move(row));
 		}
+	});
+
+	std::vector<TableDTO::Row> rows = std::move(chunkRows.front());
+	for (std::size_t chunk = 1; chunk < chunkRows.size(); chunk++) {
+		std::move(chunkRows[chunk].begin(), chunkRows[chunk].end(), std::back_inserter(rows));
 	}
-	catch (std::stringstream::failure) {
-		throw "Extracting data from the records by splitting them on the comma delimiter caused an error.";
+	return TableDTO{ std::move(headers), std::move(rows) };
+}
+
+/**
+ * @brief Writes one cell in the same quoted form as the original data set, doubling any quote inside the value
+ * @param file the stream being written
+ * @param value the cell's value
+*/
+static void writeCsvCell(std::ostream &file, std::string_view value) {
+	file << '"';
+	for (char character : value) {
+		if (character == '"') file << '"';
+		file << character;
 	}
-	return data;
+	file << '"';
 }
 
 /**
@@ -182,29 +403,18 @@ std::vector<std::string> RecordDAO::parseRecords(std::vector<std::string> lines)
  * @param recordsList The vector of RecordDTOs to be stored in a new file
  * @param newFileName The new file's name
 */
-void RecordDAO::writeToFile(std::vector<RecordDTO> recordList, std::string newFileName) {
+void RecordDAO::writeToFile(const std::vector<RecordDTO> &recordList, const std::string &newFileName) {
 	try {
 		std::ofstream newRecordsFile{};
 		newRecordsFile.open(newFileName);
 
-		for (int i = 0; i < recordList.size(); i++)
+		for (const RecordDTO &record : recordList)
 		{
-			newRecordsFile << recordList.at(i).getRefDate()		<< ",";
-			newRecordsFile << recordList.at(i).getGeo()			<< ",";
-			newRecordsFile << recordList.at(i).getDguid()		<< ",";
-			newRecordsFile << recordList.at(i).getProductType() << ",";
-			newRecordsFile << recordList.at(i).getStorageType() << ",";
-			newRecordsFile << recordList.at(i).getUom()			<< ",";
-			newRecordsFile << recordList.at(i).getUomId()		<< ",";
-			newRecordsFile << recordList.at(i).getScalarFactor()<< ",";
-			newRecordsFile << recordList.at(i).getScalarId()	<< ",";
-			newRecordsFile << recordList.at(i).getVector()		<< ",";
-			newRecordsFile << recordList.at(i).getCoordinate()	<< ",";
-			newRecordsFile << recordList.at(i).getValue()		<< ",";
-			newRecordsFile << recordList.at(i).getStatus()		<< ",";
-			newRecordsFile << recordList.at(i).getSymbol()		<< ",";
-			newRecordsFile << recordList.at(i).getTerminated()	<< ",";
-			newRecordsFile << recordList.at(i).getDecimals()	<< std::endl;
+			for (std::size_t i = 0; i < RECORD_COLUMNS.size(); i++) {
+				if (i > 0) newRecordsFile << ",";
+				writeCsvCell(newRecordsFile, record.get(RECORD_COLUMNS[i].column));
+			}
+			newRecordsFile << "\n";
 		}
 		newRecordsFile.close();
 	}
@@ -213,6 +423,57 @@ void RecordDAO::writeToFile(std::vector<RecordDTO> recordList, std::string newFi
 	}
 }
 
+/**
+ * @brief Writes rows of text to an open file, quoting each cell the same way as the data set
+ * @param file the stream being written
+ * @param table the rows to write
+*/
+static void writeCsvRows(std::ostream &file, const std::vector<std::vector<std::string>> &table) {
+	for (const std::vector<std::string> &row : table) {
+		for (std::size_t i = 0; i < row.size(); i++) {
+			if (i > 0) file << ",";
+			writeCsvCell(file, row[i]);
+		}
+		file << "\n";
+	}
+}
+
+/**
+ * @brief Writes a table of text, such as a group-by result, to a CSV file quoted the same way as the data set
+ * @param table the rows to write, headers first
+ * @param newFileName the file name where the table will be stored
+ * @throws std::runtime_error if the file cannot be opened or written
+*/
+void RecordDAO::writeTableToFile(const std::vector<std::vector<std::string>> &table, const std::string &newFileName) {
+	std::ofstream newTableFile{ newFileName };
+	if (!newTableFile.is_open()) {
+		throw std::runtime_error("The file " + newFileName + " could not be opened.");
+	}
+	writeCsvRows(newTableFile, table);
+	newTableFile.close();
+	if (newTableFile.fail()) {
+		throw std::runtime_error("The table could not be written to " + newFileName + ".");
+	}
+}
+
+/**
+ * @brief Adds rows to the end of a CSV file, such as one batch of a join that is too large to hold in memory. The file is created if it does not exist.
+ * @param table the rows to write
+ * @param fileName the file the rows are added to
+ * @throws std::runtime_error if the file cannot be opened or written
+*/
+void RecordDAO::appendTableToFile(const std::vector<std::vector<std::string>> &table, const std::string &fileName) {
+	std::ofstream tableFile{ fileName, std::ios::app };
+	if (!tableFile.is_open()) {
+		throw std::runtime_error("The file " + fileName + " could not be opened.");
+	}
+	writeCsvRows(tableFile, table);
+	tableFile.close();
+	if (tableFile.fail()) {
+		throw std::runtime_error("The rows could not be added to " + fileName + ".");
+	}
+}
+
 TEST_CASE("Test that ifstream successfully opens") {
 	std::string filepath = "32100260.csv";
 	std::ifstream records{};
@@ -250,3 +511,96 @@ TEST_CASE("Test that ofstream successfully writes to a new file") {
 
 
 
+
+
+TEST_CASE("Test that quoted cells are split and unquoted") {
+	RecordDAO recordDao{};
+	std::vector<std::string> lines{ "\"1970-01\",\"Canada\",\"\",\"Say \"\"hi\"\", then leave\",\"0\"\r", "" };
+
+	std::vector<std::string> data = recordDao.parseRecords(lines);
+
+	REQUIRE(data.size() == 5);
+	CHECK(data[0] == "1970-01");
+	CHECK(data[1] == "Canada");
+	CHECK(data[2] == "");
+	CHECK(data[3] == "Say \"hi\", then leave");
+	CHECK(data[4] == "0");
+}
+
+TEST_CASE("Test that a whole file is read without the trim") {
+	RecordDAO recordDao{};
+	std::vector<RecordDTO> allRecords = recordDao.readRecordsFromFile("32100260.csv");
+	std::vector<RecordDTO> trimmedRecords = recordDao.getAllRecords();
+	REQUIRE(allRecords.size() > trimmedRecords.size());
+	CHECK(allRecords[0].getVector() == trimmedRecords[0].getVector());
+	CHECK(allRecords[99].getValue() == trimmedRecords[99].getValue());
+
+	/* Files written by writeToFile() have no header row */
+	recordDao.writeToFile(trimmedRecords, "Testing_Read_Records.csv");
+	std::vector<RecordDTO> rereadRecords = recordDao.readRecordsFromFile("Testing_Read_Records.csv");
+	REQUIRE(rereadRecords.size() == trimmedRecords.size());
+	CHECK(rereadRecords[0].getRefDate() == trimmedRecords[0].getRefDate());
+
+	CHECK_THROWS_AS(recordDao.readRecordsFromFile("No_Such_File.csv"), std::runtime_error);
+
+	/* A row with a missing cell is reported rather than shifting the rows after it */
+	std::ofstream malformedFile{ "Testing_Malformed_Records.csv" };
+	malformedFile << "\"1970-01\",\"Canada\",\"\",\"Potatoes\",\"\",\"\",\"\",\"\",\"\",\"v1\",\"\",\"5\",\"\",\"\",\"\",\"0\"\n"
+		<< "\"1970-02\",\"Canada\",\"Onions\"\n";
+	malformedFile.close();
+	try {
+		recordDao.readRecordsFromFile("Testing_Malformed_Records.csv");
+		FAIL("The malformed row was not reported");
+	}
+	catch (const std::runtime_error &error) {
+		CHECK(std::string{ error.what() }.find("row 2") != std::string::npos);
+	}
+
+	std::vector<std::string> cells{};
+	RecordDTO shortRecord{};
+	CHECK_FALSE(RecordDAO::parseRecordLine("\"1970-02\",\"Canada\"", cells, shortRecord));
+	CHECK(shortRecord.getGeo() == "Canada");
+	CHECK(shortRecord.getDecimals() == "");
+}
+
+TEST_CASE("Test that a table with any columns is read and appended to") {
+	RecordDAO recordDao{};
+	TableDTO table = recordDao.readTableFromFile("32100260.csv");
+	REQUIRE(table.columnCount() == RECORD_COLUMN_COUNT);
+	CHECK(table.getHeaders().front() == "REF_DATE");
+	CHECK(table.rowCount() == recordDao.readRecordsFromFile("32100260.csv").size());
+
+	/* Rows appended after the headers are read back as one table, and a short row is padded to the header count */
+	recordDao.writeTableToFile({ { "REF_DATE", "GEO", "PRICE" } }, "Testing_Append_Table.csv");
+	recordDao.appendTableToFile({ { "2020-01", "Canada", "1.5" } }, "Testing_Append_Table.csv");
+	recordDao.appendTableToFile({ { "2020-02", "Ontario" } }, "Testing_Append_Table.csv");
+	TableDTO appended = recordDao.readTableFromFile("Testing_Append_Table.csv");
+	REQUIRE(appended.rowCount() == 2);
+	CHECK(appended.findColumn("PRICE") == 2);
+	CHECK(appended.getRows()[1][1] == "Ontario");
+	CHECK(appended.getRows()[1][2] == "");
+
+	/* A table that cannot be written is reported instead of being lost */
+	CHECK_THROWS_AS(recordDao.writeTableToFile({ { "REF_DATE" } }, "No_Such_Folder/Testing_Table.csv"), std::runtime_error);
+	CHECK_THROWS_AS(recordDao.appendTableToFile({ { "2020-01" } }, "No_Such_Folder/Testing_Table.csv"), std::runtime_error);
+}
+
+TEST_CASE("Test that batched reading hands over the same records as getAllRecords") {
+	RecordDAO recordDao{};
+	std::vector<std::size_t> batchSizes{};
+	std::vector<RecordDTO> batchedRecords{};
+	std::size_t lastBytesRead{ 0 };
+	recordDao.readAllRecordsInBatches(30, [&](std::vector<RecordDTO> &&batch, std::size_t bytesRead, std::size_t totalBytes) {
+		batchSizes.push_back(batch.size());
+		CHECK(bytesRead > lastBytesRead);
+		CHECK(bytesRead <= totalBytes);
+		lastBytesRead = bytesRead;
+		std::move(batch.begin(), batch.end(), std::back_inserter(batchedRecords));
+	});
+
+	CHECK(batchSizes == std::vector<std::size_t>{ 30, 30, 30, 10 });
+	std::vector<RecordDTO> allRecords = recordDao.getAllRecords();
+	REQUIRE(batchedRecords.size() == allRecords.size());
+	CHECK(batchedRecords.front().getVector() == allRecords.front().getVector());
+	CHECK(batchedRecords.back().getValue() == allRecords.back().getValue());
+}
@@ -19,6 +19,9 @@
 
 #pragma once
 #include "RecordDTO.h"
+#include "TableDTO.h"
+#include <cstddef>
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -35,12 +38,21 @@ class RecordDAO
 */
 public:
 	/** @brief The CSV data set contains 16 columns. Used in getAllRecords() */
-	static const int NUM_OF_COLUMNS = 16;
+	static const int NUM_OF_COLUMNS = static_cast<int>(RECORD_COLUMN_COUNT);
 	static const int MAX_LIST_SIZE = 100;
 
-	/** @brief No-argument constructor */
+	/** @brief Receives each batch of records read by readAllRecordsInBatches(), with how many of the file's bytes have been read so far */
+	using RecordBatchCallback = std::function<void(std::vector<RecordDTO> &&batch, std::size_t bytesRead, std::size_t totalBytes)>;
+
+	/** @brief No-argument constructor. Reads the original data set. */
 	RecordDAO();
 
+	/**
+	 * @brief Creates an accessor that reads the data set from another file, such as a test file
+	 * @param dataSetPath the data set's path
+	*/
+	explicit RecordDAO(std::string dataSetPath);
+
 	/**
 	 * @brief Retrieves records from CSV file and returns a list of RecordDTO objects. Used in the main method to print results. 
 	 * @param filepath is the path to the file containing the CSV data set
@@ -48,12 +60,58 @@ public:
 	*/
 	std::vector<RecordDTO> getAllRecords();
 
+	/**
+	 * @brief Reads the same records as getAllRecords(), but hands them over a batch at a time as the file is read, so a caller can
+	 * use the first records before the rest are parsed
+	 * @param batchSize the most records in one batch
+	 * @param onBatch called on the reading thread with each batch, in file order
+	 * @throws std::runtime_error if the file cannot be opened
+	*/
+	void readAllRecordsInBatches(std::size_t batchSize, const RecordBatchCallback &onBatch);
+
 	/**
 	 * @brief Opens the specified CSV file and creates a vector of Strings. Each index value represents one row in the CSV file.
 	 * @return A vector containing the CSV file's rows
 	*/
 	std::vector<std::string> openFile();
 
+	/**
+	 * @brief Reads a CSV file into a vector of Strings. Each index value represents one row in the CSV file.
+	 * @param filePath the file to read
+	 * @return A vector containing the CSV file's rows
+	 * @throws std::runtime_error if the file cannot be opened
+	*/
+	std::vector<std::string> readLines(const std::string &filePath);
+
+	/**
+	 * @brief Reads every record of a CSV file laid out like the data set, such as a newer release of it or a file written
+	 * by writeToFile(). Unlike getAllRecords(), the list is not trimmed. A header row is skipped if the file has one.
+	 * Chunks of the file's rows are parsed on separate threads, each row on its own, so the records do not depend on how the rows are chunked.
+	 * @param filePath the file to read
+	 * @return the file's records, in file order
+	 * @throws std::runtime_error if the file cannot be opened or any row does not have exactly one cell per column
+	*/
+	std::vector<RecordDTO> readRecordsFromFile(const std::string &filePath);
+
+	/**
+	 * @brief Creates a RecordDTO from one CSV row laid out like the data set. A short row leaves its last columns empty and a long
+	 * row loses its extra cells, as in readTableFromFile().
+	 * @param line the row
+	 * @param cells a buffer for the row's cells, reused from row to row
+	 * @param record the record the row's cells are moved into
+	 * @return true if the row had exactly one cell per column
+	*/
+	static bool parseRecordLine(const std::string &line, std::vector<std::string> &cells, RecordDTO &record);
+
+	/**
+	 * @brief Reads a CSV file with any columns, such as another Statistics Canada table to join with the records. The first row is
+	 * taken as the headers and every row is given exactly one cell per header. Chunks of the file's rows are parsed on separate threads.
+	 * @param filePath the file to read
+	 * @return the table, in file order
+	 * @throws std::runtime_error if the file cannot be opened
+	*/
+	TableDTO readTableFromFile(const std::string &filePath);
+
 	/**
 	 * @brief Creates vector of RecordDTO instances
 	 * @param data A vector of strings containing the data used to create RecordDTO objects
@@ -77,7 +135,7 @@ public:
 	std::vector<RecordDTO> trimList(std::vector<RecordDTO> recordList, int MAX_LIST_SIZE);
 
 	/**
-	 * @brief Splits each record string into multiple parts using the comma delimiter
+	 * @brief Splits each record string into multiple parts using the comma delimiter. Commas inside quotes do not split, and the quotes around each cell are removed.
 	 * @param lines contains the records as comma-separated strings
 	 * @return a vector of strings. Each string represents one cell of data. Used to create RecordDTO objects.
 	*/
@@ -88,7 +146,27 @@ public:
 	 * @param recordsList a vector of RecordDTOs
 	 * @param newFileName the file name where the vector of RecordDTOs will be stored
 	*/
-	void writeToFile(std::vector<RecordDTO> recordsList, std::string newFileName);
+	void writeToFile(const std::vector<RecordDTO> &recordsList, const std::string &newFileName);
+
+	/**
+	 * @brief Writes a table of text, such as a group-by result, to a CSV file quoted the same way as the data set
+	 * @param table the rows to write, headers first
+	 * @param newFileName the file name where the table will be stored
+	 * @throws std::runtime_error if the file cannot be opened or written
+	*/
+	void writeTableToFile(const std::vector<std::vector<std::string>> &table, const std::string &newFileName);
+
+	/**
+	 * @brief Adds rows to the end of a CSV file, such as one batch of a join that is too large to hold in memory. The file is created if it does not exist.
+	 * @param table the rows to write
+	 * @param fileName the file the rows are added to
+	 * @throws std::runtime_error if the file cannot be opened or written
+	*/
+	void appendTableToFile(const std::vector<std::vector<std::string>> &table, const std::string &fileName);
+
+private:
+	/** The file getAllRecords(), readAllRecordsInBatches() and openFile() read */
+	std::string dataSetPath;
 };
 #endif // !RECORD_DAO_H
 
@@ -20,6 +20,8 @@
 
 #include "doctest.h"
 #include <iostream>
+#include <stdexcept>
+#include <utility>
 #include "RecordDTO.h"
 
 /**
@@ -51,198 +53,332 @@ RecordDTO::RecordDTO(std::string refDate, std::string geo, std::string dguid, st
 						std::string coordinate, std::string value, std::string status, std::string symbol, std::string terminated,
 						std::string decimals) {
 
-	RecordDTO::refDate		= refDate;
-	RecordDTO::geo			= geo;
-	RecordDTO::dguid		= dguid;
-	RecordDTO::productType	= productType;
-	RecordDTO::storageType	= storageType;
-	RecordDTO::uom			= uom;
-	RecordDTO::uomId		= uomId;
-	RecordDTO::scalarFactor	= scalarFactor;
-	RecordDTO::scalarId		= scalarId;
-	RecordDTO::vector		= vector;
-	RecordDTO::coordinate	= coordinate;
-	RecordDTO::value		= value;
-	RecordDTO::status		= status;
-	RecordDTO::symbol		= symbol;
-	RecordDTO::terminated	= terminated;
-	RecordDTO::decimals		= decimals;
+	set<RecordColumn::RefDate>(std::move(refDate));
+	set<RecordColumn::Geo>(std::move(geo));
+	set<RecordColumn::Dguid>(std::move(dguid));
+	set<RecordColumn::ProductType>(std::move(productType));
+	set<RecordColumn::StorageType>(std::move(storageType));
+	set<RecordColumn::Uom>(std::move(uom));
+	set<RecordColumn::UomId>(std::move(uomId));
+	set<RecordColumn::ScalarFactor>(std::move(scalarFactor));
+	set<RecordColumn::ScalarId>(std::move(scalarId));
+	set<RecordColumn::Vector>(std::move(vector));
+	set<RecordColumn::Coordinate>(std::move(coordinate));
+	set<RecordColumn::Value>(std::move(value));
+	set<RecordColumn::Status>(std::move(status));
+	set<RecordColumn::Symbol>(std::move(symbol));
+	set<RecordColumn::Terminated>(std::move(terminated));
+	set<RecordColumn::Decimals>(std::move(decimals));
 
 }
 
+/**
+ * @brief Copy constructor. The side allocation is copied too, so the two records never share cold columns.
+ * @param other the record to copy
+*/
+RecordDTO::RecordDTO(const RecordDTO &other)
+	: refDate(other.refDate), value(other.value), geo(other.geo), productType(other.productType),
+	storageType(other.storageType), uom(other.uom), scalarFactor(other.scalarFactor), vector(other.vector),
+	coordinate(other.coordinate), uomId(other.uomId), scalarId(other.scalarId), decimals(other.decimals),
+	cold(other.cold ? std::make_unique<ColdFields>(*other.cold) : nullptr) {}
+
+/**
+ * @brief Move constructor. The side allocation is taken over, so any inline column of the moved-from record that was
+ * spilled into it is emptied rather than left pointing at a side allocation that is gone.
+ * @param other the record to move
+*/
+RecordDTO::RecordDTO(RecordDTO &&other) noexcept
+	: refDate(other.refDate), value(other.value), geo(other.geo), productType(other.productType),
+	storageType(other.storageType), uom(other.uom), scalarFactor(other.scalarFactor), vector(other.vector),
+	coordinate(other.coordinate), uomId(other.uomId), scalarId(other.scalarId), decimals(other.decimals),
+	cold(std::move(other.cold)) {
+	other.clearSpilledValues();
+}
+
+/**
+ * @brief Move assignment. As with the move constructor, the moved-from record keeps no spilled columns.
+ * @param other the record to move
+ * @return this record
+*/
+RecordDTO &RecordDTO::operator=(RecordDTO &&other) noexcept {
+	if (this != &other) {
+		refDate = other.refDate;
+		value = other.value;
+		geo = other.geo;
+		productType = other.productType;
+		storageType = other.storageType;
+		uom = other.uom;
+		scalarFactor = other.scalarFactor;
+		vector = other.vector;
+		coordinate = other.coordinate;
+		uomId = other.uomId;
+		scalarId = other.scalarId;
+		decimals = other.decimals;
+		cold = std::move(other.cold);
+		other.clearSpilledValues();
+	}
+	return *this;
+}
+
+/**
+ * @brief Empties every inline column marked spilled, whose value was in a side allocation this record no longer has
+*/
+void RecordDTO::clearSpilledValues() {
+	auto clearIfSpilled = [](auto &inlineValue) { if (inlineValue.isSpilled()) inlineValue.clear(); };
+	clearIfSpilled(refDate);
+	clearIfSpilled(value);
+	clearIfSpilled(vector);
+	clearIfSpilled(coordinate);
+	clearIfSpilled(uomId);
+	clearIfSpilled(scalarId);
+	clearIfSpilled(decimals);
+}
+
+/**
+ * @brief Copy assignment. The side allocation is copied too, so the two records never share cold columns.
+ * @param other the record to copy
+ * @return this record
+*/
+RecordDTO &RecordDTO::operator=(const RecordDTO &other) {
+	if (this != &other) {
+		RecordDTO copy{ other };
+		*this = std::move(copy);
+	}
+	return *this;
+}
+
 /**
  * @brief the date the record was recorded
  * @return the date the record was recorded
 */
-std::string RecordDTO::getRefDate()				{ return RecordDTO::refDate; }
+std::string_view RecordDTO::getRefDate() const				{ return get<RecordColumn::RefDate>(); }
 /**
  * @brief the location where the record was recorded
  * @return the location where the record was recorded
 */
-std::string RecordDTO::getGeo()					{ return RecordDTO::geo; }
+std::string_view RecordDTO::getGeo() const					{ return get<RecordColumn::Geo>(); }
 /**
  * @brief the Dissemination Geography Unique Identifier [4]
  * @return the dguid
-*/std::string RecordDTO::getDguid()				{ return RecordDTO::dguid; }
+*/std::string_view RecordDTO::getDguid() const				{ return get<RecordColumn::Dguid>(); }
 /**
  * @brief the type of vegetable
  * @return the type of vegetable
 */
-std::string RecordDTO::getProductType()			{ return RecordDTO::productType; }
+std::string_view RecordDTO::getProductType() const			{ return get<RecordColumn::ProductType>(); }
 /**
  * @brief the storage type
  * @return the storage type
 */
-std::string RecordDTO::getStorageType()			{ return RecordDTO::storageType; }
+std::string_view RecordDTO::getStorageType() const			{ return get<RecordColumn::StorageType>(); }
 /**
  * @brief the unit of measurement
  * @return the unit of measurement 
 */
-std::string RecordDTO::getUom()					{ return RecordDTO::uom; }
+std::string_view RecordDTO::getUom() const					{ return get<RecordColumn::Uom>(); }
 /**
  * @brief the unit of measurement's ID
  * @return the unit of measurement's ID 
 */
-std::string RecordDTO::getUomId()				{ return RecordDTO::uomId; }
+std::string_view RecordDTO::getUomId() const				{ return get<RecordColumn::UomId>(); }
 /**
  * @brief the record's scalar factor
  * @return the record's scalar factor 
 */
-std::string RecordDTO::getScalarFactor()		{ return RecordDTO::scalarFactor; }
+std::string_view RecordDTO::getScalarFactor() const		{ return get<RecordColumn::ScalarFactor>(); }
 /**
  * @brief the record's scalar ID
  * @return the record's scalar ID 
 */
-std::string RecordDTO::getScalarId()			{ return RecordDTO::scalarId; }
+std::string_view RecordDTO::getScalarId() const			{ return get<RecordColumn::ScalarId>(); }
 /**
  * @brief the record's spatial representation in vector format
  * @return the record's spatial representation in vector format 
 */
-std::string RecordDTO::getVector()				{ return RecordDTO::vector; }
+std::string_view RecordDTO::getVector() const				{ return get<RecordColumn::Vector>(); }
 /**
  * @brief the location where the record was taken 
  * @return the location where the record was taken 
 */
-std::string	RecordDTO::getCoordinate()			{ return RecordDTO::coordinate; }
+std::string_view RecordDTO::getCoordinate() const			{ return get<RecordColumn::Coordinate>(); }
 /**
  * @brief the record's value
  * @return the record's value 
 */
-std::string	RecordDTO::getValue()				{ return RecordDTO::value; }
+std::string_view RecordDTO::getValue() const				{ return get<RecordColumn::Value>(); }
 /**
  * @brief the record's status
  * @return the record's status 
 */
-std::string RecordDTO::getStatus()				{ return RecordDTO::status; }
+std::string_view RecordDTO::getStatus() const				{ return get<RecordColumn::Status>(); }
 /**
  * @brief the record's symbol
  * @return the record's symbol 
 */
-std::string RecordDTO::getSymbol()				{ return RecordDTO::symbol; }
+std::string_view RecordDTO::getSymbol() const				{ return get<RecordColumn::Symbol>(); }
 /**
  * @brief the record's terminated status
  * @return the record's terminated status 
 */
-std::string RecordDTO::getTerminated()			{ return RecordDTO::terminated; }
+std::string_view RecordDTO::getTerminated() const			{ return get<RecordColumn::Terminated>(); }
 /**
  * @brief the number of decimals in the record
  * @return the number of decimals in the record 
 */
-std::string	RecordDTO::getDecimals()			{ return RecordDTO::decimals; }
+std::string_view RecordDTO::getDecimals() const			{ return get<RecordColumn::Decimals>(); }
 
 /**
 * Sets a new reference date. Used in RecordDAO to create a RecordDTO.
 * @return void
 */
 //RecordDTO RecordDTO::setRefDate(std::string date) { refDate = date; return *this; }
-void RecordDTO::setRefDate(std::string date)					{ refDate = date; }
+void RecordDTO::setRefDate(std::string date)					{ set<RecordColumn::RefDate>(std::move(date)); }
 /**
 * Sets a new geographic location. Used in RecordDAO to create a RecordDTO.
 * @return void
 */
-void RecordDTO::setGeo(std::string newGeo)						{ geo = newGeo; };
+void RecordDTO::setGeo(std::string newGeo)						{ set<RecordColumn::Geo>(std::move(newGeo)); };
 /**
 * Sets a new DGUID. Used in RecordDAO to create a RecordDTO.
 * @return void
 */
-void RecordDTO::setDguid(std::string newDguid)					{ dguid = newDguid; }
+void RecordDTO::setDguid(std::string newDguid)					{ set<RecordColumn::Dguid>(std::move(newDguid)); }
 /**
 * Sets a new product type. Used in RecordDAO to create a RecordDTO.
 * @return void
 */
-void RecordDTO::setProductType(std::string newProductType)		{ productType = newProductType; }
+void RecordDTO::setProductType(std::string newProductType)		{ set<RecordColumn::ProductType>(std::move(newProductType)); }
 /**
 * Sets a new storage type. Used in RecordDAO to create a RecordDTO.
 * @return void
 */
-void RecordDTO::setStorageType(std::string newStorageType)		{ storageType = newStorageType; }
+void RecordDTO::setStorageType(std::string newStorageType)		{ set<RecordColumn::StorageType>(std::move(newStorageType)); }
 /**
 * Sets a new unit of measurement. Used in RecordDAO to create a RecordDTO.
 * @return void
 */
-void RecordDTO::setUom(std::string newUom)						{ uom = newUom; }
+void RecordDTO::setUom(std::string newUom)						{ set<RecordColumn::Uom>(std::move(newUom)); }
 /**
 * Sets a new unit of measurement ID. Used in RecordDAO to create a RecordDTO.
 * @return void
 */
-void RecordDTO::setUomId(std::string newUomId)					{ uomId = newUomId; }
+void RecordDTO::setUomId(std::string newUomId)					{ set<RecordColumn::UomId>(std::move(newUomId)); }
 /**
 * Sets a new scalar factor. Used in RecordDAO to create a RecordDTO.
 * @return void
 */
-void RecordDTO::setScalarFactor(std::string newScalarFactor)	{ scalarFactor = newScalarFactor; }
+void RecordDTO::setScalarFactor(std::string newScalarFactor)	{ set<RecordColumn::ScalarFactor>(std::move(newScalarFactor)); }
 /**
 * Sets a new scalar factor ID. Used in RecordDAO to create a RecordDTO.
 * @return void
 */
-void RecordDTO::setScalarId(std::string newScalarId)			{ scalarId = newScalarId; }
+void RecordDTO::setScalarId(std::string newScalarId)			{ set<RecordColumn::ScalarId>(std::move(newScalarId)); }
 /**
 * Sets a new vector. Used in RecordDAO to create a RecordDTO.
 * @return void
 */
-void RecordDTO::setVector(std::string newVector)				{ vector = newVector; }
+void RecordDTO::setVector(std::string newVector)				{ set<RecordColumn::Vector>(std::move(newVector)); }
 /**
 * Sets a new coordinate. Used in RecordDAO to create a RecordDTO.
 * @return void
 */
-void RecordDTO::setCoordinate(std::string newCoordinate)		{ coordinate = newCoordinate; }
+void RecordDTO::setCoordinate(std::string newCoordinate)		{ set<RecordColumn::Coordinate>(std::move(newCoordinate)); }
 /**
 * Sets a new value. Used in RecordDAO to create a RecordDTO.
 * @return void
 */
-void RecordDTO::setValue(std::string newValue)					{ value = newValue; }
+void RecordDTO::setValue(std::string newValue)					{ set<RecordColumn::Value>(std::move(newValue)); }
 /**
 * Sets a new status. Used in RecordDAO to create a RecordDTO.
 * @return void
 */
-void RecordDTO::setStatus(std::string newStatus)				{ status = newStatus; }
+void RecordDTO::setStatus(std::string newStatus)				{ set<RecordColumn::Status>(std::move(newStatus)); }
 /**
 * Sets a new symbol. Used in RecordDAO to create a RecordDTO.
 * @return void
 */
-void RecordDTO::setSymbol(std::string newSymbol)				{ symbol = newSymbol; }
+void RecordDTO::setSymbol(std::string newSymbol)				{ set<RecordColumn::Symbol>(std::move(newSymbol)); }
 /**
 * Sets a new terminated status. Used in RecordDAO to create a RecordDTO.
 * @return void
 */
-void RecordDTO::setTerminated(std::string newTerminated)		{ terminated = newTerminated; }
+void RecordDTO::setTerminated(std::string newTerminated)		{ set<RecordColumn::Terminated>(std::move(newTerminated)); }
 /**
 * Sets a new decimals. Used in RecordDAO to create a RecordDTO.
 * @return void
 */
-void RecordDTO::setDecimals(std::string newDecimals)			{ decimals = newDecimals; }
+void RecordDTO::setDecimals(std::string newDecimals)			{ set<RecordColumn::Decimals>(std::move(newDecimals)); }
+
+/**
+ * @brief Reads a column chosen at run time
+ * @param column the column to read
+ * @return a view of the column's value
+*/
+std::string_view RecordDTO::get(RecordColumn column) const {
+	return visitColumn(column, [this](auto columnConstant) { return get<decltype(columnConstant)::value>(); });
+}
+
+/**
+ * @brief Replaces a column chosen at run time. Used by the RecordDAO's parser and the console's update menu.
+ * @param column the column to replace
+ * @param newValue the column's new value
+*/
+void RecordDTO::set(RecordColumn column, std::string newValue) {
+	visitColumn(column, [this, &newValue](auto columnConstant) { set<decltype(columnConstant)::value>(std::move(newValue)); });
+}
+
+/**
+ * @brief Reads the dictionary code of a dictionary column chosen at run time
+ * @param column a column stored as ColumnStorage::Dictionary
+ * @return the column's code
+*/
+std::uint32_t RecordDTO::code(RecordColumn column) const {
+	return visitColumn(column, [this](auto columnConstant) -> std::uint32_t {
+		if constexpr (columnInfo(decltype(columnConstant)::value).storage == ColumnStorage::Dictionary) {
+			return code<decltype(columnConstant)::value>();
+		}
+		else {
+			throw std::invalid_argument("Only dictionary columns have codes.");
+		}
+	});
+}
+
+/**
+ * @brief The dictionary shared by every record for a dictionary column chosen at run time
+ * @param column a column stored as ColumnStorage::Dictionary
+ * @return the column's dictionary
+*/
+StringDictionary &RecordDTO::dictionary(RecordColumn column) {
+	return visitColumn(column, [](auto columnConstant) -> StringDictionary & {
+		if constexpr (columnInfo(decltype(columnConstant)::value).storage == ColumnStorage::Dictionary) {
+			return dictionary<decltype(columnConstant)::value>();
+		}
+		else {
+			throw std::invalid_argument("Only dictionary columns have a dictionary.");
+		}
+	});
+}
+
+/**
+ * @brief Returns the side allocation for cold columns, making it the first time a cold value is stored
+ * @return the side allocation
+*/
+RecordDTO::ColdFields &RecordDTO::coldFields() {
+	if (!cold) {
+		cold = std::make_unique<ColdFields>();
+	}
+	return *cold;
+}
 
 /** 
  * Prints a formatted RecordDTO's information. Used in main() to print a specified number of records.  
  * @return void
  */
-void RecordDTO::printRecord() {
-		std::cout << "RefDate:\t\t" << getRefDate() << "\nGeo:\t\t\t" << getGeo() << "\nDGUID:\t\t\t" << getDguid()
-			<< "\nProduct Type:\t\t" << getProductType() << "\nStorage Type:\t\t" << getStorageType() << "\nUnit of Measurement:\t"
-			<< getUom() << "\nUnit of Measurement ID: " << getUomId() << "\nScalar Factor:\t\t" << getScalarFactor() << "\nScalar ID:\t\t"
-			<< getScalarId() << "\nVector:\t\t\t" << getVector() << "\nCoordinate:\t\t" << getCoordinate() << "\nValue:\t\t\t" << getValue()
-			<< "\nStatus:\t\t\t" << getStatus() << "\nSymbol:\t\t\t" << getSymbol() << "\nTerminated:\t\t" << getTerminated()
-			<< "\nDecimals:\t\t" << getDecimals() << std::endl << std::endl;
+void RecordDTO::printRecord() const {
+	for (const ColumnInfo &columnInfo : RECORD_COLUMNS) {
+		std::cout << columnInfo.printLabel << get(columnInfo.column) << "\n";
+	}
+	std::cout << std::endl;
 }
 
 TEST_CASE("Test parameterized RecordDTO's constructor") {
@@ -327,3 +463,79 @@ TEST_CASE("Test no-argument DTO's default instance variable values") {
 	CHECK(noArgsRecordDto.getTerminated()	== "");
 	CHECK(noArgsRecordDto.getDecimals()		== "");
 }
+
+
+TEST_CASE("Test that DTO's accessors return views into the record without copying") {
+	RecordDTO recordDto{};
+	std::string newDguid = "A DGUID long enough to need a heap allocation";
+	const char *newDguidBuffer = newDguid.data();
+
+	/* Moving a string into the modifier hands its buffer over instead of copying it */
+	recordDto.setDguid(std::move(newDguid));
+
+	CHECK(recordDto.getDguid().data() == newDguidBuffer);
+	CHECK(recordDto.getDguid().data() == recordDto.getDguid().data());
+	CHECK(recordDto.getDguid() == "A DGUID long enough to need a heap allocation");
+}
+
+TEST_CASE("Test that DTO's column accessors match the named accessors") {
+	RecordDTO recordDto("1979-10-01", "Canada", "", "Onions", "Cold and common storage", "Tonnes", "288", "units", "0", "v722359", "2.4.1", "0", "", "", "", "0");
+
+	CHECK(recordDto.get(RecordColumn::ProductType)			== recordDto.getProductType());
+	CHECK(recordDto.get<RecordColumn::Vector>()				== recordDto.getVector());
+
+	/* Replacing a column by its id only changes that column */
+	recordDto.set(RecordColumn::ProductType, "Carrots");
+	CHECK(recordDto.getProductType()	== "Carrots");
+	CHECK(recordDto.getRefDate()		== "1979-10-01");
+
+	for (const ColumnInfo &columnInfo : RECORD_COLUMNS) {
+		recordDto.set(columnInfo.column, columnInfo.header);
+		CHECK(recordDto.get(columnInfo.column) == columnInfo.header);
+	}
+}
+
+TEST_CASE("Test DTO's compact layout") {
+	/* The hot columns fit in HOT_BYTES, and records tile cache lines without a hot block straddling two of them */
+	CHECK(sizeof(RecordDTO) <= 3 * RecordDTO::HOT_BYTES);
+	CHECK(alignof(RecordDTO) == RecordDTO::HOT_BYTES);
+	CHECK(sizeof(RecordDTO) % RecordDTO::HOT_BYTES == 0);
+
+	/* A typical row never makes the side allocation */
+	RecordDTO typicalRecord("1970-01", "Canada", "", "Potatoes", "Cold and common storage", "Tonnes", "288", "units ", "0", "v722342", "1.1.1", "1041", "", "", "", "0");
+	CHECK_FALSE(typicalRecord.hasColdFields());
+
+	/* Values too long to store in place, and cold values, survive a copy */
+	typicalRecord.setVector("a vector code far longer than the inline width");
+	typicalRecord.setStatus("x");
+	RecordDTO copy{ typicalRecord };
+	typicalRecord.setVector("v1");
+
+	CHECK(copy.hasColdFields());
+	CHECK(copy.getVector() == "a vector code far longer than the inline width");
+	CHECK(copy.getStatus() == "x");
+	CHECK(typicalRecord.getVector() == "v1");
+
+	/* Records with the same dictionary value share its code */
+	RecordDTO otherRecord{};
+	otherRecord.setGeo("Canada");
+	CHECK(otherRecord.code<RecordColumn::Geo>() == typicalRecord.code(RecordColumn::Geo));
+	CHECK(RecordDTO::dictionary(RecordColumn::Geo).lookup(otherRecord.code<RecordColumn::Geo>()) == "Canada");
+}
+TEST_CASE("Test that a moved-from DTO can still be read after its spilled columns move away") {
+	RecordDTO recordDto{};
+	recordDto.setRefDate("A date far too long to store in place");
+	recordDto.setStatus("Revised");
+
+	RecordDTO movedTo{ std::move(recordDto) };
+	CHECK(movedTo.getRefDate() == "A date far too long to store in place");
+	CHECK(recordDto.getRefDate() == "");
+	CHECK(recordDto.getStatus() == "");
+
+	RecordDTO assigned{};
+	assigned = std::move(movedTo);
+	CHECK(assigned.getRefDate() == "A date far too long to store in place");
+	CHECK(movedTo.getRefDate() == "");
+	movedTo.setRefDate("1976-01");
+	CHECK(movedTo.getRefDate() == "1976-01");
+}
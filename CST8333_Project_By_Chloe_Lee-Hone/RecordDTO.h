@@ -18,51 +18,68 @@
 */
 
 #pragma once
+#include <array>
+#include <cstdint>
 #include <iostream>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <format>
+#include <utility>
+#include "InlineString.h"
+#include "RecordColumn.h"
+#include "StringDictionary.h"
 #include "doctest.h"
 
 #ifndef RECORD_DTO_H
 #define RECORD_DTO_H
 /**
 * RecordDTO class is used by the RecordDAO class to store a record retrieved from the Open Government database.
+* 
+* Each column is stored the way RECORD_COLUMNS says: short codes in place, repeated text as a StringDictionary code, and the
+* columns that are nearly always empty in a side allocation that most records never make. The hot columns read by sorting
+* and lookups (date, value, location, product) form the first HOT_BYTES of the record. The record is aligned to HOT_BYTES
+* and its size is a multiple of it, so in a vector of records the hot columns never straddle a cache line.
 */
-class RecordDTO {
+class alignas(32) RecordDTO {
 // STUDENT NAME: CHLOE LEE-HONE
+public:
+	/** @brief The size of the block of hot columns at the start of every record */
+	static constexpr std::size_t HOT_BYTES = 32;
+
 private:
+	/** @brief Holds the cold columns and any inline column whose value was too long to store in place */
+	struct ColdFields {
+		std::array<std::string, RECORD_COLUMN_COUNT> values{};
+	};
+
 	/** @brief stores the reference date */
-	std::string refDate{};
+	InlineString<11> refDate{};
+	/** @brief stores the record's value */
+	InlineString<11> value{};
 	/** @brief stores the record's location */
-	std::string geo{};
-	/** @brief stores the DGUID */
-	std::string dguid{};
+	std::uint32_t geo{ StringDictionary::EMPTY_CODE };
 	/** @brief stores the product type */
-	std::string productType{};
+	std::uint32_t productType{ StringDictionary::EMPTY_CODE };
+
 	/** @brief stores the storage type */
-	std::string storageType{};
+	std::uint32_t storageType{ StringDictionary::EMPTY_CODE };
 	/** @brief stores the unit of measurement */
-	std::string uom{};
-	/** @brief stores the unit of measurement's ID */
-	std::string uomId{};
+	std::uint32_t uom{ StringDictionary::EMPTY_CODE };
 	/** @brief stores the record's scalar factor */
-	std::string scalarFactor{};
-	/** @brief stores the record's scalar ID */
-	std::string scalarId{};
+	std::uint32_t scalarFactor{ StringDictionary::EMPTY_CODE };
 	/** @brief stores the record's location as a vector */
-	std::string vector{};
+	InlineString<11> vector{};
 	/** @brief stores the record's location as a coordinate */
-	std::string coordinate{};
-	/** @brief stores the record's value */
-	std::string	value{};
-	/** @brief stores the record's status */
-	std::string	status{};
-	/** @brief stores the record's symbol */
-	std::string	symbol{};
-	/** @brief stores the record's terminated status */
-	std::string terminated{};
+	InlineString<11> coordinate{};
+	/** @brief stores the unit of measurement's ID */
+	InlineString<7> uomId{};
+	/** @brief stores the record's scalar ID */
+	InlineString<3> scalarId{};
 	/** @brief stores the record's decimals */
-	std::string decimals{};
+	InlineString<3> decimals{};
+	/** @brief stores the DGUID, status, symbol and terminated status. Null while they are all empty. */
+	std::unique_ptr<ColdFields> cold{};
 
 public:
 	/**
@@ -106,25 +123,32 @@ public:
 				std::string terminated, 
 				std::string decimal);
 	
-	/** Accessor declarations */
-	std::string getRefDate();
-	std::string getGeo();
-	std::string getDguid();
-	std::string getProductType();
-	std::string getStorageType();
-	std::string getUom();
-	std::string getUomId();
-	std::string getScalarFactor();
-	std::string getScalarId();
-	std::string getVector();
-	std::string	getCoordinate();
-	std::string	getValue();
-	std::string getStatus();
-	std::string getSymbol();
-	std::string getTerminated();
-	std::string	getDecimals();
-
-	/** Modifier declarations */
+	/** @brief Copies the record, including its cold columns */
+	RecordDTO(const RecordDTO &other);
+	RecordDTO &operator=(const RecordDTO &other);
+	/** @brief Moves the record. The moved-from record is left with its inline columns and no cold columns, none of them spilled. */
+	RecordDTO(RecordDTO &&other) noexcept;
+	RecordDTO &operator=(RecordDTO &&other) noexcept;
+
+	/** Accessor declarations. Views are only valid while this RecordDTO is alive and unmodified. */
+	std::string_view getRefDate() const;
+	std::string_view getGeo() const;
+	std::string_view getDguid() const;
+	std::string_view getProductType() const;
+	std::string_view getStorageType() const;
+	std::string_view getUom() const;
+	std::string_view getUomId() const;
+	std::string_view getScalarFactor() const;
+	std::string_view getScalarId() const;
+	std::string_view getVector() const;
+	std::string_view getCoordinate() const;
+	std::string_view getValue() const;
+	std::string_view getStatus() const;
+	std::string_view getSymbol() const;
+	std::string_view getTerminated() const;
+	std::string_view getDecimals() const;
+
+	/** Modifier declarations. Arguments are taken by value and moved into place, so callers can hand over temporaries without a copy. */
 	void setRefDate			(std::string newRefDate);
 	void setGeo				(std::string newGeo);
 	void setDguid			(std::string newDguid);
@@ -142,10 +166,140 @@ public:
 	void setTerminated		(std::string newTerminated);
 	void setDecimals		(std::string newDecimals);
 
+	/**
+	 * @brief Reads a column chosen at compile time. Compiles down to a member access, plus a dictionary lookup for dictionary columns.
+	 * @return a view of the column's value
+	*/
+	template <RecordColumn Column>
+	std::string_view get() const {
+		constexpr ColumnStorage storage = columnInfo(Column).storage;
+		if constexpr (storage == ColumnStorage::Dictionary) {
+			return dictionary<Column>().lookup(field<Column>(*this));
+		}
+		else if constexpr (storage == ColumnStorage::Inline) {
+			const auto &inlineValue = field<Column>(*this);
+			return inlineValue.isSpilled() ? std::string_view{ cold->values[columnIndex(Column)] } : inlineValue.view();
+		}
+		else {
+			return cold ? std::string_view{ cold->values[columnIndex(Column)] } : std::string_view{};
+		}
+	}
+
+	/**
+	 * @brief Reads a column chosen at run time
+	 * @param column the column to read
+	 * @return a view of the column's value
+	*/
+	std::string_view get(RecordColumn column) const;
+
+	/**
+	 * @brief Replaces a column chosen at compile time. Cold values, and inline values too long to store in place, are moved into the side allocation.
+	 * @param newValue the column's new value
+	*/
+	template <RecordColumn Column>
+	void set(std::string newValue) {
+		constexpr ColumnStorage storage = columnInfo(Column).storage;
+		if constexpr (storage == ColumnStorage::Dictionary) {
+			field<Column>(*this) = dictionary<Column>().intern(newValue);
+		}
+		else if constexpr (storage == ColumnStorage::Inline) {
+			auto &inlineValue = field<Column>(*this);
+			if (inlineValue.isSpilled()) {
+				cold->values[columnIndex(Column)].clear();
+			}
+			if (inlineValue.fits(newValue)) {
+				inlineValue.assign(newValue);
+			}
+			else {
+				coldFields().values[columnIndex(Column)] = std::move(newValue);
+				inlineValue.markSpilled();
+			}
+		}
+		else if (cold || !newValue.empty()) {
+			coldFields().values[columnIndex(Column)] = std::move(newValue);
+		}
+	}
+
+	/**
+	 * @brief Replaces a column chosen at run time. Used by the RecordDAO's parser and the console's update menu.
+	 * @param column the column to replace
+	 * @param newValue the column's new value
+	*/
+	void set(RecordColumn column, std::string newValue);
+
+	/**
+	 * @brief Reads the dictionary code of a dictionary column. Codes compare equal exactly when the values do.
+	 * @return the column's code in dictionary<Column>()
+	*/
+	template <RecordColumn Column>
+	std::uint32_t code() const {
+		static_assert(columnInfo(Column).storage == ColumnStorage::Dictionary, "only dictionary columns have codes");
+		return field<Column>(*this);
+	}
+
+	/**
+	 * @brief Reads the dictionary code of a dictionary column chosen at run time
+	 * @param column a column stored as ColumnStorage::Dictionary
+	 * @return the column's code
+	*/
+	std::uint32_t code(RecordColumn column) const;
+
+	/**
+	 * @brief The dictionary shared by every record for a dictionary column
+	 * @return the column's dictionary
+	*/
+	template <RecordColumn Column>
+	static StringDictionary &dictionary() {
+		static_assert(columnInfo(Column).storage == ColumnStorage::Dictionary, "only dictionary columns have a dictionary");
+		static StringDictionary columnDictionary{};
+		return columnDictionary;
+	}
+
+	/**
+	 * @brief The dictionary shared by every record for a dictionary column chosen at run time
+	 * @param column a column stored as ColumnStorage::Dictionary
+	 * @return the column's dictionary
+	*/
+	static StringDictionary &dictionary(RecordColumn column);
+
+	/** @return true if this record has made its side allocation for cold columns */
+	bool hasColdFields() const { return cold != nullptr; }
+
 	/**
 	 * @brief Prints a formatted RecordDTO's information. Used in main() to print a specified number of records. 
 	*/
-	void printRecord();
+	void printRecord() const;
+
+private:
+	/**
+	 * @brief Maps an inline or dictionary column to the member that stores it. This is the only place the mapping is spelled out.
+	 * @param self the RecordDTO, const or not
+	 * @return a reference to the column's member
+	*/
+	template <RecordColumn Column, typename Self>
+	static auto &field(Self &self) {
+		if constexpr (Column == RecordColumn::RefDate)			return self.refDate;
+		else if constexpr (Column == RecordColumn::Geo)			return self.geo;
+		else if constexpr (Column == RecordColumn::ProductType)	return self.productType;
+		else if constexpr (Column == RecordColumn::StorageType)	return self.storageType;
+		else if constexpr (Column == RecordColumn::Uom)			return self.uom;
+		else if constexpr (Column == RecordColumn::UomId)		return self.uomId;
+		else if constexpr (Column == RecordColumn::ScalarFactor)	return self.scalarFactor;
+		else if constexpr (Column == RecordColumn::ScalarId)		return self.scalarId;
+		else if constexpr (Column == RecordColumn::Vector)		return self.vector;
+		else if constexpr (Column == RecordColumn::Coordinate)	return self.coordinate;
+		else if constexpr (Column == RecordColumn::Value)		return self.value;
+		else {
+			static_assert(Column == RecordColumn::Decimals, "cold columns have no member of their own");
+			return self.decimals;
+		}
+	}
+
+	/** @return the side allocation, making it if needed */
+	ColdFields &coldFields();
+
+	/** @brief Empties every inline column marked spilled, whose value was in a side allocation this record no longer has */
+	void clearSpilledValues();
 };
 #endif // !RECORD_DTO_H
 
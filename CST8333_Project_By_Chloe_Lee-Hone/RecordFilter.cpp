@@ -0,0 +1,278 @@
+/**
+* @file				RecordFilter.cpp
+* @author			Chloe Lee-Hone<leeh0002@algonquinlive.com>
+* @version			1.0
+* @section			This file contains the RecordFilter class used by RecordService to select the records that match a predicate tree.
+*					This project contains information licensed under the Open Government Licence  Canada [1][2]. Code structure was informed by the provided example written by Stanley Pieda for CST8333 [3].
+*
+* Student Name:     Chloe Lee-Hone
+* Student Number:   041023578
+* Course:           CST8333_350: Programming Language Research Project
+* Professor:        Reg Dyer
+* Date:             05/06/2023
+*
+* References:
+* [1]   T. B. of C. Secretariat and T. B. S. of C. Open Government, Open Government Licence - Canada. http://open.canada.ca/en/open-government-licence-canada (accessed May 11, 2023).
+* [2]	T. B. of C. Secretariat and Open Government Portal, Vegetables in cold and common storage, Oct. 10, 2008. https://open.canada.ca/data/en/dataset/473f9524-45f8-47d0-9a12-537bb7704089 (accessed May 16, 2023).
+* [3]	S. Pieda, CST8333 19F Practical Project 2 Example Layered. Algonquin College, Algonquin College, Jun. 07, 2022. [Online]. Available: https://brightspace.algonquincollege.com/d2l/le/content/543581/viewContent/8322468/View
+*/
+
+#include "RecordFilter.h"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include "ParallelRange.h"
+#include "doctest.h"
+
+/**
+ * @brief Keeps the rows of a selection that pass a test. Chunks of the selection are tested on separate threads, and their
+ * results are joined in chunk order so the rows stay ascending. The loop writes every row and only advances past the ones that
+ * pass, so it does not branch on the test.
+ * @param selection the rows to test, in ascending order
+ * @param test a callable taking (std::size_t position) that tests selection[position]
+ * @return the rows that passed, in ascending order
+*/
+template <typename Test>
+static std::vector<RecordFilter::RowId> selectWhere(const std::vector<RecordFilter::RowId> &selection, const Test &test) {
+	std::vector<std::vector<RecordFilter::RowId>> chunkRows(parallelChunkCount(selection.size()));
+
+	forEachChunk(selection.size(), [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+		std::vector<RecordFilter::RowId> &rows = chunkRows[chunk];
+		rows.resize(end - begin);
+		std::size_t count{ 0 };
+		for (std::size_t position = begin; position < end; position++) {
+			rows[count] = selection[position];
+			count += test(position) ? 1 : 0;
+		}
+		rows.resize(count);
+	});
+
+	std::vector<RecordFilter::RowId> selectedRows = std::move(chunkRows.front());
+	for (std::size_t chunk = 1; chunk < chunkRows.size(); chunk++) {
+		selectedRows.insert(selectedRows.end(), chunkRows[chunk].begin(), chunkRows[chunk].end());
+	}
+	return selectedRows;
+}
+
+RecordFilter::RecordFilter(Operation operation, RecordColumn column, std::vector<std::string> values)
+	: operation{ operation }, column{ column }, values{ std::move(values) } {
+	if (operation == Operation::In) {
+		std::sort(RecordFilter::values.begin(), RecordFilter::values.end());
+	}
+
+	if (isOrdering()) {
+		std::vector<double> bounds{};
+		for (const std::string &value : RecordFilter::values) {
+			bounds.push_back(readNumericValue(value));
+			if (std::isnan(bounds.back())) {
+				throw std::invalid_argument("Numeric columns can only be compared with numbers.");
+			}
+		}
+
+		// Every ordering predicate becomes an inclusive range, so a single comparison loop serves them all
+		constexpr double INFINITE = std::numeric_limits<double>::infinity();
+		switch (operation) {
+		case Operation::Less:			low = -INFINITE;	high = std::nextafter(bounds[0], -INFINITE);	break;
+		case Operation::LessOrEqual:	low = -INFINITE;	high = bounds[0];								break;
+		case Operation::Greater:		low = std::nextafter(bounds[0], INFINITE);	high = INFINITE;		break;
+		case Operation::GreaterOrEqual:	low = bounds[0];	high = INFINITE;								break;
+		default:						low = bounds[0];	high = bounds[1];								break;
+		}
+	}
+}
+
+/** Factory methods. Each predicate stores its operands in values. */
+RecordFilter RecordFilter::equals(RecordColumn column, std::string value) { return RecordFilter{ Operation::Equal, column, { std::move(value) } }; }
+RecordFilter RecordFilter::lessThan(RecordColumn column, std::string value) { return RecordFilter{ Operation::Less, column, { std::move(value) } }; }
+RecordFilter RecordFilter::lessOrEqual(RecordColumn column, std::string value) { return RecordFilter{ Operation::LessOrEqual, column, { std::move(value) } }; }
+RecordFilter RecordFilter::greaterThan(RecordColumn column, std::string value) { return RecordFilter{ Operation::Greater, column, { std::move(value) } }; }
+RecordFilter RecordFilter::greaterOrEqual(RecordColumn column, std::string value) { return RecordFilter{ Operation::GreaterOrEqual, column, { std::move(value) } }; }
+RecordFilter RecordFilter::between(RecordColumn column, std::string low, std::string high) { return RecordFilter{ Operation::Between, column, { std::move(low), std::move(high) } }; }
+RecordFilter RecordFilter::isIn(RecordColumn column, std::vector<std::string> values) { return RecordFilter{ Operation::In, column, std::move(values) }; }
+RecordFilter RecordFilter::startsWith(RecordColumn column, std::string prefix) { return RecordFilter{ Operation::Prefix, column, { std::move(prefix) } }; }
+
+RecordFilter RecordFilter::allOf(std::vector<RecordFilter> filters) {
+	RecordFilter filter{ Operation::And, RecordColumn::RefDate, {} };
+	filter.children = std::move(filters);
+	return filter;
+}
+
+RecordFilter RecordFilter::anyOf(std::vector<RecordFilter> filters) {
+	RecordFilter filter{ Operation::Or, RecordColumn::RefDate, {} };
+	filter.children = std::move(filters);
+	return filter;
+}
+
+RecordFilter RecordFilter::negate(RecordFilter negatedFilter) {
+	RecordFilter filter{ Operation::Not, RecordColumn::RefDate, {} };
+	filter.children.push_back(std::move(negatedFilter));
+	return filter;
+}
+
+/**
+ * @return true for the predicates that compare numeric columns as numbers
+*/
+bool RecordFilter::isOrdering() const {
+	bool isOrderingOperation = operation == Operation::Less || operation == Operation::LessOrEqual || operation == Operation::Greater
+		|| operation == Operation::GreaterOrEqual || operation == Operation::Between;
+	return isOrderingOperation && columnInfo(column).isNumeric;
+}
+
+/**
+ * @brief Tests a text value against the predicate
+ * @param value the column's value
+ * @return true if the value satisfies the predicate
+*/
+bool RecordFilter::matchesText(std::string_view value) const {
+	switch (operation) {
+	case Operation::Equal:			return value == values[0];
+	case Operation::Less:			return value < values[0];
+	case Operation::LessOrEqual:	return value <= values[0];
+	case Operation::Greater:		return value > values[0];
+	case Operation::GreaterOrEqual:	return value >= values[0];
+	case Operation::Between:		return values[0] <= value && value <= values[1];
+	case Operation::In:				return std::binary_search(values.begin(), values.end(), value, std::less<>{});
+	case Operation::Prefix:			return value.substr(0, values[0].size()) == values[0];
+	default:						return false;
+	}
+}
+
+/**
+ * @brief Selects the rows matching a predicate on a column known at compile time, so the per-row loop reads the column's member directly
+ * @param recordList the records
+ * @param selection the rows to test, in ascending order
+ * @return the matching rows in ascending order
+*/
+template <RecordColumn Column>
+std::vector<RecordFilter::RowId> RecordFilter::selectColumn(const std::vector<RecordDTO> &recordList, const std::vector<RowId> &selection) const {
+	if constexpr (columnInfo(Column).storage == ColumnStorage::Dictionary) {
+		// Decide once per distinct value, then each row is a code lookup. Equality never has to look at the other values.
+		const StringDictionary &dictionary = RecordDTO::dictionary<Column>();
+		std::vector<char> isCodeMatch(dictionary.size(), false);
+
+		if (operation == Operation::Equal || operation == Operation::In) {
+			for (const std::string &value : values) {
+				if (std::optional<std::uint32_t> code = dictionary.find(value)) {
+					isCodeMatch[*code] = true;
+				}
+			}
+		}
+		else {
+			for (std::uint32_t code = 0; code < isCodeMatch.size(); code++) {
+				isCodeMatch[code] = matchesText(dictionary.lookup(code));
+			}
+		}
+
+		return selectWhere(selection, [&](std::size_t position) {
+			std::uint32_t code = recordList[selection[position]].template code<Column>();
+			return code < isCodeMatch.size() && isCodeMatch[code];
+		});
+	}
+	else {
+		if (isOrdering()) {
+			// A range test on a double is one comparison pair with no text handling; NaN, for empty or non-numeric values, fails it
+			return selectWhere(selection, [&](std::size_t position) {
+				double number = readNumericValue(recordList[selection[position]].template get<Column>());
+				return (number >= low) & (number <= high);
+			});
+		}
+		return selectWhere(selection, [&](std::size_t position) {
+			return matchesText(recordList[selection[position]].template get<Column>());
+		});
+	}
+}
+
+/**
+ * @brief Finds the rows of a selection that the filter matches
+ * @param recordList the records, where row i is recordList[i]
+ * @param selection the rows to test, in ascending order
+ * @return the matching rows in ascending order
+*/
+std::vector<RecordFilter::RowId> RecordFilter::select(const std::vector<RecordDTO> &recordList, const std::vector<RowId> &selection) const {
+	switch (operation) {
+	case Operation::And: {
+		// Each filter only tests the rows the ones before it kept
+		std::vector<RowId> selectedRows = selection;
+		for (const RecordFilter &child : children) {
+			if (selectedRows.empty()) break;
+			selectedRows = child.select(recordList, selectedRows);
+		}
+		return selectedRows;
+	}
+	case Operation::Or: {
+		// Each filter only tests the rows the ones before it did not match
+		std::vector<RowId> selectedRows{};
+		std::vector<RowId> remainingRows = selection;
+		for (const RecordFilter &child : children) {
+			if (remainingRows.empty()) break;
+			std::vector<RowId> childRows = child.select(recordList, remainingRows);
+			std::vector<RowId> unitedRows{};
+			std::set_union(selectedRows.begin(), selectedRows.end(), childRows.begin(), childRows.end(), std::back_inserter(unitedRows));
+			std::vector<RowId> unmatchedRows{};
+			std::set_difference(remainingRows.begin(), remainingRows.end(), childRows.begin(), childRows.end(), std::back_inserter(unmatchedRows));
+			selectedRows = std::move(unitedRows);
+			remainingRows = std::move(unmatchedRows);
+		}
+		return selectedRows;
+	}
+	case Operation::Not: {
+		std::vector<RowId> childRows = children.front().select(recordList, selection);
+		std::vector<RowId> selectedRows{};
+		std::set_difference(selection.begin(), selection.end(), childRows.begin(), childRows.end(), std::back_inserter(selectedRows));
+		return selectedRows;
+	}
+	default:
+		return visitColumn(column, [&](auto columnConstant) {
+			return selectColumn<decltype(columnConstant)::value>(recordList, selection);
+		});
+	}
+}
+
+/**
+ * @brief Finds every row the filter matches
+ * @param recordList the records, where row i is recordList[i]
+ * @return the matching rows in ascending order
+*/
+std::vector<RecordFilter::RowId> RecordFilter::apply(const std::vector<RecordDTO> &recordList) const {
+	std::vector<RowId> allRows(recordList.size());
+	std::iota(allRows.begin(), allRows.end(), RowId{ 0 });
+	return select(recordList, allRows);
+}
+
+TEST_CASE("Test that a filter tree selects the same rows as testing each record") {
+	const char *provinces[] = { "Quebec", "Ontario", "Manitoba", "Alberta" };
+	std::vector<RecordDTO> recordList(40000);
+	for (std::size_t row = 0; row < recordList.size(); row++) {
+		recordList[row].setGeo(provinces[row % 4]);
+		recordList[row].setRefDate("19" + std::to_string(70 + row % 30) + "-01");
+		recordList[row].setVector("v" + std::to_string(row % 700));
+		if (row % 9 != 0) recordList[row].setValue(std::to_string(row % 1000));
+	}
+
+	/* (GEO IN (Quebec, Alberta) AND VALUE BETWEEN 100 AND 250) OR (VECTOR starts with "v69" AND NOT REF_DATE < "1990") */
+	RecordFilter filter = RecordFilter::anyOf({
+		RecordFilter::allOf({ RecordFilter::isIn(RecordColumn::Geo, { "Quebec", "Alberta", "Nunavut" }), RecordFilter::between(RecordColumn::Value, "100", "250") }),
+		RecordFilter::allOf({ RecordFilter::startsWith(RecordColumn::Vector, "v69"), RecordFilter::negate(RecordFilter::lessThan(RecordColumn::RefDate, "1990")) })
+	});
+
+	std::vector<RecordFilter::RowId> expected{};
+	for (std::size_t row = 0; row < recordList.size(); row++) {
+		const RecordDTO &record = recordList[row];
+		bool isInRange = !record.getValue().empty() && std::stoi(std::string{ record.getValue() }) >= 100 && std::stoi(std::string{ record.getValue() }) <= 250;
+		bool isFirstMatch = (record.getGeo() == "Quebec" || record.getGeo() == "Alberta") && isInRange;
+		bool isSecondMatch = record.getVector().substr(0, 3) == "v69" && !(record.getRefDate() < "1990");
+		if (isFirstMatch || isSecondMatch) {
+			expected.push_back(static_cast<RecordFilter::RowId>(row));
+		}
+	}
+
+	CHECK(filter.apply(recordList) == expected);
+	CHECK(RecordFilter::equals(RecordColumn::Geo, "Nunavut").apply(recordList).empty());
+	CHECK(RecordFilter::greaterThan(RecordColumn::Value, "998").apply(recordList).size() == 35);
+	CHECK_THROWS_AS(RecordFilter::lessThan(RecordColumn::Value, "many"), std::invalid_argument);
+}
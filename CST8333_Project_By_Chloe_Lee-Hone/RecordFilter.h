@@ -0,0 +1,113 @@
+/**
+* @file				RecordFilter.h
+* @author			Chloe Lee-Hone<leeh0002@algonquinlive.com>
+* @version			1.0
+* @section			Header file for the RecordFilter class, a predicate tree that selects the records matching it.
+*					This project contains information licensed under the Open Government Licence  Canada [1][2]. Code structure was informed by the provided example written by Stanley Pieda for CST8333 [3].
+*
+* Student Name:     Chloe Lee-Hone
+* Student Number:   041023578
+* Course:           CST8333_350: Programming Language Research Project
+* Professor:        Reg Dyer
+* Date:             05/06/2023
+*
+* References:
+* [1]   T. B. of C. Secretariat and T. B. S. of C. Open Government, Open Government Licence - Canada. http://open.canada.ca/en/open-government-licence-canada (accessed May 11, 2023).
+* [2]	T. B. of C. Secretariat and Open Government Portal, Vegetables in cold and common storage, Oct. 10, 2008. https://open.canada.ca/data/en/dataset/473f9524-45f8-47d0-9a12-537bb7704089 (accessed May 16, 2023).
+* [3]	S. Pieda, CST8333 19F Practical Project 2 Example Layered. Algonquin College, Algonquin College, Jun. 07, 2022. [Online]. Available: https://brightspace.algonquincollege.com/d2l/le/content/543581/viewContent/8322468/View
+*/
+
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "RecordColumn.h"
+#include "RecordDTO.h"
+#include "RecordIndex.h"
+#include "doctest.h"
+
+#ifndef RECORD_FILTER_H
+#define RECORD_FILTER_H
+
+/**
+ * @brief A tree of predicates over record columns, such as GEO = "Quebec" AND VALUE BETWEEN 100 AND 500.
+ * Filters are built with the static factory methods and evaluated with apply(). Evaluation works one predicate at a time over
+ * a selection vector, the ascending list of rows still in play: each predicate scans only its own column and only the rows
+ * that earlier predicates kept.
+ *
+ * Dictionary columns are compared by code: a predicate is tested once per distinct value, and each row then costs one code lookup.
+ * The ordering predicates (lessThan() to between()) compare numeric columns as numbers, and rows whose value is not a number
+ * never match them. Every other comparison is on the text.
+*/
+class RecordFilter
+{
+public:
+	using RowId = RecordIndex::RowId;
+
+	/** @brief matches rows whose column equals value */
+	static RecordFilter equals(RecordColumn column, std::string value);
+	/** @brief matches rows whose column is less than value */
+	static RecordFilter lessThan(RecordColumn column, std::string value);
+	/** @brief matches rows whose column is less than or equal to value */
+	static RecordFilter lessOrEqual(RecordColumn column, std::string value);
+	/** @brief matches rows whose column is greater than value */
+	static RecordFilter greaterThan(RecordColumn column, std::string value);
+	/** @brief matches rows whose column is greater than or equal to value */
+	static RecordFilter greaterOrEqual(RecordColumn column, std::string value);
+	/** @brief matches rows whose column is from low to high, both included */
+	static RecordFilter between(RecordColumn column, std::string low, std::string high);
+	/** @brief matches rows whose column equals any of the values */
+	static RecordFilter isIn(RecordColumn column, std::vector<std::string> values);
+	/** @brief matches rows whose column starts with prefix */
+	static RecordFilter startsWith(RecordColumn column, std::string prefix);
+	/** @brief matches rows that every filter matches. An empty list matches every row. */
+	static RecordFilter allOf(std::vector<RecordFilter> filters);
+	/** @brief matches rows that any filter matches. An empty list matches no row. */
+	static RecordFilter anyOf(std::vector<RecordFilter> filters);
+	/** @brief matches rows that the filter does not match */
+	static RecordFilter negate(RecordFilter filter);
+
+	/**
+	 * @brief Finds every row the filter matches
+	 * @param recordList the records, where row i is recordList[i]
+	 * @return the matching rows in ascending order
+	*/
+	std::vector<RowId> apply(const std::vector<RecordDTO> &recordList) const;
+
+	/**
+	 * @brief Finds the rows of a selection that the filter matches
+	 * @param recordList the records, where row i is recordList[i]
+	 * @param selection the rows to test, in ascending order
+	 * @return the matching rows in ascending order
+	*/
+	std::vector<RowId> select(const std::vector<RecordDTO> &recordList, const std::vector<RowId> &selection) const;
+
+private:
+	enum class Operation { Equal, Less, LessOrEqual, Greater, GreaterOrEqual, Between, In, Prefix, And, Or, Not };
+
+	RecordFilter(Operation operation, RecordColumn column, std::vector<std::string> values);
+
+	/** @brief the predicate, or how the children are combined */
+	Operation operation;
+	/** @brief the column a predicate tests. Unused by And, Or and Not. */
+	RecordColumn column;
+	/** @brief the predicate's operands. In sorts them so they can be binary searched. */
+	std::vector<std::string> values{};
+	/** @brief the filters combined by And, Or and Not */
+	std::vector<RecordFilter> children{};
+	/** @brief the numeric range an ordering predicate on a numeric column accepts, both ends included */
+	double low{ 0 };
+	double high{ 0 };
+
+	/** @return true for the predicates that compare numeric columns as numbers */
+	bool isOrdering() const;
+
+	/** @return true if a text value satisfies the predicate */
+	bool matchesText(std::string_view value) const;
+
+	/** @brief Selects the rows matching a predicate on a column known at compile time */
+	template <RecordColumn Column>
+	std::vector<RowId> selectColumn(const std::vector<RecordDTO> &recordList, const std::vector<RowId> &selection) const;
+};
+#endif // !RECORD_FILTER_H
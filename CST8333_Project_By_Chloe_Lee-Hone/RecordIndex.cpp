@@ -0,0 +1,266 @@
+/**
+* @file				RecordIndex.cpp
+* @author			Chloe Lee-Hone<leeh0002@algonquinlive.com>
+* @version			1.0
+* @section			This file contains the RecordIndex class used by RecordService to answer equality lookups on a column without scanning every record.
+*					This project contains information licensed under the Open Government Licence  Canada [1][2]. Code structure was informed by the provided example written by Stanley Pieda for CST8333 [3].
+*
+* Student Name:     Chloe Lee-Hone
+* Student Number:   041023578
+* Course:           CST8333_350: Programming Language Research Project
+* Professor:        Reg Dyer
+* Date:             05/06/2023
+*
+* References:
+* [1]   T. B. of C. Secretariat and T. B. S. of C. Open Government, Open Government Licence - Canada. http://open.canada.ca/en/open-government-licence-canada (accessed May 11, 2023).
+* [2]	T. B. of C. Secretariat and Open Government Portal, Vegetables in cold and common storage, Oct. 10, 2008. https://open.canada.ca/data/en/dataset/473f9524-45f8-47d0-9a12-537bb7704089 (accessed May 16, 2023).
+* [3]	S. Pieda, CST8333 19F Practical Project 2 Example Layered. Algonquin College, Algonquin College, Jun. 07, 2022. [Online]. Available: https://brightspace.algonquincollege.com/d2l/le/content/543581/viewContent/8322468/View
+*/
+
+#include "RecordIndex.h"
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include "ParallelRange.h"
+#include "doctest.h"
+
+/** @brief Returned by find() for a value no row holds */
+static const std::vector<RecordIndex::RowId> NO_ROWS{};
+
+/**
+ * @brief Creates an empty index
+ * @param column the column to index
+*/
+RecordIndex::RecordIndex(RecordColumn column) : column(column), slots(16) {}
+
+/**
+ * @brief Replaces the index's contents with every row of the list. Chunks of rows are indexed on separate threads and then merged.
+ * @param recordList the records to index, where row i is recordList[i]
+*/
+void RecordIndex::build(const std::vector<RecordDTO> &recordList) {
+	std::vector<RecordIndex> chunkIndexes(parallelChunkCount(recordList.size()), RecordIndex{ column });
+
+	forEachChunk(recordList.size(), [this, &recordList, &chunkIndexes](std::size_t begin, std::size_t end, std::size_t chunk) {
+		RecordIndex &chunkIndex = chunkIndexes[chunk];
+		for (std::size_t row = begin; row < end; row++) {
+			chunkIndex.slotFor(recordList[row].get(column)).rows.push_back(static_cast<RowId>(row));
+		}
+	});
+
+	// Chunk 0 holds the lowest rows, so appending chunk by chunk keeps every row list in ascending order
+	*this = std::move(chunkIndexes.front());
+	for (std::size_t chunk = 1; chunk < chunkIndexes.size(); chunk++) {
+		for (Slot &chunkSlot : chunkIndexes[chunk].slots) {
+			if (chunkSlot.isUsed) {
+				std::vector<RowId> &rows = slotFor(chunkSlot.key).rows;
+				rows.insert(rows.end(), chunkSlot.rows.begin(), chunkSlot.rows.end());
+			}
+		}
+	}
+}
+
+/**
+ * @brief Adds a row under a key
+ * @param key the row's value in the indexed column
+ * @param row the row to add
+*/
+void RecordIndex::insert(std::string_view key, RowId row) {
+	std::vector<RowId> &rows = slotFor(key).rows;
+	// New records are appended to the vector, so this is almost always a push_back
+	rows.insert(std::upper_bound(rows.begin(), rows.end(), row), row);
+}
+
+/**
+ * @brief Removes a row from a key's list
+ * @param key the row's value in the indexed column
+ * @param row the row to remove
+*/
+void RecordIndex::erase(std::string_view key, RowId row) {
+	Slot &slot = slots[probe(key, std::hash<std::string_view>{}(key))];
+	if (!slot.isUsed) {
+		return;
+	}
+	auto position = std::lower_bound(slot.rows.begin(), slot.rows.end(), row);
+	if (position != slot.rows.end() && *position == row) {
+		slot.rows.erase(position);
+	}
+}
+
+/**
+ * @brief Adds many rows at once. Entries are grouped by key first, so each key's row list is merged once rather than
+ * shifted once per row.
+ * @param entries the rows and their values in the indexed column. Reordered by the call.
+*/
+void RecordIndex::insertBatch(std::vector<Entry> &entries) {
+	std::sort(entries.begin(), entries.end());
+	std::vector<RowId> merged{};
+
+	for (auto group = entries.begin(); group != entries.end();) {
+		auto groupEnd = std::find_if(group, entries.end(), [&group](const Entry &entry) { return entry.first != group->first; });
+		std::vector<RowId> &rows = slotFor(group->first).rows;
+
+		merged.clear();
+		merged.reserve(rows.size() + static_cast<std::size_t>(groupEnd - group));
+		auto position = rows.begin();
+		for (auto entry = group; entry != groupEnd; ++entry) {
+			auto next = std::upper_bound(position, rows.end(), entry->second);
+			merged.insert(merged.end(), position, next);
+			merged.push_back(entry->second);
+			position = next;
+		}
+		merged.insert(merged.end(), position, rows.end());
+		rows.swap(merged);
+		group = groupEnd;
+	}
+}
+
+/**
+ * @brief Removes many rows at once, rewriting each affected key's row list once
+ * @param entries the rows and the values they were inserted under. Reordered by the call.
+*/
+void RecordIndex::eraseBatch(std::vector<Entry> &entries) {
+	std::sort(entries.begin(), entries.end());
+
+	for (auto group = entries.begin(); group != entries.end();) {
+		auto groupEnd = std::find_if(group, entries.end(), [&group](const Entry &entry) { return entry.first != group->first; });
+		Slot &slot = slots[probe(group->first, std::hash<std::string_view>{}(group->first))];
+
+		if (slot.isUsed) {
+			// Both lists are sorted, so one pass keeps every row that is not being erased
+			std::size_t kept{ 0 };
+			auto entry = group;
+			for (RowId row : slot.rows) {
+				while (entry != groupEnd && entry->second < row) ++entry;
+				if (entry != groupEnd && entry->second == row) continue;
+				slot.rows[kept++] = row;
+			}
+			slot.rows.resize(kept);
+		}
+		group = groupEnd;
+	}
+}
+
+/**
+ * @brief Moves every row to its new position after the vector was compacted, and drops the rows that were removed
+ * @param newRows the new position of each old row, or NO_ROW for a removed row
+*/
+void RecordIndex::renumber(const std::vector<RowId> &newRows) {
+	for (Slot &slot : slots) {
+		std::size_t kept{ 0 };
+		for (RowId row : slot.rows) {
+			if (newRows[row] != NO_ROW) {
+				slot.rows[kept++] = newRows[row];
+			}
+		}
+		slot.rows.resize(kept);
+	}
+}
+
+/**
+ * @brief Looks up the rows holding a value
+ * @param key the value to find
+ * @return the rows in ascending order. Empty if no row holds the value.
+*/
+const std::vector<RecordIndex::RowId> &RecordIndex::find(std::string_view key) const {
+	const Slot &slot = slots[probe(key, std::hash<std::string_view>{}(key))];
+	return slot.isUsed ? slot.rows : NO_ROWS;
+}
+
+/**
+ * @brief Finds the slot holding a key, or the empty slot where it would go
+ * @return the slot's position in the table
+*/
+std::size_t RecordIndex::probe(std::string_view key, std::size_t hash) const {
+	std::size_t mask = slots.size() - 1;
+	std::size_t position = hash & mask;
+
+	while (slots[position].isUsed && (slots[position].hash != hash || slots[position].key != key)) {
+		position = (position + 1) & mask;
+	}
+	return position;
+}
+
+/**
+ * @brief Returns the key's slot, claiming an empty slot if the key is new
+ * @return the key's slot
+*/
+RecordIndex::Slot &RecordIndex::slotFor(std::string_view key) {
+	std::size_t hash = std::hash<std::string_view>{}(key);
+	Slot *slot = &slots[probe(key, hash)];
+
+	if (!slot->isUsed) {
+		if ((usedSlots + 1) * 8 > slots.size() * MAX_LOAD_EIGHTHS) {
+			grow();
+			slot = &slots[probe(key, hash)];
+		}
+		slot->key.assign(key);
+		slot->hash = hash;
+		slot->isUsed = true;
+		usedSlots++;
+	}
+	return *slot;
+}
+
+/**
+ * @brief Doubles the table and reinserts every key
+*/
+void RecordIndex::grow() {
+	std::vector<Slot> oldSlots(slots.size() * 2);
+	oldSlots.swap(slots);
+
+	for (Slot &oldSlot : oldSlots) {
+		if (oldSlot.isUsed) {
+			slots[probe(oldSlot.key, oldSlot.hash)] = std::move(oldSlot);
+		}
+	}
+}
+
+TEST_CASE("Test that the index finds every row holding a value") {
+	std::vector<RecordDTO> recordList(40000);
+	for (std::size_t row = 0; row < recordList.size(); row++) {
+		recordList[row].setGeo(row % 3 == 0 ? "Quebec" : "Ontario");
+		recordList[row].setProductType("Product " + std::to_string(row % 100));
+	}
+
+	/* 40000 rows is enough for build() to split the work across threads on a multi-core machine */
+	RecordIndex geoIndex{ RecordColumn::Geo };
+	geoIndex.build(recordList);
+	RecordIndex productIndex{ RecordColumn::ProductType };
+	productIndex.build(recordList);
+
+	const std::vector<RecordIndex::RowId> &quebecRows = geoIndex.find("Quebec");
+	CHECK(quebecRows.size() == 13334);
+	CHECK(std::is_sorted(quebecRows.begin(), quebecRows.end()));
+	CHECK(quebecRows[1] == 3);
+	CHECK(geoIndex.find("Manitoba").empty());
+	CHECK(productIndex.keyCount() == 100);
+	CHECK(productIndex.find("Product 42").size() == 400);
+}
+
+TEST_CASE("Test that the index follows inserts, edits and deletes") {
+	RecordIndex index{ RecordColumn::Vector };
+	index.insert("v1", 0);
+	index.insert("v2", 1);
+	index.insert("v1", 2);
+	index.insert("v2", 3);
+
+	/* Row 2 is edited from v1 to v2 */
+	index.erase("v1", 2);
+	index.insert("v2", 2);
+	CHECK(index.find("v1") == std::vector<RecordIndex::RowId>{ 0 });
+	CHECK(index.find("v2") == std::vector<RecordIndex::RowId>{ 1, 2, 3 });
+
+	/* Row 1 is compacted out of the vector, so rows 2 and 3 become rows 1 and 2 */
+	index.renumber({ 0, RecordIndex::NO_ROW, 1, 2 });
+	CHECK(index.find("v2") == std::vector<RecordIndex::RowId>{ 1, 2 });
+	CHECK(index.find("v1") == std::vector<RecordIndex::RowId>{ 0 });
+
+	/* A batch edits rows 0 and 2 to v3 and appends rows 3 and 4 */
+	std::vector<RecordIndex::Entry> erased{ { "v2", 2 }, { "v1", 0 } };
+	std::vector<RecordIndex::Entry> inserted{ { "v3", 4 }, { "v3", 0 }, { "v1", 3 }, { "v3", 2 } };
+	index.eraseBatch(erased);
+	index.insertBatch(inserted);
+	CHECK(index.find("v1") == std::vector<RecordIndex::RowId>{ 3 });
+	CHECK(index.find("v2") == std::vector<RecordIndex::RowId>{ 1 });
+	CHECK(index.find("v3") == std::vector<RecordIndex::RowId>{ 0, 2, 4 });
+}
@@ -0,0 +1,141 @@
+/**
+* @file				RecordIndex.h
+* @author			Chloe Lee-Hone<leeh0002@algonquinlive.com>
+* @version			1.0
+* @section			Header file for the RecordIndex class, a secondary hash index from one column's values to the rows that hold them.
+*					This project contains information licensed under the Open Government Licence  Canada [1][2]. Code structure was informed by the provided example written by Stanley Pieda for CST8333 [3].
+*
+* Student Name:     Chloe Lee-Hone
+* Student Number:   041023578
+* Course:           CST8333_350: Programming Language Research Project
+* Professor:        Reg Dyer
+* Date:             05/06/2023
+*
+* References:
+* [1]   T. B. of C. Secretariat and T. B. S. of C. Open Government, Open Government Licence - Canada. http://open.canada.ca/en/open-government-licence-canada (accessed May 11, 2023).
+* [2]	T. B. of C. Secretariat and Open Government Portal, Vegetables in cold and common storage, Oct. 10, 2008. https://open.canada.ca/data/en/dataset/473f9524-45f8-47d0-9a12-537bb7704089 (accessed May 16, 2023).
+* [3]	S. Pieda, CST8333 19F Practical Project 2 Example Layered. Algonquin College, Algonquin College, Jun. 07, 2022. [Online]. Available: https://brightspace.algonquincollege.com/d2l/le/content/543581/viewContent/8322468/View
+*/
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "RecordColumn.h"
+#include "RecordDTO.h"
+#include "doctest.h"
+
+#ifndef RECORD_INDEX_H
+#define RECORD_INDEX_H
+
+/**
+ * @brief Maps each value of one column to the ascending list of rows holding it, so an equality lookup costs one hash probe
+ * instead of a scan. The table uses open addressing with linear probing. Keys are never removed, since a column's set of
+ * values only grows; a key whose last row goes away keeps an empty row list, so the table never needs tombstones.
+*/
+class RecordIndex
+{
+public:
+	/** @brief A record's position in the RecordService's vector */
+	using RowId = std::uint32_t;
+	/** @brief Marks a row that compaction removed, in the mapping passed to renumber() */
+	static constexpr RowId NO_ROW = std::numeric_limits<RowId>::max();
+	/** @brief A row under a key, as passed to insertBatch() and eraseBatch() */
+	using Entry = std::pair<std::string, RowId>;
+
+	/**
+	 * @brief Creates an empty index
+	 * @param column the column to index
+	*/
+	explicit RecordIndex(RecordColumn column);
+
+	/** @return the indexed column */
+	RecordColumn getColumn() const { return column; }
+
+	/**
+	 * @brief Replaces the index's contents with every row of the list. Chunks of rows are indexed on separate threads and then merged.
+	 * @param recordList the records to index, where row i is recordList[i]
+	*/
+	void build(const std::vector<RecordDTO> &recordList);
+
+	/**
+	 * @brief Adds a row under a key
+	 * @param key the row's value in the indexed column
+	 * @param row the row to add
+	*/
+	void insert(std::string_view key, RowId row);
+
+	/**
+	 * @brief Removes a row from a key's list
+	 * @param key the row's value in the indexed column
+	 * @param row the row to remove
+	*/
+	void erase(std::string_view key, RowId row);
+
+	/**
+	 * @brief Adds many rows at once. Entries are grouped by key first, so each key's row list is merged once rather than
+	 * shifted once per row.
+	 * @param entries the rows and their values in the indexed column. Reordered by the call.
+	*/
+	void insertBatch(std::vector<Entry> &entries);
+
+	/**
+	 * @brief Removes many rows at once, rewriting each affected key's row list once
+	 * @param entries the rows and the values they were inserted under. Reordered by the call.
+	*/
+	void eraseBatch(std::vector<Entry> &entries);
+
+	/**
+	 * @brief Moves every row to its new position after the vector was compacted, and drops the rows that were removed.
+	 * Compaction keeps the rows in order, so every row list stays sorted. Costs one pass over the index.
+	 * @param newRows the new position of each old row, or NO_ROW for a removed row
+	*/
+	void renumber(const std::vector<RowId> &newRows);
+
+	/**
+	 * @brief Looks up the rows holding a value
+	 * @param key the value to find
+	 * @return the rows in ascending order. Empty if no row holds the value.
+	*/
+	const std::vector<RowId> &find(std::string_view key) const;
+
+	/** @return the number of distinct values seen by the index */
+	std::size_t keyCount() const { return usedSlots; }
+
+private:
+	/** @brief One entry of the open-addressing table */
+	struct Slot {
+		std::string key{};
+		std::size_t hash{ 0 };
+		std::vector<RowId> rows{};
+		bool isUsed{ false };
+	};
+
+	/** The table grows once it is this full, expressed as used slots per 8 slots */
+	static constexpr std::size_t MAX_LOAD_EIGHTHS = 6;
+
+	RecordColumn column;
+	/** @brief the table. Its size is always a power of two. */
+	std::vector<Slot> slots{};
+	std::size_t usedSlots{ 0 };
+
+	/**
+	 * @brief Finds the slot holding a key, or the empty slot where it would go
+	 * @return the slot's position in the table
+	*/
+	std::size_t probe(std::string_view key, std::size_t hash) const;
+
+	/**
+	 * @brief Returns the key's slot, claiming an empty slot if the key is new
+	 * @return the key's slot
+	*/
+	Slot &slotFor(std::string_view key);
+
+	/** @brief Doubles the table and reinserts every key */
+	void grow();
+};
+#endif // !RECORD_INDEX_H
@@ -0,0 +1,224 @@
+/**
+* @file				RecordJoin.cpp
+* @author			Chloe Lee-Hone<leeh0002@algonquinlive.com>
+* @version			1.0
+* @section			This file contains the RecordJoin class, which joins the records with another table using a partitioned parallel hash join.
+*					This project contains information licensed under the Open Government Licence  Canada [1][2]. Code structure was informed by the provided example written by Stanley Pieda for CST8333 [3].
+*
+* Student Name:     Chloe Lee-Hone
+* Student Number:   041023578
+* Course:           CST8333_350: Programming Language Research Project
+* Professor:        Reg Dyer
+* Date:             05/06/2023
+*
+* References:
+* [1]   T. B. of C. Secretariat and T. B. S. of C. Open Government, Open Government Licence - Canada. http://open.canada.ca/en/open-government-licence-canada (accessed May 11, 2023).
+* [2]	T. B. of C. Secretariat and Open Government Portal, Vegetables in cold and common storage, Oct. 10, 2008. https://open.canada.ca/data/en/dataset/473f9524-45f8-47d0-9a12-537bb7704089 (accessed May 16, 2023).
+* [3]	S. Pieda, CST8333 19F Practical Project 2 Example Layered. Algonquin College, Algonquin College, Jun. 07, 2022. [Online]. Available: https://brightspace.algonquincollege.com/d2l/le/content/543581/viewContent/8322468/View
+*/
+
+#include "RecordJoin.h"
+#include "ParallelRange.h"
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+/**
+ * @brief Builds the hash table for the table's keys. The table must outlive the join.
+ * @param table the build side
+ * @param spec the key columns and join type
+ * @throws std::invalid_argument if there are no keys, the key lists differ in length, or the table lacks a key header
+*/
+RecordJoin::RecordJoin(const TableDTO &table, JoinSpec spec) : table{ table }, spec{ std::move(spec) } {
+	if (RecordJoin::spec.recordKeys.empty() || RecordJoin::spec.recordKeys.size() != RecordJoin::spec.tableKeys.size()) {
+		throw std::invalid_argument("A join needs the same number of record and table key columns.");
+	}
+	for (const std::string &header : RecordJoin::spec.tableKeys) {
+		std::size_t column = table.findColumn(header);
+		if (column == TableDTO::NO_COLUMN) {
+			throw std::invalid_argument("The table has no " + header + " column.");
+		}
+		RecordJoin::tableKeyColumns.push_back(column);
+	}
+
+	for (const ColumnInfo &columnInfo : RECORD_COLUMNS) {
+		RecordJoin::headers.emplace_back(columnInfo.header);
+	}
+	for (std::size_t column = 0; column < table.columnCount(); column++) {
+		if (std::find(RecordJoin::tableKeyColumns.begin(), RecordJoin::tableKeyColumns.end(), column) != RecordJoin::tableKeyColumns.end()) {
+			continue;
+		}
+		std::string header = table.getHeaders()[column];
+		auto recordHeadersEnd = RecordJoin::headers.begin() + RECORD_COLUMN_COUNT;
+		if (std::find(RecordJoin::headers.begin(), recordHeadersEnd, header) != recordHeadersEnd) header += DUPLICATE_HEADER_SUFFIX;
+		RecordJoin::payloadColumns.push_back(column);
+		RecordJoin::headers.push_back(std::move(header));
+	}
+
+	const std::vector<Row> &tableRows = table.getRows();
+	using Entry = std::pair<std::string, std::size_t>;
+	RecordJoin::partitions.resize(parallelChunkCount(tableRows.size()));
+	forEachPartition<Entry>(tableRows.size(), [&](std::size_t row, auto &add) {
+		std::string key = tableKey(tableRows[row]);
+		std::size_t hash = std::hash<std::string>{}(key);
+		add(hash, Entry{ std::move(key), row });
+	}, [&](std::size_t partition, std::vector<Entry> &entries) {
+		std::unordered_map<std::string, std::vector<std::size_t>> &matches = RecordJoin::partitions[partition];
+		for (Entry &entry : entries) {
+			matches[std::move(entry.first)].push_back(entry.second);
+		}
+	});
+}
+
+/** @return the output's headers: the record headers, then the table's non-key headers */
+const std::vector<std::string> &RecordJoin::getHeaders() const {
+	return RecordJoin::headers;
+}
+
+/** @return the record's key, built the same way as tableKey() */
+std::string RecordJoin::recordKey(const RecordDTO &record) const {
+	std::string key{};
+	for (std::size_t i = 0; i < RecordJoin::spec.recordKeys.size(); i++) {
+		if (i > 0) key.push_back(KEY_SEPARATOR);
+		key.append(record.get(RecordJoin::spec.recordKeys[i]));
+	}
+	return key;
+}
+
+/** @return the table row's key */
+std::string RecordJoin::tableKey(const Row &row) const {
+	std::string key{};
+	for (std::size_t i = 0; i < RecordJoin::tableKeyColumns.size(); i++) {
+		if (i > 0) key.push_back(KEY_SEPARATOR);
+		key.append(row[RecordJoin::tableKeyColumns[i]]);
+	}
+	return key;
+}
+
+/**
+ * @brief Joins the selected records with the table
+ * @param recordList the records
+ * @param rows the rows to join, such as RecordService::liveRows()
+ * @param sink called with each batch of joined rows
+*/
+void RecordJoin::probe(const std::vector<RecordDTO> &recordList, const std::vector<RowId> &rows, const RowSink &sink) const {
+	const std::vector<Row> &tableRows = RecordJoin::table.getRows();
+	const std::vector<std::string> noMatch(RecordJoin::payloadColumns.size());
+
+	for (std::size_t batchBegin = 0; batchBegin < rows.size(); batchBegin += BATCH_ROWS) {
+		std::size_t batchSize = std::min(BATCH_ROWS, rows.size() - batchBegin);
+		std::vector<std::vector<Row>> chunkRows(parallelChunkCount(batchSize));
+
+		forEachChunk(batchSize, [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+			std::hash<std::string> hasher{};
+			std::vector<Row> &output = chunkRows[chunk];
+			output.reserve(end - begin);
+
+			for (std::size_t position = batchBegin + begin; position < batchBegin + end; position++) {
+				const RecordDTO &record = recordList[rows[position]];
+				std::string key = recordKey(record);
+				const auto &matches = RecordJoin::partitions[hasher(key) % RecordJoin::partitions.size()];
+				auto found = matches.find(key);
+
+				auto emit = [&](const Row *tableRow) {
+					Row joined{};
+					joined.reserve(RecordJoin::headers.size());
+					for (const ColumnInfo &columnInfo : RECORD_COLUMNS) {
+						joined.emplace_back(record.get(columnInfo.column));
+					}
+					for (std::size_t i = 0; i < RecordJoin::payloadColumns.size(); i++) {
+						joined.push_back(tableRow == nullptr ? noMatch[i] : (*tableRow)[RecordJoin::payloadColumns[i]]);
+					}
+					output.push_back(std::move(joined));
+				};
+
+				if (found != matches.end()) {
+					for (std::size_t tableRow : found->second) {
+						emit(&tableRows[tableRow]);
+					}
+				}
+				else if (RecordJoin::spec.type == JoinType::Left) {
+					emit(nullptr);
+				}
+			}
+		});
+
+		std::vector<Row> batch = std::move(chunkRows.front());
+		for (std::size_t chunk = 1; chunk < chunkRows.size(); chunk++) {
+			std::move(chunkRows[chunk].begin(), chunkRows[chunk].end(), std::back_inserter(batch));
+		}
+		sink(std::move(batch));
+	}
+}
+
+/**
+ * @brief Joins the selected records with the table and collects the result in memory
+ * @param recordList the records
+ * @param rows the rows to join
+ * @param table the build side
+ * @param spec the key columns and join type
+ * @return the joined table
+ * @throws std::invalid_argument if the spec does not fit the table
+*/
+TableDTO RecordJoin::join(const std::vector<RecordDTO> &recordList, const std::vector<RowId> &rows, const TableDTO &table, const JoinSpec &spec) {
+	RecordJoin recordJoin{ table, spec };
+	TableDTO joined{ recordJoin.getHeaders(), {} };
+	recordJoin.probe(recordList, rows, [&joined](std::vector<Row> &&batch) { joined.addRows(std::move(batch)); });
+	return joined;
+}
+
+TEST_CASE("Test that inner and left joins match records with table rows on GEO and REF_DATE") {
+	const char *provinces[] = { "Quebec", "Ontario", "Manitoba" };
+	std::vector<RecordDTO> recordList(40000);
+	std::vector<RecordJoin::RowId> rows(recordList.size());
+	for (std::size_t row = 0; row < recordList.size(); row++) {
+		recordList[row].setGeo(provinces[row % 3]);
+		recordList[row].setRefDate("2020-0" + std::to_string(1 + row % 4));
+		recordList[row].setVector("v" + std::to_string(row));
+		rows[row] = static_cast<RecordJoin::RowId>(row);
+	}
+
+	/* Manitoba has no prices, and Ontario has two for 2020-01. The table's VALUE header clashes with the records'. */
+	std::vector<TableDTO::Row> priceRows{};
+	for (int month = 1; month <= 4; month++) {
+		priceRows.push_back({ "Quebec", "2020-0" + std::to_string(month), std::to_string(month) });
+		priceRows.push_back({ "Ontario", "2020-0" + std::to_string(month), std::to_string(10 * month) });
+	}
+	priceRows.push_back({ "Ontario", "2020-01", "11" });
+	TableDTO prices({ "GEO", "REF_DATE", "VALUE" }, priceRows);
+
+	TableDTO inner = RecordJoin::join(recordList, rows, prices, JoinSpec{});
+	REQUIRE(inner.columnCount() == RECORD_COLUMN_COUNT + 1);
+	CHECK(inner.getHeaders().back() == "VALUE_2");
+
+	/* Every Quebec and Ontario record matches once, except Ontario in 2020-01, which matches twice */
+	std::size_t ontarioJanuary{ 0 };
+	for (std::size_t row = 0; row < recordList.size(); row++) {
+		if (row % 3 == 1 && row % 4 == 0) ontarioJanuary++;
+	}
+	std::size_t unmatched = (recordList.size() + 1) / 3;
+	CHECK(inner.rowCount() == recordList.size() - unmatched + ontarioJanuary);
+
+	/* Record order is kept, and a record's matches follow table order: record 2 is Manitoba and record 4 is Ontario in 2020-01 */
+	CHECK(inner.getRows()[0][columnIndex(RecordColumn::Vector)] == "v0");
+	CHECK(inner.getRows()[0].back() == "1");
+	CHECK(inner.getRows()[2][columnIndex(RecordColumn::Vector)] == "v3");
+	CHECK(inner.getRows()[3][columnIndex(RecordColumn::Vector)] == "v4");
+	CHECK(inner.getRows()[3].back() == "10");
+	CHECK(inner.getRows()[4][columnIndex(RecordColumn::Vector)] == "v4");
+	CHECK(inner.getRows()[4].back() == "11");
+
+	JoinSpec leftSpec{};
+	leftSpec.type = JoinType::Left;
+	TableDTO left = RecordJoin::join(recordList, rows, prices, leftSpec);
+	CHECK(left.rowCount() == recordList.size() + ontarioJanuary);
+	CHECK(left.getRows()[2][columnIndex(RecordColumn::Geo)] == "Manitoba");
+	CHECK(left.getRows()[2].back() == "");
+
+	JoinSpec missingKey{};
+	missingKey.tableKeys = { "REF_DATE", "VECTOR" };
+	CHECK_THROWS_AS(RecordJoin(prices, missingKey), std::invalid_argument);
+	missingKey.tableKeys = { "REF_DATE" };
+	CHECK_THROWS_AS(RecordJoin(prices, missingKey), std::invalid_argument);
+}
@@ -0,0 +1,115 @@
+/**
+* @file				RecordJoin.h
+* @author			Chloe Lee-Hone<leeh0002@algonquinlive.com>
+* @version			1.0
+* @section			Header file for RecordJoin class, which joins the records with another table on shared key columns.
+*					This project contains information licensed under the Open Government Licence  Canada [1][2]. Code structure was informed by the provided example written by Stanley Pieda for CST8333 [3].
+*
+* Student Name:     Chloe Lee-Hone
+* Student Number:   041023578
+* Course:           CST8333_350: Programming Language Research Project
+* Professor:        Reg Dyer
+* Date:             05/06/2023
+*
+* References:
+* [1]   T. B. of C. Secretariat and T. B. S. of C. Open Government, Open Government Licence - Canada. http://open.canada.ca/en/open-government-licence-canada (accessed May 11, 2023).
+* [2]	T. B. of C. Secretariat and Open Government Portal, Vegetables in cold and common storage, Oct. 10, 2008. https://open.canada.ca/data/en/dataset/473f9524-45f8-47d0-9a12-537bb7704089 (accessed May 16, 2023).
+* [3]	S. Pieda, CST8333 19F Practical Project 2 Example Layered. Algonquin College, Algonquin College, Jun. 07, 2022. [Online]. Available: https://brightspace.algonquincollege.com/d2l/le/content/543581/viewContent/8322468/View
+*/
+
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "RecordColumn.h"
+#include "RecordDTO.h"
+#include "RecordIndex.h"
+#include "TableDTO.h"
+#include "doctest.h"
+
+#ifndef RECORD_JOIN_H
+#define RECORD_JOIN_H
+
+/** @brief Inner keeps only the records that match a table row. Left also keeps unmatched records, with empty table cells. */
+enum class JoinType { Inner, Left };
+
+/** @brief What a join matches on */
+struct JoinSpec {
+	/** @brief the record columns that form the key */
+	std::vector<RecordColumn> recordKeys{ RecordColumn::RefDate, RecordColumn::Geo };
+	/** @brief the table headers matched with recordKeys, in the same order */
+	std::vector<std::string> tableKeys{ "REF_DATE", "GEO" };
+	JoinType type{ JoinType::Inner };
+};
+
+/**
+ * @brief Joins the records with another table, such as a production or price table for the same provinces and months.
+ * The table is the build side: its rows are split into partitions by the hash of their key, and each partition's hash map is
+ * built on its own thread. The records are then probed in batches, each batch split across threads, and every batch is handed
+ * to a sink as soon as it is done, so a join can be written to a file without holding the whole result in memory.
+ * Each output row holds the record's columns followed by the table's columns that are not part of the key. A record that matches
+ * several table rows gets one output row per match, in table order.
+*/
+class RecordJoin
+{
+public:
+	using RowId = RecordIndex::RowId;
+	using Row = TableDTO::Row;
+	/** @brief Receives each batch of joined rows, in record order */
+	using RowSink = std::function<void(std::vector<Row> &&)>;
+
+	/** @brief The number of records probed per batch. Bounds the memory a streamed join holds at once. */
+	static constexpr std::size_t BATCH_ROWS = std::size_t{ 1 } << 16;
+	/** @brief Appended to a table header that is already a record header */
+	static constexpr const char *DUPLICATE_HEADER_SUFFIX = "_2";
+
+	/**
+	 * @brief Builds the hash table for the table's keys. The table must outlive the join.
+	 * @param table the build side
+	 * @param spec the key columns and join type
+	 * @throws std::invalid_argument if there are no keys, the key lists differ in length, or the table lacks a key header
+	*/
+	RecordJoin(const TableDTO &table, JoinSpec spec);
+
+	/** @return the output's headers: the record headers, then the table's non-key headers */
+	const std::vector<std::string> &getHeaders() const;
+
+	/**
+	 * @brief Joins the selected records with the table
+	 * @param recordList the records
+	 * @param rows the rows to join, such as RecordService::liveRows()
+	 * @param sink called with each batch of joined rows
+	*/
+	void probe(const std::vector<RecordDTO> &recordList, const std::vector<RowId> &rows, const RowSink &sink) const;
+
+	/**
+	 * @brief Joins the selected records with the table and collects the result in memory
+	 * @param recordList the records
+	 * @param rows the rows to join
+	 * @param table the build side
+	 * @param spec the key columns and join type
+	 * @return the joined table
+	 * @throws std::invalid_argument if the spec does not fit the table
+	*/
+	static TableDTO join(const std::vector<RecordDTO> &recordList, const std::vector<RowId> &rows, const TableDTO &table, const JoinSpec &spec);
+
+private:
+	const TableDTO &table;
+	JoinSpec spec;
+	/** @brief the table's key columns, in spec order */
+	std::vector<std::size_t> tableKeyColumns{};
+	/** @brief the table's other columns, which are copied to the output */
+	std::vector<std::size_t> payloadColumns{};
+	std::vector<std::string> headers{};
+	/** @brief partitions[hash % size] maps a key to the table rows that have it, in ascending order */
+	std::vector<std::unordered_map<std::string, std::vector<std::size_t>>> partitions{};
+
+	/** @return the record's key, built the same way as tableKey() */
+	std::string recordKey(const RecordDTO &record) const;
+
+	/** @return the table row's key */
+	std::string tableKey(const Row &row) const;
+};
+#endif // !RECORD_JOIN_H
@@ -0,0 +1,115 @@
+/**
+* @file				RecordLoader.cpp
+* @author			Chloe Lee-Hone<leeh0002@algonquinlive.com>
+* @version			1.0
+* @section			This file contains the RecordLoader class, which collects the records as a background load parses them.
+*					This project contains information licensed under the Open Government Licence  Canada [1][2]. Code structure was informed by the provided example written by Stanley Pieda for CST8333 [3].
+*
+* Student Name:     Chloe Lee-Hone
+* Student Number:   041023578
+* Course:           CST8333_350: Programming Language Research Project
+* Professor:        Reg Dyer
+* Date:             05/06/2023
+*
+* References:
+* [1]   T. B. of C. Secretariat and T. B. S. of C. Open Government, Open Government Licence - Canada. http://open.canada.ca/en/open-government-licence-canada (accessed May 11, 2023).
+* [2]	T. B. of C. Secretariat and Open Government Portal, Vegetables in cold and common storage, Oct. 10, 2008. https://open.canada.ca/data/en/dataset/473f9524-45f8-47d0-9a12-537bb7704089 (accessed May 16, 2023).
+* [3]	S. Pieda, CST8333 19F Practical Project 2 Example Layered. Algonquin College, Algonquin College, Jun. 07, 2022. [Online]. Available: https://brightspace.algonquincollege.com/d2l/le/content/543581/viewContent/8322468/View
+*/
+
+#include "RecordLoader.h"
+#include <iterator>
+#include <memory>
+#include <thread>
+#include <utility>
+
+/**
+ * @brief Adds a parsed batch. Called on the loading thread.
+ * @param batch the records, in file order
+ * @param bytesRead the number of the file's bytes read so far
+ * @param totalBytes the file's size in bytes
+*/
+void RecordLoader::addBatch(std::vector<RecordDTO> &&batch, std::size_t bytesRead, std::size_t totalBytes) {
+	{
+		std::lock_guard<std::mutex> lock{ RecordLoader::mutex };
+		RecordLoader::parsedCount += batch.size();
+		RecordLoader::bytesRead = bytesRead;
+		RecordLoader::totalBytes = totalBytes;
+		if (RecordLoader::records.empty()) {
+			RecordLoader::records = std::move(batch);
+		}
+		else {
+			std::move(batch.begin(), batch.end(), std::back_inserter(RecordLoader::records));
+		}
+	}
+	RecordLoader::batchAdded.notify_all();
+}
+
+/**
+ * @brief Ends the load's parsing and hands over every record added. Later calls to copyPage() return no page.
+ * @return the records, in file order
+*/
+std::vector<RecordDTO> RecordLoader::takeRecords() {
+	std::vector<RecordDTO> takenRecords{};
+	{
+		std::lock_guard<std::mutex> lock{ RecordLoader::mutex };
+		takenRecords = std::move(RecordLoader::records);
+		RecordLoader::records.clear();
+		RecordLoader::isTaken = true;
+	}
+	RecordLoader::batchAdded.notify_all();
+	return takenRecords;
+}
+
+/**
+ * @brief Copies one page of the records parsed so far, waiting until its last record is parsed. Only the page's records are copied.
+ * @param offset the number of records before the page
+ * @param limit the most records the page holds
+ * @return a page that owns its records, or no page if parsing ended first
+*/
+std::optional<RecordPage> RecordLoader::copyPage(std::size_t offset, std::size_t limit) const {
+	std::unique_lock<std::mutex> lock{ RecordLoader::mutex };
+	RecordLoader::batchAdded.wait(lock, [&]() { return RecordLoader::isTaken || (RecordLoader::records.size() >= offset && RecordLoader::records.size() - offset >= limit); });
+	if (RecordLoader::isTaken) {
+		return std::nullopt;
+	}
+
+	auto first = RecordLoader::records.begin() + offset;
+	auto pageRecords = std::make_shared<const std::vector<RecordDTO>>(first, first + limit);
+	return RecordPage{ std::move(pageRecords), offset, RecordLoader::parsedCount };
+}
+
+/** @return how far the load has got. isLoaded is left false for the caller to fill in. */
+LoadProgress RecordLoader::progress() const {
+	std::lock_guard<std::mutex> lock{ RecordLoader::mutex };
+	return LoadProgress{ RecordLoader::parsedCount, RecordLoader::bytesRead, RecordLoader::totalBytes, false };
+}
+
+TEST_CASE("Test that a loader serves a page as soon as its records are parsed") {
+	RecordLoader loader{};
+	std::vector<RecordDTO> firstBatch(3);
+	firstBatch[2].setVector("v2");
+	loader.addBatch(std::move(firstBatch), 30, 100);
+
+	std::optional<RecordPage> firstPage = loader.copyPage(1, 2);
+	REQUIRE(firstPage.has_value());
+	CHECK(firstPage->size() == 2);
+	CHECK(firstPage->back().getVector() == "v2");
+	CHECK(loader.progress().recordCount == 3);
+	CHECK(loader.progress().bytesRead == 30);
+
+	/* A page past the parsed records waits for the batch that completes it */
+	std::thread loadingThread([&loader]() {
+		std::vector<RecordDTO> secondBatch(3);
+		secondBatch[0].setVector("v3");
+		loader.addBatch(std::move(secondBatch), 60, 100);
+	});
+	std::optional<RecordPage> laterPage = loader.copyPage(3, 2);
+	loadingThread.join();
+	REQUIRE(laterPage.has_value());
+	CHECK(laterPage->front().getVector() == "v3");
+
+	/* Once the records are taken, a page that was not yet parsed is no longer served */
+	CHECK(loader.takeRecords().size() == 6);
+	CHECK(!loader.copyPage(5, 10).has_value());
+}
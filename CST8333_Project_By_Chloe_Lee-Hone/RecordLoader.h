@@ -0,0 +1,92 @@
+/**
+* @file				RecordLoader.h
+* @author			Chloe Lee-Hone<leeh0002@algonquinlive.com>
+* @version			1.0
+* @section			Header file for RecordLoader class, which collects the records as a background load parses them.
+*					This project contains information licensed under the Open Government Licence  Canada [1][2]. Code structure was informed by the provided example written by Stanley Pieda for CST8333 [3].
+*
+* Student Name:     Chloe Lee-Hone
+* Student Number:   041023578
+* Course:           CST8333_350: Programming Language Research Project
+* Professor:        Reg Dyer
+* Date:             05/06/2023
+*
+* References:
+* [1]   T. B. of C. Secretariat and T. B. S. of C. Open Government, Open Government Licence - Canada. http://open.canada.ca/en/open-government-licence-canada (accessed May 11, 2023).
+* [2]	T. B. of C. Secretariat and Open Government Portal, Vegetables in cold and common storage, Oct. 10, 2008. https://open.canada.ca/data/en/dataset/473f9524-45f8-47d0-9a12-537bb7704089 (accessed May 16, 2023).
+* [3]	S. Pieda, CST8333 19F Practical Project 2 Example Layered. Algonquin College, Algonquin College, Jun. 07, 2022. [Online]. Available: https://brightspace.algonquincollege.com/d2l/le/content/543581/viewContent/8322468/View
+*/
+
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <vector>
+#include "RecordDTO.h"
+#include "RecordPage.h"
+#include "doctest.h"
+
+#ifndef RECORD_LOADER_H
+#define RECORD_LOADER_H
+
+/** @brief How far a background load has got */
+struct LoadProgress {
+	/** @brief the number of records parsed so far */
+	std::size_t recordCount{ 0 };
+	/** @brief the number of the file's bytes read so far */
+	std::size_t bytesRead{ 0 };
+	/** @brief the file's size in bytes */
+	std::size_t totalBytes{ 0 };
+	/** @brief true once the records can be used by every operation */
+	bool isLoaded{ false };
+};
+
+/**
+ * @brief Collects the records while RecordService loads them on a background thread. The loading thread adds each batch as soon as
+ * it is parsed, so other threads can read the first records, and follow the progress, before the whole file is read. Once parsing
+ * ends, the loading thread takes every record at once to build the store from.
+*/
+class RecordLoader
+{
+public:
+	/** @brief The number of records parsed between hand-overs. The first page can be shown once the first batch is in. */
+	static constexpr std::size_t BATCH_RECORDS = 1024;
+
+	/**
+	 * @brief Adds a parsed batch. Called on the loading thread.
+	 * @param batch the records, in file order
+	 * @param bytesRead the number of the file's bytes read so far
+	 * @param totalBytes the file's size in bytes
+	*/
+	void addBatch(std::vector<RecordDTO> &&batch, std::size_t bytesRead, std::size_t totalBytes);
+
+	/**
+	 * @brief Ends the load's parsing and hands over every record added. Later calls to copyPage() return no page. Called on the
+	 * loading thread, also when the load fails, so that no reader waits for records that will never come.
+	 * @return the records, in file order
+	*/
+	std::vector<RecordDTO> takeRecords();
+
+	/**
+	 * @brief Copies one page of the records parsed so far, waiting until its last record is parsed. Only the page's records are copied.
+	 * @param offset the number of records before the page
+	 * @param limit the most records the page holds
+	 * @return a page that owns its records, or no page if parsing ended first. The page's total count is the number of records parsed so far.
+	*/
+	std::optional<RecordPage> copyPage(std::size_t offset, std::size_t limit) const;
+
+	/** @return how far the load has got. isLoaded is left false for the caller to fill in. */
+	LoadProgress progress() const;
+
+private:
+	mutable std::mutex mutex{};
+	/** @brief signalled whenever a batch is added or parsing ends */
+	mutable std::condition_variable batchAdded{};
+	std::vector<RecordDTO> records{};
+	std::size_t parsedCount{ 0 };
+	std::size_t bytesRead{ 0 };
+	std::size_t totalBytes{ 0 };
+	bool isTaken{ false };
+};
+#endif // !RECORD_LOADER_H
@@ -0,0 +1,70 @@
+/**
+* @file				RecordPage.cpp
+* @author			Chloe Lee-Hone<leeh0002@algonquinlive.com>
+* @version			1.0
+* @section			This file contains the RecordPage class, a non-owning view of one page of records.
+*					This project contains information licensed under the Open Government Licence  Canada [1][2]. Code structure was informed by the provided example written by Stanley Pieda for CST8333 [3].
+*
+* Student Name:     Chloe Lee-Hone
+* Student Number:   041023578
+* Course:           CST8333_350: Programming Language Research Project
+* Professor:        Reg Dyer
+* Date:             05/06/2023
+*
+* References:
+* [1]   T. B. of C. Secretariat and T. B. S. of C. Open Government, Open Government Licence - Canada. http://open.canada.ca/en/open-government-licence-canada (accessed May 11, 2023).
+* [2]	T. B. of C. Secretariat and Open Government Portal, Vegetables in cold and common storage, Oct. 10, 2008. https://open.canada.ca/data/en/dataset/473f9524-45f8-47d0-9a12-537bb7704089 (accessed May 16, 2023).
+* [3]	S. Pieda, CST8333 19F Practical Project 2 Example Layered. Algonquin College, Algonquin College, Jun. 07, 2022. [Online]. Available: https://brightspace.algonquincollege.com/d2l/le/content/543581/viewContent/8322468/View
+*/
+
+#include "RecordPage.h"
+#include <numeric>
+#include <utility>
+
+/**
+ * @brief Parameterized constructor
+ * @param recordList the records the page refers to
+ * @param rows the page's rows in recordList, in page order
+ * @param offset the position of the page's first record among all the records being paged through
+ * @param totalCount the number of records being paged through, across every page
+*/
+RecordPage::RecordPage(const std::vector<RecordDTO> &recordList, std::vector<RowId> rows, std::size_t offset, std::size_t totalCount)
+	: recordList{ &recordList }, rows{ std::move(rows) }, offset{ offset }, totalCount{ totalCount } {}
+
+/**
+ * @brief Creates a page that owns its records, such as a page copied while the records are still loading
+ * @param pageRecords the page's records, in page order
+ * @param offset the position of the page's first record among all the records being paged through
+ * @param totalCount the number of records being paged through, across every page
+*/
+RecordPage::RecordPage(std::shared_ptr<const std::vector<RecordDTO>> pageRecords, std::size_t offset, std::size_t totalCount)
+	: recordList{ pageRecords.get() }, ownedRecords{ std::move(pageRecords) }, rows(RecordPage::recordList->size()), offset{ offset }, totalCount{ totalCount } {
+	std::iota(RecordPage::rows.begin(), RecordPage::rows.end(), RowId{ 0 });
+}
+
+TEST_CASE("Test that a page refers to the records instead of copying them") {
+	std::vector<RecordDTO> recordList(5);
+	for (std::size_t row = 0; row < recordList.size(); row++) {
+		recordList[row].setVector("v" + std::to_string(row));
+	}
+
+	RecordPage page{ recordList, { 3, 1 }, 2, 5 };
+	REQUIRE(page.size() == 2);
+	CHECK(&page.front() == &recordList[3]);
+	CHECK(page.back().getVector() == "v1");
+	CHECK(page.hasNextPage());
+
+	std::string vectors{};
+	for (const RecordDTO &record : page) {
+		vectors += record.getVector();
+	}
+	CHECK(vectors == "v3v1");
+
+	/* A page is a view, so it sees a change made to a record it refers to */
+	recordList[1].setVector("changed");
+	CHECK(page[1].getVector() == "changed");
+
+	RecordPage lastPage{ recordList, { 4 }, 4, 5 };
+	CHECK(!lastPage.hasNextPage());
+	CHECK(RecordPage{}.empty());
+}
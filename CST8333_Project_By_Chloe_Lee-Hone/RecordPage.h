@@ -0,0 +1,127 @@
+/**
+* @file				RecordPage.h
+* @author			Chloe Lee-Hone<leeh0002@algonquinlive.com>
+* @version			1.0
+* @section			Header file for RecordPage class, a non-owning view of one page of records.
+*					This project contains information licensed under the Open Government Licence  Canada [1][2]. Code structure was informed by the provided example written by Stanley Pieda for CST8333 [3].
+*
+* Student Name:     Chloe Lee-Hone
+* Student Number:   041023578
+* Course:           CST8333_350: Programming Language Research Project
+* Professor:        Reg Dyer
+* Date:             05/06/2023
+*
+* References:
+* [1]   T. B. of C. Secretariat and T. B. S. of C. Open Government, Open Government Licence - Canada. http://open.canada.ca/en/open-government-licence-canada (accessed May 11, 2023).
+* [2]	T. B. of C. Secretariat and Open Government Portal, Vegetables in cold and common storage, Oct. 10, 2008. https://open.canada.ca/data/en/dataset/473f9524-45f8-47d0-9a12-537bb7704089 (accessed May 16, 2023).
+* [3]	S. Pieda, CST8333 19F Practical Project 2 Example Layered. Algonquin College, Algonquin College, Jun. 07, 2022. [Online]. Available: https://brightspace.algonquincollege.com/d2l/le/content/543581/viewContent/8322468/View
+*/
+
+#pragma once
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <vector>
+#include "RecordDTO.h"
+#include "RecordIndex.h"
+#include "doctest.h"
+
+#ifndef RECORD_PAGE_H
+#define RECORD_PAGE_H
+
+/**
+ * @brief One page of records, such as the 50 records a screen shows. The page holds only the rows it covers and refers to the
+ * records where they are stored, so building a page never copies a record. Like a std::string_view, a page does not keep the
+ * records alive: it is valid until the next change to the records it was taken from. The exception is a page served while the
+ * records are still loading, which owns copies of its own records.
+*/
+class RecordPage
+{
+public:
+	using RowId = RecordIndex::RowId;
+
+	/** @brief Visits the page's records in page order */
+	class Iterator {
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = RecordDTO;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const RecordDTO *;
+		using reference = const RecordDTO &;
+
+		Iterator(const std::vector<RecordDTO> *recordList, std::vector<RowId>::const_iterator position) : recordList{ recordList }, position{ position } {}
+
+		reference operator*() const { return (*recordList)[*position]; }
+		pointer operator->() const { return &(*recordList)[*position]; }
+		Iterator &operator++() { ++position; return *this; }
+		Iterator operator++(int) { Iterator previous = *this; ++position; return previous; }
+		bool operator==(const Iterator &other) const { return position == other.position; }
+		bool operator!=(const Iterator &other) const { return position != other.position; }
+
+	private:
+		const std::vector<RecordDTO> *recordList;
+		std::vector<RowId>::const_iterator position;
+	};
+
+	/** @brief No-argument constructor. The page is empty. */
+	RecordPage() = default;
+
+	/**
+	 * @brief Parameterized constructor
+	 * @param recordList the records the page refers to
+	 * @param rows the page's rows in recordList, in page order
+	 * @param offset the position of the page's first record among all the records being paged through
+	 * @param totalCount the number of records being paged through, across every page
+	*/
+	RecordPage(const std::vector<RecordDTO> &recordList, std::vector<RowId> rows, std::size_t offset, std::size_t totalCount);
+
+	/**
+	 * @brief Creates a page that owns its records, such as a page copied while the records are still loading
+	 * @param pageRecords the page's records, in page order
+	 * @param offset the position of the page's first record among all the records being paged through
+	 * @param totalCount the number of records being paged through, across every page
+	*/
+	RecordPage(std::shared_ptr<const std::vector<RecordDTO>> pageRecords, std::size_t offset, std::size_t totalCount);
+
+	/** @return the number of records on the page */
+	std::size_t size() const { return RecordPage::rows.size(); }
+
+	/** @return true if the page has no records */
+	bool empty() const { return RecordPage::rows.empty(); }
+
+	/**
+	 * @param position the record's position on the page
+	 * @return the record, without copying it
+	*/
+	const RecordDTO &operator[](std::size_t position) const { return (*RecordPage::recordList)[RecordPage::rows[position]]; }
+
+	/** @return the page's first record. The page must not be empty. */
+	const RecordDTO &front() const { return (*this)[0]; }
+
+	/** @return the page's last record. The page must not be empty. */
+	const RecordDTO &back() const { return (*this)[RecordPage::rows.size() - 1]; }
+
+	Iterator begin() const { return Iterator{ RecordPage::recordList, RecordPage::rows.begin() }; }
+	Iterator end() const { return Iterator{ RecordPage::recordList, RecordPage::rows.end() }; }
+
+	/** @return the position of the page's first record among all the records being paged through */
+	std::size_t getOffset() const { return RecordPage::offset; }
+
+	/** @return the number of records being paged through, across every page */
+	std::size_t getTotalCount() const { return RecordPage::totalCount; }
+
+	/** @return true if more records follow this page */
+	bool hasNextPage() const { return RecordPage::offset + RecordPage::rows.size() < RecordPage::totalCount; }
+
+	/** @return the page's rows in the records' vector, in page order */
+	const std::vector<RowId> &getRows() const { return RecordPage::rows; }
+
+private:
+	const std::vector<RecordDTO> *recordList{ nullptr };
+	/** @brief keeps the records of a page that owns them alive. Empty for a view. */
+	std::shared_ptr<const std::vector<RecordDTO>> ownedRecords{};
+	std::vector<RowId> rows{};
+	std::size_t offset{ 0 };
+	std::size_t totalCount{ 0 };
+};
+#endif // !RECORD_PAGE_H
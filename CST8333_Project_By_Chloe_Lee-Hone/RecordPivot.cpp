@@ -0,0 +1,285 @@
+/**
+* @file				RecordPivot.cpp
+* @author			Chloe Lee-Hone<leeh0002@algonquinlive.com>
+* @version			1.0
+* @section			This file contains the RecordPivot class used by RecordService to cross-tabulate records.
+*					This project contains information licensed under the Open Government Licence  Canada [1][2]. Code structure was informed by the provided example written by Stanley Pieda for CST8333 [3].
+*
+* Student Name:     Chloe Lee-Hone
+* Student Number:   041023578
+* Course:           CST8333_350: Programming Language Research Project
+* Professor:        Reg Dyer
+* Date:             05/06/2023
+*
+* References:
+* [1]   T. B. of C. Secretariat and T. B. S. of C. Open Government, Open Government Licence - Canada. http://open.canada.ca/en/open-government-licence-canada (accessed May 11, 2023).
+* [2]	T. B. of C. Secretariat and Open Government Portal, Vegetables in cold and common storage, Oct. 10, 2008. https://open.canada.ca/data/en/dataset/473f9524-45f8-47d0-9a12-537bb7704089 (accessed May 16, 2023).
+* [3]	S. Pieda, CST8333 19F Practical Project 2 Example Layered. Algonquin College, Algonquin College, Jun. 07, 2022. [Online]. Available: https://brightspace.algonquincollege.com/d2l/le/content/543581/viewContent/8322468/View
+*/
+
+#include "RecordPivot.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include "ParallelRange.h"
+#include "TimeSeries.h"
+#include "doctest.h"
+
+/** @brief Marks a row whose REF_DATE has no period, which the pivot skips */
+static constexpr std::int32_t NO_PERIOD = -1;
+
+/** @brief The running summary of one pivot cell */
+struct CellState {
+	double sum{ 0 };
+	double min{ std::numeric_limits<double>::infinity() };
+	double max{ -std::numeric_limits<double>::infinity() };
+	/** @brief the number of values that were numbers */
+	std::uint64_t numberCount{ 0 };
+	/** @brief the number of non-empty values */
+	std::uint64_t count{ 0 };
+	/** @brief the number of rows in the cell, so rows and columns with no rows at all can be left out */
+	std::uint64_t rowCount{ 0 };
+};
+
+/**
+ * @brief Finds the month or year a REF_DATE falls in
+ * @return the month number, the year, or no value if the date is not in YYYY-MM form
+*/
+static std::optional<std::int32_t> periodKey(std::string_view refDate, PivotPeriod period) {
+	std::optional<std::int32_t> month = TimeSeries::toMonthNumber(refDate);
+	if (month && period == PivotPeriod::Year) {
+		return *month / 12;
+	}
+	return month;
+}
+
+/**
+ * @brief Lists the codes of a dictionary whose values occur in the pivot, in ascending order of value
+*/
+static std::vector<std::uint32_t> usedCodes(const std::vector<char> &isUsed, const StringDictionary &dictionary) {
+	std::vector<std::uint32_t> codes{};
+	for (std::uint32_t code = 0; code < isUsed.size(); code++) {
+		if (isUsed[code]) codes.push_back(code);
+	}
+	std::sort(codes.begin(), codes.end(), [&dictionary](std::uint32_t first, std::uint32_t second) {
+		return dictionary.lookup(first) < dictionary.lookup(second);
+	});
+	return codes;
+}
+
+/**
+ * @brief Cross-tabulates rowCount rows, where rowAt(i) gives the i-th row. The first pass finds each row's period; the second
+ * adds every row to its thread's dense matrix at [period][row code][column code]; the matrices are then added up and the
+ * unused rows and columns dropped.
+*/
+template <typename RowAt>
+static PivotTable pivotRows(const std::vector<RecordDTO> &recordList, std::size_t rowCount, const RowAt &rowAt, const PivotSpec &spec) {
+	if (columnInfo(spec.rowColumn).storage != ColumnStorage::Dictionary || columnInfo(spec.columnColumn).storage != ColumnStorage::Dictionary) {
+		throw std::invalid_argument("Pivot rows and columns must be dictionary columns.");
+	}
+	if (spec.function == AggregateFunction::CountDistinct) {
+		throw std::invalid_argument("Pivots can only summarize with Sum, Count, Min, Max or Average.");
+	}
+
+	const StringDictionary &rowDictionary = RecordDTO::dictionary(spec.rowColumn);
+	const StringDictionary &columnDictionary = RecordDTO::dictionary(spec.columnColumn);
+	std::size_t rowCodeCount = rowDictionary.size();
+	std::size_t columnCodeCount = columnDictionary.size();
+
+	// Periods are numbered from the earliest one, so the period axis is as dense as the code axes
+	std::vector<std::int32_t> rowPeriods(rowCount, 0);
+	std::int32_t firstPeriod{ 0 };
+	std::size_t periodCount{ 1 };
+	if (spec.period != PivotPeriod::None) {
+		std::size_t chunkCount = parallelChunkCount(rowCount);
+		std::vector<std::int32_t> chunkFirsts(chunkCount, std::numeric_limits<std::int32_t>::max());
+		std::vector<std::int32_t> chunkLasts(chunkCount, std::numeric_limits<std::int32_t>::min());
+
+		forEachChunk(rowCount, [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+			for (std::size_t i = begin; i < end; i++) {
+				const RecordDTO &record = recordList[rowAt(i)];
+				std::optional<std::int32_t> key = periodKey(record.get<RecordColumn::RefDate>(), spec.period);
+				rowPeriods[i] = key ? *key : NO_PERIOD;
+				if (!key) continue;
+				chunkFirsts[chunk] = std::min(chunkFirsts[chunk], *key);
+				chunkLasts[chunk] = std::max(chunkLasts[chunk], *key);
+			}
+		});
+
+		firstPeriod = *std::min_element(chunkFirsts.begin(), chunkFirsts.end());
+		std::int32_t lastPeriod = *std::max_element(chunkLasts.begin(), chunkLasts.end());
+		periodCount = firstPeriod > lastPeriod ? 0 : static_cast<std::size_t>(lastPeriod - firstPeriod) + 1;
+	}
+
+	std::size_t cellCount = periodCount * rowCodeCount * columnCodeCount;
+	if (cellCount > RecordPivot::MAX_CELLS) {
+		throw std::invalid_argument("The pivot would have too many cells.");
+	}
+
+	std::vector<std::vector<CellState>> chunkCells(parallelChunkCount(rowCount));
+	forEachChunk(rowCount, [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+		std::vector<CellState> &cells = chunkCells[chunk];
+		cells.resize(cellCount);
+
+		for (std::size_t i = begin; i < end; i++) {
+			if (rowPeriods[i] == NO_PERIOD) continue;
+			const RecordDTO &record = recordList[rowAt(i)];
+			std::size_t period = static_cast<std::size_t>(rowPeriods[i] - firstPeriod);
+			CellState &cell = cells[(period * rowCodeCount + record.code(spec.rowColumn)) * columnCodeCount + record.code(spec.columnColumn)];
+
+			std::string_view value = record.get(spec.valueColumn);
+			double number = readNumericValue(value);
+			cell.rowCount++;
+			cell.count += value.empty() ? 0 : 1;
+			if (!std::isnan(number)) {
+				cell.sum += number;
+				cell.min = std::min(cell.min, number);
+				cell.max = std::max(cell.max, number);
+				cell.numberCount++;
+			}
+		}
+	});
+
+	std::vector<CellState> &cells = chunkCells.front();
+	for (std::size_t chunk = 1; chunk < chunkCells.size(); chunk++) {
+		for (std::size_t i = 0; i < cellCount; i++) {
+			const CellState &other = chunkCells[chunk][i];
+			cells[i].sum += other.sum;
+			cells[i].min = std::min(cells[i].min, other.min);
+			cells[i].max = std::max(cells[i].max, other.max);
+			cells[i].numberCount += other.numberCount;
+			cells[i].count += other.count;
+			cells[i].rowCount += other.rowCount;
+		}
+	}
+
+	std::vector<char> isPeriodUsed(periodCount, false);
+	std::vector<char> isRowCodeUsed(rowCodeCount, false);
+	std::vector<char> isColumnCodeUsed(columnCodeCount, false);
+	for (std::size_t i = 0; i < cellCount; i++) {
+		if (cells[i].rowCount == 0) continue;
+		isPeriodUsed[i / (rowCodeCount * columnCodeCount)] = true;
+		isRowCodeUsed[i / columnCodeCount % rowCodeCount] = true;
+		isColumnCodeUsed[i % columnCodeCount] = true;
+	}
+
+	PivotTable table{};
+	table.spec = spec;
+	std::vector<std::uint32_t> rowCodes = usedCodes(isRowCodeUsed, rowDictionary);
+	std::vector<std::uint32_t> columnCodes = usedCodes(isColumnCodeUsed, columnDictionary);
+	for (std::uint32_t code : rowCodes) table.rowLabels.emplace_back(rowDictionary.lookup(code));
+	for (std::uint32_t code : columnCodes) table.columnLabels.emplace_back(columnDictionary.lookup(code));
+
+	constexpr double NO_VALUE = std::numeric_limits<double>::quiet_NaN();
+	for (std::size_t period = 0; period < periodCount; period++) {
+		if (!isPeriodUsed[period]) continue;
+
+		std::int32_t key = firstPeriod + static_cast<std::int32_t>(period);
+		if (spec.period == PivotPeriod::Month) table.periods.push_back(TimeSeries::toRefDate(key));
+		else if (spec.period == PivotPeriod::Year) table.periods.push_back(TimeSeries::toRefDate(key * 12).substr(0, 4));
+		else table.periods.emplace_back();
+
+		for (std::uint32_t rowCode : rowCodes) {
+			for (std::uint32_t columnCode : columnCodes) {
+				const CellState &cell = cells[(period * rowCodeCount + rowCode) * columnCodeCount + columnCode];
+				double value{ NO_VALUE };
+				if (spec.function == AggregateFunction::Count) value = static_cast<double>(cell.count);
+				else if (cell.numberCount == 0) value = NO_VALUE;
+				else if (spec.function == AggregateFunction::Sum) value = cell.sum;
+				else if (spec.function == AggregateFunction::Min) value = cell.min;
+				else if (spec.function == AggregateFunction::Max) value = cell.max;
+				else value = cell.sum / cell.numberCount;
+				table.cells.push_back(value);
+			}
+		}
+	}
+	return table;
+}
+
+/**
+ * @brief Cross-tabulates the records
+ * @param recordList the records
+ * @param spec the axes, period and summary
+ * @return the dense pivot table
+ * @throws std::invalid_argument if an axis is not a dictionary column, the function is CountDistinct, or the table would exceed MAX_CELLS
+*/
+PivotTable RecordPivot::pivot(const std::vector<RecordDTO> &recordList, const PivotSpec &spec) {
+	return pivotRows(recordList, recordList.size(), [](std::size_t i) { return i; }, spec);
+}
+
+/**
+ * @brief Cross-tabulates the selected records, such as the rows a RecordFilter matched
+ * @param recordList the records
+ * @param rows the rows to include
+ * @param spec the axes, period and summary
+ * @return the dense pivot table
+ * @throws std::invalid_argument if an axis is not a dictionary column, the function is CountDistinct, or the table would exceed MAX_CELLS
+*/
+PivotTable RecordPivot::pivot(const std::vector<RecordDTO> &recordList, const std::vector<RowId> &rows, const PivotSpec &spec) {
+	return pivotRows(recordList, rows.size(), [&rows](std::size_t i) { return rows[i]; }, spec);
+}
+
+/**
+ * @brief Lays the pivot out as text for display or export: a header row, then one row per period and row label
+ * @return the table's rows of cells
+*/
+std::vector<std::vector<std::string>> PivotTable::toTable() const {
+	bool hasPeriod = spec.period != PivotPeriod::None;
+	std::vector<std::vector<std::string>> table{};
+
+	std::vector<std::string> header{};
+	if (hasPeriod) header.push_back(columnInfo(RecordColumn::RefDate).header);
+	header.push_back(columnInfo(spec.rowColumn).header);
+	header.insert(header.end(), columnLabels.begin(), columnLabels.end());
+	table.push_back(std::move(header));
+
+	for (std::size_t period = 0; period < periods.size(); period++) {
+		for (std::size_t row = 0; row < rowLabels.size(); row++) {
+			std::vector<std::string> cells{};
+			if (hasPeriod) cells.push_back(periods[period]);
+			cells.push_back(rowLabels[row]);
+			for (std::size_t column = 0; column < columnLabels.size(); column++) {
+				cells.push_back(formatAggregateValue(at(period, row, column)));
+			}
+			table.push_back(std::move(cells));
+		}
+	}
+	return table;
+}
+
+TEST_CASE("Test that a parallel pivot matches totals computed row by row") {
+	const char *provinces[] = { "Quebec", "Ontario", "Manitoba" };
+	const char *products[] = { "Potatoes", "Onions" };
+	std::vector<RecordDTO> recordList(48000);
+	for (std::size_t row = 0; row < recordList.size(); row++) {
+		recordList[row].setGeo(provinces[row % 3]);
+		recordList[row].setProductType(products[row % 2]);
+		recordList[row].setRefDate(std::to_string(1970 + row % 4) + "-0" + std::to_string(1 + row % 9));
+		recordList[row].setValue(std::to_string(row % 50));
+	}
+
+	PivotSpec spec{};
+	spec.period = PivotPeriod::Year;
+	PivotTable table = RecordPivot::pivot(recordList, spec);
+
+	REQUIRE(table.periods == std::vector<std::string>{ "1970", "1971", "1972", "1973" });
+	REQUIRE(table.rowLabels == std::vector<std::string>{ "Manitoba", "Ontario", "Quebec" });
+	REQUIRE(table.columnLabels == std::vector<std::string>{ "Onions", "Potatoes" });
+
+	/* Ontario (row % 3 == 1), Onions (row % 2 == 1), 1971 (row % 4 == 1) */
+	double sum{ 0 };
+	for (std::size_t row = 0; row < recordList.size(); row++) {
+		if (row % 3 == 1 && row % 2 == 1 && row % 4 == 1) sum += row % 50;
+	}
+	CHECK(table.at(1, 1, 0) == sum);
+	/* Rows in 1970 have even numbers, so none of them are onions */
+	CHECK(std::isnan(table.at(0, 0, 0)));
+
+	std::vector<std::vector<std::string>> text = table.toTable();
+	CHECK(text.size() == 1 + 4 * 3);
+	CHECK(text[0] == std::vector<std::string>{ "REF_DATE", "GEO", "Onions", "Potatoes" });
+	CHECK_THROWS_AS(RecordPivot::pivot(recordList, PivotSpec{ RecordColumn::Vector }), std::invalid_argument);
+}
@@ -0,0 +1,104 @@
+/**
+* @file				RecordPivot.h
+* @author			Chloe Lee-Hone<leeh0002@algonquinlive.com>
+* @version			1.0
+* @section			Header file for the RecordPivot class, which builds cross-tabulations such as GEO by product type by period.
+*					This project contains information licensed under the Open Government Licence  Canada [1][2]. Code structure was informed by the provided example written by Stanley Pieda for CST8333 [3].
+*
+* Student Name:     Chloe Lee-Hone
+* Student Number:   041023578
+* Course:           CST8333_350: Programming Language Research Project
+* Professor:        Reg Dyer
+* Date:             05/06/2023
+*
+* References:
+* [1]   T. B. of C. Secretariat and T. B. S. of C. Open Government, Open Government Licence - Canada. http://open.canada.ca/en/open-government-licence-canada (accessed May 11, 2023).
+* [2]	T. B. of C. Secretariat and Open Government Portal, Vegetables in cold and common storage, Oct. 10, 2008. https://open.canada.ca/data/en/dataset/473f9524-45f8-47d0-9a12-537bb7704089 (accessed May 16, 2023).
+* [3]	S. Pieda, CST8333 19F Practical Project 2 Example Layered. Algonquin College, Algonquin College, Jun. 07, 2022. [Online]. Available: https://brightspace.algonquincollege.com/d2l/le/content/543581/viewContent/8322468/View
+*/
+
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "RecordAggregator.h"
+#include "RecordColumn.h"
+#include "RecordDTO.h"
+#include "doctest.h"
+
+#ifndef RECORD_PIVOT_H
+#define RECORD_PIVOT_H
+
+/** @brief How a pivot splits the records by REF_DATE. Each period gets its own matrix. */
+enum class PivotPeriod { None, Month, Year };
+
+/** @brief What a pivot cross-tabulates */
+struct PivotSpec {
+	/** @brief the column whose values label the matrix rows. Must be a dictionary column. */
+	RecordColumn rowColumn{ RecordColumn::Geo };
+	/** @brief the column whose values label the matrix columns. Must be a dictionary column. */
+	RecordColumn columnColumn{ RecordColumn::ProductType };
+	PivotPeriod period{ PivotPeriod::None };
+	/** @brief Sum, Count, Min, Max or Average */
+	AggregateFunction function{ AggregateFunction::Sum };
+	/** @brief the column summarized in each cell */
+	RecordColumn valueColumn{ RecordColumn::Value };
+};
+
+/**
+ * @brief A dense cross-tab: one matrix per period, with a row per rowColumn value and a column per columnColumn value.
+ * Labels are in ascending order and only values that occur in the records get a row or column.
+*/
+struct PivotTable {
+	PivotSpec spec{};
+	/** @brief each period's REF_DATE (YYYY-MM or YYYY), or a single empty label when the pivot has no period */
+	std::vector<std::string> periods{};
+	std::vector<std::string> rowLabels{};
+	std::vector<std::string> columnLabels{};
+	/** @brief the cells, period by period, then row by row. NaN where a Sum, Min, Max or Average had no numbers. */
+	std::vector<double> cells{};
+
+	/** @return the cell for a period, row and column */
+	double at(std::size_t period, std::size_t row, std::size_t column) const {
+		return cells[(period * rowLabels.size() + row) * columnLabels.size() + column];
+	}
+
+	/**
+	 * @brief Lays the pivot out as text for display or export: a header row, then one row per period and row label
+	 * @return the table's rows of cells
+	*/
+	std::vector<std::vector<std::string>> toTable() const;
+};
+
+/**
+ * @brief Builds pivot tables. Because both axes are dictionary columns, a row's cell is found by indexing with its two codes, with
+ * no hashing or searching, so the pivot costs about as much as one scan. Each thread fills its own dense matrix and the matrices are added up at the end.
+*/
+class RecordPivot
+{
+public:
+	using RowId = RecordIndex::RowId;
+
+	/** @brief The most cells a pivot may have, per thread. A pivot larger than this would not be worth reading. */
+	static constexpr std::size_t MAX_CELLS = std::size_t{ 1 } << 22;
+
+	/**
+	 * @brief Cross-tabulates the records
+	 * @param recordList the records
+	 * @param spec the axes, period and summary
+	 * @return the dense pivot table
+	 * @throws std::invalid_argument if an axis is not a dictionary column, the function is CountDistinct, or the table would exceed MAX_CELLS
+	*/
+	static PivotTable pivot(const std::vector<RecordDTO> &recordList, const PivotSpec &spec);
+
+	/**
+	 * @brief Cross-tabulates the selected records, such as the rows a RecordFilter matched
+	 * @param recordList the records
+	 * @param rows the rows to include
+	 * @param spec the axes, period and summary
+	 * @return the dense pivot table
+	 * @throws std::invalid_argument if an axis is not a dictionary column, the function is CountDistinct, or the table would exceed MAX_CELLS
+	*/
+	static PivotTable pivot(const std::vector<RecordDTO> &recordList, const std::vector<RowId> &rows, const PivotSpec &spec);
+};
+#endif // !RECORD_PIVOT_H
@@ -22,104 +22,1714 @@
 */
 
 #include "RecordService.h"
+#include "ParallelRange.h"
 #include "doctest.h"
 //#include <map>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <future>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <unordered_set>
 
 const int ASCENDING_ORDER = 0;
 const int DESCENDING_ORDER = 1;
 
 /**
- * @brief When a RecordService object is created, it reloads the data from the original data source.
+ * @brief Checks whether a column is part of the ordered index's key
+ * @param column the column
+ * @return true for RefDate and Geo
 */
-RecordService::RecordService() {
-	RecordService::reloadData();
+static bool isSortKeyColumn(RecordColumn column) {
+	return column == RecordColumn::RefDate || column == RecordColumn::Geo;
+}
+
+/**
+ * @brief Checks whether a column is read by the time series
+ * @param column the column
+ * @return true for RefDate, Vector and Value
+*/
+static bool isSeriesColumn(RecordColumn column) {
+	return column == RecordColumn::RefDate || column == RecordColumn::Vector || column == RecordColumn::Value;
+}
+
+/**
+ * @brief When a RecordService object is created, it starts loading the data from the original data source on a background
+ * thread, so the caller can show its first screen straight away.
+*/
+RecordService::RecordService() : RecordService(RecordDAO{}) {}
+
+/**
+ * @brief Starts loading the data set the given accessor reads, such as a test file, on a background thread
+ * @param recordAccessor the accessor for the data set
+*/
+RecordService::RecordService(RecordDAO recordAccessor) : recordAccessor{ std::move(recordAccessor) } {
+	for (RecordColumn column : DEFAULT_INDEXED_COLUMNS) {
+		RecordService::indexes.emplace_back(column);
+	}
+	for (RecordColumn column : DEFAULT_TEXT_INDEXED_COLUMNS) {
+		RecordService::textIndexes.emplace_back(column);
+	}
+	for (RecordColumn column : DEFAULT_SKETCH_GROUP_COLUMNS) {
+		RecordService::sketch.addGroupColumn(column);
+	}
+	// Published before the load starts, so snapshot() never has to wait on the loaded future
+	RecordService::publishedSnapshot = std::make_shared<const RecordSnapshot>();
+	RecordService::loaded = std::async(std::launch::async, &RecordService::loadInBackground, this).share();
+}
+
+/**
+ * @brief Waits for the background load to finish, as it uses the object
+*/
+RecordService::~RecordService() {
+	if (RecordService::loaded.valid()) {
+		RecordService::loaded.wait();
+	}
+}
+
+/**
+ * @brief Reads the data set a batch at a time, handing each batch to the loader so the first page can be served early, then
+ * builds the store from every record. Runs on the background thread the constructor starts. If the data set cannot be read,
+ * the store is built empty and loadError says why, so every operation still works and reloadData() can try again.
+*/
+void RecordService::loadInBackground() {
+	try {
+		RecordService::recordAccessor.readAllRecordsInBatches(RecordLoader::BATCH_RECORDS, [this](std::vector<RecordDTO> &&batch, std::size_t bytesRead, std::size_t totalBytes) {
+			RecordService::loader.addBatch(std::move(batch), bytesRead, totalBytes);
+		});
+	}
+	catch (const std::exception &error) {
+		// Wakes any reader waiting for a page; the records read before the error are dropped
+		RecordService::loader.takeRecords();
+		RecordService::loadError = error.what();
+		RecordService::installRecords({});
+		return;
+	}
+	RecordService::installRecords(RecordService::loader.takeRecords());
+}
+
+/**
+ * @brief Replaces every record, clears the undo history, and rebuilds the ids, indexes and snapshot
+ * @param newRecords the new records, in file order
+*/
+void RecordService::installRecords(std::vector<RecordDTO> newRecords) {
+	RecordService::recordList = std::move(newRecords);
+	RecordService::changeLog.clear();
+	RecordService::assignRecordIds();
+	RecordService::rebuildIndexes();
+	RecordService::rebuildUniqueKey();
+	RecordService::publish();
+}
+
+/** @return true once the background load has built the store */
+bool RecordService::isLoaded() const {
+	return RecordService::loaded.wait_for(std::chrono::seconds{ 0 }) == std::future_status::ready;
+}
+
+/** @return how far the background load has got */
+LoadProgress RecordService::loadProgress() const {
+	LoadProgress progress = RecordService::loader.progress();
+	progress.isLoaded = isLoaded();
+	return progress;
+}
+
+/**
+ * @brief Waits for the load, then reports whether it failed
+ * @return why the last load or reload could not read the data set, or an empty string if it succeeded
+*/
+std::string RecordService::getLoadError() const {
+	RecordService::waitUntilLoaded();
+	return RecordService::loadError;
 }
 
 /**
  * @brief Retrieves the specified record from the RecordService class' vector. This method is used to retrieve 
  * a record from the vector and modify it, so we want to pass by reference, rather than by value. 
- * @param recordId the record's line number
+ * @param recordId the record's id
  * @return the specified RecordDTO
+ * @throws std::out_of_range if no record has the id
+*/
+const RecordDTO &RecordService::getRecord(RecordId recordId) const {
+	RecordService::waitUntilLoaded();
+	return RecordService::recordList[slotOf(recordId)];
+}
+
+/**
+ * @brief Checks whether a record exists
+ * @param recordId the record's id
+ * @return true if the id belongs to a record that has not been deleted
+*/
+bool RecordService::hasRecord(RecordId recordId) const {
+	RecordService::waitUntilLoaded();
+	return RecordService::idToSlot.count(recordId) != 0;
+}
+
+/**
+ * @brief Finds a live record's slot
+ * @param recordId the record's id
+ * @return the record's position in recordList
+ * @throws std::out_of_range if no live record has the id
+*/
+RecordIndex::RowId RecordService::slotOf(RecordId recordId) const {
+	auto position = RecordService::idToSlot.find(recordId);
+	if (position == RecordService::idToSlot.end()) {
+		throw std::out_of_range("No record has the id " + std::to_string(recordId) + ".");
+	}
+	return position->second;
+}
+
+/**
+ * @brief Replaces one column of a record and updates the column's index. The edit can be reversed with undo().
+ * @param recordId the record's id
+ * @param column the column to change
+ * @param newValue the column's new value
+ * @throws std::invalid_argument if the edit would give the record another record's unique key
+*/
+void RecordService::updateRecord(RecordId recordId, RecordColumn column, std::string newValue) {
+	RecordService::waitUntilLoaded();
+	RecordIndex::RowId row = slotOf(recordId);
+	if (RecordService::uniqueKey && RecordService::uniqueKey->covers(column)) {
+		std::string newKey = RecordService::uniqueKey->keyOf(RecordService::recordList[row], column, newValue);
+		RecordId owner = RecordService::uniqueKey->find(newKey);
+		if (owner != UniqueKey::NO_RECORD && owner != recordId) {
+			throw std::invalid_argument("Another record already has " + RecordService::uniqueKey->describe(newKey) + ".");
+		}
+	}
+	RecordService::changeLog.recordUpdate(recordId, column, RecordService::recordList[row].get(column), newValue);
+	RecordService::applyUpdate(row, column, std::move(newValue));
+	RecordService::publish();
+}
+
+/**
+ * @brief Replaces one column of the record in a slot, keeping the indexes and caches in step, without logging the change
+ * @param row the record's slot
+ * @param column the column to change
+ * @param newValue the column's new value
+*/
+void RecordService::applyUpdate(RecordIndex::RowId row, RecordColumn column, std::string newValue) {
+	RecordDTO &record = RecordService::recordList[row];
+	bool isKeyChanged = RecordService::uniqueKey && RecordService::uniqueKey->covers(column);
+	if (isKeyChanged) {
+		RecordService::uniqueKey->erase(RecordService::uniqueKey->keyOf(record), RecordService::slotIds[row]);
+	}
+
+	for (RecordIndex &index : RecordService::indexes) {
+		if (index.getColumn() == column) {
+			index.erase(record.get(column), row);
+			index.insert(newValue, row);
+		}
+	}
+	RecordService::learnTextValue(column, newValue);
+
+	for (MaterializedAggregate &aggregate : RecordService::aggregateCache) {
+		if (aggregate.dependsOn(column)) aggregate.remove(record);
+	}
+	bool isSketchedColumn = RecordService::sketch.dependsOn(column);
+	if (isSketchedColumn) RecordService::sketch.remove(record);
+
+	if (isSortKeyColumn(column)) {
+		RecordService::sortIndex.erase(RecordService::recordList, row);
+		record.set(column, std::move(newValue));
+		RecordService::sortIndex.insert(RecordService::recordList, row);
+	}
+	else {
+		record.set(column, std::move(newValue));
+	}
+
+	for (MaterializedAggregate &aggregate : RecordService::aggregateCache) {
+		if (aggregate.dependsOn(column)) aggregate.add(record);
+	}
+	if (isSketchedColumn) {
+		RecordService::sketch.add(record);
+	}
+	else {
+		RecordService::sketch.replaceValue(column, record.get(column));
+	}
+	if (isKeyChanged) {
+		RecordService::uniqueKey->insert(RecordService::uniqueKey->keyOf(record), RecordService::slotIds[row]);
+	}
+	RecordService::isTimeSeriesStale = RecordService::isTimeSeriesStale || isSeriesColumn(column);
+	RecordService::markChanged(row);
+}
+
+/**
+ * @brief Retrieves a given number of RecordDTOs in a vector
+ * @param numberOfRecords The number of RecordDTOs to retrieve
+ * @return a vector containing the specified number of RecordDTOs.
+*/
+std::vector<RecordDTO> RecordService::getTopRecords(int numberOfRecords) {
+	RecordService::waitUntilLoaded();
+	RecordPage page = getPage(0, static_cast<std::size_t>(std::max(numberOfRecords, 0)));
+	return std::vector<RecordDTO>(page.begin(), page.end());
+}
+
+/**
+ * @brief Returns all the records stored in the RecordService class' vector. Copies every record; getPage() shows records without copying them.
+ * @return a list of RecordDTO objects
+*/
+std::vector<RecordDTO> RecordService::getAllRecords() {
+	RecordService::waitUntilLoaded();
+	if (RecordService::deletedCount == 0) {
+		return RecordService::recordList;
+	}
+
+	std::vector<RecordDTO> allRecords{};
+	allRecords.reserve(recordCount());
+	for (RecordIndex::RowId row : liveRows()) {
+		allRecords.push_back(RecordService::recordList[row]);
+	}
+	return allRecords;
+}
+
+/**
+ * @brief Returns a view of a page of records in the order they are stored, without copying any record. With no deleted records
+ * the page is found directly; otherwise the deleted slots are skipped from whichever end of the vector is nearer the page.
+ * @param offset the number of records before the page
+ * @param limit the most records the page holds
+ * @return the page, valid until the next change to the records. Empty if offset is past the last record.
+*/
+RecordPage RecordService::getPage(std::size_t offset, std::size_t limit) const {
+	if (!isLoaded()) {
+		std::optional<RecordPage> earlyPage = RecordService::loader.copyPage(offset, limit);
+		if (earlyPage) {
+			return *earlyPage;
+		}
+	}
+	RecordService::waitUntilLoaded();
+
+	std::size_t totalCount = recordCount();
+	std::size_t count = offset < totalCount ? std::min(limit, totalCount - offset) : 0;
+	std::vector<RecordIndex::RowId> rows{};
+	rows.reserve(count);
+
+	if (count == 0) {
+		return RecordPage{ RecordService::recordList, std::move(rows), offset, totalCount };
+	}
+	if (RecordService::deletedCount == 0) {
+		rows.resize(count);
+		std::iota(rows.begin(), rows.end(), static_cast<RecordIndex::RowId>(offset));
+	}
+	else if (offset <= totalCount - offset - count) {
+		std::size_t skipped{ 0 };
+		for (RecordIndex::RowId row = 0; rows.size() < count; row++) {
+			if (RecordService::slotIds[row] == DELETED_RECORD) continue;
+			if (skipped < offset) skipped++;
+			else rows.push_back(row);
+		}
+	}
+	else {
+		// The page is nearer the end, so count the live records after it from the back and then reverse
+		std::size_t after = totalCount - offset - count;
+		std::size_t skipped{ 0 };
+		for (std::size_t row = RecordService::recordList.size(); rows.size() < count; ) {
+			row--;
+			if (RecordService::slotIds[row] == DELETED_RECORD) continue;
+			if (skipped < after) skipped++;
+			else rows.push_back(static_cast<RecordIndex::RowId>(row));
+		}
+		std::reverse(rows.begin(), rows.end());
+	}
+	return RecordPage{ RecordService::recordList, std::move(rows), offset, totalCount };
+}
+
+/**
+ * @brief Returns a view of a page of the records in any sort order, optionally only the records a filter matches, without
+ * copying any record. A sorted page costs O(n log (offset + limit)), as only the rows up to the page's end are kept in order.
+ * @param request the page's offset and limit, and the sort order and filter
+ * @return the page, valid until the next change to the records
+*/
+RecordPage RecordService::getPage(const PageRequest &request) const {
+	if (!request.filter && request.sortKeys.empty()) {
+		return getPage(request.offset, request.limit);
+	}
+	RecordService::waitUntilLoaded();
+
+	std::size_t pageEnd = request.offset + std::min(request.limit, std::numeric_limits<std::size_t>::max() - request.offset);
+	std::vector<RecordIndex::RowId> rows{};
+	std::size_t totalCount{ 0 };
+	if (request.filter) {
+		rows = request.filter->select(RecordService::recordList, liveRows());
+		totalCount = rows.size();
+		if (!request.sortKeys.empty()) {
+			rows = RecordSorter::topK(RecordService::recordList, rows, request.sortKeys, pageEnd);
+		}
+	}
+	else {
+		// Deleted slots are still in recordList, so keep enough rows to skip all of them
+		totalCount = recordCount();
+		std::size_t wanted = pageEnd + std::min(RecordService::deletedCount, std::numeric_limits<std::size_t>::max() - pageEnd);
+		rows = RecordSorter::topK(RecordService::recordList, request.sortKeys, wanted);
+		rows.erase(std::remove_if(rows.begin(), rows.end(), [this](RecordIndex::RowId row) { return RecordService::slotIds[row] == DELETED_RECORD; }), rows.end());
+	}
+
+	std::size_t pageBegin = std::min(request.offset, rows.size());
+	std::vector<RecordIndex::RowId> pageRows(rows.begin() + pageBegin, rows.begin() + std::min(pageEnd, rows.size()));
+	return RecordPage{ RecordService::recordList, std::move(pageRows), request.offset, totalCount };
+}
+
+/**
+ * @brief Inserts a new record into the RecordService class' vector. The insert can be reversed with undo().
+ * @param newRecord 
+ * @return the new record's id
+ * @throws std::invalid_argument if another record has the new record's unique key
+*/
+RecordService::RecordId RecordService::insertRecord(RecordDTO newRecord) {
+	RecordService::waitUntilLoaded();
+	if (RecordService::uniqueKey) {
+		std::string key = RecordService::uniqueKey->keyOf(newRecord);
+		if (RecordService::uniqueKey->find(key) != UniqueKey::NO_RECORD) {
+			throw std::invalid_argument("A record with " + RecordService::uniqueKey->describe(key) + " already exists.");
+		}
+	}
+	RecordId recordId = RecordService::nextRecordId++;
+	RecordIndex::RowId row = RecordService::appendRecord(recordId, std::move(newRecord));
+	RecordService::changeLog.recordInsert(recordId, row, RecordService::compactionCount, RecordService::recordList[row]);
+	RecordService::publish();
+	return recordId;
+}
+
+/**
+ * @brief Adds a record with a given id to the end of the vector, keeping the indexes and caches in step, without logging the change
+ * @param recordId the record's id
+ * @param newRecord the record
+ * @return the record's slot
+*/
+RecordIndex::RowId RecordService::appendRecord(RecordId recordId, RecordDTO newRecord) {
+	RecordIndex::RowId row = static_cast<RecordIndex::RowId>(RecordService::recordList.size());
+	for (RecordIndex &index : RecordService::indexes) {
+		index.insert(newRecord.get(index.getColumn()), row);
+	}
+	for (TextIndex &textIndex : RecordService::textIndexes) {
+		textIndex.addValue(newRecord.get(textIndex.getColumn()));
+	}
+	for (MaterializedAggregate &aggregate : RecordService::aggregateCache) {
+		aggregate.add(newRecord);
+	}
+	RecordService::sketch.add(newRecord);
+	if (RecordService::uniqueKey) {
+		RecordService::uniqueKey->insert(RecordService::uniqueKey->keyOf(newRecord), recordId);
+	}
+	RecordService::recordList.push_back(std::move(newRecord));
+	RecordService::sortIndex.insert(RecordService::recordList, row);
+	RecordService::isTimeSeriesStale = true;
+
+	RecordService::slotIds.push_back(recordId);
+	RecordService::idToSlot.emplace(recordId, row);
+	RecordService::markChanged(row);
+	return row;
+}
+
+/**
+ * @brief Deletes a RecordDTO by leaving a tombstone in its slot, so no other record moves and every id stays valid.
+ * The indexes keep listing the slot until compaction; lookups leave tombstones out. The delete can be reversed with undo().
+ * @param recordId the record's id
+*/
+void RecordService::deleteRecord(RecordId recordId) {
+	RecordService::waitUntilLoaded();
+	RecordIndex::RowId row = slotOf(recordId);
+	RecordService::changeLog.recordDelete(recordId, row, RecordService::compactionCount, RecordService::recordList[row]);
+	RecordService::tombstone(row);
+	RecordService::publish();
+}
+
+/**
+ * @brief Leaves a tombstone in a live record's slot, keeping the caches in step, without logging the change
+ * @param row the record's slot
+*/
+void RecordService::tombstone(RecordIndex::RowId row) {
+	for (MaterializedAggregate &aggregate : RecordService::aggregateCache) {
+		aggregate.remove(RecordService::recordList[row]);
+	}
+	RecordService::sketch.remove(RecordService::recordList[row]);
+	if (RecordService::uniqueKey) {
+		RecordService::uniqueKey->erase(RecordService::uniqueKey->keyOf(RecordService::recordList[row]), RecordService::slotIds[row]);
+	}
+	RecordService::idToSlot.erase(RecordService::slotIds[row]);
+	RecordService::slotIds[row] = DELETED_RECORD;
+	RecordService::deletedCount++;
+	RecordService::isTimeSeriesStale = true;
+	RecordService::markChanged(row);
+	RecordService::compactIfNeeded();
+}
+
+/**
+ * @brief Compacts recordList once deleted slots make up a quarter of it. Each compaction costs O(n) and follows at least n / 4
+ * deletes, so deletes cost O(1) amortized even when millions of records are deleted one after another.
+*/
+void RecordService::compactIfNeeded() {
+	if (RecordService::deletedCount * 4 >= RecordService::recordList.size()) {
+		RecordService::compactSlots();
+	}
+}
+
+/**
+ * @brief Removes the deleted records' slots by sliding the live records down in one pass. Records keep their order and their
+ * ids; the indexes are renumbered in place rather than rebuilt.
+*/
+void RecordService::compact() {
+	RecordService::waitUntilLoaded();
+	RecordService::compactSlots();
+	RecordService::publish();
+}
+
+/**
+ * @brief Removes the deleted records' slots without publishing a new snapshot, so a compaction in the middle of an undo or a
+ * transaction is published with the rest of it
+*/
+void RecordService::compactSlots() {
+	if (RecordService::deletedCount == 0) {
+		return;
+	}
+
+	std::vector<RecordIndex::RowId> newRows(RecordService::recordList.size(), RecordIndex::NO_ROW);
+	RecordIndex::RowId nextRow{ 0 };
+	for (RecordIndex::RowId row = 0; row < RecordService::recordList.size(); row++) {
+		if (RecordService::slotIds[row] == DELETED_RECORD) {
+			continue;
+		}
+		if (row != nextRow) {
+			RecordService::recordList[nextRow] = std::move(RecordService::recordList[row]);
+			RecordService::slotIds[nextRow] = RecordService::slotIds[row];
+			RecordService::idToSlot[RecordService::slotIds[nextRow]] = nextRow;
+		}
+		newRows[row] = nextRow++;
+	}
+	RecordService::recordList.erase(RecordService::recordList.begin() + nextRow, RecordService::recordList.end());
+	RecordService::slotIds.resize(nextRow);
+
+	for (RecordIndex &index : RecordService::indexes) {
+		index.renumber(newRows);
+	}
+	RecordService::sortIndex.renumber(newRows);
+	RecordService::deletedCount = 0;
+	RecordService::compactionCount++;
+	RecordService::isTimeSeriesStale = true;
+	RecordService::markAllChanged();
+}
+
+/**
+ * @brief Brings back a record that an Insert or Delete change refers to. If no compaction has run since the change, the
+ * record's tombstone is still in its slot and still listed by every index, so it is revived in place. Otherwise the record
+ * is read back from the change log and appended with its old id.
+ * @param change the change
+*/
+void RecordService::restoreRecord(const ChangeLog::Change &change) {
+	if (change.compactionCount != RecordService::compactionCount || RecordService::slotIds[change.slot] != DELETED_RECORD) {
+		RecordService::appendRecord(change.recordId, RecordService::changeLog.readRecord(change));
+		return;
+	}
+
+	RecordService::slotIds[change.slot] = change.recordId;
+	RecordService::idToSlot.emplace(change.recordId, change.slot);
+	if (RecordService::uniqueKey) {
+		RecordService::uniqueKey->insert(RecordService::uniqueKey->keyOf(RecordService::recordList[change.slot]), change.recordId);
+	}
+	RecordService::deletedCount--;
+	for (MaterializedAggregate &aggregate : RecordService::aggregateCache) {
+		aggregate.add(RecordService::recordList[change.slot]);
+	}
+	RecordService::sketch.add(RecordService::recordList[change.slot]);
+	RecordService::isTimeSeriesStale = true;
+	RecordService::markChanged(change.slot);
+}
+
+/**
+ * @brief Applies every operation of a transaction in order, or none of them. Every operation is checked before anything
+ * changes. The records are then changed in one pass while the journal records the operations as one group, and each index,
+ * the ordered index and the cached group-by results are brought up to date once at the end rather than once per operation.
+ * @param transaction the staged operations
+ * @return the ids of the inserted records, in the order they were staged
+ * @throws std::invalid_argument if an update or delete names a record that does not exist or that the transaction already deleted
+ * or if the transaction would give two records the same unique key
+*/
+std::vector<RecordService::RecordId> RecordService::commitTransaction(RecordTransaction transaction) {
+	RecordService::waitUntilLoaded();
+	using OperationKind = RecordTransaction::OperationKind;
+
+	std::unordered_set<RecordId> deletedIds{};
+	std::vector<RecordIndex::RowId> changedRows{};
+	// Rows the percentile sketches must remove and add again: deleted rows and rows with an edited VALUE or group column
+	std::vector<RecordIndex::RowId> sketchedRows{};
+	for (const RecordTransaction::Operation &operation : transaction.getOperations()) {
+		if (operation.kind == OperationKind::Insert) {
+			continue;
+		}
+		if (!hasRecord(operation.recordId) || deletedIds.count(operation.recordId) != 0) {
+			throw std::invalid_argument("The transaction changes record " + std::to_string(operation.recordId) + ", which does not exist.");
+		}
+		if (operation.kind == OperationKind::Delete) {
+			deletedIds.insert(operation.recordId);
+		}
+		changedRows.push_back(slotOf(operation.recordId));
+		if (operation.kind == OperationKind::Delete || RecordService::sketch.dependsOn(operation.column)) {
+			sketchedRows.push_back(slotOf(operation.recordId));
+		}
+	}
+	if (RecordService::uniqueKey) {
+		checkUniqueKeys(transaction);
+	}
+	std::sort(changedRows.begin(), changedRows.end());
+	changedRows.erase(std::unique(changedRows.begin(), changedRows.end()), changedRows.end());
+	std::sort(sketchedRows.begin(), sketchedRows.end());
+	sketchedRows.erase(std::unique(sketchedRows.begin(), sketchedRows.end()), sketchedRows.end());
+
+	// A transaction touching a quarter of the records is cheaper to re-aggregate from scratch on the next read
+	std::vector<RecordDTO> insertedRecords = transaction.takeInsertedRecords();
+	bool isBulk = (changedRows.size() + insertedRecords.size()) * 4 > RecordService::recordList.size();
+	for (MaterializedAggregate &aggregate : RecordService::aggregateCache) {
+		if (isBulk) {
+			aggregate.invalidate();
+			continue;
+		}
+		for (RecordIndex::RowId row : changedRows) {
+			aggregate.remove(RecordService::recordList[row]);
+		}
+	}
+	// A stale sketch ignores every change until it is rebuilt, so a bulk commit skips the per-record sketch updates
+	if (isBulk) {
+		RecordService::sketch.invalidate();
+	}
+	else {
+		for (RecordIndex::RowId row : sketchedRows) {
+			RecordService::sketch.remove(RecordService::recordList[row]);
+		}
+	}
+
+	/* Apply the operations. An indexed value is remembered the first time its row and column change, so each index erases
+	   it and inserts the final value once, however many operations touched it. */
+	std::vector<std::vector<RecordIndex::Entry>> erasedEntries(RecordService::indexes.size());
+	std::vector<std::vector<RecordIndex::RowId>> editedRows(RecordService::indexes.size());
+	std::unordered_set<std::uint64_t> editedCells{};
+	std::vector<RecordIndex::RowId> insertedRows{};
+	std::vector<RecordIndex::RowId> placedRows{};
+	std::vector<RecordId> insertedIds{};
+	bool isSeriesChanged{ false };
+
+	RecordService::recordList.reserve(RecordService::recordList.size() + insertedRecords.size());
+	RecordService::slotIds.reserve(RecordService::slotIds.size() + insertedRecords.size());
+	RecordService::idToSlot.reserve(RecordService::idToSlot.size() + insertedRecords.size());
+	std::vector<RecordTransaction::Operation> operations = transaction.takeOperations();
+	RecordService::changeLog.beginGroup();
+	for (RecordTransaction::Operation &operation : operations) {
+		if (operation.kind == OperationKind::Insert) {
+			RecordId recordId = RecordService::nextRecordId++;
+			RecordIndex::RowId row = static_cast<RecordIndex::RowId>(RecordService::recordList.size());
+			RecordService::recordList.push_back(std::move(insertedRecords[operation.recordIndex]));
+			RecordService::slotIds.push_back(recordId);
+			RecordService::idToSlot.emplace(recordId, row);
+			RecordService::changeLog.recordInsert(recordId, row, RecordService::compactionCount, RecordService::recordList[row]);
+			if (RecordService::uniqueKey) {
+				RecordService::uniqueKey->insert(RecordService::uniqueKey->keyOf(RecordService::recordList[row]), recordId);
+			}
+
+			RecordService::markChanged(row);
+			insertedRows.push_back(row);
+			placedRows.push_back(row);
+			insertedIds.push_back(recordId);
+			isSeriesChanged = true;
+		}
+		else if (operation.kind == OperationKind::Update) {
+			RecordIndex::RowId row = slotOf(operation.recordId);
+			RecordDTO &record = RecordService::recordList[row];
+			RecordService::changeLog.recordUpdate(operation.recordId, operation.column, record.get(operation.column), operation.value);
+
+			for (std::size_t i = 0; i < RecordService::indexes.size(); i++) {
+				std::uint64_t cell = static_cast<std::uint64_t>(row) * RecordService::indexes.size() + i;
+				if (RecordService::indexes[i].getColumn() == operation.column && editedCells.insert(cell).second) {
+					erasedEntries[i].emplace_back(std::string{ record.get(operation.column) }, row);
+					editedRows[i].push_back(row);
+				}
+			}
+			if (isSortKeyColumn(operation.column)) {
+				placedRows.push_back(row);
+			}
+			bool isKeyChanged = RecordService::uniqueKey && RecordService::uniqueKey->covers(operation.column);
+			if (isKeyChanged) {
+				RecordService::uniqueKey->erase(RecordService::uniqueKey->keyOf(record), operation.recordId);
+			}
+			record.set(operation.column, std::move(operation.value));
+			if (isKeyChanged) {
+				RecordService::uniqueKey->insert(RecordService::uniqueKey->keyOf(record), operation.recordId);
+			}
+			if (!isBulk && !RecordService::sketch.dependsOn(operation.column)) {
+				RecordService::sketch.replaceValue(operation.column, record.get(operation.column));
+			}
+			RecordService::markChanged(row);
+			isSeriesChanged = isSeriesChanged || isSeriesColumn(operation.column);
+		}
+		else {
+			RecordIndex::RowId row = slotOf(operation.recordId);
+			RecordService::changeLog.recordDelete(operation.recordId, row, RecordService::compactionCount, RecordService::recordList[row]);
+			if (RecordService::uniqueKey) {
+				RecordService::uniqueKey->erase(RecordService::uniqueKey->keyOf(RecordService::recordList[row]), operation.recordId);
+			}
+			RecordService::idToSlot.erase(operation.recordId);
+			RecordService::slotIds[row] = DELETED_RECORD;
+			RecordService::deletedCount++;
+			RecordService::markChanged(row);
+			isSeriesChanged = true;
+		}
+	}
+	RecordService::changeLog.endGroup();
+
+	/* Bring every structure up to date once. Deleted rows stay listed as tombstones, as they do for deleteRecord(). */
+	for (std::size_t i = 0; i < RecordService::indexes.size(); i++) {
+		RecordIndex &index = RecordService::indexes[i];
+		std::vector<RecordIndex::Entry> insertedEntries{};
+		insertedEntries.reserve(editedRows[i].size() + insertedRows.size());
+		for (RecordIndex::RowId row : editedRows[i]) {
+			insertedEntries.emplace_back(std::string{ RecordService::recordList[row].get(index.getColumn()) }, row);
+		}
+		for (RecordIndex::RowId row : insertedRows) {
+			insertedEntries.emplace_back(std::string{ RecordService::recordList[row].get(index.getColumn()) }, row);
+		}
+		index.eraseBatch(erasedEntries[i]);
+		index.insertBatch(insertedEntries);
+	}
+	for (TextIndex &textIndex : RecordService::textIndexes) {
+		for (RecordIndex::RowId row : changedRows) {
+			textIndex.addValue(RecordService::recordList[row].get(textIndex.getColumn()));
+		}
+		for (RecordIndex::RowId row : insertedRows) {
+			textIndex.addValue(RecordService::recordList[row].get(textIndex.getColumn()));
+		}
+	}
+
+	std::sort(placedRows.begin(), placedRows.end());
+	placedRows.erase(std::unique(placedRows.begin(), placedRows.end()), placedRows.end());
+	if (!placedRows.empty()) {
+		RecordService::sortIndex.placeBatch(RecordService::recordList, placedRows);
+	}
+
+	if (!isBulk) {
+		for (RecordIndex::RowId row : sketchedRows) {
+			if (RecordService::slotIds[row] != DELETED_RECORD) RecordService::sketch.add(RecordService::recordList[row]);
+		}
+		for (RecordIndex::RowId row : insertedRows) {
+			RecordService::sketch.add(RecordService::recordList[row]);
+		}
+		for (MaterializedAggregate &aggregate : RecordService::aggregateCache) {
+			for (RecordIndex::RowId row : changedRows) {
+				if (RecordService::slotIds[row] != DELETED_RECORD) aggregate.add(RecordService::recordList[row]);
+			}
+			for (RecordIndex::RowId row : insertedRows) {
+				aggregate.add(RecordService::recordList[row]);
+			}
+		}
+	}
+
+	RecordService::isTimeSeriesStale = RecordService::isTimeSeriesStale || isSeriesChanged;
+	RecordService::compactIfNeeded();
+	RecordService::publish();
+	return insertedIds;
+}
+
+/**
+ * @brief Inserts many records as one transaction: the storage is reserved once, the records are moved in, and every index
+ * and the journal are updated once for the batch. undo() removes the whole batch.
+ * @param newRecords the records to insert
+ * @return the new records' ids, in the same order
+*/
+std::vector<RecordService::RecordId> RecordService::insertRecords(std::vector<RecordDTO> newRecords) {
+	RecordService::waitUntilLoaded();
+	RecordTransaction transaction{};
+	transaction.reserve(newRecords.size());
+	for (RecordDTO &newRecord : newRecords) {
+		transaction.insertRecord(std::move(newRecord));
+	}
+	return commitTransaction(std::move(transaction));
+}
+
+/**
+ * @brief Deletes every record a filter matches as one transaction. The records are tested in parallel in a single pass.
+ * @param filter the records to delete
+ * @return the number of records deleted
+*/
+std::size_t RecordService::deleteWhere(const RecordFilter &filter) {
+	RecordService::waitUntilLoaded();
+	std::vector<RecordId> recordIds = filterRecords(filter);
+
+	RecordTransaction transaction{};
+	transaction.reserve(recordIds.size());
+	for (RecordId recordId : recordIds) {
+		transaction.deleteRecord(recordId);
+	}
+	commitTransaction(std::move(transaction));
+	return recordIds.size();
+}
+
+/**
+ * @brief Sets one column of every record a filter matches as one transaction. The records are tested and the new values
+ * computed in parallel in a single pass.
+ * @param filter the records to update
+ * @param column the column to change
+ * @param expression computes each record's new value from the record. It is called from several threads at once.
+ * @return the number of records updated
+*/
+std::size_t RecordService::updateWhere(const RecordFilter &filter, RecordColumn column, const RecordExpression &expression) {
+	RecordService::waitUntilLoaded();
+	std::vector<RecordIndex::RowId> rows = filter.apply(RecordService::recordList);
+	rows.erase(std::remove_if(rows.begin(), rows.end(), [this](RecordIndex::RowId row) { return RecordService::slotIds[row] == DELETED_RECORD; }), rows.end());
+
+	std::vector<std::string> newValues(rows.size());
+	forEachChunk(rows.size(), [&](std::size_t begin, std::size_t end, std::size_t) {
+		for (std::size_t position = begin; position < end; position++) {
+			newValues[position] = expression(RecordService::recordList[rows[position]]);
+		}
+	});
+
+	RecordTransaction transaction{};
+	transaction.reserve(rows.size());
+	for (std::size_t position = 0; position < rows.size(); position++) {
+		transaction.updateRecord(RecordService::slotIds[rows[position]], column, std::move(newValues[position]));
+	}
+	commitTransaction(std::move(transaction));
+	return rows.size();
+}
+
+/**
+ * @brief Reverses the latest change that has not been undone, or every change of the latest committed transaction.
+ * Touches only the changed records.
+ * @return false if there is no change to undo
+*/
+bool RecordService::undo() {
+	RecordService::waitUntilLoaded();
+	if (!RecordService::changeLog.canUndo()) {
+		return false;
+	}
+
+	ChangeLog::Change change{};
+	do {
+		change = RecordService::changeLog.undo();
+		switch (change.kind) {
+		case ChangeLog::ChangeKind::Insert:
+			RecordService::tombstone(slotOf(change.recordId));
+			break;
+		case ChangeLog::ChangeKind::Update:
+			RecordService::applyUpdate(slotOf(change.recordId), change.column, RecordService::changeLog.readValue(change, false));
+			break;
+		default:
+			RecordService::restoreRecord(change);
+			break;
+		}
+	} while (!change.isGroupStart);
+	RecordService::publish();
+	return true;
+}
+
+/**
+ * @brief Applies the latest undone change or transaction again
+ * @return false if there is no change to redo
+*/
+bool RecordService::redo() {
+	RecordService::waitUntilLoaded();
+	if (!RecordService::changeLog.canRedo()) {
+		return false;
+	}
+
+	do {
+		ChangeLog::Change change = RecordService::changeLog.redo();
+		switch (change.kind) {
+		case ChangeLog::ChangeKind::Insert:
+			RecordService::restoreRecord(change);
+			break;
+		case ChangeLog::ChangeKind::Update:
+			RecordService::applyUpdate(slotOf(change.recordId), change.column, RecordService::changeLog.readValue(change, true));
+			break;
+		default:
+			RecordService::tombstone(slotOf(change.recordId));
+			break;
+		}
+	} while (RecordService::changeLog.canRedoInGroup());
+	RecordService::publish();
+	return true;
+}
+
+/**
+ * @brief Keeps at most maxMemoryBytes of the change history in memory and spills the rest to a file
+ * @param path the file to spill to. It is replaced.
+ * @param maxMemoryBytes the most history bytes kept in memory
+*/
+void RecordService::spillHistoryToDisk(std::string path, std::size_t maxMemoryBytes) {
+	RecordService::waitUntilLoaded();
+	RecordService::changeLog.enableSpill(std::move(path), maxMemoryBytes);
+}
+
+/**
+ * @brief Converts slots to record ids, leaving out deleted slots
+ * @param rows positions in recordList
+ * @return the ids of the live records among them, in the same order
+*/
+std::vector<RecordService::RecordId> RecordService::toRecordIds(const std::vector<RecordIndex::RowId> &rows) const {
+	std::vector<RecordId> recordIds{};
+	recordIds.reserve(rows.size());
+	for (RecordIndex::RowId row : rows) {
+		if (RecordService::slotIds[row] != DELETED_RECORD) {
+			recordIds.push_back(RecordService::slotIds[row]);
+		}
+	}
+	return recordIds;
+}
+
+/**
+ * @return the position of every live record in recordList, in ascending order
+*/
+std::vector<RecordIndex::RowId> RecordService::liveRows() const {
+	std::vector<RecordIndex::RowId> rows{};
+	rows.reserve(RecordService::recordList.size() - RecordService::deletedCount);
+	for (RecordIndex::RowId row = 0; row < RecordService::recordList.size(); row++) {
+		if (RecordService::slotIds[row] != DELETED_RECORD) {
+			rows.push_back(row);
+		}
+	}
+	return rows;
+}
+
+/**
+ * @brief Uses the RecordDAO object to write the current list of records to a new file
+*/
+void RecordService::writeToFile(std::string newFileName) {
+	RecordService::waitUntilLoaded();
+	newFileName.append(".csv");
+	// Deleted slots are skipped rather than compacted away, so pages taken before the write stay valid
+	if (RecordService::deletedCount == 0) {
+		recordAccessor.writeToFile(RecordService::recordList, newFileName);
+		return;
+	}
+	std::vector<RecordDTO> liveRecords{};
+	liveRecords.reserve(RecordService::recordList.size() - RecordService::deletedCount);
+	for (RecordIndex::RowId row : liveRows()) {
+		liveRecords.push_back(RecordService::recordList[row]);
+	}
+	recordAccessor.writeToFile(liveRecords, newFileName);
+}
+
+/**
+ * @brief Uses a RecordDAO object to write a snapshot's records to a new file. Safe to run on any thread while the records
+ * change, because the snapshot never does.
+ * @param snapshot the version to write. Holding it keeps the version alive until the file is written.
+ * @param newFileName the file's name without the extension
+*/
+void RecordService::writeSnapshotToFile(std::shared_ptr<const RecordSnapshot> snapshot, std::string newFileName) {
+	RecordDAO recordAccessor{};
+	newFileName.append(".csv");
+	recordAccessor.writeToFile(snapshot->getAllRecords(), newFileName);
+}
+
+/**
+ * @brief Returns the latest published version of the records. This is the only member that may be called from another thread
+ * while the records change: it pins the version without waiting on the writer, and the version never changes afterwards.
+ * Until the background load finishes it returns the empty version 0, so wait on whenLoaded() first to read the data set.
+ * @return the latest snapshot
+*/
+std::shared_ptr<const RecordSnapshot> RecordService::snapshot() const {
+	return std::atomic_load(&publishedSnapshot);
+}
+
+/**
+ * @brief Notes that a slot changed, so the next published snapshot copies the slot's chunk
+ * @param row the slot
+*/
+void RecordService::markChanged(RecordIndex::RowId row) {
+	std::size_t chunk = row / RecordSnapshot::CHUNK_SIZE;
+	if (chunk >= RecordService::dirtyChunks.size()) {
+		RecordService::dirtyChunks.resize(chunk + 1, true);
+	}
+	RecordService::dirtyChunks[chunk] = true;
+	RecordService::hasUnpublishedChanges = true;
+}
+
+/**
+ * @brief Notes that every slot may have changed, so the next published snapshot copies every chunk
+*/
+void RecordService::markAllChanged() {
+	RecordService::dirtyChunks.clear();
+	RecordService::hasUnpublishedChanges = true;
+}
+
+/**
+ * @brief Publishes the records as a new snapshot once a public change is complete, so readers see all of a change or none of
+ * it. Chunks with no changed slot are shared with the previous snapshot, so a single edit copies CHUNK_SIZE records rather
+ * than all of them. The previous snapshot is freed when its last reader lets go of it.
+*/
+void RecordService::publish() {
+	if (!RecordService::hasUnpublishedChanges) {
+		return;
+	}
+
+	std::shared_ptr<const RecordSnapshot> previous = std::atomic_load(&publishedSnapshot);
+	std::size_t chunkCount = (RecordService::recordList.size() + RecordSnapshot::CHUNK_SIZE - 1) / RecordSnapshot::CHUNK_SIZE;
+	std::vector<std::shared_ptr<const RecordSnapshot::Chunk>> chunks(chunkCount);
+	for (std::size_t chunk = 0; chunk < chunkCount; chunk++) {
+		bool isClean = chunk < RecordService::dirtyChunks.size() && !RecordService::dirtyChunks[chunk];
+		if (isClean && previous && chunk < previous->getChunks().size()) {
+			chunks[chunk] = previous->getChunks()[chunk];
+			continue;
+		}
+
+		std::size_t begin = chunk * RecordSnapshot::CHUNK_SIZE;
+		std::size_t end = std::min(begin + RecordSnapshot::CHUNK_SIZE, RecordService::recordList.size());
+		auto copy = std::make_shared<RecordSnapshot::Chunk>();
+		copy->records.assign(RecordService::recordList.begin() + begin, RecordService::recordList.begin() + end);
+		copy->ids.assign(RecordService::slotIds.begin() + begin, RecordService::slotIds.begin() + end);
+		chunks[chunk] = std::move(copy);
+	}
+
+	std::atomic_store(&publishedSnapshot,
+		std::shared_ptr<const RecordSnapshot>(std::make_shared<RecordSnapshot>(++RecordService::snapshotVersion, std::move(chunks))));
+	RecordService::dirtyChunks.assign(chunkCount, false);
+	RecordService::hasUnpublishedChanges = false;
+}
+
+/**
+ * @brief Uses the RecordDAO object to reload the data from the original CSV file. If the file cannot be read, the records are
+ * left as they are and getLoadError() says why. If the reloaded records break the unique key, the constraint is turned off.
+ * @return true if the records were reloaded
+*/
+bool RecordService::reloadData() {
+	RecordService::waitUntilLoaded();
+	std::vector<RecordDTO> newRecords{};
+	try {
+		newRecords = recordAccessor.getAllRecords();
+	}
+	catch (const std::exception &error) {
+		RecordService::loadError = error.what();
+		return false;
+	}
+	RecordService::loadError.clear();
+	RecordService::installRecords(std::move(newRecords));
+	return true;
+}
+
+/**
+ * @brief Returns every record sorted by the RefDate and Geo columns in ascending or descending order, depending on the user's input.
+ * The records are read in the ordered index's order, so recordList and the record ids that refer to it are left untouched.
+ * @param order either 0 (ascending) or 1(descending).
+ * @return the sorted vector of RecordDTOs
+ * Learned how to use C++ streams in [4][5][6]
+*/
+std::vector<RecordDTO> RecordService::sortRecords(int order) const {
+	RecordService::waitUntilLoaded();
+	return getSortedRecords(static_cast<int>(recordCount()), order);
+}
+
+/**
+ * @brief Returns the first records sorted by the RefDate and Geo columns. Reads them from the ordered index, so the cost is
+ * proportional to numberOfRecords rather than to the size of the data set.
+ * @param numberOfRecords the number of sorted records wanted
+ * @param order either 0 (ascending) or 1(descending).
+ * @return at most numberOfRecords RecordDTOs in sorted order
+*/
+std::vector<RecordDTO> RecordService::getSortedRecords(int numberOfRecords, int order) const {
+	RecordService::waitUntilLoaded();
+	std::vector<RecordDTO> sortedRecords{};
+	std::size_t count = static_cast<std::size_t>(std::max(numberOfRecords, 0));
+	// Deleted slots stay in the ordered index until compaction, so read enough rows to skip all of them
+	std::vector<OrderedIndex::RowId> rows = RecordService::sortIndex.first(count + RecordService::deletedCount, order == DESCENDING_ORDER);
+
+	sortedRecords.reserve(std::min(count, rows.size()));
+	for (OrderedIndex::RowId row : rows) {
+		if (sortedRecords.size() == count) break;
+		if (RecordService::slotIds[row] != DELETED_RECORD) {
+			sortedRecords.push_back(RecordService::recordList[row]);
+		}
+	}
+	return sortedRecords;
+}
+
+/**
+ * @brief Sorts the records by any list of columns, each ascending or descending. recordList itself is not reordered.
+ * @param sortKeys the columns to sort by, most significant first
+ * @param isStable true to keep records with equal keys in their current order
+ * @return the records' ids, in sorted order
+*/
+std::vector<RecordService::RecordId> RecordService::sortRecordIds(const std::vector<SortKey> &sortKeys, bool isStable) const {
+	RecordService::waitUntilLoaded();
+	return toRecordIds(RecordSorter::sort(RecordService::recordList, sortKeys, isStable));
+}
+
+/**
+ * @brief Returns the first records of any sort order, copying only those records. Costs O(n log numberOfRecords).
+ * @param sortKeys the columns to sort by, most significant first
+ * @param numberOfRecords the number of sorted records wanted
+ * @return at most numberOfRecords RecordDTOs in sorted order, with ties in their current order
+*/
+std::vector<RecordDTO> RecordService::getSortedRecords(const std::vector<SortKey> &sortKeys, int numberOfRecords) const {
+	RecordService::waitUntilLoaded();
+	std::vector<RecordDTO> sortedRecords{};
+	std::size_t count = static_cast<std::size_t>(std::max(numberOfRecords, 0));
+	std::vector<RecordIndex::RowId> rows = RecordSorter::topK(RecordService::recordList, sortKeys, count + RecordService::deletedCount);
+
+	sortedRecords.reserve(std::min(count, rows.size()));
+	for (RecordIndex::RowId row : rows) {
+		if (sortedRecords.size() == count) break;
+		if (RecordService::slotIds[row] != DELETED_RECORD) {
+			sortedRecords.push_back(RecordService::recordList[row]);
+		}
+	}
+	return sortedRecords;
+}
+
+/**
+ * @brief Rebuilds every index from recordList. Used after the list is replaced or reordered.
+*/
+void RecordService::rebuildIndexes() {
+	for (RecordIndex &index : RecordService::indexes) {
+		index.build(RecordService::recordList);
+	}
+	for (TextIndex &textIndex : RecordService::textIndexes) {
+		textIndex.build(RecordService::recordList);
+	}
+	RecordService::sortIndex.build(RecordService::recordList);
+	RecordService::sketch.build(RecordService::recordList);
+	RecordService::isTimeSeriesStale = true;
+	for (MaterializedAggregate &aggregate : RecordService::aggregateCache) {
+		aggregate.invalidate();
+	}
+}
+
+/**
+ * @brief Gives the records in recordList new ids, numbered from 0 in file order. Used after the list is replaced.
+*/
+void RecordService::assignRecordIds() {
+	RecordService::slotIds.resize(RecordService::recordList.size());
+	std::iota(RecordService::slotIds.begin(), RecordService::slotIds.end(), RecordId{ 0 });
+	RecordService::idToSlot.clear();
+	RecordService::idToSlot.reserve(RecordService::slotIds.size());
+	for (RecordIndex::RowId row = 0; row < RecordService::slotIds.size(); row++) {
+		RecordService::idToSlot.emplace(RecordService::slotIds[row], row);
+	}
+	RecordService::nextRecordId = RecordService::slotIds.size();
+	RecordService::deletedCount = 0;
+	RecordService::compactionCount++;
+	RecordService::markAllChanged();
+}
+
+
+/**
+ * @brief Finds the index on a column
+ * @param column the column
+ * @return the column's index, or nullptr if the column is not indexed
+*/
+const RecordIndex *RecordService::findIndex(RecordColumn column) const {
+	for (const RecordIndex &index : RecordService::indexes) {
+		if (index.getColumn() == column) {
+			return &index;
+		}
+	}
+	return nullptr;
+}
+
+/**
+ * @brief Builds an index on a column so findRecords() can answer lookups on it without a scan. Does nothing if the column is already indexed.
+ * @param column the column to index
+*/
+void RecordService::createIndex(RecordColumn column) {
+	RecordService::waitUntilLoaded();
+	if (!hasIndex(column)) {
+		RecordService::indexes.emplace_back(column);
+		RecordService::indexes.back().build(RecordService::recordList);
+	}
+}
+
+/**
+ * @brief Removes a column's index, and its text index, which finds rows through it. Lookups on the column fall back to a scan.
+ * @param column the column whose index is removed
+*/
+void RecordService::dropIndex(RecordColumn column) {
+	RecordService::waitUntilLoaded();
+	RecordService::indexes.erase(std::remove_if(RecordService::indexes.begin(), RecordService::indexes.end(),
+		[column](const RecordIndex &index) { return index.getColumn() == column; }), RecordService::indexes.end());
+	RecordService::dropTextIndex(column);
+}
+
+/**
+ * @brief Checks whether a column is indexed
+ * @param column the column
+ * @return true if findRecords() uses an index for the column
+*/
+bool RecordService::hasIndex(RecordColumn column) const {
+	RecordService::waitUntilLoaded();
+	return findIndex(column) != nullptr;
+}
+
+/**
+ * @brief Finds every record whose column equals a value. Uses the column's index if there is one, and scans otherwise.
+ * @param column the column to compare
+ * @param value the value to look for
+ * @return the matching records' ids, in the order the records are stored
+*/
+std::vector<RecordService::RecordId> RecordService::findRecords(RecordColumn column, std::string_view value) const {
+	RecordService::waitUntilLoaded();
+	const RecordIndex *index = findIndex(column);
+	if (index != nullptr) {
+		return toRecordIds(index->find(value));
+	}
+
+	return toRecordIds(RecordFilter::equals(column, std::string{ value }).apply(RecordService::recordList));
+}
+
+/**
+ * @brief Finds every record a filter matches, such as GEO = "Quebec" AND VALUE > 1000
+ * @param filter the predicate tree to evaluate
+ * @return the matching records' ids, in the order the records are stored
+*/
+std::vector<RecordService::RecordId> RecordService::filterRecords(const RecordFilter &filter) const {
+	RecordService::waitUntilLoaded();
+	return toRecordIds(filter.apply(RecordService::recordList));
+}
+
+/**
+ * @brief Tells the column's text index, if there is one, about a value a change has given it
+ * @param column the changed column
+ * @param value the column's new value
+*/
+void RecordService::learnTextValue(RecordColumn column, std::string_view value) {
+	for (TextIndex &textIndex : RecordService::textIndexes) {
+		if (textIndex.getColumn() == column) {
+			textIndex.addValue(value);
+		}
+	}
+}
+
+/**
+ * @brief Finds the slots whose column matches a piece of text, through the column's text index if there is one and by a scan otherwise
+ * @param column the column to search
+ * @param text the text to look for
+ * @param match whether the text may appear anywhere in the value or only at its start
+ * @return the matching slots in ascending order, deleted slots included
+*/
+std::vector<RecordIndex::RowId> RecordService::textRows(RecordColumn column, std::string_view text, TextMatch match) const {
+	std::vector<RecordIndex::RowId> rows{};
+	for (const TextIndex &textIndex : RecordService::textIndexes) {
+		if (textIndex.getColumn() != column) {
+			continue;
+		}
+		// Each matching value's rows come from the column's equality index; values no record holds any more find none
+		const RecordIndex *index = findIndex(column);
+		for (std::string_view value : textIndex.findValues(text, match)) {
+			std::vector<RecordIndex::RowId> valueRows = index->find(value);
+			rows.insert(rows.end(), valueRows.begin(), valueRows.end());
+		}
+		std::sort(rows.begin(), rows.end());
+		return rows;
+	}
+
+	for (RecordIndex::RowId row = 0; row < RecordService::recordList.size(); row++) {
+		if (TextIndex::isMatch(RecordService::recordList[row].get(column), text, match)) {
+			rows.push_back(row);
+		}
+	}
+	return rows;
+}
+
+/**
+ * @brief Builds a trigram index on a column so searchText() can answer searches on it without comparing every record. Also
+ * indexes the column for findRecords(), as the search uses that index to find the rows holding each matching value.
+ * Does nothing if the column already has a text index.
+ * @param column the column to index
+*/
+void RecordService::createTextIndex(RecordColumn column) {
+	RecordService::waitUntilLoaded();
+	if (hasTextIndex(column)) {
+		return;
+	}
+	createIndex(column);
+	RecordService::textIndexes.emplace_back(column);
+	RecordService::textIndexes.back().build(RecordService::recordList);
+}
+
+/**
+ * @brief Removes a column's text index. Searches on the column fall back to a scan. The column keeps its findRecords() index.
+ * @param column the column whose text index is removed
 */
-RecordDTO &RecordService::getRecord(int recordId) {
-	 //assumes the recordId corresponds to a record's row number
-	return RecordService::recordList.at(recordId);
+void RecordService::dropTextIndex(RecordColumn column) {
+	RecordService::waitUntilLoaded();
+	RecordService::textIndexes.erase(std::remove_if(RecordService::textIndexes.begin(), RecordService::textIndexes.end(),
+		[column](const TextIndex &textIndex) { return textIndex.getColumn() == column; }), RecordService::textIndexes.end());
 }
 
 /**
- * @brief Retrieves a given number of RecordDTOs in a vector
- * @param numberOfRecords The number of RecordDTOs to retrieve
- * @return a vector containing the specified number of RecordDTOs.
+ * @brief Checks whether a column has a text index
+ * @param column the column
+ * @return true if searchText() uses a trigram index for the column
 */
-std::vector<RecordDTO> RecordService::getTopRecords(int numberOfRecords) {
-	std::vector<RecordDTO> topRecords{};
-	
-	for (int i = 0; i < numberOfRecords; i++) {
-		topRecords.push_back(RecordService::recordList.at(i));
+bool RecordService::hasTextIndex(RecordColumn column) const {
+	RecordService::waitUntilLoaded();
+	return std::any_of(RecordService::textIndexes.begin(), RecordService::textIndexes.end(),
+		[column](const TextIndex &textIndex) { return textIndex.getColumn() == column; });
+}
+
+/**
+ * @brief Finds every record whose column holds a piece of text, ignoring the case of ASCII letters, such as "brit" in GEO
+ * @param column the column to search
+ * @param text the text to look for
+ * @param match whether the text may appear anywhere in the value or only at its start
+ * @return the matching records' ids, in the order the records are stored
+*/
+std::vector<RecordService::RecordId> RecordService::searchText(RecordColumn column, std::string_view text, TextMatch match) const {
+	RecordService::waitUntilLoaded();
+	return toRecordIds(textRows(column, text, match));
+}
+
+/**
+ * @brief Finds every record whose column holds a piece of text and that a filter also matches. The filter only tests the
+ * rows the search found.
+ * @param column the column to search
+ * @param text the text to look for
+ * @param match whether the text may appear anywhere in the value or only at its start
+ * @param filter the other conditions the records must meet
+ * @return the matching records' ids, in the order the records are stored
+*/
+std::vector<RecordService::RecordId> RecordService::searchText(RecordColumn column, std::string_view text, TextMatch match, const RecordFilter &filter) const {
+	RecordService::waitUntilLoaded();
+	return toRecordIds(filter.select(RecordService::recordList, textRows(column, text, match)));
+}
+
+/**
+ * @brief Summarizes the records by group, such as the total and average VALUE for each GEO
+ * @param keys the columns to group by
+ * @param aggregates the summaries to compute for each group
+ * @return one row per group, in ascending key order
+*/
+GroupByResult RecordService::groupRecords(const std::vector<GroupKey> &keys, const std::vector<Aggregate> &aggregates) const {
+	RecordService::waitUntilLoaded();
+	if (RecordService::deletedCount == 0) {
+		return RecordAggregator::groupBy(RecordService::recordList, keys, aggregates);
 	}
-	return topRecords;
+	return RecordAggregator::groupBy(RecordService::recordList, liveRows(), keys, aggregates);
 }
 
 /**
- * @brief Returns all the records stored in the RecordService class' vector
- * @return a list of RecordDTO objects
+ * @brief Summarizes the records a filter matches by group
+ * @param keys the columns to group by
+ * @param aggregates the summaries to compute for each group
+ * @param filter selects the records to summarize
+ * @return one row per group, in ascending key order
 */
-std::vector<RecordDTO> RecordService::getAllRecords() {
-	return RecordService::recordList;
+GroupByResult RecordService::groupRecords(const std::vector<GroupKey> &keys, const std::vector<Aggregate> &aggregates, const RecordFilter &filter) const {
+	RecordService::waitUntilLoaded();
+	return RecordAggregator::groupBy(RecordService::recordList, filter.select(RecordService::recordList, liveRows()), keys, aggregates);
 }
 
 /**
- * @brief Inserts a new record into the RecordService class' vector
- * @param newRecord 
+ * @brief Uses the RecordDAO object to write a group-by result to a new file
+ * @param result the result to write
+ * @param newFileName the file's name without the file extension
+ * @throws std::runtime_error if the file cannot be opened or written
 */
-void RecordService::insertRecord(RecordDTO newRecord) {
-	RecordService::recordList.push_back(newRecord);
+void RecordService::writeGroupsToFile(const GroupByResult &result, std::string newFileName) {
+	RecordService::waitUntilLoaded();
+	newFileName.append(".csv");
+	recordAccessor.writeTableToFile(result.toTable(), newFileName);
 }
 
 /**
- * @brief Deletes a RecordDTO from the RecordService class' vector. Assumes the recordId is 
- * equivalent to its row in the CSV file.
- * @param recordId the record's row in the CSV file
+ * @brief Cross-tabulates the records, such as total VALUE by GEO and product type for each year
+ * @param spec the axes, period and summary
+ * @return the dense pivot table
+ * @throws std::invalid_argument if an axis is not a dictionary column, the function is CountDistinct, or the table would exceed RecordPivot::MAX_CELLS
 */
-void RecordService::deleteRecord(int recordId) {
-	RecordService::recordList.erase(RecordService::recordList.begin() + recordId);
+PivotTable RecordService::pivotRecords(const PivotSpec &spec) const {
+	RecordService::waitUntilLoaded();
+	if (RecordService::deletedCount == 0) {
+		return RecordPivot::pivot(RecordService::recordList, spec);
+	}
+	return RecordPivot::pivot(RecordService::recordList, liveRows(), spec);
 }
 
 /**
- * @brief Uses the RecordDAO object to write the current list of records to a new file
+ * @brief Uses the RecordDAO object to write a pivot table to a new file
+ * @param table the pivot table to write
+ * @param newFileName the file's name without the file extension
+ * @throws std::runtime_error if the file cannot be opened or written
 */
-void RecordService::writeToFile(std::string newFileName) {
+void RecordService::writePivotToFile(const PivotTable &table, std::string newFileName) {
+	RecordService::waitUntilLoaded();
 	newFileName.append(".csv");
-	recordAccessor.writeToFile(RecordService::recordList, newFileName);
+	recordAccessor.writeTableToFile(table.toTable(), newFileName);
 }
 
 /**
- * @brief Uses the RecordDAO object to reload the data from the original CSV file
+ * @brief Returns the records grouped into one date-ordered series per VECTOR. The series are rebuilt here the first time
+ * they are needed after a change, so edits never pay for them.
+ * @return the series, valid until the next change to the records
 */
-void RecordService::reloadData() {
-	RecordService::recordList = recordAccessor.getAllRecords();
+const TimeSeries &RecordService::getTimeSeries() {
+	RecordService::waitUntilLoaded();
+	if (RecordService::isTimeSeriesStale) {
+		// The series refer to records by slot; compactSlots() marks them stale when it moves the slots
+		if (RecordService::deletedCount == 0) {
+			RecordService::timeSeries.build(RecordService::recordList);
+		}
+		else {
+			RecordService::timeSeries.build(RecordService::recordList, liveRows());
+		}
+		RecordService::isTimeSeriesStale = false;
+	}
+	return RecordService::timeSeries;
 }
 
 /**
- * @brief Sorts the RefDate and Geo columns by ascending or descending, depending on the user's input
- * @param order either 0 (ascending) or 1(descending).
- * @return the sorted vector of RecordDTOs
- * Learned how to use C++ streams in [4][5][6]
+ * @brief Summarizes the records by group, reusing the cached result for the same keys and aggregates. The cache entry is
+ * created on first use and rebuilt only when an edit left it stale.
+ * @param keys the columns to group by
+ * @param aggregates the summaries to compute for each group
+ * @return one row per group, in ascending key order
+*/
+GroupByResult RecordService::getCachedGroups(const std::vector<GroupKey> &keys, const std::vector<Aggregate> &aggregates) {
+	RecordService::waitUntilLoaded();
+	auto cached = std::find_if(RecordService::aggregateCache.begin(), RecordService::aggregateCache.end(),
+		[&](const MaterializedAggregate &aggregate) { return aggregate.isFor(keys, aggregates); });
+	if (cached == RecordService::aggregateCache.end()) {
+		RecordService::aggregateCache.emplace_back(keys, aggregates);
+		cached = RecordService::aggregateCache.end() - 1;
+	}
+	if (cached->isStale()) {
+		if (RecordService::deletedCount == 0) {
+			cached->build(RecordService::recordList);
+		}
+		else {
+			cached->build(RecordService::recordList, liveRows());
+		}
+	}
+	return cached->result();
+}
+
+/**
+ * @brief Rebuilds the sketch from the live records if removals have made it stale
+*/
+void RecordService::refreshSketch() {
+	if (RecordService::sketch.isStale()) {
+		if (RecordService::deletedCount == 0) {
+			RecordService::sketch.build(RecordService::recordList);
+		}
+		else {
+			RecordService::sketch.build(RecordService::recordList, liveRows());
+		}
+	}
+}
+
+/**
+ * @brief Counts a column's different non-empty values, such as the number of series in VECTOR. The estimate is read from a
+ * HyperLogLog sketch in constant time and is typically within 2%; values removed since the sketch was last rebuilt may still be counted.
+ * @param column the column
+ * @param isExact true to count every live record's value instead
+ * @return the estimated or exact count
+*/
+std::size_t RecordService::estimateDistinctCount(RecordColumn column, bool isExact) {
+	RecordService::waitUntilLoaded();
+	if (isExact) {
+		return RecordSketch::exactDistinctCount(RecordService::recordList, liveRows(), column);
+	}
+	refreshSketch();
+	return RecordService::sketch.distinctCount(column);
+}
+
+/**
+ * @brief Finds a percentile of VALUE over every record, such as the 95th. The estimate is read from a quantile sketch in constant time.
+ * @param fraction the percentile as a fraction, such as 0.95 for the 95th
+ * @param isExact true to sort every live record's value instead
+ * @return the estimated or exact percentile, or NaN if no VALUE is a number
+ * @throws std::invalid_argument if the fraction is not between 0 and 1
+*/
+double RecordService::estimateQuantile(double fraction, bool isExact) {
+	RecordService::waitUntilLoaded();
+	if (isExact) {
+		std::map<std::string, double> quantiles = RecordSketch::exactQuantiles(RecordService::recordList, liveRows(), std::nullopt, fraction);
+		return quantiles.empty() ? std::numeric_limits<double>::quiet_NaN() : quantiles.begin()->second;
+	}
+	refreshSketch();
+	return RecordService::sketch.quantile(fraction);
+}
+
+/**
+ * @brief Finds a percentile of VALUE for each value of a column, such as the 95th percentile by province. A column without
+ * a sketch yet is sketched once, then kept up to date like the others.
+ * @param groupColumn the column to group by
+ * @param fraction the percentile as a fraction, such as 0.95 for the 95th
+ * @param isExact true to sort every live record's value instead
+ * @return the estimated or exact percentile of each group with a numeric VALUE, in ascending group order
+ * @throws std::invalid_argument if the fraction is not between 0 and 1
+*/
+std::map<std::string, double> RecordService::estimateQuantiles(RecordColumn groupColumn, double fraction, bool isExact) {
+	RecordService::waitUntilLoaded();
+	if (isExact) {
+		return RecordSketch::exactQuantiles(RecordService::recordList, liveRows(), groupColumn, fraction);
+	}
+	RecordService::sketch.addGroupColumn(groupColumn);
+	refreshSketch();
+	return RecordService::sketch.groupQuantiles(groupColumn, fraction);
+}
+
+/**
+ * @brief Forgets every cached group-by result
+*/
+void RecordService::clearAggregateCache() {
+	RecordService::waitUntilLoaded();
+	RecordService::aggregateCache.clear();
+}
+
+/**
+ * @brief Refuses, from now on, any insert, edit or transaction that would give two records the same values in the key columns.
+ * Each check is a single hash lookup. Undo and redo restore earlier states without checking them.
+ * @param columns the key's columns, by default REF_DATE and VECTOR
+ * @throws std::invalid_argument if the records already break the constraint. findDuplicates() lists the offenders.
+*/
+void RecordService::enableUniqueKey(std::vector<RecordColumn> columns) {
+	RecordService::waitUntilLoaded();
+	UniqueKey newKey{ std::move(columns) };
+	std::vector<RecordIndex::RowId> rows = liveRows();
+	std::vector<UniqueKey::Duplicate> duplicates = newKey.findDuplicates(RecordService::recordList, rows);
+	if (!duplicates.empty()) {
+		throw std::invalid_argument(std::to_string(duplicates.size()) + " keys are held by more than one record, such as " + newKey.describe(duplicates.front().key) + ".");
+	}
+
+	RecordService::uniqueKey = std::move(newKey);
+	RecordService::rebuildUniqueKey();
+}
+
+/**
+ * @brief Lists every combination of key values that more than one record holds, scanning the records in parallel.
+ * Works whether or not a unique key is enabled.
+ * @param columns the key's columns, by default REF_DATE and VECTOR
+ * @return one entry per duplicated key, ordered by the key's first record
+*/
+std::vector<RecordService::DuplicateRecords> RecordService::findDuplicates(std::vector<RecordColumn> columns) const {
+	RecordService::waitUntilLoaded();
+	UniqueKey key{ std::move(columns) };
+	std::vector<DuplicateRecords> duplicates{};
+	for (UniqueKey::Duplicate &duplicate : key.findDuplicates(RecordService::recordList, liveRows())) {
+		duplicates.push_back(DuplicateRecords{ key.describe(duplicate.key), toRecordIds(duplicate.rows) });
+	}
+	return duplicates;
+}
+
+/**
+ * @brief Applies a revised CSV file, such as a newer release of the data set, without discarding local changes. The file is
+ * read by the parallel loader and hash-joined against the stored records: each chunk of the file probes the key's hash map on
+ * its own thread and notes which records are new and which columns of the others changed. The matches are then staged in file
+ * order and committed as one transaction. When the unique key is enabled on the same columns its map is probed directly, so
+ * the merge costs one pass over the file; otherwise the map is built from the stored records first.
+ * @param filePath the revised file
+ * @param keyColumns the columns that identify a record, by default REF_DATE and VECTOR
+ * @return the number of records inserted, updated and left unchanged
+ * @throws std::runtime_error if the file cannot be opened
+ * @throws std::invalid_argument if the merge would break the unique key
+*/
+RecordService::MergeResult RecordService::mergeFromFile(const std::string &filePath, std::vector<RecordColumn> keyColumns) {
+	RecordService::waitUntilLoaded();
+	std::vector<RecordDTO> fileRecords = RecordService::recordAccessor.readRecordsFromFile(filePath);
+
+	std::optional<UniqueKey> joinKey{};
+	if (!RecordService::uniqueKey || RecordService::uniqueKey->getColumns() != keyColumns) {
+		joinKey.emplace(std::move(keyColumns));
+		for (RecordIndex::RowId row : liveRows()) {
+			joinKey->insert(joinKey->keyOf(RecordService::recordList[row]), RecordService::slotIds[row]);
+		}
+	}
+	const UniqueKey &storeKey = joinKey ? *joinKey : *RecordService::uniqueKey;
+
+	/* Probe the store in parallel. A match remembers which columns differ as bits in columnIndex() order, or none if the file's
+	   record is identical. */
+	struct Match {
+		std::size_t position;
+		RecordId recordId;
+		std::uint32_t changedColumns;
+	};
+	struct ChunkMatches {
+		std::vector<std::pair<std::string, std::size_t>> inserts{};
+		std::vector<Match> matches{};
+	};
+	std::vector<ChunkMatches> chunkMatches(parallelChunkCount(fileRecords.size()));
+	forEachChunk(fileRecords.size(), [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+		ChunkMatches &matches = chunkMatches[chunk];
+		for (std::size_t position = begin; position < end; position++) {
+			const RecordDTO &fileRecord = fileRecords[position];
+			std::string key = storeKey.keyOf(fileRecord);
+			RecordId owner = storeKey.find(key);
+			if (owner == UniqueKey::NO_RECORD) {
+				matches.inserts.emplace_back(std::move(key), position);
+				continue;
+			}
+
+			const RecordDTO &storedRecord = RecordService::recordList[slotOf(owner)];
+			std::uint32_t changedColumns{ 0 };
+			for (const ColumnInfo &column : RECORD_COLUMNS) {
+				if (storedRecord.get(column.column) != fileRecord.get(column.column)) {
+					changedColumns |= std::uint32_t{ 1 } << columnIndex(column.column);
+				}
+			}
+			matches.matches.push_back(Match{ position, owner, changedColumns });
+		}
+	});
+
+	/* Stage the matches in file order. A key the file repeats is inserted or compared once, with the file's last record for it,
+	   so each count is of distinct records. */
+	MergeResult result{ 0, 0, 0 };
+	std::vector<std::size_t> insertPositions{};
+	std::unordered_map<std::string, std::size_t> stagedKeys{};
+	std::vector<Match> recordMatches{};
+	std::unordered_map<RecordId, std::size_t> matchedRecords{};
+	for (ChunkMatches &matches : chunkMatches) {
+		for (auto &insert : matches.inserts) {
+			auto staged = stagedKeys.try_emplace(std::move(insert.first), insertPositions.size());
+			if (staged.second) {
+				insertPositions.push_back(insert.second);
+			}
+			else {
+				insertPositions[staged.first->second] = insert.second;
+			}
+		}
+		for (const Match &match : matches.matches) {
+			auto matched = matchedRecords.try_emplace(match.recordId, recordMatches.size());
+			if (matched.second) {
+				recordMatches.push_back(match);
+			}
+			else {
+				recordMatches[matched.first->second] = match;
+			}
+		}
+	}
+
+	RecordTransaction transaction{};
+	for (const Match &match : recordMatches) {
+		if (match.changedColumns == 0) {
+			result.unchangedCount++;
+			continue;
+		}
+		for (const ColumnInfo &column : RECORD_COLUMNS) {
+			if (match.changedColumns & (std::uint32_t{ 1 } << columnIndex(column.column))) {
+				transaction.updateRecord(match.recordId, column.column, std::string{ fileRecords[match.position].get(column.column) });
+			}
+		}
+		result.updatedCount++;
+	}
+	for (std::size_t position : insertPositions) {
+		transaction.insertRecord(std::move(fileRecords[position]));
+	}
+	result.insertedCount = insertPositions.size();
+
+	commitTransaction(std::move(transaction));
+	return result;
+}
+
+/**
+ * @brief Fills the unique key from the live records. If two records share a key, such as after a reload, the constraint is
+ * turned off rather than left half enforced, since deleting the record that held the key would free it while its duplicate remains.
+ * @return false if the constraint was turned off
 */
-std::vector<RecordDTO> RecordService::sortRecords(int order) {
-	if (order == ASCENDING_ORDER) {
-		std::sort(RecordService::recordList.begin(), RecordService::recordList.end(), [](RecordDTO first, RecordDTO second) {
-			if (first.getRefDate() != second.getRefDate()) return first.getRefDate() < second.getRefDate(); return first.getGeo() < second.getGeo();
-			});
+bool RecordService::rebuildUniqueKey() {
+	if (!RecordService::uniqueKey) {
+		return true;
+	}
+	RecordService::uniqueKey->clear();
+	for (RecordIndex::RowId row : liveRows()) {
+		std::string key = RecordService::uniqueKey->keyOf(RecordService::recordList[row]);
+		if (RecordService::uniqueKey->find(key) != UniqueKey::NO_RECORD) {
+			RecordService::uniqueKey.reset();
+			return false;
+		}
+		RecordService::uniqueKey->insert(std::move(key), RecordService::slotIds[row]);
 	}
-	if (order == DESCENDING_ORDER) {
-		std::sort(RecordService::recordList.begin(), RecordService::recordList.end(), [](RecordDTO first, RecordDTO second) {
-			if (first.getRefDate() != second.getRefDate()) return first.getRefDate() > second.getRefDate(); return first.getGeo() > second.getGeo();
-			});
+	return true;
+}
+
+/**
+ * @brief Replays a transaction's effect on the unique key without changing anything, tracking the keys the transaction
+ * takes and releases on top of the keys already held
+ * @param transaction the transaction
+ * @throws std::invalid_argument if an operation would take a key that is held when the operation runs
+*/
+void RecordService::checkUniqueKeys(const RecordTransaction &transaction) const {
+	using OperationKind = RecordTransaction::OperationKind;
+	std::unordered_map<std::string, bool> isTaken{};
+	std::unordered_map<RecordId, RecordDTO> changedRecords{};
+
+	auto isHeld = [this, &isTaken](const std::string &key) {
+		auto taken = isTaken.find(key);
+		return taken != isTaken.end() ? taken->second : RecordService::uniqueKey->find(key) != UniqueKey::NO_RECORD;
+	};
+	auto take = [this, &isTaken, &isHeld](const std::string &key) {
+		if (isHeld(key)) {
+			throw std::invalid_argument("The transaction gives a second record " + RecordService::uniqueKey->describe(key) + ".");
+		}
+		isTaken[key] = true;
+	};
+
+	for (const RecordTransaction::Operation &operation : transaction.getOperations()) {
+		if (operation.kind == OperationKind::Insert) {
+			take(RecordService::uniqueKey->keyOf(transaction.getInsertedRecords()[operation.recordIndex]));
+			continue;
+		}
+		if (operation.kind == OperationKind::Update && !RecordService::uniqueKey->covers(operation.column)) {
+			continue;
+		}
+
+		RecordDTO &record = changedRecords.try_emplace(operation.recordId, RecordService::recordList[slotOf(operation.recordId)]).first->second;
+		std::string oldKey = RecordService::uniqueKey->keyOf(record);
+		if (operation.kind == OperationKind::Delete) {
+			isTaken[oldKey] = false;
+			continue;
+		}
+		record.set(operation.column, operation.value);
+		std::string newKey = RecordService::uniqueKey->keyOf(record);
+		if (newKey != oldKey) {
+			isTaken[oldKey] = false;
+			take(newKey);
+		}
 	}
+}
+
+/**
+ * @brief Uses the RecordDAO object to read another table, such as a production or price table, to join with the records
+ * @param filePath the table's CSV file, with a header row
+ * @return the table
+ * @throws std::runtime_error if the file cannot be opened
+*/
+TableDTO RecordService::loadTable(const std::string &filePath) {
+	return RecordService::recordAccessor.readTableFromFile(filePath);
+}
+
+/**
+ * @brief Joins the records with another table on the spec's key columns and keeps the result in memory
+ * @param table the table, such as one returned by loadTable()
+ * @param spec the key columns and join type, by default an inner join on REF_DATE and GEO
+ * @return the record columns followed by the table's non-key columns, one row per match
+ * @throws std::invalid_argument if the spec does not fit the table
+*/
+TableDTO RecordService::joinTable(const TableDTO &table, const JoinSpec &spec) const {
+	RecordService::waitUntilLoaded();
+	return RecordJoin::join(RecordService::recordList, liveRows(), table, spec);
+}
+
+/**
+ * @brief Joins the records with another table and writes each batch of the result to a new file as soon as it is ready,
+ * so the whole join is never held in memory
+ * @param table the table, such as one returned by loadTable()
+ * @param spec the key columns and join type
+ * @param newFileName the file's name without the file extension
+ * @return the number of joined rows written
+ * @throws std::invalid_argument if the spec does not fit the table. Nothing is written.
+ * @throws std::runtime_error if the file cannot be opened or written. The rows written before the error are kept.
+*/
+std::size_t RecordService::writeJoinToFile(const TableDTO &table, const JoinSpec &spec, std::string newFileName) {
+	RecordService::waitUntilLoaded();
+	RecordJoin recordJoin{ table, spec };
+	newFileName.append(".csv");
+	RecordService::recordAccessor.writeTableToFile({ recordJoin.getHeaders() }, newFileName);
 
-	return RecordService::recordList;
+	std::size_t writtenCount{ 0 };
+	recordJoin.probe(RecordService::recordList, liveRows(), [&](std::vector<RecordJoin::Row> &&batch) {
+		writtenCount += batch.size();
+		RecordService::recordAccessor.appendTableToFile(batch, newFileName);
+	});
+	return writtenCount;
 }
 
 //STUDENT NAME: CHLOE LEE-HONE
@@ -147,24 +1757,654 @@ TEST_CASE("Test that records are inserted into the vector with correct data") {
 						"CLH Decimals");
 	
 	recordService.insertRecord(recordDto);
+	RecordPage lastPage = recordService.getPage(recordService.recordCount() - 1, 1);
+	REQUIRE(lastPage.size() == 1);
+	const RecordDTO &insertedRecord = lastPage.front();
+
+	CHECK(insertedRecord.getRefDate()			== "CLH RefDate");
+	CHECK(insertedRecord.getGeo()				== "CLH Geo");
+	CHECK(insertedRecord.getDguid()			== "CLH DGUID");
+	CHECK(insertedRecord.getProductType()		== "CLH Product Type");
+	CHECK(insertedRecord.getStorageType()		== "CLH Storage Type");
+	CHECK(insertedRecord.getUom()				== "CLH UOM");
+	CHECK(insertedRecord.getUomId()			== "CLH UOM ID");
+	CHECK(insertedRecord.getScalarFactor()	== "CLH Scalar Factor");
+	CHECK(insertedRecord.getScalarId()		== "CLH Scalar ID");
+	CHECK(insertedRecord.getVector()			== "CLH Vector");
+	CHECK(insertedRecord.getCoordinate()		== "CLH Coordinate");
+	CHECK(insertedRecord.getValue()			== "CLH Value");
+	CHECK(insertedRecord.getStatus()			== "CLH Status");
+	CHECK(insertedRecord.getSymbol()			== "CLH Symbol");
+	CHECK(insertedRecord.getTerminated()		== "CLH Terminated");
+	CHECK(insertedRecord.getDecimals()		== "CLH Decimals");
+}
+
+
+
+
+/**
+* Tests that the default indexes answer lookups and stay correct as records are inserted, edited and deleted.
+* Every indexed answer is compared with the answer from a scan of the same column.
+*/
+TEST_CASE("Test that indexed lookups match scans after changes") {
+	RecordService recordService{};
+	REQUIRE(recordService.hasIndex(RecordColumn::Geo));
+
+	std::vector<RecordService::RecordId> quebecIds = recordService.findRecords(RecordColumn::Geo, "Quebec");
+	REQUIRE_FALSE(quebecIds.empty());
+	for (RecordService::RecordId recordId : quebecIds) {
+		CHECK(recordService.getRecord(recordId).getGeo() == "Quebec");
+	}
+
+	RecordService::RecordId newId = recordService.insertRecord(RecordDTO("2024-01", "Quebec", "", "Carrots", "", "", "", "", "", "v1", "", "5", "", "", "", ""));
+	recordService.updateRecord(0, RecordColumn::Geo, "Quebec");
+	recordService.deleteRecord(1);
+
+	std::vector<RecordService::RecordId> indexedIds = recordService.findRecords(RecordColumn::Geo, "Quebec");
+	recordService.dropIndex(RecordColumn::Geo);
+	CHECK_FALSE(recordService.hasIndex(RecordColumn::Geo));
+	CHECK(indexedIds == recordService.findRecords(RecordColumn::Geo, "Quebec"));
+	CHECK(indexedIds.front() == 0);
+	CHECK(indexedIds.back() == newId);
+}
+
+/**
+* Tests that sorting reads records through the ordered index without moving them, so record ids keep referring to the same rows.
+*/
+TEST_CASE("Test that sorting leaves record positions unchanged") {
+	RecordService recordService{};
+	std::string firstVector{ recordService.getRecord(0).getVector() };
+
+	recordService.insertRecord(RecordDTO("1969-01", "Yukon", "", "", "", "", "", "", "", "vNewest", "", "", "", "", "", ""));
+	std::vector<RecordDTO> sortedRecords = recordService.getSortedRecords(2, 0);
+	std::vector<RecordDTO> reverseRecords = recordService.sortRecords(1);
+
+	REQUIRE(sortedRecords.size() == 2);
+	CHECK(sortedRecords.front().getVector() == "vNewest");
+	CHECK(reverseRecords.back().getVector() == "vNewest");
+	CHECK(reverseRecords.size() == recordService.getAllRecords().size());
+	CHECK(recordService.getRecord(0).getVector() == firstVector);
+
+	/* A top-K with the same sort spec returns the same first records as the index */
+	std::vector<RecordDTO> topRecords = recordService.getSortedRecords({ { RecordColumn::RefDate, false }, { RecordColumn::Geo, false } }, 2);
+	REQUIRE(topRecords.size() == 2);
+	CHECK(topRecords[0].getVector() == sortedRecords[0].getVector());
+	CHECK(topRecords[1].getVector() == sortedRecords[1].getVector());
+}
 
-	CHECK(recordService.getAllRecords().back().getRefDate()			== "CLH RefDate");
-	CHECK(recordService.getAllRecords().back().getGeo()				== "CLH Geo");
-	CHECK(recordService.getAllRecords().back().getDguid()			== "CLH DGUID");
-	CHECK(recordService.getAllRecords().back().getProductType()		== "CLH Product Type");
-	CHECK(recordService.getAllRecords().back().getStorageType()		== "CLH Storage Type");
-	CHECK(recordService.getAllRecords().back().getUom()				== "CLH UOM");
-	CHECK(recordService.getAllRecords().back().getUomId()			== "CLH UOM ID");
-	CHECK(recordService.getAllRecords().back().getScalarFactor()	== "CLH Scalar Factor");
-	CHECK(recordService.getAllRecords().back().getScalarId()		== "CLH Scalar ID");
-	CHECK(recordService.getAllRecords().back().getVector()			== "CLH Vector");
-	CHECK(recordService.getAllRecords().back().getCoordinate()		== "CLH Coordinate");
-	CHECK(recordService.getAllRecords().back().getValue()			== "CLH Value");
-	CHECK(recordService.getAllRecords().back().getStatus()			== "CLH Status");
-	CHECK(recordService.getAllRecords().back().getSymbol()			== "CLH Symbol");
-	CHECK(recordService.getAllRecords().back().getTerminated()		== "CLH Terminated");
-	CHECK(recordService.getAllRecords().back().getDecimals()		== "CLH Decimals");
+TEST_CASE("Test that the time series follow record changes") {
+	RecordService recordService{};
+	std::string vector{ recordService.getRecord(0).getVector() };
+	std::size_t pointsBefore = recordService.getTimeSeries().getSeries(*recordService.getTimeSeries().findSeries(vector)).size;
+
+	recordService.insertRecord(RecordDTO("1969-12", "Canada", "", "", "", "", "", "", "", vector, "", "5", "", "", "", ""));
+	const TimeSeries &timeSeries = recordService.getTimeSeries();
+	TimeSeries::Slice points = timeSeries.getSeries(*timeSeries.findSeries(vector));
+
+	REQUIRE(points.size == pointsBefore + 1);
+	CHECK(TimeSeries::toRefDate(points.months[0]) == "1969-12");
+	CHECK(points.values[0] == 5);
+}
+
+TEST_CASE("Test that cached group-by results follow record changes") {
+	RecordService recordService{};
+	std::vector<GroupKey> keys{ { RecordColumn::Geo } };
+	std::vector<Aggregate> aggregates{ { AggregateFunction::Count }, { AggregateFunction::Sum } };
+	recordService.getCachedGroups(keys, aggregates);
+
+	recordService.insertRecord(RecordDTO("2024-01", "Yukon", "", "Carrots", "", "", "", "", "", "v1", "", "5", "", "", "", ""));
+	recordService.updateRecord(0, RecordColumn::Value, "12345");
+	recordService.deleteRecord(1);
+
+	GroupByResult cached = recordService.getCachedGroups(keys, aggregates);
+	GroupByResult scanned = recordService.groupRecords(keys, aggregates);
+	REQUIRE(cached.groups.size() == scanned.groups.size());
+	for (std::size_t i = 0; i < cached.groups.size(); i++) {
+		CHECK(cached.groups[i].keys == scanned.groups[i].keys);
+		CHECK(cached.groups[i].values == scanned.groups[i].values);
+	}
+}
+
+TEST_CASE("Test that reading statistics or saving leaves a page taken before them valid") {
+	RecordService recordService{};
+	/* Six deletes make the sketch stale without reaching the compaction threshold */
+	for (RecordService::RecordId recordId = 0; recordId < 6; recordId++) {
+		recordService.deleteRecord(recordId);
+	}
+	RecordPage page = recordService.getPage(0, 10);
+	std::vector<std::string> vectorsBefore{};
+	for (const RecordDTO &record : page) {
+		vectorsBefore.emplace_back(record.getVector());
+	}
+
+	std::vector<GroupKey> keys{ { RecordColumn::Geo } };
+	std::vector<Aggregate> aggregates{ { AggregateFunction::Count } };
+	CHECK(recordService.getCachedGroups(keys, aggregates).groups.size() == recordService.groupRecords(keys, aggregates).groups.size());
+	CHECK(recordService.getTimeSeries().pointCount() == recordService.recordCount());
+	CHECK(recordService.estimateDistinctCount(RecordColumn::Geo) == recordService.estimateDistinctCount(RecordColumn::Geo, true));
+	recordService.writeToFile("Testing_Page_Write");
+	CHECK(RecordDAO{}.readRecordsFromFile("Testing_Page_Write.csv").size() == recordService.recordCount());
+
+	std::vector<std::string> vectorsAfter{};
+	for (const RecordDTO &record : page) {
+		vectorsAfter.emplace_back(record.getVector());
+	}
+	CHECK(vectorsAfter == vectorsBefore);
+	CHECK(page.size() == 10);
+}
+
+/**
+* Tests that deleting records leaves every other record's id unchanged, including after the deletes trigger a compaction.
+*/
+TEST_CASE("Test that record ids survive deletes and compaction") {
+	RecordService recordService{};
+	std::size_t loadedCount = recordService.recordCount();
+	RecordService::RecordId lastId = loadedCount - 1;
+	std::string lastVector{ recordService.getRecord(lastId).getVector() };
+
+	/* Deleting every even id leaves enough tombstones to compact at least once */
+	for (RecordService::RecordId recordId = 0; recordId < loadedCount; recordId += 2) {
+		recordService.deleteRecord(recordId);
+	}
+
+	CHECK(recordService.recordCount() == loadedCount / 2);
+	CHECK_FALSE(recordService.hasRecord(0));
+	CHECK_THROWS_AS(recordService.getRecord(0), std::out_of_range);
+	CHECK(recordService.getRecord(lastId).getVector() == lastVector);
+	CHECK(recordService.getAllRecords().size() == loadedCount / 2);
+	CHECK(recordService.findRecords(RecordColumn::Vector, lastVector).back() == lastId);
+	CHECK(recordService.sortRecords(0).size() == loadedCount / 2);
+}
+
+/**
+* Tests that undo reverses inserts, edits and deletes one at a time, restoring deleted records under their old ids,
+* and that redo applies them again.
+*/
+TEST_CASE("Test that undo and redo reverse changes") {
+	RecordService recordService{};
+	std::size_t loadedCount = recordService.recordCount();
+	std::string oldValue{ recordService.getRecord(2).getValue() };
+	std::string deletedVector{ recordService.getRecord(3).getVector() };
+
+	RecordService::RecordId newId = recordService.insertRecord(RecordDTO("2024-01", "Yukon", "", "Carrots", "", "", "", "", "", "vUndo", "", "5", "", "", "", ""));
+	recordService.updateRecord(2, RecordColumn::Value, "999999");
+	recordService.deleteRecord(3);
+
+	REQUIRE(recordService.undo());
+	CHECK(recordService.getRecord(3).getVector() == deletedVector);
+	REQUIRE(recordService.undo());
+	CHECK(recordService.getRecord(2).getValue() == oldValue);
+	REQUIRE(recordService.undo());
+	CHECK_FALSE(recordService.hasRecord(newId));
+	CHECK(recordService.recordCount() == loadedCount);
+	CHECK_FALSE(recordService.undo());
+
+	REQUIRE(recordService.redo());
+	CHECK(recordService.findRecords(RecordColumn::Vector, "vUndo") == std::vector<RecordService::RecordId>{ newId });
+
+	/* Deleting enough records to compact moves the tombstone's slot away, so undo appends the record instead */
+	for (RecordService::RecordId recordId = 4; recordId < loadedCount; recordId++) {
+		recordService.deleteRecord(recordId);
+	}
+	while (recordService.recordCount() < loadedCount - 4) {
+		REQUIRE(recordService.undo());
+	}
+	REQUIRE(recordService.hasRecord(loadedCount - 1));
+	std::vector<RecordService::RecordId> sameVector = recordService.findRecords(RecordColumn::Vector, recordService.getRecord(loadedCount - 1).getVector());
+	CHECK(std::count(sameVector.begin(), sameVector.end(), loadedCount - 1) == 1);
+}
+
+TEST_CASE("Test that a transaction commits all of its operations or none") {
+	RecordService recordService{};
+	std::size_t loadedCount = recordService.recordCount();
+	std::string oldValue{ recordService.getRecord(2).getValue() };
+	std::string oldGeo{ recordService.getRecord(2).getGeo() };
+
+	RecordTransaction failing{};
+	failing.updateRecord(2, RecordColumn::Value, "1");
+	failing.deleteRecord(3);
+	failing.updateRecord(3, RecordColumn::Value, "2");
+	CHECK_THROWS_AS(recordService.commitTransaction(failing), std::invalid_argument);
+	CHECK(recordService.getRecord(2).getValue() == oldValue);
+	CHECK(recordService.hasRecord(3));
+	CHECK_FALSE(recordService.undo());
+
+	RecordTransaction transaction{};
+	transaction.updateRecord(2, RecordColumn::Value, "1");
+	transaction.updateRecord(2, RecordColumn::Geo, "Nunavut");
+	transaction.updateRecord(2, RecordColumn::Geo, "Txn Territory");
+	transaction.deleteRecord(3);
+	transaction.insertRecord(RecordDTO("2024-01", "Txn Territory", "", "Carrots", "", "", "", "", "", "vTxn", "", "5", "", "", "", ""));
+	std::vector<RecordService::RecordId> insertedIds = recordService.commitTransaction(transaction);
+
+	REQUIRE(insertedIds.size() == 1);
+	CHECK(recordService.getRecord(2).getValue() == "1");
+	CHECK_FALSE(recordService.hasRecord(3));
+	CHECK(recordService.findRecords(RecordColumn::Geo, "Txn Territory") == std::vector<RecordService::RecordId>{ 2, insertedIds[0] });
+	CHECK(recordService.findRecords(RecordColumn::Geo, "Nunavut").empty());
+
+	REQUIRE(recordService.undo());
+	CHECK(recordService.recordCount() == loadedCount);
+	CHECK(recordService.getRecord(2).getValue() == oldValue);
+	CHECK(recordService.getRecord(2).getGeo() == oldGeo);
+	CHECK(recordService.hasRecord(3));
+	CHECK(recordService.findRecords(RecordColumn::Geo, "Txn Territory").empty());
+	CHECK_FALSE(recordService.undo());
+
+	REQUIRE(recordService.redo());
+	CHECK(recordService.findRecords(RecordColumn::Geo, "Txn Territory") == std::vector<RecordService::RecordId>{ 2, insertedIds[0] });
+	CHECK_FALSE(recordService.redo());
+}
+
+TEST_CASE("Test that snapshots keep their version while the records change") {
+	RecordService recordService{};
+	/* A snapshot is available straight away, without waiting for the load */
+	REQUIRE(recordService.snapshot());
+	recordService.whenLoaded().get();
+	std::shared_ptr<const RecordSnapshot> before = recordService.snapshot();
+	REQUIRE(before);
+	CHECK(before->recordCount() == recordService.recordCount());
+	std::string oldValue{ recordService.getRecord(2).getValue() };
+
+	recordService.updateRecord(2, RecordColumn::Value, "424242");
+	recordService.deleteRecord(3);
+	std::shared_ptr<const RecordSnapshot> after = recordService.snapshot();
+
+	CHECK(after->getVersion() > before->getVersion());
+	CHECK(before->getAllRecords()[2].getValue() == oldValue);
+	CHECK(before->recordCount() == after->recordCount() + 1);
+	CHECK(after->getAllRecords()[2].getValue() == "424242");
+
+	/* Readers take snapshots on other threads while the records change; each one sees a whole version */
+	std::atomic<bool> isDone{ false };
+	std::atomic<int> badSnapshots{ 0 };
+	std::vector<std::thread> readers{};
+	for (int i = 0; i < 3; i++) {
+		readers.emplace_back([&recordService, &isDone, &badSnapshots]() {
+			while (!isDone.load()) {
+				std::shared_ptr<const RecordSnapshot> snapshot = recordService.snapshot();
+				if (snapshot->getRecordIds().size() != snapshot->recordCount()) badSnapshots++;
+			}
+		});
+	}
+	for (int i = 0; i < 50; i++) {
+		RecordTransaction transaction{};
+		transaction.updateRecord(4, RecordColumn::Value, std::to_string(i));
+		transaction.insertRecord(RecordDTO("2024-01", "Yukon", "", "Carrots", "", "", "", "", "", "vSnap", "", "5", "", "", "", ""));
+		recordService.commitTransaction(transaction);
+	}
+	recordService.reloadData();
+	isDone = true;
+	for (std::thread &reader : readers) {
+		reader.join();
+	}
+	CHECK(badSnapshots.load() == 0);
+	CHECK(recordService.snapshot()->recordCount() == recordService.recordCount());
+
+	/* An edit copies only its own chunk; the others are shared with the previous version */
+	RecordTransaction bulkInsert{};
+	for (std::size_t i = 0; i < RecordSnapshot::CHUNK_SIZE; i++) {
+		bulkInsert.insertRecord(RecordDTO("2024-02", "Yukon", "", "Beets", "", "", "", "", "", "vBulk", "", "1", "", "", "", ""));
+	}
+	recordService.commitTransaction(bulkInsert);
+	before = recordService.snapshot();
+	recordService.updateRecord(2, RecordColumn::Value, "7");
+	after = recordService.snapshot();
+	REQUIRE(after->getChunks().size() > 1);
+	CHECK(before->getChunks()[0] != after->getChunks()[0]);
+	CHECK(before->getChunks()[1] == after->getChunks()[1]);
+}
+
+TEST_CASE("Test that bulk inserts, deletes and updates apply as one change") {
+	RecordService recordService{};
+	std::size_t loadedCount = recordService.recordCount();
+
+	std::vector<RecordDTO> newRecords{};
+	for (int i = 0; i < 5000; i++) {
+		newRecords.push_back(RecordDTO("2024-0" + std::to_string(1 + i % 9), "Bulk Territory", "", "Carrots", "", "", "", "", "", "vBulk" + std::to_string(i % 2), "", std::to_string(i), "", "", "", ""));
+	}
+	std::vector<RecordService::RecordId> newIds = recordService.insertRecords(std::move(newRecords));
+	REQUIRE(newIds.size() == 5000);
+	CHECK(recordService.recordCount() == loadedCount + 5000);
+	CHECK(recordService.getRecord(newIds[42]).getValue() == "42");
+	CHECK(recordService.findRecords(RecordColumn::Geo, "Bulk Territory").size() == 5000);
+
+	std::size_t updatedCount = recordService.updateWhere(RecordFilter::equals(RecordColumn::Vector, "vBulk1"), RecordColumn::Value,
+		[](const RecordDTO &record) { return std::string{ record.getValue() } + "0"; });
+	CHECK(updatedCount == 2500);
+	CHECK(recordService.getRecord(newIds[43]).getValue() == "430");
+	CHECK(recordService.getRecord(newIds[42]).getValue() == "42");
+
+	CHECK(recordService.deleteWhere(RecordFilter::equals(RecordColumn::Vector, "vBulk0")) == 2500);
+	CHECK(recordService.findRecords(RecordColumn::Geo, "Bulk Territory").size() == 2500);
+	CHECK_FALSE(recordService.hasRecord(newIds[42]));
+
+	REQUIRE(recordService.undo());
+	CHECK(recordService.getRecord(newIds[42]).getValue() == "42");
+	REQUIRE(recordService.undo());
+	CHECK(recordService.getRecord(newIds[43]).getValue() == "43");
+	REQUIRE(recordService.undo());
+	CHECK(recordService.recordCount() == loadedCount);
+	CHECK(recordService.findRecords(RecordColumn::Geo, "Bulk Territory").empty());
+}
+
+TEST_CASE("Test that the unique key refuses duplicates and reports them") {
+	RecordService recordService{};
+	REQUIRE(recordService.findDuplicates().empty());
+	recordService.enableUniqueKey();
+	REQUIRE(recordService.hasUniqueKey());
+	std::size_t loadedCount = recordService.recordCount();
+	RecordDTO copy = recordService.getRecord(0);
+
+	CHECK_THROWS_AS(recordService.insertRecord(copy), std::invalid_argument);
+	CHECK_THROWS_AS(recordService.updateRecord(1, RecordColumn::Vector, std::string{ copy.getVector() }), std::invalid_argument);
+	CHECK(recordService.recordCount() == loadedCount);
+
+	/* A transaction may release a key and take it again, but not take it twice */
+	RecordTransaction twice{};
+	twice.insertRecord(RecordDTO("2031-01", "Yukon", "", "Carrots", "", "", "", "", "", "vUnique", "", "5", "", "", "", ""));
+	twice.insertRecord(RecordDTO("2031-01", "Quebec", "", "Beets", "", "", "", "", "", "vUnique", "", "6", "", "", "", ""));
+	CHECK_THROWS_AS(recordService.commitTransaction(twice), std::invalid_argument);
+	CHECK(recordService.recordCount() == loadedCount);
+
+	RecordTransaction replace{};
+	replace.deleteRecord(0);
+	replace.insertRecord(copy);
+	std::vector<RecordService::RecordId> newIds = recordService.commitTransaction(replace);
+	CHECK(recordService.recordCount() == loadedCount);
+
+	recordService.disableUniqueKey();
+	RecordService::RecordId duplicateId = recordService.insertRecord(copy);
+	std::vector<RecordService::DuplicateRecords> duplicates = recordService.findDuplicates();
+	REQUIRE(duplicates.size() == 1);
+	CHECK(duplicates[0].recordIds == std::vector<RecordService::RecordId>{ newIds[0], duplicateId });
+	CHECK(duplicates[0].key == "REF_DATE " + std::string{ copy.getRefDate() } + ", VECTOR " + std::string{ copy.getVector() });
+	CHECK_THROWS_AS(recordService.enableUniqueKey(), std::invalid_argument);
+	CHECK_FALSE(recordService.hasUniqueKey());
+}
+
+TEST_CASE("Test that reloading records that share a key turns the unique key off") {
+	std::ifstream dataSet{ "32100260.csv" };
+	std::ofstream copy{ "Testing_Reload_Duplicates.csv" };
+	copy << dataSet.rdbuf();
+	copy.close();
+	RecordService recordService{ RecordDAO{ "Testing_Reload_Duplicates.csv" } };
+	recordService.enableUniqueKey();
+
+	/* A reload of records without duplicates keeps the constraint */
+	REQUIRE(recordService.reloadData());
+	CHECK(recordService.hasUniqueKey());
+
+	/* The file's first record is repeated as its second */
+	std::ifstream original{ "32100260.csv" };
+	std::string header{};
+	std::string firstRow{};
+	std::getline(original, header);
+	std::getline(original, firstRow);
+	std::ofstream duplicated{ "Testing_Reload_Duplicates.csv" };
+	duplicated << header << "\n" << firstRow << "\n" << firstRow << "\n" << original.rdbuf();
+	duplicated.close();
+
+	REQUIRE(recordService.reloadData());
+	CHECK_FALSE(recordService.hasUniqueKey());
+	std::vector<RecordService::DuplicateRecords> duplicates = recordService.findDuplicates();
+	REQUIRE(duplicates.size() == 1);
+	CHECK(duplicates[0].recordIds == std::vector<RecordService::RecordId>{ 0, 1 });
+	std::remove("Testing_Reload_Duplicates.csv");
+}
+
+TEST_CASE("Test that merging a revised file inserts new keys and updates changed records") {
+	RecordService recordService{};
+	std::size_t loadedCount = recordService.recordCount();
+	std::string oldValue{ recordService.getRecord(0).getValue() };
+	recordService.updateRecord(5, RecordColumn::Status, "local edit");
+
+	RecordDTO revised = recordService.getRecord(0);
+	revised.setValue("123456");
+	RecordDTO unchanged = recordService.getRecord(1);
+	RecordDTO added = RecordDTO("2031-01", "Yukon", "", "Carrots", "", "", "", "", "", "vMerge", "", "5", "", "", "", "");
+	RecordDTO addedAgain = added;
+	addedAgain.setValue("6");
+	/* Record 2 is revised twice; the last row wins and it counts as one update */
+	RecordDTO revisedTwice = recordService.getRecord(2);
+	revisedTwice.setValue("111");
+	RecordDTO revisedAgain = recordService.getRecord(2);
+	revisedAgain.setStatus("revised");
+	RecordDAO{}.writeToFile({ revised, unchanged, added, revisedTwice, addedAgain, revisedAgain }, "Testing_Merge_Revisions.csv");
+	std::string secondValue{ recordService.getRecord(2).getValue() };
+
+	RecordService::MergeResult result = recordService.mergeFromFile("Testing_Merge_Revisions.csv");
+	CHECK(result.insertedCount == 1);
+	CHECK(result.updatedCount == 2);
+	CHECK(result.unchangedCount == 1);
+	CHECK(recordService.getRecord(0).getValue() == "123456");
+	CHECK(recordService.getRecord(2).getValue() == secondValue);
+	CHECK(recordService.getRecord(2).getStatus() == "revised");
+	CHECK(recordService.getRecord(5).getStatus() == "local edit");
+	std::vector<RecordService::RecordId> addedIds = recordService.findRecords(RecordColumn::Vector, "vMerge");
+	REQUIRE(addedIds.size() == 1);
+	CHECK(recordService.getRecord(addedIds[0]).getValue() == "6");
+
+	REQUIRE(recordService.undo());
+	CHECK(recordService.getRecord(0).getValue() == oldValue);
+	CHECK(recordService.recordCount() == loadedCount);
+	CHECK_THROWS_AS(recordService.mergeFromFile("No_Such_File.csv"), std::runtime_error);
+}
+
+TEST_CASE("Test that a joined table matches whether kept in memory or written to a file") {
+	RecordService recordService{};
+	recordService.deleteRecord(0);
+
+	/* One price per GEO and REF_DATE of the first ten records */
+	std::vector<TableDTO::Row> priceRows{};
+	for (RecordService::RecordId id = 1; id <= 10; id++) {
+		RecordDTO record = recordService.getRecord(id);
+		priceRows.push_back({ std::string{ record.getRefDate() }, std::string{ record.getGeo() }, std::to_string(id) });
+	}
+	RecordDAO{}.writeTableToFile({ { "REF_DATE", "GEO", "PRICE" } }, "Testing_Join_Prices.csv");
+	RecordDAO{}.appendTableToFile(priceRows, "Testing_Join_Prices.csv");
+	TableDTO prices = recordService.loadTable("Testing_Join_Prices.csv");
+	REQUIRE(prices.rowCount() == 10);
+
+	/* Each live record joins once per price row with its REF_DATE and GEO, so the deleted record is left out */
+	std::size_t expectedCount{ 0 };
+	for (const RecordDTO &record : recordService.snapshot()->getAllRecords()) {
+		for (const TableDTO::Row &price : priceRows) {
+			if (record.getRefDate() == price[0] && record.getGeo() == price[1]) expectedCount++;
+		}
+	}
+	TableDTO joined = recordService.joinTable(prices);
+	REQUIRE(expectedCount >= 10);
+	CHECK(joined.rowCount() == expectedCount);
+	CHECK(joined.getHeaders().back() == "PRICE");
+
+	JoinSpec leftSpec{};
+	leftSpec.type = JoinType::Left;
+	std::size_t writtenCount = recordService.writeJoinToFile(prices, leftSpec, "Testing_Join_Output");
+	CHECK(writtenCount >= recordService.recordCount());
+	TableDTO reread = recordService.loadTable("Testing_Join_Output.csv");
+	CHECK(reread.rowCount() == writtenCount);
+	CHECK(reread.getHeaders() == joined.getHeaders());
+	CHECK_THROWS_AS(recordService.writeJoinToFile(prices, leftSpec, "No_Such_Folder/Testing_Join_Output"), std::runtime_error);
+
+	JoinSpec badSpec{};
+	badSpec.tableKeys = { "REF_DATE", "VECTOR" };
+	CHECK_THROWS_AS(recordService.joinTable(prices, badSpec), std::invalid_argument);
+}
+
+TEST_CASE("Test that pages match the records they view in every order") {
+	RecordService recordService{};
+	std::vector<RecordDTO> allRecords = recordService.getAllRecords();
+
+	/* Without deletes a page is a slice of the stored order */
+	RecordPage page = recordService.getPage(10, 20);
+	REQUIRE(page.size() == 20);
+	CHECK(page.getTotalCount() == allRecords.size());
+	CHECK(page.front().getVector() == allRecords[10].getVector());
+	CHECK(recordService.getPage(allRecords.size(), 5).empty());
+
+	/* Deleted records are skipped whether the page is found from the front or from the back */
+	recordService.deleteRecord(3);
+	recordService.deleteRecord(95);
+	allRecords = recordService.getAllRecords();
+	for (std::size_t offset : { std::size_t{ 0 }, std::size_t{ 2 }, allRecords.size() - 7 }) {
+		RecordPage livePage = recordService.getPage(offset, 5);
+		REQUIRE(livePage.size() == 5);
+		for (std::size_t i = 0; i < livePage.size(); i++) {
+			CHECK(livePage[i].getVector() == allRecords[offset + i].getVector());
+		}
+	}
+	RecordPage lastPage = recordService.getPage(allRecords.size() - 3, RecordService::DEFAULT_PAGE_SIZE);
+	CHECK(lastPage.size() == 3);
+	CHECK(!lastPage.hasNextPage());
+
+	/* A sorted, filtered page is the matching slice of the full sort */
+	RecordService::PageRequest request{};
+	request.offset = 2;
+	request.limit = 4;
+	request.sortKeys = { SortKey{ RecordColumn::Value, true } };
+	request.filter = RecordFilter::equals(RecordColumn::ProductType, "Potatoes");
+	RecordPage sortedPage = recordService.getPage(request);
+
+	std::vector<RecordService::RecordId> potatoIds = recordService.filterRecords(*request.filter);
+	std::vector<RecordService::RecordId> sortedIds = recordService.sortRecordIds(request.sortKeys);
+	std::vector<std::string> expected{};
+	for (RecordService::RecordId id : sortedIds) {
+		if (std::find(potatoIds.begin(), potatoIds.end(), id) != potatoIds.end()) expected.emplace_back(recordService.getRecord(id).getVector());
+	}
+	CHECK(sortedPage.getTotalCount() == potatoIds.size());
+	REQUIRE(sortedPage.size() == 4);
+	for (std::size_t i = 0; i < sortedPage.size(); i++) {
+		CHECK(sortedPage[i].getVector() == expected[request.offset + i]);
+	}
+
+	/* Sorting without a filter skips the deleted records */
+	request.filter.reset();
+	request.offset = 0;
+	request.limit = allRecords.size();
+	CHECK(recordService.getPage(request).size() == allRecords.size());
+}
+
+TEST_CASE("Test that the records load in the background and the first page is served early") {
+	RecordService recordService{};
+	RecordPage firstPage = recordService.getPage(0, 10);
+	REQUIRE(firstPage.size() == 10);
+
+	recordService.whenLoaded().get();
+	CHECK(recordService.isLoaded());
+	LoadProgress progress = recordService.loadProgress();
+	CHECK(progress.isLoaded);
+	CHECK(progress.recordCount == static_cast<std::size_t>(RecordDAO::MAX_LIST_SIZE));
+	CHECK(progress.bytesRead > 0);
+	CHECK(progress.bytesRead <= progress.totalBytes);
+
+	/* A page served while loading holds the same records as the store built from them */
+	for (std::size_t i = 0; i < firstPage.size(); i++) {
+		CHECK(firstPage[i].getVector() == recordService.getRecord(i).getVector());
+	}
+	CHECK(recordService.getPage(0, 10).front().getRefDate() == firstPage.front().getRefDate());
+}
+
+TEST_CASE("Test that a data set that cannot be read leaves an empty store that a reload can fill") {
+	std::remove("Testing_Missing_Data_Set.csv");
+	RecordService recordService{ RecordDAO{ "Testing_Missing_Data_Set.csv" } };
+	CHECK(recordService.getLoadError().find("Testing_Missing_Data_Set.csv") != std::string::npos);
+	CHECK(recordService.isLoaded());
+	CHECK(recordService.recordCount() == 0);
+	CHECK(recordService.getPage(0, 10).size() == 0);
+	CHECK_FALSE(recordService.reloadData());
+	CHECK_FALSE(recordService.getLoadError().empty());
+
+	/* Once the file exists, a reload reads it and clears the error */
+	std::ifstream dataSet{ "32100260.csv", std::ios::binary };
+	std::ofstream copy{ "Testing_Missing_Data_Set.csv", std::ios::binary };
+	copy << dataSet.rdbuf();
+	copy.close();
+	CHECK(recordService.reloadData());
+	CHECK(recordService.getLoadError().empty());
+	CHECK(recordService.recordCount() == static_cast<std::size_t>(RecordDAO::MAX_LIST_SIZE));
+	std::remove("Testing_Missing_Data_Set.csv");
+}
+
+/**
+* Tests that text searches find records by partial GEO and product names through the default trigram indexes, follow inserts, edits
+* and deletes, combine with other filters, and agree with the scan used for columns without a text index.
+*/
+TEST_CASE("Test that text searches match scans and follow record changes") {
+	RecordService recordService{};
+	REQUIRE(recordService.hasTextIndex(RecordColumn::Geo));
+
+	std::vector<RecordService::RecordId> manitobaIds = recordService.searchText(RecordColumn::Geo, "TOBA");
+	CHECK(manitobaIds.size() == 12);
+	for (RecordService::RecordId recordId : manitobaIds) {
+		CHECK(recordService.getRecord(recordId).getGeo() == "Manitoba");
+	}
+	/* Manitoba and Maritime provinces */
+	CHECK(recordService.searchText(RecordColumn::Geo, "ma", TextMatch::Prefix).size() == 24);
+	/* Onions in Canada, Manitoba and Saskatchewan */
+	CHECK(recordService.searchText(RecordColumn::Geo, "an", TextMatch::Contains, RecordFilter::equals(RecordColumn::ProductType, "Onions")).size() == 10);
+
+	recordService.updateRecord(0, RecordColumn::Geo, "Nunavut");
+	RecordService::RecordId newId = recordService.insertRecord(RecordDTO("2024-01", "Northwest Territories", "", "Purple carrots", "", "", "", "", "", "v1", "", "5", "", "", "", ""));
+	CHECK(recordService.searchText(RecordColumn::Geo, "navu") == std::vector<RecordService::RecordId>{ 0 });
+	CHECK(recordService.searchText(RecordColumn::ProductType, "purple car", TextMatch::Prefix) == std::vector<RecordService::RecordId>{ newId });
+	CHECK(recordService.searchText(RecordColumn::ProductType, "carrots").size() == 26);
+	recordService.deleteRecord(newId);
+	CHECK(recordService.searchText(RecordColumn::Geo, "territ").empty());
+
+	std::vector<RecordService::RecordId> indexedIds = recordService.searchText(RecordColumn::Geo, "an");
+	recordService.dropTextIndex(RecordColumn::Geo);
+	CHECK_FALSE(recordService.hasTextIndex(RecordColumn::Geo));
+	CHECK(recordService.hasIndex(RecordColumn::Geo));
+	CHECK(indexedIds == recordService.searchText(RecordColumn::Geo, "an"));
+
+	recordService.dropIndex(RecordColumn::ProductType);
+	CHECK_FALSE(recordService.hasTextIndex(RecordColumn::ProductType));
+	recordService.createTextIndex(RecordColumn::Vector);
+	CHECK(recordService.searchText(RecordColumn::Vector, "V7223", TextMatch::Prefix).size() == recordService.recordCount());
 }
 
+/**
+* Tests that the sketched statistics agree with the exact ones, follow inserts and edits as they happen, and are rebuilt without
+* the deleted records once enough records are deleted.
+*/
+TEST_CASE("Test that estimated statistics match exact ones and follow record changes") {
+	RecordService recordService{};
+	CHECK(recordService.estimateDistinctCount(RecordColumn::Geo) == 8);
+	CHECK(recordService.estimateDistinctCount(RecordColumn::Vector) == recordService.estimateDistinctCount(RecordColumn::Vector, true));
+	/* With 100 records the quantile sketches still keep every VALUE, so their estimates are exact */
+	CHECK(recordService.estimateQuantile(0.95) == recordService.estimateQuantile(0.95, true));
+	CHECK(recordService.estimateQuantiles(RecordColumn::Geo, 0.95) == recordService.estimateQuantiles(RecordColumn::Geo, 0.95, true));
+	CHECK(recordService.estimateQuantiles(RecordColumn::ProductType, 0.5) == recordService.estimateQuantiles(RecordColumn::ProductType, 0.5, true));
+	CHECK_THROWS_AS(recordService.estimateQuantile(95), std::invalid_argument);
+
+	RecordService::RecordId newId = recordService.insertRecord(RecordDTO("2024-01", "Yukon", "", "Carrots", "", "", "", "", "", "v1", "", "99999999", "", "", "", ""));
+	recordService.updateRecord(0, RecordColumn::Value, "-5");
+	CHECK(recordService.estimateDistinctCount(RecordColumn::Geo) == 9);
+	CHECK(recordService.estimateQuantile(1) == 99999999);
+	CHECK(recordService.estimateQuantile(0) == -5);
+	CHECK(recordService.estimateQuantiles(RecordColumn::Geo, 1).at("Yukon") == 99999999);
 
+	/* Editing a column the percentiles do not read adds only its new value, so the new record's VALUE is not counted twice */
+	recordService.updateRecord(newId, RecordColumn::Status, "E");
+	CHECK(recordService.estimateQuantile(0.99) == recordService.estimateQuantile(0.99, true));
+	CHECK(recordService.estimateDistinctCount(RecordColumn::Status) == recordService.estimateDistinctCount(RecordColumn::Status, true));
 
+	/* Deleting the new record and a few others makes the sketch stale, so the next estimate no longer counts them */
+	recordService.deleteRecord(newId);
+	for (RecordService::RecordId recordId = 0; recordId < 8; recordId++) {
+		recordService.deleteRecord(recordId);
+	}
+	CHECK(recordService.estimateDistinctCount(RecordColumn::Geo) == recordService.estimateDistinctCount(RecordColumn::Geo, true));
+	CHECK(recordService.estimateQuantile(1) == recordService.estimateQuantile(1, true));
+	CHECK(recordService.estimateQuantiles(RecordColumn::Geo, 0.5) == recordService.estimateQuantiles(RecordColumn::Geo, 0.5, true));
+
+	/* A bulk commit skips the per-record updates and leaves the sketch to be rebuilt on the next read */
+	RecordTransaction bulkInsert{};
+	for (int i = 0; i < 40; i++) {
+		bulkInsert.insertRecord(RecordDTO("2024-03", "Bulk Territory", "", "Beets", "", "", "", "", "", "vBulk", "", std::to_string(i), "", "", "", ""));
+	}
+	recordService.commitTransaction(bulkInsert);
+	CHECK(recordService.estimateDistinctCount(RecordColumn::Geo) == recordService.estimateDistinctCount(RecordColumn::Geo, true));
+	CHECK(recordService.estimateQuantile(0.5) == recordService.estimateQuantile(0.5, true));
+}
@@ -18,21 +18,125 @@
 */
 
 #pragma once
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
+#include "ChangeLog.h"
+#include "RecordAggregator.h"
+#include "RecordColumn.h"
 #include "RecordDAO.h"
 #include "RecordDTO.h"
+#include "OrderedIndex.h"
+#include "RecordFilter.h"
+#include "RecordIndex.h"
+#include "RecordJoin.h"
+#include "RecordLoader.h"
+#include "RecordPage.h"
+#include "MaterializedAggregate.h"
+#include "RecordPivot.h"
+#include "RecordSketch.h"
+#include "RecordSnapshot.h"
+#include "RecordSorter.h"
+#include "RecordTransaction.h"
+#include "TextIndex.h"
+#include "TimeSeries.h"
+#include "UniqueKey.h"
 #include "doctest.h"
 
 #ifndef RECORD_SERVICE_H
 #define RFECORD_SERVICE_H
 class RecordService
 {
+public:
+	/** @brief A record's permanent id. Unlike the record's slot in the vector, the id never changes while the record exists. */
+	using RecordId = std::uint64_t;
+
+	/** @brief Computes a column's new value from a record, for updateWhere() */
+	using RecordExpression = std::function<std::string(const RecordDTO &)>;
+
+	/** @brief Records that share a unique key, as reported by findDuplicates() */
+	struct DuplicateRecords {
+		/** @brief the shared key's columns and values, such as "REF_DATE 1976-01, VECTOR v108237" */
+		std::string key;
+		/** @brief the records' ids, in the order the records are stored */
+		std::vector<RecordId> recordIds;
+	};
+
+	/** @brief What mergeFromFile() did with the file's records */
+	struct MergeResult {
+		/** @brief the number of records with a key the store did not have, which were inserted */
+		std::size_t insertedCount;
+		/** @brief the number of stored records changed by the file's last record with the same key */
+		std::size_t updatedCount;
+		/** @brief the number of stored records identical to the file's last record with the same key */
+		std::size_t unchangedCount;
+	};
+
+	/** @brief The number of records on a page unless the caller asks for another number */
+	static constexpr std::size_t DEFAULT_PAGE_SIZE = 50;
+
+	/** @brief Which page of records getPage() returns */
+	struct PageRequest {
+		/** @brief the number of records before the page, in the requested order */
+		std::size_t offset{ 0 };
+		/** @brief the most records the page holds */
+		std::size_t limit{ DEFAULT_PAGE_SIZE };
+		/** @brief the order to page through, most significant column first. Empty keeps the order the records are stored in. */
+		std::vector<SortKey> sortKeys{};
+		/** @brief if set, only the records it matches are paged through */
+		std::optional<RecordFilter> filter{};
+	};
+
 private:
-	/** Simple data structure in memory. User interacts with this structure and modifies its contents. */
+	/** Marks a deleted record's slot in slotIds until compaction removes the slot */
+	static constexpr RecordId DELETED_RECORD = RecordSnapshot::DELETED_RECORD;
+
+	/** Simple data structure in memory. User interacts with this structure and modifies its contents. Deleted records stay in their slots until compact(). */
 	std::vector<RecordDTO> recordList{};
+	/** The id of the record in each slot of recordList, or DELETED_RECORD. Ids only grow, but a record that undo() brings back after a compaction is appended with its old id. */
+	std::vector<RecordId> slotIds{};
+	/** Finds a live record's slot from its id */
+	std::unordered_map<RecordId, RecordIndex::RowId> idToSlot{};
+	RecordId nextRecordId{ 0 };
+	std::size_t deletedCount{ 0 };
+	/** Counts compactions and reloads. A slot recorded in the change log is only valid while this is unchanged. */
+	std::uint64_t compactionCount{ 0 };
+	/** Every insert, edit and delete since the data was loaded, kept so they can be undone and redone */
+	ChangeLog changeLog{};
 	/** Used to persist the data structure or retrieve records from the CSV file*/
 	RecordDAO recordAccessor{};
+	/** Secondary indexes, each kept in step with recordList by every method that changes it. Deleted slots stay listed until compact(). */
+	std::vector<RecordIndex> indexes{};
+	/** Trigram indexes for searchText(), each over a column that also has an entry in indexes. They learn new values on every change and never forget old ones. */
+	std::vector<TextIndex> textIndexes{};
+	/** Keeps the rows in (RefDate, Geo) order for sortRecords(), which therefore never moves the records */
+	OrderedIndex sortIndex{};
+	/** The records' dates and values grouped by series. Rebuilt by getTimeSeries() when the records have changed since it was built. */
+	TimeSeries timeSeries{};
+	bool isTimeSeriesStale{ true };
+	/** Group-by results kept up to date by every method that changes recordList. Filled in by getCachedGroups(). */
+	std::vector<MaterializedAggregate> aggregateCache{};
+	/** Approximate distinct counts and VALUE percentiles, kept up to date by every method that changes recordList and rebuilt by the estimate methods once stale */
+	RecordSketch sketch{};
+	std::shared_ptr<const RecordSnapshot> publishedSnapshot{};
+	std::uint64_t snapshotVersion{ 0 };
+	std::vector<bool> dirtyChunks{};
+	bool hasUnpublishedChanges{ false };
+	std::optional<UniqueKey> uniqueKey{};
+
+	/** Collects the records while the constructor's background load parses them, for getPage() and loadProgress() */
+	RecordLoader loader{};
+	/** Ready once the background load has built the store. Every operation that needs the whole store waits for it. */
+	std::shared_future<void> loaded{};
+	/** Why the last load or reload failed, or empty if it succeeded. Set before loaded becomes ready. */
+	std::string loadError{};
 
 	struct Record {
 		std::string RefDate;
@@ -53,19 +157,203 @@ private:
 		std::string Decimals;
 	};
 
+	/** @brief Rebuilds every index from recordList. Used after the list is replaced or reordered. */
+	void rebuildIndexes();
+
+	/**
+	 * @brief Reads the data set and builds the store from it. Runs on the background thread the constructor starts, so it must
+	 * not call any method that waits for the load. If the data set cannot be read, the store is left empty and loadError is set.
+	*/
+	void loadInBackground();
+
+	/**
+	 * @brief Replaces every record, clears the undo history, and rebuilds the ids, indexes and snapshot
+	 * @param newRecords the new records, in file order
+	*/
+	void installRecords(std::vector<RecordDTO> newRecords);
+
+	/** @brief Rebuilds the sketch from the live records if removals have made it stale */
+	void refreshSketch();
+
+	/** @brief Blocks until the background load has built the store, which is empty if the load failed */
+	void waitUntilLoaded() const { RecordService::loaded.get(); }
+
+	/** @brief Gives the records in recordList new ids, numbered from 0 in file order. Used after the list is replaced. */
+	void assignRecordIds();
+
+	/**
+	 * @brief Finds a live record's slot
+	 * @param recordId the record's id
+	 * @return the record's position in recordList
+	 * @throws std::out_of_range if no live record has the id
+	*/
+	RecordIndex::RowId slotOf(RecordId recordId) const;
+
+	/**
+	 * @brief Converts slots to record ids, leaving out deleted slots
+	 * @param rows positions in recordList
+	 * @return the ids of the live records among them, in the same order
+	*/
+	std::vector<RecordId> toRecordIds(const std::vector<RecordIndex::RowId> &rows) const;
+
+	/** @return the position of every live record in recordList, in ascending order */
+	std::vector<RecordIndex::RowId> liveRows() const;
+
+	/** @brief Compacts recordList once deleted slots make up a quarter of it, so deletes cost O(1) amortized */
+	void compactIfNeeded();
+
+	/**
+	 * @brief Removes the deleted records' slots without publishing a new snapshot, so a compaction in the middle of an undo or a
+	 * transaction is published with the rest of it
+	*/
+	void compactSlots();
+
+	/**
+	 * @brief Notes that a slot changed, so the next published snapshot copies the slot's chunk
+	 * @param row the slot
+	*/
+	void markChanged(RecordIndex::RowId row);
+
+	/** @brief Notes that every slot may have changed, so the next published snapshot copies every chunk */
+	void markAllChanged();
+
+	/**
+	 * @brief Publishes the records as a new snapshot once a public change is complete, so readers see all of a change or none of it.
+	 * Chunks with no changed slot are shared with the previous snapshot.
+	*/
+	void publish();
+
+	/**
+	 * @brief Replaces one column of the record in a slot, keeping the indexes and caches in step, without logging the change
+	 * @param row the record's slot
+	 * @param column the column to change
+	 * @param newValue the column's new value
+	*/
+	void applyUpdate(RecordIndex::RowId row, RecordColumn column, std::string newValue);
+
+	/**
+	 * @brief Adds a record with a given id to the end of the vector, keeping the indexes and caches in step, without logging the change
+	 * @param recordId the record's id
+	 * @param newRecord the record
+	 * @return the record's slot
+	*/
+	RecordIndex::RowId appendRecord(RecordId recordId, RecordDTO newRecord);
+
+	/**
+	 * @brief Leaves a tombstone in a live record's slot, keeping the caches in step, without logging the change
+	 * @param row the record's slot
+	*/
+	void tombstone(RecordIndex::RowId row);
+
+	/**
+	 * @brief Brings back the record an Insert or Delete change refers to, in its old slot if it is still there
+	 * @param change the change
+	*/
+	void restoreRecord(const ChangeLog::Change &change);
+
+	/**
+	 * @brief Finds the index on a column
+	 * @param column the column
+	 * @return the column's index, or nullptr if the column is not indexed
+	*/
+	const RecordIndex *findIndex(RecordColumn column) const;
+
+	/**
+	 * @brief Tells the column's text index, if there is one, about a value a change has given it
+	 * @param column the changed column
+	 * @param value the column's new value
+	*/
+	void learnTextValue(RecordColumn column, std::string_view value);
+
+	/**
+	 * @brief Finds the slots whose column matches a piece of text, through the column's text index if there is one and by a scan otherwise
+	 * @param column the column to search
+	 * @param text the text to look for
+	 * @param match whether the text may appear anywhere in the value or only at its start
+	 * @return the matching slots in ascending order, deleted slots included
+	*/
+	std::vector<RecordIndex::RowId> textRows(RecordColumn column, std::string_view text, TextMatch match) const;
+
+	/**
+	 * @brief Replays a transaction's effect on the unique key without changing anything, tracking the keys the transaction
+	 * takes and releases on top of the keys already held
+	 * @param transaction the transaction
+	 * @throws std::invalid_argument if an operation would take a key that is held when the operation runs
+	*/
+	void checkUniqueKeys(const RecordTransaction &transaction) const;
+
+	/**
+	 * @brief Fills the unique key from the live records. If two records share a key, such as after a reload, the constraint is
+	 * turned off rather than left half enforced.
+	 * @return false if the constraint was turned off
+	*/
+	bool rebuildUniqueKey();
+
 public:
+	/** @brief The columns indexed by default. These are the columns users look records up by. */
+	static constexpr RecordColumn DEFAULT_INDEXED_COLUMNS[] = { RecordColumn::RefDate, RecordColumn::Geo, RecordColumn::ProductType, RecordColumn::Vector };
+	/** @brief The columns searchText() can answer from a trigram index when the service is created */
+	static constexpr RecordColumn DEFAULT_TEXT_INDEXED_COLUMNS[] = { RecordColumn::Geo, RecordColumn::ProductType };
+	/** @brief The columns estimateQuantiles() can group by from the sketch built at load. Other columns are added on first use. */
+	static constexpr RecordColumn DEFAULT_SKETCH_GROUP_COLUMNS[] = { RecordColumn::Geo };
+
 	/**
-	 * @brief No-argument constructor
+	 * @brief No-argument constructor. Starts loading the data set on a background thread and returns at once. Each operation
+	 * waits for the load to finish, except getPage(), which serves a page as soon as its records are parsed.
 	*/
 	RecordService();
+
+	/**
+	 * @brief Starts loading the data set the given accessor reads, such as a test file, on a background thread
+	 * @param recordAccessor the accessor for the data set
+	*/
+	explicit RecordService(RecordDAO recordAccessor);
+
+	/** @brief Waits for the background load to finish, as it uses the object */
+	~RecordService();
+
+	/** @return a future that becomes ready once the background load has built the store, even if the load failed */
+	std::shared_future<void> whenLoaded() const { return RecordService::loaded; }
+
+	/** @return true once the background load has built the store */
+	bool isLoaded() const;
+
+	/** @return how far the background load has got */
+	LoadProgress loadProgress() const;
+
+	/**
+	 * @brief Waits for the load, then reports whether it failed
+	 * @return why the last load or reload could not read the data set, or an empty string if it succeeded
+	*/
+	std::string getLoadError() const;
 	
 	/**
-	 * @brief Retrives the specified record from the RecordService class' vector. This method is used to retrieve
-	 * a record from the vector and modify it, so we want to pass by reference, rather than by value.
-	 * @param recordId the record's line number
+	 * @brief Retrives the specified record from the RecordService class' vector. The record is returned by reference to avoid
+	 * a copy; changes go through updateRecord() so that the indexes stay correct.
+	 * @param recordId the record's id. Records loaded from the file are numbered from 0 in file order.
 	 * @return the specified RecordDTO
+	 * @throws std::out_of_range if no record has the id
 	*/
-	RecordDTO &getRecord(int recordId);
+	const RecordDTO &getRecord(RecordId recordId) const;
+
+	/**
+	 * @brief Checks whether a record exists
+	 * @param recordId the record's id
+	 * @return true if the id belongs to a record that has not been deleted
+	*/
+	bool hasRecord(RecordId recordId) const;
+
+	/** @return the number of records, not counting deleted ones */
+	std::size_t recordCount() const { waitUntilLoaded(); return RecordService::recordList.size() - RecordService::deletedCount; }
+
+	/**
+	 * @brief Replaces one column of a record and updates the column's index
+	 * @param recordId the record's id
+	 * @param column the column to change
+	 * @param newValue the column's new value
+	 * @throws std::invalid_argument if the edit would give the record another record's unique key
+	*/
+	void updateRecord(RecordId recordId, RecordColumn column, std::string newValue);
 	
 	/**
 	 * @brief Retrieves a given number of RecordDTOs in a vector
@@ -75,23 +363,118 @@ public:
 	std::vector<RecordDTO> getTopRecords(int numberOfRecords);
 	
 	/**
-	 * @brief Returns all the records stored in the RecordService class' vector
+	 * @brief Returns all the records stored in the RecordService class' vector. Copies every record; getPage() shows records without copying them.
 	 * @return a list of RecordDTO objects
 	*/
 	std::vector<RecordDTO> getAllRecords();
+
+	/**
+	 * @brief Returns a view of a page of records in the order they are stored, without copying any record. With no deleted records
+	 * the page is found directly; otherwise the deleted slots are skipped from whichever end of the vector is nearer the page.
+	 * While the data set is still loading, the page is served, as a copy, as soon as its records are parsed.
+	 * @param offset the number of records before the page
+	 * @param limit the most records the page holds
+	 * @return the page, valid until the next change to the records. Empty if offset is past the last record.
+	*/
+	RecordPage getPage(std::size_t offset, std::size_t limit = DEFAULT_PAGE_SIZE) const;
+
+	/**
+	 * @brief Returns a view of a page of the records in any sort order, optionally only the records a filter matches, without
+	 * copying any record. A sorted page costs O(n log (offset + limit)), as only the rows up to the page's end are kept in order.
+	 * @param request the page's offset and limit, and the sort order and filter
+	 * @return the page, valid until the next change to the records
+	*/
+	RecordPage getPage(const PageRequest &request) const;
 	
 	/**
 	 * @brief Inserts a new record into the RecordService class' vector
 	 * @param newRecord
+	 * @return the new record's id
+	 * @throws std::invalid_argument if another record has the new record's unique key
+	*/
+	RecordId insertRecord(RecordDTO newRecord);
+
+	/**
+	 * @brief Deletes a RecordDTO by leaving a tombstone in its slot. No other record moves or changes id.
+	 * @param recordId the record's id
+	*/
+	void deleteRecord(RecordId recordId);
+
+	/**
+	 * @brief Applies every operation of a transaction in order, or none of them. The indexes, the ordered index and the
+	 * cached group-by results are brought up to date once for the whole transaction, and undo() reverses it as one change.
+	 * @param transaction the staged operations
+	 * @return the ids of the inserted records, in the order they were staged
+	 * @throws std::invalid_argument if an update or delete names a record that does not exist or that the transaction already deleted
+	 * or if the transaction would give two records the same unique key
+	*/
+	std::vector<RecordId> commitTransaction(RecordTransaction transaction);
+
+	/**
+	 * @brief Inserts many records as one transaction: the storage is reserved once, the records are moved in, and every index
+	 * and the journal are updated once for the batch. undo() removes the whole batch.
+	 * @param newRecords the records to insert
+	 * @return the new records' ids, in the same order
+	*/
+	std::vector<RecordId> insertRecords(std::vector<RecordDTO> newRecords);
+
+	/**
+	 * @brief Deletes every record a filter matches as one transaction. The records are tested in parallel in a single pass.
+	 * @param filter the records to delete
+	 * @return the number of records deleted
+	*/
+	std::size_t deleteWhere(const RecordFilter &filter);
+
+	/**
+	 * @brief Sets one column of every record a filter matches as one transaction. The records are tested and the new values
+	 * computed in parallel in a single pass.
+	 * @param filter the records to update
+	 * @param column the column to change
+	 * @param expression computes each record's new value from the record. It is called from several threads at once.
+	 * @return the number of records updated
 	*/
-	void insertRecord(RecordDTO newRecord);
+	std::size_t updateWhere(const RecordFilter &filter, RecordColumn column, const RecordExpression &expression);
 
 	/**
-	 * @brief Deletes a RecordDTO from the RecordService class' vector. Assumes the recordId is
-	 * equivalent to its row in the CSV file.
-	 * @param recordId the record's row in the CSV file
+	 * @brief Reverses the latest insert, edit, delete or transaction that has not been undone. Costs O(1) per change and
+	 * touches only the changed records.
+	 * @return false if there is no change to undo
 	*/
-	void deleteRecord(int recordId);
+	bool undo();
+
+	/**
+	 * @brief Applies the latest undone change again
+	 * @return false if there is no change to redo
+	*/
+	bool redo();
+
+	/**
+	 * @brief Keeps at most maxMemoryBytes of the change history in memory and spills the rest to a file. The history is unbounded otherwise.
+	 * @param path the file to spill to. It is replaced.
+	 * @param maxMemoryBytes the most history bytes kept in memory
+	*/
+	void spillHistoryToDisk(std::string path, std::size_t maxMemoryBytes);
+
+	/**
+	 * @brief Removes the deleted records' slots from the vector. Record ids are unchanged; only their slots move.
+	 * Called automatically as deletes accumulate.
+	*/
+	void compact();
+
+	/**
+	 * @brief Returns the latest published version of the records. This is the only member that may be called from another thread
+	 * while the records change: it pins the version without waiting on the writer, and the version never changes afterwards.
+	 * Until the background load finishes it returns the empty version 0, so wait on whenLoaded() first to read the data set.
+	 * @return the latest snapshot
+	*/
+	std::shared_ptr<const RecordSnapshot> snapshot() const;
+
+	/**
+	 * @brief Writes a snapshot's records to a new file. Safe to run on any thread while the records change, because the snapshot never does.
+	 * @param snapshot the version to write. Holding it keeps the version alive until the file is written.
+	 * @param newFileName the file's name without the extension
+	*/
+	static void writeSnapshotToFile(std::shared_ptr<const RecordSnapshot> snapshot, std::string newFileName);
 	
 	/**
 	 * @brief Uses the RecordDAO object to write the current list of records to a new file
@@ -99,16 +482,273 @@ public:
 	void writeToFile(std::string newFileName);
 
 	/**
-	 * @brief Uses the RecordDAO object to reload the data from the original CSV file
+	 * @brief Uses the RecordDAO object to reload the data from the original CSV file. Clears the undo history. If the file cannot
+	 * be read, the records are left as they are and getLoadError() says why. If the reloaded records break the unique key, the
+	 * constraint is turned off and hasUniqueKey() returns false; findDuplicates() lists the offenders.
+	 * @return true if the records were reloaded
 	*/
-	void reloadData();
+	bool reloadData();
 
 	/**
-	 * @brief Sorts the RefDate and Geo columns by ascending or descending, depending on the user's input
+	 * @brief Returns every record sorted by the RefDate and Geo columns in ascending or descending order, depending on the user's input.
+	 * recordList itself is not reordered.
 	 * @param order either 0 (ascending) or 1(descending).
 	 * @return the sorted vector of RecordDTOs
 	*/
-	std::vector<RecordDTO> sortRecords(int order);
+	std::vector<RecordDTO> sortRecords(int order) const;
+
+	/**
+	 * @brief Returns the first records sorted by the RefDate and Geo columns, at a cost proportional to numberOfRecords
+	 * @param numberOfRecords the number of sorted records wanted
+	 * @param order either 0 (ascending) or 1(descending).
+	 * @return at most numberOfRecords RecordDTOs in sorted order
+	*/
+	std::vector<RecordDTO> getSortedRecords(int numberOfRecords, int order) const;
+
+	/**
+	 * @brief Sorts the records by any list of columns, each ascending or descending. recordList itself is not reordered.
+	 * @param sortKeys the columns to sort by, most significant first
+	 * @param isStable true to keep records with equal keys in their current order
+	 * @return the records' ids, in sorted order
+	*/
+	std::vector<RecordId> sortRecordIds(const std::vector<SortKey> &sortKeys, bool isStable = true) const;
+
+	/**
+	 * @brief Returns the first records of any sort order, copying only those records. Costs O(n log numberOfRecords).
+	 * @param sortKeys the columns to sort by, most significant first
+	 * @param numberOfRecords the number of sorted records wanted
+	 * @return at most numberOfRecords RecordDTOs in sorted order, with ties in their current order
+	*/
+	std::vector<RecordDTO> getSortedRecords(const std::vector<SortKey> &sortKeys, int numberOfRecords) const;
+
+	/**
+	 * @brief Builds an index on a column so findRecords() can answer lookups on it without a scan. Does nothing if the column is already indexed.
+	 * @param column the column to index
+	*/
+	void createIndex(RecordColumn column);
+
+	/**
+	 * @brief Removes a column's index, and its text index, which finds rows through it. Lookups on the column fall back to a scan.
+	 * @param column the column whose index is removed
+	*/
+	void dropIndex(RecordColumn column);
+
+	/**
+	 * @brief Checks whether a column is indexed
+	 * @param column the column
+	 * @return true if findRecords() uses an index for the column
+	*/
+	bool hasIndex(RecordColumn column) const;
+
+	/**
+	 * @brief Finds every record whose column equals a value. Uses the column's index if there is one, and scans otherwise.
+	 * @param column the column to compare
+	 * @param value the value to look for
+	 * @return the matching records' ids, in the order the records are stored
+	*/
+	std::vector<RecordId> findRecords(RecordColumn column, std::string_view value) const;
+
+	/**
+	 * @brief Finds every record a filter matches, such as GEO = "Quebec" AND VALUE > 1000
+	 * @param filter the predicate tree to evaluate
+	 * @return the matching records' ids, in the order the records are stored
+	*/
+	std::vector<RecordId> filterRecords(const RecordFilter &filter) const;
+
+	/**
+	 * @brief Builds a trigram index on a column so searchText() can answer searches on it without comparing every record. Also
+	 * indexes the column for findRecords(), as the search uses that index to find the rows holding each matching value.
+	 * Does nothing if the column already has a text index.
+	 * @param column the column to index
+	*/
+	void createTextIndex(RecordColumn column);
+
+	/**
+	 * @brief Removes a column's text index. Searches on the column fall back to a scan. The column keeps its findRecords() index.
+	 * @param column the column whose text index is removed
+	*/
+	void dropTextIndex(RecordColumn column);
+
+	/**
+	 * @brief Checks whether a column has a text index
+	 * @param column the column
+	 * @return true if searchText() uses a trigram index for the column
+	*/
+	bool hasTextIndex(RecordColumn column) const;
+
+	/**
+	 * @brief Finds every record whose column holds a piece of text, ignoring the case of ASCII letters, such as "brit" in GEO
+	 * @param column the column to search
+	 * @param text the text to look for
+	 * @param match whether the text may appear anywhere in the value or only at its start
+	 * @return the matching records' ids, in the order the records are stored
+	*/
+	std::vector<RecordId> searchText(RecordColumn column, std::string_view text, TextMatch match = TextMatch::Contains) const;
+
+	/**
+	 * @brief Finds every record whose column holds a piece of text and that a filter also matches. The filter only tests the
+	 * rows the search found.
+	 * @param column the column to search
+	 * @param text the text to look for
+	 * @param match whether the text may appear anywhere in the value or only at its start
+	 * @param filter the other conditions the records must meet
+	 * @return the matching records' ids, in the order the records are stored
+	*/
+	std::vector<RecordId> searchText(RecordColumn column, std::string_view text, TextMatch match, const RecordFilter &filter) const;
+
+	/**
+	 * @brief Summarizes the records by group, such as the total and average VALUE for each GEO
+	 * @param keys the columns to group by
+	 * @param aggregates the summaries to compute for each group
+	 * @return one row per group, in ascending key order
+	*/
+	GroupByResult groupRecords(const std::vector<GroupKey> &keys, const std::vector<Aggregate> &aggregates) const;
+
+	/**
+	 * @brief Summarizes the records a filter matches by group
+	 * @param keys the columns to group by
+	 * @param aggregates the summaries to compute for each group
+	 * @param filter selects the records to summarize
+	 * @return one row per group, in ascending key order
+	*/
+	GroupByResult groupRecords(const std::vector<GroupKey> &keys, const std::vector<Aggregate> &aggregates, const RecordFilter &filter) const;
+
+	/**
+	 * @brief Returns the records grouped into one date-ordered series per VECTOR, for range queries, rolling windows,
+	 * year-over-year changes and resampling. The series are rebuilt here the first time they are needed after a change.
+	 * @return the series, valid until the next change to the records
+	*/
+	const TimeSeries &getTimeSeries();
+
+	/**
+	 * @brief Summarizes the records by group like groupRecords(), but keeps the result and maintains it as records are
+	 * inserted, edited and deleted, so asking again costs one step per group rather than a scan of every record
+	 * @param keys the columns to group by
+	 * @param aggregates the summaries to compute for each group
+	 * @return one row per group, in ascending key order
+	*/
+	GroupByResult getCachedGroups(const std::vector<GroupKey> &keys, const std::vector<Aggregate> &aggregates);
+
+	/** @brief Forgets every cached group-by result */
+	void clearAggregateCache();
+
+	/**
+	 * @brief Counts a column's different non-empty values, such as the number of series in VECTOR. The estimate is read from a
+	 * HyperLogLog sketch in constant time and is typically within 2%; values removed since the sketch was last rebuilt may still be counted.
+	 * @param column the column
+	 * @param isExact true to count every live record's value instead
+	 * @return the estimated or exact count
+	*/
+	std::size_t estimateDistinctCount(RecordColumn column, bool isExact = false);
+
+	/**
+	 * @brief Finds a percentile of VALUE over every record, such as the 95th. The estimate is read from a quantile sketch in constant time.
+	 * @param fraction the percentile as a fraction, such as 0.95 for the 95th
+	 * @param isExact true to sort every live record's value instead
+	 * @return the estimated or exact percentile, or NaN if no VALUE is a number
+	 * @throws std::invalid_argument if the fraction is not between 0 and 1
+	*/
+	double estimateQuantile(double fraction, bool isExact = false);
+
+	/**
+	 * @brief Finds a percentile of VALUE for each value of a column, such as the 95th percentile by province. A column without
+	 * a sketch yet is sketched once, then kept up to date like the others.
+	 * @param groupColumn the column to group by
+	 * @param fraction the percentile as a fraction, such as 0.95 for the 95th
+	 * @param isExact true to sort every live record's value instead
+	 * @return the estimated or exact percentile of each group with a numeric VALUE, in ascending group order
+	 * @throws std::invalid_argument if the fraction is not between 0 and 1
+	*/
+	std::map<std::string, double> estimateQuantiles(RecordColumn groupColumn, double fraction, bool isExact = false);
+
+	/**
+	 * @brief Uses the RecordDAO object to write a group-by result to a new file
+	 * @param result the result to write
+	 * @param newFileName the file's name without the file extension
+	 * @throws std::runtime_error if the file cannot be opened or written
+	*/
+	void writeGroupsToFile(const GroupByResult &result, std::string newFileName);
+
+	/**
+	 * @brief Cross-tabulates the records, such as total VALUE by GEO and product type for each year
+	 * @param spec the axes, period and summary
+	 * @return the dense pivot table
+	 * @throws std::invalid_argument if an axis is not a dictionary column, the function is CountDistinct, or the table would exceed RecordPivot::MAX_CELLS
+	*/
+	PivotTable pivotRecords(const PivotSpec &spec) const;
+
+	/**
+	 * @brief Uses the RecordDAO object to write a pivot table to a new file
+	 * @param table the pivot table to write
+	 * @param newFileName the file's name without the file extension
+	 * @throws std::runtime_error if the file cannot be opened or written
+	*/
+	void writePivotToFile(const PivotTable &table, std::string newFileName);
+
+	/**
+	 * @brief Refuses, from now on, any insert, edit or transaction that would give two records the same values in the key columns.
+	 * Each check is a single hash lookup. Undo and redo restore earlier states without checking them.
+	 * @param columns the key's columns, by default REF_DATE and VECTOR
+	 * @throws std::invalid_argument if the records already break the constraint. findDuplicates() lists the offenders.
+	*/
+	void enableUniqueKey(std::vector<RecordColumn> columns = { RecordColumn::RefDate, RecordColumn::Vector });
+
+	/** @brief Stops checking the unique key */
+	void disableUniqueKey() { waitUntilLoaded(); RecordService::uniqueKey.reset(); }
+
+	/** @return true if a unique key is checked */
+	bool hasUniqueKey() const { waitUntilLoaded(); return RecordService::uniqueKey.has_value(); }
+
+	/**
+	 * @brief Lists every combination of key values that more than one record holds, scanning the records in parallel.
+	 * Works whether or not a unique key is enabled.
+	 * @param columns the key's columns, by default REF_DATE and VECTOR
+	 * @return one entry per duplicated key, ordered by the key's first record
+	*/
+	std::vector<DuplicateRecords> findDuplicates(std::vector<RecordColumn> columns = { RecordColumn::RefDate, RecordColumn::Vector }) const;
+
+	/**
+	 * @brief Applies a revised CSV file, such as a newer release of the data set, without discarding local changes. Each of the
+	 * file's records is matched to the stored record with the same key: new keys are inserted, and stored records are updated
+	 * only in the columns the file changes. Records the file does not mention are left alone. The whole merge is one
+	 * transaction, so undo() reverses it.
+	 * @param filePath the revised file
+	 * @param keyColumns the columns that identify a record, by default REF_DATE and VECTOR
+	 * @return the number of records inserted, updated and left unchanged
+	 * @throws std::runtime_error if the file cannot be opened
+	 * @throws std::invalid_argument if the merge would break the unique key
+	*/
+	MergeResult mergeFromFile(const std::string &filePath, std::vector<RecordColumn> keyColumns = { RecordColumn::RefDate, RecordColumn::Vector });
+
+	/**
+	 * @brief Uses the RecordDAO object to read another table, such as a production or price table, to join with the records.
+	 * Does not wait for the data set to load.
+	 * @param filePath the table's CSV file, with a header row
+	 * @return the table
+	 * @throws std::runtime_error if the file cannot be opened
+	*/
+	TableDTO loadTable(const std::string &filePath);
+
+	/**
+	 * @brief Joins the records with another table on the spec's key columns and keeps the result in memory
+	 * @param table the table, such as one returned by loadTable()
+	 * @param spec the key columns and join type, by default an inner join on REF_DATE and GEO
+	 * @return the record columns followed by the table's non-key columns, one row per match
+	 * @throws std::invalid_argument if the spec does not fit the table
+	*/
+	TableDTO joinTable(const TableDTO &table, const JoinSpec &spec = JoinSpec{}) const;
+
+	/**
+	 * @brief Joins the records with another table and writes each batch of the result to a new file as soon as it is ready,
+	 * so the whole join is never held in memory
+	 * @param table the table, such as one returned by loadTable()
+	 * @param spec the key columns and join type
+	 * @param newFileName the file's name without the file extension
+	 * @return the number of joined rows written
+	 * @throws std::invalid_argument if the spec does not fit the table. Nothing is written.
+	 * @throws std::runtime_error if the file cannot be opened or written. The rows written before the error are kept.
+	*/
+	std::size_t writeJoinToFile(const TableDTO &table, const JoinSpec &spec, std::string newFileName);
 
 };
 #endif // RECORD_SERVICE_H
@@ -0,0 +1,300 @@
+/**
+* @file				RecordSketch.cpp
+* @author			Chloe Lee-Hone<leeh0002@algonquinlive.com>
+* @version			1.0
+* @section			This file contains the RecordSketch class used by RecordService to estimate distinct counts and percentiles in constant time.
+*					This project contains information licensed under the Open Government Licence  Canada [1][2]. Code structure was informed by the provided example written by Stanley Pieda for CST8333 [3].
+*
+* Student Name:     Chloe Lee-Hone
+* Student Number:   041023578
+* Course:           CST8333_350: Programming Language Research Project
+* Professor:        Reg Dyer
+* Date:             05/06/2023
+*
+* References:
+* [1]   T. B. of C. Secretariat and T. B. S. of C. Open Government, Open Government Licence - Canada. http://open.canada.ca/en/open-government-licence-canada (accessed May 11, 2023).
+* [2]	T. B. of C. Secretariat and Open Government Portal, Vegetables in cold and common storage, Oct. 10, 2008. https://open.canada.ca/data/en/dataset/473f9524-45f8-47d0-9a12-537bb7704089 (accessed May 16, 2023).
+* [3]	S. Pieda, CST8333 19F Practical Project 2 Example Layered. Algonquin College, Algonquin College, Jun. 07, 2022. [Online]. Available: https://brightspace.algonquincollege.com/d2l/le/content/543581/viewContent/8322468/View
+*/
+
+#include "RecordSketch.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+#include "ParallelRange.h"
+
+/**
+ * @brief Checks a percentile's fraction before any group is read
+ * @param fraction the percentile as a fraction
+ * @throws std::invalid_argument if the fraction is not between 0 and 1
+*/
+static void checkFraction(double fraction) {
+	if (!(fraction >= 0 && fraction <= 1)) {
+		throw std::invalid_argument("A percentile must be between 0 and 1.");
+	}
+}
+
+/**
+ * @return true if build() must run before an estimate is read
+*/
+bool RecordSketch::isStale() const {
+	return isOutOfDate || removedCount * REBUILD_FRACTION > recordCount;
+}
+
+/**
+ * @brief Checks whether percentiles are estimated for each value of a column
+ * @param column the column
+ * @return true if groupQuantiles() can be called for the column
+*/
+bool RecordSketch::hasGroupColumn(RecordColumn column) const {
+	return std::any_of(groupedValues.begin(), groupedValues.end(), [column](const GroupedValues &grouped) { return grouped.column == column; });
+}
+
+/**
+ * @brief Estimates percentiles for each value of another column from now on. Marks the sketch stale.
+ * @param column the column to group by
+*/
+void RecordSketch::addGroupColumn(RecordColumn column) {
+	if (!hasGroupColumn(column)) {
+		groupedValues.push_back(GroupedValues{ column });
+		isOutOfDate = true;
+	}
+}
+
+/**
+ * @brief Checks whether the percentile sketches read a column, so an edit to it must remove and add the whole record
+ * @param column the column
+ * @return true for VALUE and the group columns
+*/
+bool RecordSketch::dependsOn(RecordColumn column) const {
+	return column == RecordColumn::Value || hasGroupColumn(column);
+}
+
+/**
+ * @brief Rebuilds every sketch from rowCount records. Chunks of records are sketched on separate threads and the sketches merged.
+ * @param recordList the records
+ * @param rowCount the number of records to sketch
+ * @param rowAt a callable taking a position below rowCount and returning its row in recordList
+*/
+template <typename RowAt>
+void RecordSketch::buildRows(const std::vector<RecordDTO> &recordList, std::size_t rowCount, const RowAt &rowAt) {
+	RecordSketch emptySketch{};
+	for (const GroupedValues &grouped : groupedValues) {
+		emptySketch.groupedValues.push_back(GroupedValues{ grouped.column });
+	}
+	emptySketch.isOutOfDate = false;
+	std::vector<RecordSketch> chunkSketches(parallelChunkCount(rowCount), emptySketch);
+
+	forEachChunk(rowCount, [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+		for (std::size_t i = begin; i < end; i++) {
+			chunkSketches[chunk].add(recordList[rowAt(i)]);
+		}
+	});
+
+	*this = std::move(chunkSketches.front());
+	for (std::size_t chunk = 1; chunk < chunkSketches.size(); chunk++) {
+		merge(chunkSketches[chunk]);
+	}
+}
+
+/**
+ * @brief Rebuilds every sketch from the records
+ * @param recordList the records, none of them deleted
+*/
+void RecordSketch::build(const std::vector<RecordDTO> &recordList) {
+	buildRows(recordList, recordList.size(), [](std::size_t i) { return i; });
+}
+
+/**
+ * @brief Rebuilds every sketch from the selected records, such as the live ones
+ * @param recordList the records
+ * @param rows the rows to sketch
+*/
+void RecordSketch::build(const std::vector<RecordDTO> &recordList, const std::vector<RecordIndex::RowId> &rows) {
+	buildRows(recordList, rows.size(), [&rows](std::size_t i) { return rows[i]; });
+}
+
+/**
+ * @brief Adds the values another sketch, built from different records with the same group columns, has seen
+*/
+void RecordSketch::merge(const RecordSketch &other) {
+	for (std::size_t i = 0; i < RECORD_COLUMN_COUNT; i++) {
+		distinctValues[i].merge(other.distinctValues[i]);
+	}
+	values.merge(other.values);
+	for (std::size_t i = 0; i < groupedValues.size(); i++) {
+		for (const auto &group : other.groupedValues[i].groups) {
+			groupedValues[i].groups[group.first].merge(group.second);
+		}
+	}
+	recordCount += other.recordCount;
+}
+
+/**
+ * @brief Adds a record to every sketch
+ * @param record a record that was inserted, or the new state of an edited record
+*/
+void RecordSketch::add(const RecordDTO &record) {
+	if (isOutOfDate) return;
+
+	for (std::size_t i = 0; i < RECORD_COLUMN_COUNT; i++) {
+		std::string_view value = record.get(RECORD_COLUMNS[i].column);
+		if (!value.empty()) distinctValues[i].add(value);
+	}
+	recordCount++;
+
+	double number = readNumericValue(record.get(RecordColumn::Value));
+	if (std::isnan(number)) return;
+	values.add(number);
+	for (GroupedValues &grouped : groupedValues) {
+		grouped.groups[std::string{ record.get(grouped.column) }].add(number);
+	}
+}
+
+/**
+ * @brief Records an edit to a column dependsOn() is false for: the new value is added to that column's distinct count only, and
+ * the old value, which the distinct count cannot forget, is counted as a removal
+ * @param column the edited column
+ * @param value the new value
+*/
+void RecordSketch::replaceValue(RecordColumn column, std::string_view value) {
+	if (isOutOfDate) return;
+
+	removedCount++;
+	if (!value.empty()) distinctValues[columnIndex(column)].add(value);
+}
+
+/**
+ * @brief Counts a record's removal, which the sketches cannot undo
+ * @param record a record about to be deleted, or the old state of a record about to be edited
+*/
+void RecordSketch::remove(const RecordDTO &) {
+	if (isOutOfDate) return;
+
+	removedCount++;
+	recordCount -= recordCount > 0 ? 1 : 0;
+}
+
+/**
+ * @brief Estimates the number of different non-empty values of a column. The sketch must not be stale.
+ * @param column the column
+ * @return the estimated count
+*/
+std::size_t RecordSketch::distinctCount(RecordColumn column) const {
+	return distinctValues[columnIndex(column)].estimate();
+}
+
+/**
+ * @brief Estimates a percentile of VALUE over all records. The sketch must not be stale.
+ * @param fraction the percentile as a fraction, such as 0.95 for the 95th
+ * @return the estimated percentile, or NaN if no VALUE is a number
+ * @throws std::invalid_argument if the fraction is not between 0 and 1
+*/
+double RecordSketch::quantile(double fraction) const {
+	return values.quantile(fraction);
+}
+
+/**
+ * @brief Estimates a percentile of VALUE for each value of a group column. The sketch must not be stale.
+ * @param column a column added with addGroupColumn()
+ * @param fraction the percentile as a fraction, such as 0.95 for the 95th
+ * @return the estimated percentile of each group with a numeric VALUE, by group value
+ * @throws std::invalid_argument if the fraction is not between 0 and 1 or the column is not a group column
+*/
+std::map<std::string, double> RecordSketch::groupQuantiles(RecordColumn column, double fraction) const {
+	checkFraction(fraction);
+	auto grouped = std::find_if(groupedValues.begin(), groupedValues.end(), [column](const GroupedValues &grouped) { return grouped.column == column; });
+	if (grouped == groupedValues.end()) {
+		throw std::invalid_argument(std::string{ columnInfo(column).header } + " is not sketched by group.");
+	}
+
+	std::map<std::string, double> quantiles{};
+	for (const auto &group : grouped->groups) {
+		quantiles.emplace(group.first, group.second.quantile(fraction));
+	}
+	return quantiles;
+}
+
+/**
+ * @brief Counts a column's different non-empty values exactly
+ * @param recordList the records
+ * @param rows the rows to count
+ * @param column the column
+ * @return the count
+*/
+std::size_t RecordSketch::exactDistinctCount(const std::vector<RecordDTO> &recordList, const std::vector<RecordIndex::RowId> &rows, RecordColumn column) {
+	std::unordered_set<std::string_view> distinct{};
+	for (RecordIndex::RowId row : rows) {
+		std::string_view value = recordList[row].get(column);
+		if (!value.empty()) distinct.insert(value);
+	}
+	return distinct.size();
+}
+
+/**
+ * @brief Finds a percentile of VALUE exactly, for each value of a group column, or over all the rows if there is none
+ * @param recordList the records
+ * @param rows the rows to read
+ * @param groupColumn the column to group by, or none
+ * @param fraction the percentile as a fraction, such as 0.95 for the 95th
+ * @return the percentile of each group with a numeric VALUE, by group value. Without a group column the only group is "".
+ * @throws std::invalid_argument if the fraction is not between 0 and 1
+*/
+std::map<std::string, double> RecordSketch::exactQuantiles(const std::vector<RecordDTO> &recordList, const std::vector<RecordIndex::RowId> &rows,
+	std::optional<RecordColumn> groupColumn, double fraction) {
+	checkFraction(fraction);
+	std::map<std::string, std::vector<double>> groupNumbers{};
+	for (RecordIndex::RowId row : rows) {
+		double number = readNumericValue(recordList[row].get(RecordColumn::Value));
+		if (std::isnan(number)) continue;
+		groupNumbers[groupColumn ? std::string{ recordList[row].get(*groupColumn) } : std::string{}].push_back(number);
+	}
+
+	std::map<std::string, double> quantiles{};
+	for (auto &group : groupNumbers) {
+		quantiles.emplace(group.first, QuantileSketch::exactQuantile(group.second, fraction));
+	}
+	return quantiles;
+}
+
+TEST_CASE("Test that record sketches estimate distinct counts and percentiles near the exact ones") {
+	const char *provinces[] = { "Alberta", "Manitoba", "Ontario", "Quebec", "Saskatchewan" };
+	std::vector<RecordDTO> recordList(60000);
+	std::vector<RecordIndex::RowId> rows(recordList.size());
+	for (RecordIndex::RowId row = 0; row < recordList.size(); row++) {
+		recordList[row].setGeo(provinces[row % 5]);
+		recordList[row].setVector("v" + std::to_string(row % 20000));
+		recordList[row].setValue(std::to_string((row * 7919) % 60000));
+		rows[row] = row;
+	}
+
+	RecordSketch sketch{};
+	sketch.addGroupColumn(RecordColumn::Geo);
+	CHECK(sketch.isStale());
+	sketch.build(recordList);
+	REQUIRE_FALSE(sketch.isStale());
+
+	CHECK(sketch.distinctCount(RecordColumn::Geo) == RecordSketch::exactDistinctCount(recordList, rows, RecordColumn::Geo));
+	double seriesCount = static_cast<double>(sketch.distinctCount(RecordColumn::Vector));
+	CHECK(std::abs(seriesCount - 20000) < 20000 * 0.05);
+	CHECK(sketch.distinctCount(RecordColumn::Status) == 0);
+
+	double exact = RecordSketch::exactQuantiles(recordList, rows, std::nullopt, 0.95).at("");
+	CHECK(std::abs(sketch.quantile(0.95) - exact) < 60000 * 0.02);
+	std::map<std::string, double> estimates = sketch.groupQuantiles(RecordColumn::Geo, 0.95);
+	std::map<std::string, double> exacts = RecordSketch::exactQuantiles(recordList, rows, RecordColumn::Geo, 0.95);
+	REQUIRE(estimates.size() == 5);
+	for (const auto &group : exacts) {
+		CHECK(std::abs(estimates.at(group.first) - group.second) < 60000 * 0.02);
+	}
+	CHECK_THROWS_AS(sketch.groupQuantiles(RecordColumn::Vector, 0.95), std::invalid_argument);
+
+	/* Removals cannot be undone, so enough of them make the sketch ask for a rebuild */
+	for (std::size_t row = 0; row * RecordSketch::REBUILD_FRACTION <= recordList.size(); row++) {
+		sketch.remove(recordList[row]);
+	}
+	CHECK(sketch.isStale());
+}
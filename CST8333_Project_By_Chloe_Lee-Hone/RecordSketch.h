@@ -0,0 +1,187 @@
+/**
+* @file				RecordSketch.h
+* @author			Chloe Lee-Hone<leeh0002@algonquinlive.com>
+* @version			1.0
+* @section			Header file for the RecordSketch class, which keeps approximate statistics of the records up to date as they change.
+*					This project contains information licensed under the Open Government Licence  Canada [1][2]. Code structure was informed by the provided example written by Stanley Pieda for CST8333 [3].
+*
+* Student Name:     Chloe Lee-Hone
+* Student Number:   041023578
+* Course:           CST8333_350: Programming Language Research Project
+* Professor:        Reg Dyer
+* Date:             05/06/2023
+*
+* References:
+* [1]   T. B. of C. Secretariat and T. B. S. of C. Open Government, Open Government Licence - Canada. http://open.canada.ca/en/open-government-licence-canada (accessed May 11, 2023).
+* [2]	T. B. of C. Secretariat and Open Government Portal, Vegetables in cold and common storage, Oct. 10, 2008. https://open.canada.ca/data/en/dataset/473f9524-45f8-47d0-9a12-537bb7704089 (accessed May 16, 2023).
+* [3]	S. Pieda, CST8333 19F Practical Project 2 Example Layered. Algonquin College, Algonquin College, Jun. 07, 2022. [Online]. Available: https://brightspace.algonquincollege.com/d2l/le/content/543581/viewContent/8322468/View
+*/
+
+#pragma once
+#include <array>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "HyperLogLog.h"
+#include "QuantileSketch.h"
+#include "RecordColumn.h"
+#include "RecordDTO.h"
+#include "RecordIndex.h"
+#include "doctest.h"
+
+#ifndef RECORD_SKETCH_H
+#define RECORD_SKETCH_H
+
+/**
+ * @brief Keeps sketches of the records so statistics can be estimated without reading them: a HyperLogLog of every column's
+ * non-empty values for distinct counts, and QuantileSketches of VALUE, over all records and for each value of chosen group
+ * columns such as GEO. Reading an estimate costs the same however many records there are.
+ *
+ * Inserts and the new state of edited records are added as they happen. A sketch cannot take a value out, so a delete or the
+ * old state of an edit is only counted: until the next build(), a removed value can still be counted as distinct or shift a
+ * percentile. Once removals reach one sixteenth of the records, the sketch reports itself stale so the next read rebuilds it.
+*/
+class RecordSketch
+{
+public:
+	/** @brief A sketch is stale once it has counted more than one removal for this many records */
+	static constexpr std::uint64_t REBUILD_FRACTION = 16;
+
+	/** @brief Creates an empty, stale sketch that estimates percentiles over all records only */
+	RecordSketch() = default;
+
+	/** @return true if build() must run before an estimate is read */
+	bool isStale() const;
+
+	/** @brief Marks the sketch stale, such as after a change too large to apply a record at a time */
+	void invalidate() { isOutOfDate = true; }
+
+	/**
+	 * @brief Checks whether percentiles are estimated for each value of a column
+	 * @param column the column
+	 * @return true if groupQuantiles() can be called for the column
+	*/
+	bool hasGroupColumn(RecordColumn column) const;
+
+	/**
+	 * @brief Estimates percentiles for each value of another column from now on. Marks the sketch stale.
+	 * @param column the column to group by
+	*/
+	void addGroupColumn(RecordColumn column);
+
+	/**
+	 * @brief Checks whether the percentile sketches read a column, so an edit to it must remove and add the whole record
+	 * @param column the column
+	 * @return true for VALUE and the group columns
+	*/
+	bool dependsOn(RecordColumn column) const;
+
+	/**
+	 * @brief Rebuilds every sketch from the records. Chunks of records are sketched on separate threads and the sketches merged.
+	 * @param recordList the records, none of them deleted
+	*/
+	void build(const std::vector<RecordDTO> &recordList);
+
+	/**
+	 * @brief Rebuilds every sketch from the selected records, such as the live ones
+	 * @param recordList the records
+	 * @param rows the rows to sketch
+	*/
+	void build(const std::vector<RecordDTO> &recordList, const std::vector<RecordIndex::RowId> &rows);
+
+	/**
+	 * @brief Adds a record to every sketch
+	 * @param record a record that was inserted, or the new state of an edited record
+	*/
+	void add(const RecordDTO &record);
+
+	/**
+	 * @brief Records an edit to a column dependsOn() is false for: the new value is added to that column's distinct count only, and
+	 * the old value, which the distinct count cannot forget, is counted as a removal
+	 * @param column the edited column
+	 * @param value the new value
+	*/
+	void replaceValue(RecordColumn column, std::string_view value);
+
+	/**
+	 * @brief Counts a record's removal, which the sketches cannot undo
+	 * @param record a record about to be deleted, or the old state of a record about to be edited
+	*/
+	void remove(const RecordDTO &record);
+
+	/**
+	 * @brief Estimates the number of different non-empty values of a column. The sketch must not be stale.
+	 * @param column the column
+	 * @return the estimated count
+	*/
+	std::size_t distinctCount(RecordColumn column) const;
+
+	/**
+	 * @brief Estimates a percentile of VALUE over all records. The sketch must not be stale.
+	 * @param fraction the percentile as a fraction, such as 0.95 for the 95th
+	 * @return the estimated percentile, or NaN if no VALUE is a number
+	 * @throws std::invalid_argument if the fraction is not between 0 and 1
+	*/
+	double quantile(double fraction) const;
+
+	/**
+	 * @brief Estimates a percentile of VALUE for each value of a group column. The sketch must not be stale.
+	 * @param column a column added with addGroupColumn()
+	 * @param fraction the percentile as a fraction, such as 0.95 for the 95th
+	 * @return the estimated percentile of each group with a numeric VALUE, by group value
+	 * @throws std::invalid_argument if the fraction is not between 0 and 1 or the column is not a group column
+	*/
+	std::map<std::string, double> groupQuantiles(RecordColumn column, double fraction) const;
+
+	/**
+	 * @brief Counts a column's different non-empty values exactly
+	 * @param recordList the records
+	 * @param rows the rows to count
+	 * @param column the column
+	 * @return the count
+	*/
+	static std::size_t exactDistinctCount(const std::vector<RecordDTO> &recordList, const std::vector<RecordIndex::RowId> &rows, RecordColumn column);
+
+	/**
+	 * @brief Finds a percentile of VALUE exactly, for each value of a group column, or over all the rows if there is none
+	 * @param recordList the records
+	 * @param rows the rows to read
+	 * @param groupColumn the column to group by, or none
+	 * @param fraction the percentile as a fraction, such as 0.95 for the 95th
+	 * @return the percentile of each group with a numeric VALUE, by group value. Without a group column the only group is "".
+	 * @throws std::invalid_argument if the fraction is not between 0 and 1
+	*/
+	static std::map<std::string, double> exactQuantiles(const std::vector<RecordDTO> &recordList, const std::vector<RecordIndex::RowId> &rows,
+		std::optional<RecordColumn> groupColumn, double fraction);
+
+private:
+	/** @brief The VALUE sketches of one group column, by group value */
+	struct GroupedValues {
+		RecordColumn column;
+		std::unordered_map<std::string, QuantileSketch> groups{};
+	};
+
+	std::array<HyperLogLog, RECORD_COLUMN_COUNT> distinctValues{};
+	QuantileSketch values{};
+	std::vector<GroupedValues> groupedValues{};
+	/** @brief the number of records added less the number removed */
+	std::uint64_t recordCount{ 0 };
+	/** @brief the number of removals counted since the last build() */
+	std::uint64_t removedCount{ 0 };
+	bool isOutOfDate{ true };
+
+	/** @brief Adds the values another sketch, built from different records with the same group columns, has seen */
+	void merge(const RecordSketch &other);
+
+	/**
+	 * @brief Rebuilds every sketch from rowCount records
+	 * @param rowAt a callable taking a position below rowCount and returning its row in recordList
+	*/
+	template <typename RowAt>
+	void buildRows(const std::vector<RecordDTO> &recordList, std::size_t rowCount, const RowAt &rowAt);
+};
+#endif // !RECORD_SKETCH_H
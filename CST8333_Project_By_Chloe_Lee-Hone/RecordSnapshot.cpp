@@ -0,0 +1,75 @@
+/**
+* @file				RecordSnapshot.cpp
+* @author			Chloe Lee-Hone<leeh0002@algonquinlive.com>
+* @version			1.0
+* @section			This file contains the RecordSnapshot class, an immutable version of the records that readers can use while the records change.
+*					This project contains information licensed under the Open Government Licence  Canada [1][2]. Code structure was informed by the provided example written by Stanley Pieda for CST8333 [3].
+*
+* Student Name:     Chloe Lee-Hone
+* Student Number:   041023578
+* Course:           CST8333_350: Programming Language Research Project
+* Professor:        Reg Dyer
+* Date:             05/06/2023
+*
+* References:
+* [1]   T. B. of C. Secretariat and T. B. S. of C. Open Government, Open Government Licence - Canada. http://open.canada.ca/en/open-government-licence-canada (accessed May 11, 2023).
+* [2]	T. B. of C. Secretariat and Open Government Portal, Vegetables in cold and common storage, Oct. 10, 2008. https://open.canada.ca/data/en/dataset/473f9524-45f8-47d0-9a12-537bb7704089 (accessed May 16, 2023).
+* [3]	S. Pieda, CST8333 19F Practical Project 2 Example Layered. Algonquin College, Algonquin College, Jun. 07, 2022. [Online]. Available: https://brightspace.algonquincollege.com/d2l/le/content/543581/viewContent/8322468/View
+*/
+
+#include "RecordSnapshot.h"
+#include <utility>
+#include "doctest.h"
+
+/**
+ * @brief Creates a version from its chunks
+ * @param version the version number
+ * @param chunks the chunks, in slot order
+*/
+RecordSnapshot::RecordSnapshot(std::uint64_t version, std::vector<std::shared_ptr<const Chunk>> chunks)
+	: version{ version }, chunks{ std::move(chunks) } {
+	for (const std::shared_ptr<const Chunk> &chunk : RecordSnapshot::chunks) {
+		for (RecordId recordId : chunk->ids) {
+			if (recordId != DELETED_RECORD) RecordSnapshot::liveCount++;
+		}
+	}
+}
+
+/**
+ * @brief Returns every record in the order the records are stored, leaving deleted slots out
+ * @return the records
+*/
+std::vector<RecordDTO> RecordSnapshot::getAllRecords() const {
+	std::vector<RecordDTO> allRecords{};
+	allRecords.reserve(RecordSnapshot::liveCount);
+	forEachRecord([&allRecords](RecordId, const RecordDTO &record) { allRecords.push_back(record); });
+	return allRecords;
+}
+
+/**
+ * @brief Returns every record's id in the order the records are stored, leaving deleted slots out
+ * @return the ids
+*/
+std::vector<RecordSnapshot::RecordId> RecordSnapshot::getRecordIds() const {
+	std::vector<RecordId> recordIds{};
+	recordIds.reserve(RecordSnapshot::liveCount);
+	forEachRecord([&recordIds](RecordId recordId, const RecordDTO &) { recordIds.push_back(recordId); });
+	return recordIds;
+}
+
+TEST_CASE("Test that a snapshot leaves deleted slots out") {
+	auto first = std::make_shared<RecordSnapshot::Chunk>();
+	first->records = { RecordDTO("2020-01", "Ontario", "", "Carrots", "", "", "", "", "", "v1", "", "1", "", "", "", ""),
+		RecordDTO("2020-01", "Quebec", "", "Carrots", "", "", "", "", "", "v2", "", "2", "", "", "", "") };
+	first->ids = { 0, RecordSnapshot::DELETED_RECORD };
+	auto second = std::make_shared<RecordSnapshot::Chunk>();
+	second->records = { RecordDTO("2020-02", "Yukon", "", "Beets", "", "", "", "", "", "v3", "", "3", "", "", "", "") };
+	second->ids = { 7 };
+
+	RecordSnapshot snapshot{ 4, { first, second } };
+	CHECK(snapshot.getVersion() == 4);
+	CHECK(snapshot.recordCount() == 2);
+	CHECK(snapshot.getRecordIds() == std::vector<RecordSnapshot::RecordId>{ 0, 7 });
+	REQUIRE(snapshot.getAllRecords().size() == 2);
+	CHECK(snapshot.getAllRecords()[1].getVector() == "v3");
+}
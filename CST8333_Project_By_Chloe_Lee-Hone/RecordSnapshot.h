@@ -0,0 +1,104 @@
+/**
+* @file				RecordSnapshot.h
+* @author			Chloe Lee-Hone<leeh0002@algonquinlive.com>
+* @version			1.0
+* @section			Header file for the RecordSnapshot class, an immutable version of the records that readers can use while the records change.
+*					This project contains information licensed under the Open Government Licence  Canada [1][2]. Code structure was informed by the provided example written by Stanley Pieda for CST8333 [3].
+*
+* Student Name:     Chloe Lee-Hone
+* Student Number:   041023578
+* Course:           CST8333_350: Programming Language Research Project
+* Professor:        Reg Dyer
+* Date:             05/06/2023
+*
+* References:
+* [1]   T. B. of C. Secretariat and T. B. S. of C. Open Government, Open Government Licence - Canada. http://open.canada.ca/en/open-government-licence-canada (accessed May 11, 2023).
+* [2]	T. B. of C. Secretariat and Open Government Portal, Vegetables in cold and common storage, Oct. 10, 2008. https://open.canada.ca/data/en/dataset/473f9524-45f8-47d0-9a12-537bb7704089 (accessed May 16, 2023).
+* [3]	S. Pieda, CST8333 19F Practical Project 2 Example Layered. Algonquin College, Algonquin College, Jun. 07, 2022. [Online]. Available: https://brightspace.algonquincollege.com/d2l/le/content/543581/viewContent/8322468/View
+*/
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+#include "RecordDTO.h"
+#include "doctest.h"
+
+#ifndef RECORD_SNAPSHOT_H
+#define RECORD_SNAPSHOT_H
+
+/**
+ * @brief One published version of the records. A snapshot never changes after it is created, so any number of threads can
+ * read it without locking while RecordService goes on changing the records. The records are held in fixed-size chunks, and
+ * a new version shares every chunk the change did not touch with the version before it. A version and the chunks only it
+ * holds are freed when the last reader lets go of it.
+*/
+class RecordSnapshot
+{
+public:
+	/** @brief The same id as RecordService::RecordId */
+	using RecordId = std::uint64_t;
+
+	/** @brief The id stored in a deleted record's slot */
+	static constexpr RecordId DELETED_RECORD = std::numeric_limits<RecordId>::max();
+
+	/** @brief The number of slots in every chunk but the last */
+	static constexpr std::size_t CHUNK_SIZE = 1024;
+
+	/** @brief CHUNK_SIZE consecutive slots: each slot's record and its id, or DELETED_RECORD */
+	struct Chunk {
+		std::vector<RecordDTO> records;
+		std::vector<RecordId> ids;
+	};
+
+	RecordSnapshot() = default;
+
+	/**
+	 * @brief Creates a version from its chunks
+	 * @param version the version number
+	 * @param chunks the chunks, in slot order
+	*/
+	RecordSnapshot(std::uint64_t version, std::vector<std::shared_ptr<const Chunk>> chunks);
+
+	/** @return the version number, which grows by one with every published change */
+	std::uint64_t getVersion() const { return version; }
+
+	/** @return the number of records, not counting deleted slots */
+	std::size_t recordCount() const { return liveCount; }
+
+	/** @return the chunks, in slot order */
+	const std::vector<std::shared_ptr<const Chunk>> &getChunks() const { return chunks; }
+
+	/**
+	 * @brief Returns every record in the order the records are stored, leaving deleted slots out
+	 * @return the records
+	*/
+	std::vector<RecordDTO> getAllRecords() const;
+
+	/**
+	 * @brief Returns every record's id in the order the records are stored, leaving deleted slots out
+	 * @return the ids
+	*/
+	std::vector<RecordId> getRecordIds() const;
+
+	/**
+	 * @brief Calls callback(recordId, record) for every record in the order the records are stored, leaving deleted slots out
+	 * @param callback the function to call
+	*/
+	template <typename Callback>
+	void forEachRecord(Callback callback) const {
+		for (const std::shared_ptr<const Chunk> &chunk : chunks) {
+			for (std::size_t slot = 0; slot < chunk->ids.size(); slot++) {
+				if (chunk->ids[slot] != DELETED_RECORD) callback(chunk->ids[slot], chunk->records[slot]);
+			}
+		}
+	}
+
+private:
+	std::uint64_t version{ 0 };
+	std::vector<std::shared_ptr<const Chunk>> chunks{};
+	std::size_t liveCount{ 0 };
+};
+#endif // !RECORD_SNAPSHOT_H
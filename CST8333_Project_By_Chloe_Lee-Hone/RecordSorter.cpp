@@ -0,0 +1,585 @@
+/**
+* @file				RecordSorter.cpp
+* @author			Chloe Lee-Hone<leeh0002@algonquinlive.com>
+* @version			1.0
+* @section			This file contains the RecordSorter class used by RecordService to sort records by any combination of columns.
+*					This project contains information licensed under the Open Government Licence  Canada [1][2]. Code structure was informed by the provided example written by Stanley Pieda for CST8333 [3].
+*
+* Student Name:     Chloe Lee-Hone
+* Student Number:   041023578
+* Course:           CST8333_350: Programming Language Research Project
+* Professor:        Reg Dyer
+* Date:             05/06/2023
+*
+* References:
+* [1]   T. B. of C. Secretariat and T. B. S. of C. Open Government, Open Government Licence - Canada. http://open.canada.ca/en/open-government-licence-canada (accessed May 11, 2023).
+* [2]	T. B. of C. Secretariat and Open Government Portal, Vegetables in cold and common storage, Oct. 10, 2008. https://open.canada.ca/data/en/dataset/473f9524-45f8-47d0-9a12-537bb7704089 (accessed May 16, 2023).
+* [3]	S. Pieda, CST8333 19F Practical Project 2 Example Layered. Algonquin College, Algonquin College, Jun. 07, 2022. [Online]. Available: https://brightspace.algonquincollege.com/d2l/le/content/543581/viewContent/8322468/View
+*/
+
+#include "RecordSorter.h"
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <future>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <random>
+#include "ParallelRange.h"
+#include "doctest.h"
+
+/** @brief A row waiting to be sorted, with the first 8 bytes of its key so most comparisons never touch the key string */
+struct SortEntry {
+	std::uint64_t prefix;
+	RecordSorter::RowId row;
+};
+
+/**
+ * @brief Appends a text value so that shorter values sort before longer values they are a prefix of. A zero byte is written
+ * as 00 FF and the end of the value as 00 01, so no value's encoding is a prefix of another's.
+*/
+static void appendText(std::string &key, std::string_view value) {
+	for (char character : value) {
+		key += character;
+		if (character == '\0') key += '\xFF';
+	}
+	key += '\0';
+	key += '\x01';
+}
+
+/**
+ * @brief Appends a numeric value. Numbers are written as a 1 byte followed by 8 big-endian bytes that order like the numbers
+ * do. Empty or non-numeric text is written as a 0 byte followed by the text, so it sorts before every number.
+*/
+static void appendNumber(std::string &key, std::string_view value) {
+	double number{ 0 };
+	std::from_chars_result result = std::from_chars(value.data(), value.data() + value.size(), number);
+
+	if (value.empty() || result.ec != std::errc{} || result.ptr != value.data() + value.size()) {
+		key += '\0';
+		appendText(key, value);
+		return;
+	}
+
+	std::uint64_t bits{ 0 };
+	std::memcpy(&bits, &number, sizeof(bits));
+	// Setting the sign bit of positive numbers and inverting negative ones makes the bit pattern order like the value
+	bits = (bits & (std::uint64_t{ 1 } << 63)) ? ~bits : bits | (std::uint64_t{ 1 } << 63);
+
+	key += '\x01';
+	for (int shift = 56; shift >= 0; shift -= 8) {
+		key += static_cast<char>((bits >> shift) & 0xFF);
+	}
+}
+
+/**
+ * @brief Appends a record's encoded sort keys to key. Callers that encode many rows reuse one string this way.
+*/
+static void appendNormalizedKey(std::string &key, const RecordDTO &record, const std::vector<SortKey> &sortKeys) {
+	for (const SortKey &sortKey : sortKeys) {
+		std::size_t segmentStart = key.size();
+
+		if (columnInfo(sortKey.column).isNumeric) {
+			appendNumber(key, record.get(sortKey.column));
+		}
+		else {
+			appendText(key, record.get(sortKey.column));
+		}
+
+		// Inverting every byte of a segment reverses its order without changing the order of the segments before it
+		if (sortKey.isDescending) {
+			for (std::size_t i = segmentStart; i < key.size(); i++) {
+				key[i] = static_cast<char>(~static_cast<unsigned char>(key[i]));
+			}
+		}
+	}
+}
+
+/**
+ * @brief Encodes a record's sort keys so that comparing two encodings byte by byte orders the records the way sortKeys asks
+ * @param record the record to encode
+ * @param sortKeys the columns to sort by, most significant first
+ * @return the encoded key
+*/
+std::string RecordSorter::normalizedKey(const RecordDTO &record, const std::vector<SortKey> &sortKeys) {
+	std::string key{};
+	appendNormalizedKey(key, record, sortKeys);
+	return key;
+}
+
+/**
+ * @brief Reads the first 8 bytes of a key as a big-endian number, padding short keys with zeros
+*/
+static std::uint64_t keyPrefix(const std::string &key) {
+	std::uint64_t prefix{ 0 };
+	for (std::size_t i = 0; i < sizeof(prefix); i++) {
+		prefix = (prefix << 8) | (i < key.size() ? static_cast<unsigned char>(key[i]) : 0u);
+	}
+	return prefix;
+}
+
+/**
+ * @brief Sorts each chunk of the entries on its own thread, then merges neighbouring chunks pairwise until one run is left.
+ * The merges of each round also run in parallel.
+*/
+template <typename Less>
+static void parallelMergeSort(std::vector<SortEntry> &entries, const Less &isLess) {
+	std::vector<std::size_t> boundaries = chunkBoundaries(entries.size());
+	std::size_t chunkCount = boundaries.size() - 1;
+
+	forEachChunk(entries.size(), [&entries, &isLess](std::size_t begin, std::size_t end, std::size_t) {
+		std::sort(entries.begin() + begin, entries.begin() + end, isLess);
+	});
+
+	std::vector<SortEntry> buffer(entries.size());
+	for (std::size_t width = 1; width < chunkCount; width *= 2) {
+		std::vector<std::future<void>> merges{};
+
+		for (std::size_t left = 0; left < chunkCount; left += 2 * width) {
+			std::size_t middle = std::min(left + width, chunkCount);
+			std::size_t right = std::min(left + 2 * width, chunkCount);
+			merges.push_back(std::async(std::launch::async, [&, left, middle, right]() {
+				std::merge(entries.begin() + boundaries[left], entries.begin() + boundaries[middle],
+					entries.begin() + boundaries[middle], entries.begin() + boundaries[right],
+					buffer.begin() + boundaries[left], isLess);
+			}));
+		}
+		for (std::future<void> &merge : merges) {
+			merge.get();
+		}
+		entries.swap(buffer);
+	}
+}
+
+/**
+ * @brief Sorts every row by comparing normalized keys. Chunks are sorted on separate threads and then merged pairwise, also in parallel.
+ * @param recordList the records, where row i is recordList[i]
+ * @param sortKeys the columns to sort by, most significant first
+ * @param isStable true to keep rows with equal keys in their original order
+ * @return the rows in sorted order
+*/
+std::vector<RecordSorter::RowId> RecordSorter::comparisonSort(const std::vector<RecordDTO> &recordList, const std::vector<SortKey> &sortKeys, bool isStable) {
+	std::vector<std::string> keys(recordList.size());
+	std::vector<SortEntry> entries(recordList.size());
+
+	forEachChunk(recordList.size(), [&](std::size_t begin, std::size_t end, std::size_t) {
+		for (std::size_t row = begin; row < end; row++) {
+			keys[row] = normalizedKey(recordList[row], sortKeys);
+			entries[row] = SortEntry{ keyPrefix(keys[row]), static_cast<RowId>(row) };
+		}
+	});
+
+	// Rows start in row order, so breaking ties by row makes the result exactly what a stable sort would give
+	parallelMergeSort(entries, [&keys, isStable](const SortEntry &first, const SortEntry &second) {
+		if (first.prefix != second.prefix) return first.prefix < second.prefix;
+		int comparison = keys[first.row].compare(keys[second.row]);
+		if (comparison != 0) return comparison < 0;
+		return isStable && first.row < second.row;
+	});
+
+	std::vector<RowId> sortedRows(entries.size());
+	for (std::size_t i = 0; i < entries.size(); i++) {
+		sortedRows[i] = entries[i].row;
+	}
+	return sortedRows;
+}
+
+/** @brief A row and its packed key, as moved by the radix sort */
+struct RadixEntry {
+	std::uint64_t key;
+	RecordSorter::RowId row;
+};
+
+/** @brief The largest integer a double holds exactly. Larger integers could tie in the comparison sort but not in the radix sort. */
+static constexpr long long MAX_EXACT_INTEGER = 1LL << 53;
+
+/**
+ * @brief Reads a REF_DATE in the data set's YYYY-MM form as YYYYMM. For dates of that form, the number orders as the text does.
+ * @return true if the value has that form
+*/
+static bool readYearMonth(std::string_view value, long long &yearMonth) {
+	if (value.size() != 7 || value[4] != '-') return false;
+	yearMonth = 0;
+	for (std::size_t i = 0; i < value.size(); i++) {
+		if (i == 4) continue;
+		if (value[i] < '0' || value[i] > '9') return false;
+		yearMonth = yearMonth * 10 + (value[i] - '0');
+	}
+	return true;
+}
+
+/**
+ * @brief Reads a whole number that a double holds exactly, so the radix sort orders it as the comparison sort does
+ * @return true if the whole value is such a number
+*/
+static bool readInteger(std::string_view value, long long &integer) {
+	std::from_chars_result result = std::from_chars(value.data(), value.data() + value.size(), integer);
+	return result.ec == std::errc{} && result.ptr == value.data() + value.size() && integer <= MAX_EXACT_INTEGER && integer >= -MAX_EXACT_INTEGER;
+}
+
+/**
+ * @brief Reads a column as small unsigned integers that order as the comparison sort orders the column. Dictionary columns use
+ * each code's rank among the dictionary's values; REF_DATE and numeric columns use their value's offset from the smallest
+ * value. Empty values read as 0 and sort first, as they do in the comparison sort.
+ * @param recordList the records
+ * @param column the column to read
+ * @param fields receives one integer per row
+ * @return the largest integer, or no value if the column holds values that cannot be read this way
+*/
+static std::optional<std::uint64_t> readFixedWidthColumn(const std::vector<RecordDTO> &recordList, RecordColumn column, std::vector<std::uint64_t> &fields) {
+	const ColumnInfo &info = columnInfo(column);
+	fields.resize(recordList.size());
+
+	if (info.storage == ColumnStorage::Dictionary) {
+		// Codes are handed out in order of first appearance, so they are ranked by value once; the dictionary holds a few dozen values
+		const StringDictionary &dictionary = RecordDTO::dictionary(column);
+		std::vector<std::uint32_t> codes(dictionary.size());
+		std::iota(codes.begin(), codes.end(), std::uint32_t{ 0 });
+		std::sort(codes.begin(), codes.end(), [&dictionary](std::uint32_t first, std::uint32_t second) {
+			return dictionary.lookup(first) < dictionary.lookup(second);
+		});
+		std::vector<std::uint64_t> ranks(codes.size());
+		for (std::size_t rank = 0; rank < codes.size(); rank++) {
+			ranks[codes[rank]] = rank;
+		}
+
+		forEachChunk(recordList.size(), [&](std::size_t begin, std::size_t end, std::size_t) {
+			for (std::size_t row = begin; row < end; row++) {
+				fields[row] = ranks[recordList[row].code(column)];
+			}
+		});
+		return codes.empty() ? 0 : codes.size() - 1;
+	}
+
+	if (column != RecordColumn::RefDate && !info.isNumeric) {
+		return std::nullopt;
+	}
+
+	std::size_t chunkCount = parallelChunkCount(recordList.size());
+	std::vector<long long> chunkMinimums(chunkCount, std::numeric_limits<long long>::max());
+	std::vector<long long> chunkMaximums(chunkCount, std::numeric_limits<long long>::min());
+	std::vector<char> isChunkReadable(chunkCount, true);
+	std::vector<long long> numbers(recordList.size());
+
+	forEachChunk(recordList.size(), [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+		for (std::size_t row = begin; row < end; row++) {
+			std::string_view value = recordList[row].get(column);
+			if (value.empty()) {
+				numbers[row] = std::numeric_limits<long long>::min();
+				continue;
+			}
+			bool isReadable = column == RecordColumn::RefDate ? readYearMonth(value, numbers[row]) : readInteger(value, numbers[row]);
+			if (!isReadable) {
+				isChunkReadable[chunk] = false;
+				return;
+			}
+			chunkMinimums[chunk] = std::min(chunkMinimums[chunk], numbers[row]);
+			chunkMaximums[chunk] = std::max(chunkMaximums[chunk], numbers[row]);
+		}
+	});
+
+	if (std::find(isChunkReadable.begin(), isChunkReadable.end(), false) != isChunkReadable.end()) {
+		return std::nullopt;
+	}
+	long long minimum = *std::min_element(chunkMinimums.begin(), chunkMinimums.end());
+	long long maximum = *std::max_element(chunkMaximums.begin(), chunkMaximums.end());
+	if (minimum > maximum) {
+		std::fill(fields.begin(), fields.end(), 0);
+		return 0;
+	}
+
+	forEachChunk(recordList.size(), [&](std::size_t begin, std::size_t end, std::size_t) {
+		for (std::size_t row = begin; row < end; row++) {
+			fields[row] = numbers[row] == std::numeric_limits<long long>::min() ? 0 : static_cast<std::uint64_t>(numbers[row] - minimum) + 1;
+		}
+	});
+	return static_cast<std::uint64_t>(maximum - minimum) + 1;
+}
+
+/** @return the number of bits needed to store every integer from 0 to maxValue */
+static int bitWidth(std::uint64_t maxValue) {
+	int width{ 0 };
+	while (width < 64 && (maxValue >> width) != 0) {
+		width++;
+	}
+	return width;
+}
+
+/**
+ * @brief Sorts rows by packed keys with one pass per byte, least significant byte first. In each pass every chunk counts its
+ * digits on its own thread, the counts give each (digit, chunk) pair its own output range, and every chunk then scatters its rows
+ * into its ranges in parallel. Ranges are laid out in chunk order within each digit, so every pass is stable.
+ * @param packedKeys one key per row
+ * @param keyBits the number of low bits the keys use
+ * @return the rows in key order, ties in row order
+*/
+static std::vector<RecordSorter::RowId> radixSortPackedKeys(const std::vector<std::uint64_t> &packedKeys, int keyBits) {
+	constexpr std::size_t RADIX = 256;
+	std::size_t rowCount = packedKeys.size();
+	std::vector<RadixEntry> entries(rowCount);
+	std::vector<RadixEntry> buffer(rowCount);
+	std::vector<std::array<std::size_t, RADIX>> digitPositions(parallelChunkCount(rowCount));
+
+	forEachChunk(rowCount, [&](std::size_t begin, std::size_t end, std::size_t) {
+		for (std::size_t row = begin; row < end; row++) {
+			entries[row] = RadixEntry{ packedKeys[row], static_cast<RecordSorter::RowId>(row) };
+		}
+	});
+
+	for (int shift = 0; shift < keyBits; shift += 8) {
+		forEachChunk(rowCount, [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+			std::array<std::size_t, RADIX> &counts = digitPositions[chunk];
+			counts.fill(0);
+			for (std::size_t i = begin; i < end; i++) {
+				counts[(entries[i].key >> shift) & 0xFF]++;
+			}
+		});
+
+		// Turn the counts into each chunk's first output position for each digit
+		std::size_t position{ 0 };
+		bool isSingleDigit{ false };
+		for (std::size_t digit = 0; digit < RADIX; digit++) {
+			std::size_t digitStart = position;
+			for (std::array<std::size_t, RADIX> &positions : digitPositions) {
+				std::size_t count = positions[digit];
+				positions[digit] = position;
+				position += count;
+			}
+			isSingleDigit = isSingleDigit || (position - digitStart == rowCount);
+		}
+		// A byte every key shares would leave the order as it is
+		if (isSingleDigit) continue;
+
+		forEachChunk(rowCount, [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+			std::array<std::size_t, RADIX> &positions = digitPositions[chunk];
+			for (std::size_t i = begin; i < end; i++) {
+				buffer[positions[(entries[i].key >> shift) & 0xFF]++] = entries[i];
+			}
+		});
+		entries.swap(buffer);
+	}
+
+	std::vector<RecordSorter::RowId> sortedRows(rowCount);
+	for (std::size_t i = 0; i < rowCount; i++) {
+		sortedRows[i] = entries[i].row;
+	}
+	return sortedRows;
+}
+
+/**
+ * @brief Sorts by radix when every sort key is a fixed-width integer: a dictionary column, a YYYY-MM REF_DATE, or a numeric
+ * column of whole numbers. The keys are packed into one 64-bit integer per row, most significant key in the high bits.
+ * @param recordList the records, where row i is recordList[i]
+ * @param sortKeys the columns to sort by, most significant first
+ * @return the rows in sorted order, ties in row order, or no value if the keys do not fit in 64 bits
+*/
+std::optional<std::vector<RecordSorter::RowId>> RecordSorter::radixSort(const std::vector<RecordDTO> &recordList, const std::vector<SortKey> &sortKeys) {
+	std::vector<std::uint64_t> packedKeys(recordList.size(), 0);
+	std::vector<std::uint64_t> fields{};
+	int keyBits{ 0 };
+
+	for (const SortKey &sortKey : sortKeys) {
+		std::optional<std::uint64_t> maxField = readFixedWidthColumn(recordList, sortKey.column, fields);
+		if (!maxField) {
+			return std::nullopt;
+		}
+		int width = bitWidth(*maxField);
+		keyBits += width;
+		if (keyBits > 64) {
+			return std::nullopt;
+		}
+
+		forEachChunk(recordList.size(), [&](std::size_t begin, std::size_t end, std::size_t) {
+			for (std::size_t row = begin; row < end; row++) {
+				std::uint64_t field = sortKey.isDescending ? *maxField - fields[row] : fields[row];
+				packedKeys[row] = (width == 64 ? 0 : packedKeys[row] << width) | field;
+			}
+		});
+	}
+	return radixSortPackedKeys(packedKeys, keyBits);
+}
+
+/**
+ * @brief Sorts every row of the list, by radix when every key is fixed-width and by comparing normalized keys otherwise
+ * @param recordList the records, where row i is recordList[i]
+ * @param sortKeys the columns to sort by, most significant first
+ * @param isStable true to keep rows with equal keys in their original order
+ * @return the rows in sorted order
+*/
+std::vector<RecordSorter::RowId> RecordSorter::sort(const std::vector<RecordDTO> &recordList, const std::vector<SortKey> &sortKeys, bool isStable) {
+	// The radix sort is stable, so it answers both kinds of request
+	if (std::optional<std::vector<RowId>> sortedRows = radixSort(recordList, sortKeys)) {
+		return std::move(*sortedRows);
+	}
+	return comparisonSort(recordList, sortKeys, isStable);
+}
+
+/** @brief A row kept by topK, with its encoded key */
+struct TopEntry {
+	std::string key;
+	RecordSorter::RowId row;
+};
+
+/**
+ * @brief Finds the first rows of the sort order among rowCount rows without sorting the rest. Each chunk keeps its best count
+ * rows in a bounded max-heap on its own thread, then the chunks' survivors are merged and only they are sorted.
+ * @param recordList the records
+ * @param rowCount the number of rows to consider
+ * @param rowAt maps a position in [0, rowCount) to its row in recordList. Rows must ascend with position.
+ * @param sortKeys the columns to sort by, most significant first
+ * @param count the number of rows wanted
+ * @param isStable true to break ties by row, exactly as sort() does
+ * @return at most count rows, in sorted order
+*/
+template <typename RowAt>
+static std::vector<RecordSorter::RowId> selectTopRows(const std::vector<RecordDTO> &recordList, std::size_t rowCount, RowAt rowAt,
+	const std::vector<SortKey> &sortKeys, std::size_t count, bool isStable) {
+	using RowId = RecordSorter::RowId;
+	std::vector<RowId> topRows{};
+	if (count == 0 || rowCount == 0) {
+		return topRows;
+	}
+
+	auto isBefore = [isStable](const TopEntry &first, const TopEntry &second) {
+		int comparison = first.key.compare(second.key);
+		if (comparison != 0) return comparison < 0;
+		return isStable && first.row < second.row;
+	};
+
+	std::vector<std::vector<TopEntry>> chunkHeaps(parallelChunkCount(rowCount));
+	forEachChunk(rowCount, [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+		std::vector<TopEntry> &heap = chunkHeaps[chunk];
+		heap.reserve(std::min(count, end - begin));
+		TopEntry candidate{};
+
+		for (std::size_t position = begin; position < end; position++) {
+			RowId row = rowAt(position);
+			candidate.key.clear();
+			appendNormalizedKey(candidate.key, recordList[row], sortKeys);
+			candidate.row = row;
+
+			// The heap's front is the worst row kept so far, so a row only gets in by beating it
+			if (heap.size() < count) {
+				heap.push_back(std::move(candidate));
+				std::push_heap(heap.begin(), heap.end(), isBefore);
+			}
+			else if (isBefore(candidate, heap.front())) {
+				std::pop_heap(heap.begin(), heap.end(), isBefore);
+				std::swap(heap.back(), candidate);
+				std::push_heap(heap.begin(), heap.end(), isBefore);
+			}
+		}
+	});
+
+	std::vector<TopEntry> survivors{};
+	for (std::vector<TopEntry> &heap : chunkHeaps) {
+		std::move(heap.begin(), heap.end(), std::back_inserter(survivors));
+	}
+	std::size_t keptCount = std::min(count, survivors.size());
+	std::partial_sort(survivors.begin(), survivors.begin() + keptCount, survivors.end(), isBefore);
+
+	topRows.reserve(keptCount);
+	for (std::size_t i = 0; i < keptCount; i++) {
+		topRows.push_back(survivors[i].row);
+	}
+	return topRows;
+}
+
+/**
+ * @brief Returns the first rows of the sort order without sorting the rest
+ * @param recordList the records, where row i is recordList[i]
+ * @param sortKeys the columns to sort by, most significant first
+ * @param count the number of rows wanted
+ * @param isStable true to break ties by row, exactly as sort() does
+ * @return at most count rows, in sorted order
+*/
+std::vector<RecordSorter::RowId> RecordSorter::topK(const std::vector<RecordDTO> &recordList, const std::vector<SortKey> &sortKeys, std::size_t count, bool isStable) {
+	return selectTopRows(recordList, recordList.size(), [](std::size_t position) { return static_cast<RowId>(position); }, sortKeys, count, isStable);
+}
+
+/**
+ * @brief Returns the first of the selected rows in the sort order without sorting the rest
+ * @param recordList the records, where row i is recordList[i]
+ * @param rows the rows to choose from, in ascending order, such as the rows a RecordFilter matched
+ * @param sortKeys the columns to sort by, most significant first
+ * @param count the number of rows wanted
+ * @param isStable true to break ties by row, exactly as sort() does
+ * @return at most count of the selected rows, in sorted order
+*/
+std::vector<RecordSorter::RowId> RecordSorter::topK(const std::vector<RecordDTO> &recordList, const std::vector<RowId> &rows, const std::vector<SortKey> &sortKeys, std::size_t count, bool isStable) {
+	return selectTopRows(recordList, rows.size(), [&rows](std::size_t position) { return rows[position]; }, sortKeys, count, isStable);
+}
+
+TEST_CASE("Test that normalized keys order numbers by value and honour each key's direction") {
+	RecordDTO nine{}, ten{}, empty{}, negative{};
+	nine.setValue("9");
+	ten.setValue("10");
+	negative.setValue("-2.5");
+
+	std::vector<SortKey> byValue{ { RecordColumn::Value, false } };
+	CHECK(RecordSorter::normalizedKey(empty, byValue) < RecordSorter::normalizedKey(negative, byValue));
+	CHECK(RecordSorter::normalizedKey(negative, byValue) < RecordSorter::normalizedKey(nine, byValue));
+	CHECK(RecordSorter::normalizedKey(nine, byValue) < RecordSorter::normalizedKey(ten, byValue));
+
+	/* A text value sorts before the longer values it is a prefix of, and descending keys reverse that */
+	RecordDTO brit{}, british{};
+	brit.setGeo("Brit");
+	british.setGeo("British Columbia");
+	CHECK(RecordSorter::normalizedKey(brit, { { RecordColumn::Geo, false } }) < RecordSorter::normalizedKey(british, { { RecordColumn::Geo, false } }));
+	CHECK(RecordSorter::normalizedKey(british, { { RecordColumn::Geo, true } }) < RecordSorter::normalizedKey(brit, { { RecordColumn::Geo, true } }));
+}
+
+TEST_CASE("Test that a multi-key parallel sort matches a stable comparison sort") {
+	const char *products[] = { "Potatoes", "Onions", "Carrots", "Cabbage", "Beets" };
+	std::mt19937 random{ 33 };
+	std::vector<RecordDTO> recordList(50000);
+	for (RecordDTO &record : recordList) {
+		record.setProductType(products[random() % 5]);
+		record.setValue(std::to_string(random() % 2000));
+		record.setRefDate("19" + std::to_string(70 + random() % 30));
+	}
+
+	/* Product ascending, then value descending; ties keep row order */
+	std::vector<SortKey> sortKeys{ { RecordColumn::ProductType, false }, { RecordColumn::Value, true } };
+	std::vector<RecordSorter::RowId> sortedRows = RecordSorter::sort(recordList, sortKeys);
+
+	std::vector<RecordSorter::RowId> expected(recordList.size());
+	std::iota(expected.begin(), expected.end(), RecordSorter::RowId{ 0 });
+	std::stable_sort(expected.begin(), expected.end(), [&recordList](RecordSorter::RowId first, RecordSorter::RowId second) {
+		if (recordList[first].getProductType() != recordList[second].getProductType()) {
+			return recordList[first].getProductType() < recordList[second].getProductType();
+		}
+		return std::stoi(std::string{ recordList[first].getValue() }) > std::stoi(std::string{ recordList[second].getValue() });
+	});
+
+	CHECK(sortedRows == expected);
+
+	/* The top rows are the first rows of the full sort, including how ties are broken */
+	std::vector<RecordSorter::RowId> topRows = RecordSorter::topK(recordList, sortKeys, 250);
+	CHECK(topRows == std::vector<RecordSorter::RowId>(expected.begin(), expected.begin() + 250));
+	CHECK(RecordSorter::topK(recordList, sortKeys, recordList.size() + 10) == expected);
+}
+
+TEST_CASE("Test that the radix sort is chosen for fixed-width keys and matches the comparison sort") {
+	const char *provinces[] = { "Quebec", "Ontario", "Manitoba", "Alberta", "Nova Scotia", "Canada" };
+	std::mt19937 random{ 34 };
+	std::vector<RecordDTO> recordList(40000);
+	for (RecordDTO &record : recordList) {
+		record.setGeo(provinces[random() % 6]);
+		record.setRefDate("19" + std::to_string(70 + random() % 30) + "-0" + std::to_string(1 + random() % 9));
+		if (random() % 10 != 0) record.setValue(std::to_string(static_cast<int>(random() % 60000) - 100));
+	}
+
+	std::vector<SortKey> sortKeys{ { RecordColumn::Geo, true }, { RecordColumn::RefDate, false }, { RecordColumn::Value, true } };
+	std::optional<std::vector<RecordSorter::RowId>> radixRows = RecordSorter::radixSort(recordList, sortKeys);
+
+	REQUIRE(radixRows.has_value());
+	CHECK(*radixRows == RecordSorter::comparisonSort(recordList, sortKeys, true));
+
+	/* Free text has no fixed width, so it is left to the comparison sort */
+	CHECK_FALSE(RecordSorter::radixSort(recordList, { { RecordColumn::Vector, false } }).has_value());
+}
@@ -0,0 +1,111 @@
+/**
+* @file				RecordSorter.h
+* @author			Chloe Lee-Hone<leeh0002@algonquinlive.com>
+* @version			1.0
+* @section			Header file for the RecordSorter class, which sorts records by any list of columns and directions.
+*					This project contains information licensed under the Open Government Licence  Canada [1][2]. Code structure was informed by the provided example written by Stanley Pieda for CST8333 [3].
+*
+* Student Name:     Chloe Lee-Hone
+* Student Number:   041023578
+* Course:           CST8333_350: Programming Language Research Project
+* Professor:        Reg Dyer
+* Date:             05/06/2023
+*
+* References:
+* [1]   T. B. of C. Secretariat and T. B. S. of C. Open Government, Open Government Licence - Canada. http://open.canada.ca/en/open-government-licence-canada (accessed May 11, 2023).
+* [2]	T. B. of C. Secretariat and Open Government Portal, Vegetables in cold and common storage, Oct. 10, 2008. https://open.canada.ca/data/en/dataset/473f9524-45f8-47d0-9a12-537bb7704089 (accessed May 16, 2023).
+* [3]	S. Pieda, CST8333 19F Practical Project 2 Example Layered. Algonquin College, Algonquin College, Jun. 07, 2022. [Online]. Available: https://brightspace.algonquincollege.com/d2l/le/content/543581/viewContent/8322468/View
+*/
+
+#pragma once
+#include <optional>
+#include <string>
+#include <vector>
+#include "RecordColumn.h"
+#include "RecordDTO.h"
+#include "RecordIndex.h"
+#include "doctest.h"
+
+#ifndef RECORD_SORTER_H
+#define RECORD_SORTER_H
+
+/**
+ * @brief One column of a sort specification
+*/
+struct SortKey {
+	/** @brief the column to sort by */
+	RecordColumn column;
+	/** @brief true to put the largest values first */
+	bool isDescending{ false };
+};
+
+/**
+ * @brief Sorts rows by a list of (column, direction) keys. Each row's keys are encoded once into a normalized binary string
+ * whose byte order is the requested order, so the sort itself only compares bytes. The rows are sorted as a permutation:
+ * the records never move.
+*/
+class RecordSorter
+{
+public:
+	using RowId = RecordIndex::RowId;
+
+	/**
+	 * @brief Sorts every row of the list. Uses radixSort() when every key is fixed-width and comparisonSort() otherwise.
+	 * @param recordList the records, where row i is recordList[i]
+	 * @param sortKeys the columns to sort by, most significant first
+	 * @param isStable true to keep rows with equal keys in their original order
+	 * @return the rows in sorted order
+	*/
+	static std::vector<RowId> sort(const std::vector<RecordDTO> &recordList, const std::vector<SortKey> &sortKeys, bool isStable = true);
+
+	/**
+	 * @brief Sorts by packing every key into one 64-bit integer per row and sorting the integers a byte at a time, in parallel.
+	 * Works when every key is a dictionary column, a YYYY-MM REF_DATE, or a numeric column of whole numbers, and the keys fit in 64 bits.
+	 * @param recordList the records, where row i is recordList[i]
+	 * @param sortKeys the columns to sort by, most significant first
+	 * @return the rows in sorted order with ties in row order, or no value if the keys cannot be packed
+	*/
+	static std::optional<std::vector<RowId>> radixSort(const std::vector<RecordDTO> &recordList, const std::vector<SortKey> &sortKeys);
+
+	/**
+	 * @brief Sorts by comparing normalized keys. Chunks are sorted on separate threads and then merged pairwise, also in parallel.
+	 * @param recordList the records, where row i is recordList[i]
+	 * @param sortKeys the columns to sort by, most significant first
+	 * @param isStable true to keep rows with equal keys in their original order
+	 * @return the rows in sorted order
+	*/
+	static std::vector<RowId> comparisonSort(const std::vector<RecordDTO> &recordList, const std::vector<SortKey> &sortKeys, bool isStable = true);
+
+	/**
+	 * @brief Returns the first rows of the sort order in O(n log count), without sorting or copying the rest.
+	 * Each thread keeps its best rows in a bounded heap, and the heaps are merged at the end.
+	 * @param recordList the records, where row i is recordList[i]
+	 * @param sortKeys the columns to sort by, most significant first
+	 * @param count the number of rows wanted
+	 * @param isStable true to break ties by row, exactly as sort() does
+	 * @return at most count rows, in sorted order
+	*/
+	static std::vector<RowId> topK(const std::vector<RecordDTO> &recordList, const std::vector<SortKey> &sortKeys, std::size_t count, bool isStable = true);
+
+	/**
+	 * @brief Returns the first of the selected rows in the sort order, in O(rows log count), without sorting or copying the rest
+	 * @param recordList the records, where row i is recordList[i]
+	 * @param rows the rows to choose from, in ascending order, such as the rows a RecordFilter matched
+	 * @param sortKeys the columns to sort by, most significant first
+	 * @param count the number of rows wanted
+	 * @param isStable true to break ties by row, exactly as sort() does
+	 * @return at most count of the selected rows, in sorted order
+	*/
+	static std::vector<RowId> topK(const std::vector<RecordDTO> &recordList, const std::vector<RowId> &rows, const std::vector<SortKey> &sortKeys, std::size_t count, bool isStable = true);
+
+	/**
+	 * @brief Encodes a record's sort keys so that comparing two encodings byte by byte, as unsigned bytes, orders the records
+	 * the way sortKeys asks. Numeric columns are encoded by value, so "9" sorts before "10"; empty or non-numeric values
+	 * sort before every number.
+	 * @param record the record to encode
+	 * @param sortKeys the columns to sort by, most significant first
+	 * @return the encoded key
+	*/
+	static std::string normalizedKey(const RecordDTO &record, const std::vector<SortKey> &sortKeys);
+};
+#endif // !RECORD_SORTER_H
@@ -0,0 +1,105 @@
+/**
+* @file				RecordTransaction.cpp
+* @author			Chloe Lee-Hone<leeh0002@algonquinlive.com>
+* @version			1.0
+* @section			This file contains the RecordTransaction class, which stages inserts, updates and deletes for RecordService to apply together.
+*					This project contains information licensed under the Open Government Licence  Canada [1][2]. Code structure was informed by the provided example written by Stanley Pieda for CST8333 [3].
+*
+* Student Name:     Chloe Lee-Hone
+* Student Number:   041023578
+* Course:           CST8333_350: Programming Language Research Project
+* Professor:        Reg Dyer
+* Date:             05/06/2023
+*
+* References:
+* [1]   T. B. of C. Secretariat and T. B. S. of C. Open Government, Open Government Licence - Canada. http://open.canada.ca/en/open-government-licence-canada (accessed May 11, 2023).
+* [2]	T. B. of C. Secretariat and Open Government Portal, Vegetables in cold and common storage, Oct. 10, 2008. https://open.canada.ca/data/en/dataset/473f9524-45f8-47d0-9a12-537bb7704089 (accessed May 16, 2023).
+* [3]	S. Pieda, CST8333 19F Practical Project 2 Example Layered. Algonquin College, Algonquin College, Jun. 07, 2022. [Online]. Available: https://brightspace.algonquincollege.com/d2l/le/content/543581/viewContent/8322468/View
+*/
+
+#include "RecordTransaction.h"
+#include <utility>
+#include "doctest.h"
+
+/**
+ * @brief Stages a new record. Its id is returned by the commit.
+ * @param newRecord the record
+*/
+void RecordTransaction::insertRecord(RecordDTO newRecord) {
+	RecordTransaction::operations.push_back(Operation{ OperationKind::Insert, RecordColumn::RefDate, 0, {}, RecordTransaction::insertedRecords.size() });
+	RecordTransaction::insertedRecords.push_back(std::move(newRecord));
+}
+
+/**
+ * @brief Stages a change to one column of a record
+ * @param recordId the record's id
+ * @param column the column to change
+ * @param newValue the column's new value
+*/
+void RecordTransaction::updateRecord(RecordId recordId, RecordColumn column, std::string newValue) {
+	RecordTransaction::operations.push_back(Operation{ OperationKind::Update, column, recordId, std::move(newValue), 0 });
+}
+
+/**
+ * @brief Stages a record's deletion
+ * @param recordId the record's id
+*/
+void RecordTransaction::deleteRecord(RecordId recordId) {
+	RecordTransaction::operations.push_back(Operation{ OperationKind::Delete, RecordColumn::RefDate, recordId, {}, 0 });
+}
+
+/**
+ * @brief Discards every staged operation
+*/
+void RecordTransaction::clear() {
+	RecordTransaction::operations.clear();
+	RecordTransaction::insertedRecords.clear();
+}
+
+/**
+ * @brief Makes room for a number of operations, so staging a large batch does not reallocate
+ * @param operationCount the number of operations to make room for
+*/
+void RecordTransaction::reserve(std::size_t operationCount) {
+	RecordTransaction::operations.reserve(operationCount);
+}
+
+/**
+ * @brief Moves the staged new records out, so a commit can store them without copying. The operations are left staged.
+ * @return the staged new records, in the order they were staged
+*/
+std::vector<RecordDTO> RecordTransaction::takeInsertedRecords() {
+	return std::move(RecordTransaction::insertedRecords);
+}
+
+/**
+ * @brief Moves the staged operations out, so a commit can move each update's value into its record without copying it.
+ * The transaction is left with no operations.
+ * @return the staged operations, in the order they were staged
+*/
+std::vector<RecordTransaction::Operation> RecordTransaction::takeOperations() {
+	std::vector<Operation> takenOperations = std::move(RecordTransaction::operations);
+	RecordTransaction::operations.clear();
+	return takenOperations;
+}
+
+TEST_CASE("Test that a transaction stages operations in order") {
+	RecordTransaction transaction{};
+	transaction.updateRecord(4, RecordColumn::Value, "12");
+	transaction.insertRecord(RecordDTO("2024-01", "Quebec", "", "Carrots", "", "", "", "", "", "v1", "", "5", "", "", "", ""));
+	transaction.deleteRecord(9);
+
+	REQUIRE(transaction.size() == 3);
+	CHECK(transaction.getOperations()[0].value == "12");
+	CHECK(transaction.getOperations()[1].kind == RecordTransaction::OperationKind::Insert);
+	CHECK(transaction.getInsertedRecords()[transaction.getOperations()[1].recordIndex].getGeo() == "Quebec");
+	CHECK(transaction.getOperations()[2].recordId == 9);
+
+	std::vector<RecordTransaction::Operation> operations = transaction.takeOperations();
+	CHECK(operations.size() == 3);
+	CHECK(operations[0].value == "12");
+	CHECK(transaction.getOperations().empty());
+
+	transaction.clear();
+	CHECK(transaction.empty());
+}
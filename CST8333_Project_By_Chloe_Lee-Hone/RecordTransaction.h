@@ -0,0 +1,116 @@
+/**
+* @file				RecordTransaction.h
+* @author			Chloe Lee-Hone<leeh0002@algonquinlive.com>
+* @version			1.0
+* @section			Header file for the RecordTransaction class, which stages inserts, updates and deletes for RecordService to apply together.
+*					This project contains information licensed under the Open Government Licence  Canada [1][2]. Code structure was informed by the provided example written by Stanley Pieda for CST8333 [3].
+*
+* Student Name:     Chloe Lee-Hone
+* Student Number:   041023578
+* Course:           CST8333_350: Programming Language Research Project
+* Professor:        Reg Dyer
+* Date:             05/06/2023
+*
+* References:
+* [1]   T. B. of C. Secretariat and T. B. S. of C. Open Government, Open Government Licence - Canada. http://open.canada.ca/en/open-government-licence-canada (accessed May 11, 2023).
+* [2]	T. B. of C. Secretariat and Open Government Portal, Vegetables in cold and common storage, Oct. 10, 2008. https://open.canada.ca/data/en/dataset/473f9524-45f8-47d0-9a12-537bb7704089 (accessed May 16, 2023).
+* [3]	S. Pieda, CST8333 19F Practical Project 2 Example Layered. Algonquin College, Algonquin College, Jun. 07, 2022. [Online]. Available: https://brightspace.algonquincollege.com/d2l/le/content/543581/viewContent/8322468/View
+*/
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "RecordColumn.h"
+#include "RecordDTO.h"
+#include "doctest.h"
+
+#ifndef RECORD_TRANSACTION_H
+#define RECORD_TRANSACTION_H
+
+/**
+ * @brief A list of inserts, updates and deletes staged for RecordService::commitTransaction(). Staging changes nothing; the
+ * commit applies every operation in order, or none of them if any operation names a record that does not exist.
+*/
+class RecordTransaction
+{
+public:
+	/** @brief The same id as RecordService::RecordId */
+	using RecordId = std::uint64_t;
+
+	/** @brief The kind of change an operation makes */
+	enum class OperationKind : std::uint8_t { Insert, Update, Delete };
+
+	/** @brief One staged change */
+	struct Operation {
+		OperationKind kind;
+		/** @brief the column an Update changes */
+		RecordColumn column;
+		/** @brief the record an Update or Delete changes */
+		RecordId recordId;
+		/** @brief an Update's new value */
+		std::string value;
+		/** @brief an Insert's position in getInsertedRecords() */
+		std::size_t recordIndex;
+	};
+
+	/**
+	 * @brief Stages a new record. Its id is returned by the commit.
+	 * @param newRecord the record
+	*/
+	void insertRecord(RecordDTO newRecord);
+
+	/**
+	 * @brief Stages a change to one column of a record
+	 * @param recordId the record's id
+	 * @param column the column to change
+	 * @param newValue the column's new value
+	*/
+	void updateRecord(RecordId recordId, RecordColumn column, std::string newValue);
+
+	/**
+	 * @brief Stages a record's deletion
+	 * @param recordId the record's id
+	*/
+	void deleteRecord(RecordId recordId);
+
+	/** @return the staged operations, in the order they were staged */
+	const std::vector<Operation> &getOperations() const { return operations; }
+
+	/** @return the staged new records, in the order they were staged */
+	const std::vector<RecordDTO> &getInsertedRecords() const { return insertedRecords; }
+
+	/** @return the number of staged operations */
+	std::size_t size() const { return operations.size(); }
+
+	/** @return true if nothing is staged */
+	bool empty() const { return operations.empty(); }
+
+	/** @brief Discards every staged operation */
+	void clear();
+
+	/**
+	 * @brief Makes room for a number of operations, so staging a large batch does not reallocate
+	 * @param operationCount the number of operations to make room for
+	*/
+	void reserve(std::size_t operationCount);
+
+	/**
+	 * @brief Moves the staged new records out, so a commit can store them without copying. The operations are left staged.
+	 * @return the staged new records, in the order they were staged
+	*/
+	std::vector<RecordDTO> takeInsertedRecords();
+
+	/**
+	 * @brief Moves the staged operations out, so a commit can move each update's value into its record without copying it.
+	 * The transaction is left with no operations.
+	 * @return the staged operations, in the order they were staged
+	*/
+	std::vector<Operation> takeOperations();
+
+private:
+	std::vector<Operation> operations{};
+	std::vector<RecordDTO> insertedRecords{};
+};
+#endif // !RECORD_TRANSACTION_H
@@ -0,0 +1,116 @@
+/**
+* @file				StringDictionary.cpp
+* @author			Chloe Lee-Hone<leeh0002@algonquinlive.com>
+* @version			1.0
+* @section			This file contains the StringDictionary class used by RecordDTO to store low-cardinality columns as integer codes.
+*					This project contains information licensed under the Open Government Licence  Canada [1][2]. Code structure was informed by the provided example written by Stanley Pieda for CST8333 [3].
+*
+* Student Name:     Chloe Lee-Hone
+* Student Number:   041023578
+* Course:           CST8333_350: Programming Language Research Project
+* Professor:        Reg Dyer
+* Date:             05/06/2023
+*
+* References:
+* [1]   T. B. of C. Secretariat and T. B. S. of C. Open Government, Open Government Licence - Canada. http://open.canada.ca/en/open-government-licence-canada (accessed May 11, 2023).
+* [2]	T. B. of C. Secretariat and Open Government Portal, Vegetables in cold and common storage, Oct. 10, 2008. https://open.canada.ca/data/en/dataset/473f9524-45f8-47d0-9a12-537bb7704089 (accessed May 16, 2023).
+* [3]	S. Pieda, CST8333 19F Practical Project 2 Example Layered. Algonquin College, Algonquin College, Jun. 07, 2022. [Online]. Available: https://brightspace.algonquincollege.com/d2l/le/content/543581/viewContent/8322468/View
+*/
+
+#include "StringDictionary.h"
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "doctest.h"
+
+/**
+ * @brief No-argument constructor. Interns the empty string so that EMPTY_CODE reads as "".
+*/
+StringDictionary::StringDictionary() {
+	intern("");
+}
+
+/**
+ * @brief Returns the value's code, adding the value to the dictionary if it is new
+ * @param value the value to look up
+ * @return the value's code
+*/
+std::uint32_t StringDictionary::intern(std::string_view value) {
+	std::lock_guard<std::mutex> lock{ mutex };
+
+	auto existing = codes.find(value);
+	if (existing != codes.end()) {
+		return existing->second;
+	}
+
+	std::uint32_t code = count.load(std::memory_order_relaxed);
+	std::size_t chunk = code / CHUNK_SIZE;
+	if (chunk >= MAX_CHUNKS) {
+		throw std::length_error("The string dictionary is full.");
+	}
+	if (!ownedChunks[chunk]) {
+		ownedChunks[chunk] = std::make_unique<std::string[]>(CHUNK_SIZE);
+		chunks[chunk].store(ownedChunks[chunk].get(), std::memory_order_release);
+	}
+
+	std::string &stored = ownedChunks[chunk][code % CHUNK_SIZE];
+	stored.assign(value);
+	codes.emplace(std::string_view{ stored }, code);
+	// Publishing the new count last means a reader that sees the code also sees the stored string
+	count.store(code + 1, std::memory_order_release);
+
+	return code;
+}
+
+/**
+ * @brief Returns the code of a value that is already in the dictionary
+ * @param value the value to look up
+ * @return the value's code, or no value if the dictionary has never seen it
+*/
+std::optional<std::uint32_t> StringDictionary::find(std::string_view value) const {
+	std::lock_guard<std::mutex> lock{ mutex };
+
+	auto existing = codes.find(value);
+	if (existing == codes.end()) {
+		return std::nullopt;
+	}
+	return existing->second;
+}
+
+TEST_CASE("Test that the dictionary hands out one stable code per distinct value") {
+	StringDictionary dictionary{};
+
+	CHECK(dictionary.lookup(StringDictionary::EMPTY_CODE) == "");
+
+	std::uint32_t canada = dictionary.intern("Canada");
+	std::uint32_t quebec = dictionary.intern("Quebec");
+
+	CHECK(canada != quebec);
+	CHECK(dictionary.intern("Canada") == canada);
+	CHECK(dictionary.lookup(quebec) == "Quebec");
+	CHECK(dictionary.find("Quebec").value() == quebec);
+	CHECK_FALSE(dictionary.find("Ontario").has_value());
+	CHECK(dictionary.size() == 3);
+}
+
+TEST_CASE("Test that the dictionary can be filled from several threads") {
+	StringDictionary dictionary{};
+	std::vector<std::thread> threads{};
+	std::atomic<int> mismatches{ 0 };
+
+	/* Every thread interns the same 3000 values, which spans several chunks. Each value must still get exactly one code. */
+	for (int t = 0; t < 4; t++) {
+		threads.emplace_back([&dictionary, &mismatches]() {
+			for (int i = 0; i < 3000; i++) {
+				std::uint32_t code = dictionary.intern(std::to_string(i));
+				if (dictionary.lookup(code) != std::to_string(i)) mismatches++;
+			}
+		});
+	}
+	for (std::thread &thread : threads) {
+		thread.join();
+	}
+
+	CHECK(mismatches == 0);
+	CHECK(dictionary.size() == 3001);
+}
@@ -0,0 +1,95 @@
+/**
+* @file				StringDictionary.h
+* @author			Chloe Lee-Hone<leeh0002@algonquinlive.com>
+* @version			1.0
+* @section			Header file for the StringDictionary class, which maps each distinct value of a low-cardinality column to a small integer code.
+*					This project contains information licensed under the Open Government Licence  Canada [1][2]. Code structure was informed by the provided example written by Stanley Pieda for CST8333 [3].
+*
+* Student Name:     Chloe Lee-Hone
+* Student Number:   041023578
+* Course:           CST8333_350: Programming Language Research Project
+* Professor:        Reg Dyer
+* Date:             05/06/2023
+*
+* References:
+* [1]   T. B. of C. Secretariat and T. B. S. of C. Open Government, Open Government Licence - Canada. http://open.canada.ca/en/open-government-licence-canada (accessed May 11, 2023).
+* [2]	T. B. of C. Secretariat and Open Government Portal, Vegetables in cold and common storage, Oct. 10, 2008. https://open.canada.ca/data/en/dataset/473f9524-45f8-47d0-9a12-537bb7704089 (accessed May 16, 2023).
+* [3]	S. Pieda, CST8333 19F Practical Project 2 Example Layered. Algonquin College, Algonquin College, Jun. 07, 2022. [Online]. Available: https://brightspace.algonquincollege.com/d2l/le/content/543581/viewContent/8322468/View
+*/
+
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include "doctest.h"
+
+#ifndef STRING_DICTIONARY_H
+#define STRING_DICTIONARY_H
+
+/**
+ * @brief An append-only dictionary of strings. RecordDTO stores a 4-byte code instead of the string for columns such as GEO,
+ * where a handful of values repeat across every row. Codes are never reused or removed, so a code and the view returned
+ * by lookup() stay valid for the life of the program. Lookups take no lock; intern() is safe to call from several threads.
+*/
+class StringDictionary
+{
+public:
+	/** @brief The code of the empty string. Every dictionary starts with it, so a default code reads as "". */
+	static constexpr std::uint32_t EMPTY_CODE = 0;
+
+	/** @brief No-argument constructor. Interns the empty string. */
+	StringDictionary();
+
+	StringDictionary(const StringDictionary &) = delete;
+	StringDictionary &operator=(const StringDictionary &) = delete;
+
+	/**
+	 * @brief Returns the value's code, adding the value to the dictionary if it is new
+	 * @param value the value to look up
+	 * @return the value's code
+	*/
+	std::uint32_t intern(std::string_view value);
+
+	/**
+	 * @brief Returns the code of a value that is already in the dictionary. Used by filters, which must not grow the dictionary.
+	 * @param value the value to look up
+	 * @return the value's code, or no value if the dictionary has never seen it
+	*/
+	std::optional<std::uint32_t> find(std::string_view value) const;
+
+	/**
+	 * @brief Returns the value a code stands for
+	 * @param code a code returned by intern()
+	 * @return a view of the value, valid for the life of the program
+	*/
+	std::string_view lookup(std::uint32_t code) const {
+		return chunks[code / CHUNK_SIZE].load(std::memory_order_acquire)[code % CHUNK_SIZE];
+	}
+
+	/** @return the number of distinct values, including the empty string */
+	std::size_t size() const { return count.load(std::memory_order_acquire); }
+
+private:
+	/** Values are stored in fixed-size chunks that never move, so views handed out by lookup() are never invalidated */
+	static constexpr std::size_t CHUNK_SIZE = 1024;
+	static constexpr std::size_t MAX_CHUNKS = 4096;
+
+	/** @brief the chunks allocated so far. Unused entries are null. */
+	std::array<std::atomic<std::string *>, MAX_CHUNKS> chunks{};
+	/** @brief owns the chunks */
+	std::array<std::unique_ptr<std::string[]>, MAX_CHUNKS> ownedChunks{};
+	/** @brief the number of codes handed out */
+	std::atomic<std::uint32_t> count{ 0 };
+	/** @brief maps each value, viewed in its chunk, to its code */
+	std::unordered_map<std::string_view, std::uint32_t> codes{};
+	/** @brief serializes intern() and guards codes */
+	mutable std::mutex mutex{};
+};
+#endif // !STRING_DICTIONARY_H
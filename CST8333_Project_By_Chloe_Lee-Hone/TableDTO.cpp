@@ -0,0 +1,99 @@
+/**
+* @file				TableDTO.cpp
+* @author			Chloe Lee-Hone<leeh0002@algonquinlive.com>
+* @version			1.0
+* @section			This file contains the TableDTO class used by the RecordDAO class to store a table from another Statistics Canada data set.
+*					This project contains information licensed under the Open Government Licence  Canada [1][2]. Code structure was informed by the provided example written by Stanley Pieda for CST8333 [3].
+*
+* Student Name:     Chloe Lee-Hone
+* Student Number:   041023578
+* Course:           CST8333_350: Programming Language Research Project
+* Professor:        Reg Dyer
+* Date:             05/06/2023
+*
+* References:
+* [1]   T. B. of C. Secretariat and T. B. S. of C. Open Government, Open Government Licence - Canada. http://open.canada.ca/en/open-government-licence-canada (accessed May 11, 2023).
+* [2]	T. B. of C. Secretariat and Open Government Portal, Vegetables in cold and common storage, Oct. 10, 2008. https://open.canada.ca/data/en/dataset/473f9524-45f8-47d0-9a12-537bb7704089 (accessed May 16, 2023).
+* [3]	S. Pieda, CST8333 19F Practical Project 2 Example Layered. Algonquin College, Algonquin College, Jun. 07, 2022. [Online]. Available: https://brightspace.algonquincollege.com/d2l/le/content/543581/viewContent/8322468/View
+*/
+
+#include "TableDTO.h"
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+/**
+ * @brief Parameterized constructor
+ * @param headers the column headers
+ * @param rows the rows, each with one cell per header
+*/
+TableDTO::TableDTO(std::vector<std::string> headers, std::vector<Row> rows) : headers{ std::move(headers) }, rows{ std::move(rows) } {}
+
+/** @return the column headers */
+const std::vector<std::string> &TableDTO::getHeaders() const {
+	return TableDTO::headers;
+}
+
+/** @return the rows */
+const std::vector<TableDTO::Row> &TableDTO::getRows() const {
+	return TableDTO::rows;
+}
+
+/** @return the number of rows, not counting the headers */
+std::size_t TableDTO::rowCount() const {
+	return TableDTO::rows.size();
+}
+
+/** @return the number of columns */
+std::size_t TableDTO::columnCount() const {
+	return TableDTO::headers.size();
+}
+
+/**
+ * @brief Finds a column by its header
+ * @param header the header to look for
+ * @return the column's position, or NO_COLUMN
+*/
+std::size_t TableDTO::findColumn(std::string_view header) const {
+	auto found = std::find(TableDTO::headers.begin(), TableDTO::headers.end(), header);
+	return found == TableDTO::headers.end() ? NO_COLUMN : static_cast<std::size_t>(found - TableDTO::headers.begin());
+}
+
+/**
+ * @brief Adds rows to the end of the table, such as a batch of join results
+ * @param rows the rows to move in
+*/
+void TableDTO::addRows(std::vector<Row> &&rows) {
+	if (TableDTO::rows.empty()) {
+		TableDTO::rows = std::move(rows);
+		return;
+	}
+	std::move(rows.begin(), rows.end(), std::back_inserter(TableDTO::rows));
+}
+
+/**
+ * @brief Lays the table out for display or export
+ * @return the headers followed by the rows
+*/
+std::vector<TableDTO::Row> TableDTO::toTable() const {
+	std::vector<Row> table{};
+	table.reserve(TableDTO::rows.size() + 1);
+	table.push_back(TableDTO::headers);
+	table.insert(table.end(), TableDTO::rows.begin(), TableDTO::rows.end());
+	return table;
+}
+
+TEST_CASE("Test that TableDTO finds its columns and appends rows") {
+	TableDTO table({ "REF_DATE", "GEO", "VALUE" }, { { "2020-01", "Canada", "1" } });
+	CHECK(table.columnCount() == 3);
+	CHECK(table.findColumn("GEO") == 1);
+	CHECK(table.findColumn("VECTOR") == TableDTO::NO_COLUMN);
+
+	table.addRows({ { "2020-02", "Ontario", "2" }, { "2020-03", "Quebec", "3" } });
+	CHECK(table.rowCount() == 3);
+	CHECK(table.getRows()[2][1] == "Quebec");
+
+	std::vector<TableDTO::Row> laidOut = table.toTable();
+	CHECK(laidOut.size() == 4);
+	CHECK(laidOut.front() == table.getHeaders());
+}
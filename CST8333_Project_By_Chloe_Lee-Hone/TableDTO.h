@@ -0,0 +1,90 @@
+/**
+* @file				TableDTO.h
+* @author			Chloe Lee-Hone<leeh0002@algonquinlive.com>
+* @version			1.0
+* @section			Header file for TableDTO class, which stores a table read from a CSV file whose columns need not match the data set's.
+*					This project contains information licensed under the Open Government Licence  Canada [1][2]. Code structure was informed by the provided example written by Stanley Pieda for CST8333 [3].
+*
+* Student Name:     Chloe Lee-Hone
+* Student Number:   041023578
+* Course:           CST8333_350: Programming Language Research Project
+* Professor:        Reg Dyer
+* Date:             05/06/2023
+*
+* References:
+* [1]   T. B. of C. Secretariat and T. B. S. of C. Open Government, Open Government Licence - Canada. http://open.canada.ca/en/open-government-licence-canada (accessed May 11, 2023).
+* [2]	T. B. of C. Secretariat and Open Government Portal, Vegetables in cold and common storage, Oct. 10, 2008. https://open.canada.ca/data/en/dataset/473f9524-45f8-47d0-9a12-537bb7704089 (accessed May 16, 2023).
+* [3]	S. Pieda, CST8333 19F Practical Project 2 Example Layered. Algonquin College, Algonquin College, Jun. 07, 2022. [Online]. Available: https://brightspace.algonquincollege.com/d2l/le/content/543581/viewContent/8322468/View
+*/
+
+#pragma once
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "doctest.h"
+
+#ifndef TABLE_DTO_H
+#define TABLE_DTO_H
+/**
+ * TableDTO class is used by the RecordDAO class to store a table from another Statistics Canada data set, such as a production
+ * or price table, so it can be joined with the records. Unlike RecordDTO, the columns are whatever the file's header row names, and
+ * every cell is kept as text.
+*/
+class TableDTO {
+// STUDENT NAME: CHLOE LEE-HONE
+public:
+	using Row = std::vector<std::string>;
+
+	/** @brief Returned by findColumn() when the table has no column with the header */
+	static constexpr std::size_t NO_COLUMN = std::numeric_limits<std::size_t>::max();
+
+	/** @brief No-argument constructor. The table has no columns and no rows. */
+	TableDTO() = default;
+
+	/**
+	 * @brief Parameterized constructor
+	 * @param headers the column headers
+	 * @param rows the rows, each with one cell per header
+	*/
+	TableDTO(std::vector<std::string> headers, std::vector<Row> rows);
+
+	/** @return the column headers */
+	const std::vector<std::string> &getHeaders() const;
+
+	/** @return the rows */
+	const std::vector<Row> &getRows() const;
+
+	/** @return the number of rows, not counting the headers */
+	std::size_t rowCount() const;
+
+	/** @return the number of columns */
+	std::size_t columnCount() const;
+
+	/**
+	 * @brief Finds a column by its header
+	 * @param header the header to look for
+	 * @return the column's position, or NO_COLUMN
+	*/
+	std::size_t findColumn(std::string_view header) const;
+
+	/**
+	 * @brief Adds rows to the end of the table, such as a batch of join results
+	 * @param rows the rows to move in
+	*/
+	void addRows(std::vector<Row> &&rows);
+
+	/**
+	 * @brief Lays the table out for display or export
+	 * @return the headers followed by the rows
+	*/
+	std::vector<Row> toTable() const;
+
+private:
+	/** @brief stores the column headers */
+	std::vector<std::string> headers{};
+	/** @brief stores the rows */
+	std::vector<Row> rows{};
+};
+#endif // !TABLE_DTO_H
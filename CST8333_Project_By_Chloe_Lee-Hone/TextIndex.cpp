@@ -0,0 +1,210 @@
+/**
+* @file				TextIndex.cpp
+* @author			Chloe Lee-Hone<leeh0002@algonquinlive.com>
+* @version			1.0
+* @section			This file contains the TextIndex class, a trigram index that finds a column's values by partial text.
+*					This project contains information licensed under the Open Government Licence  Canada [1][2]. Code structure was informed by the provided example written by Stanley Pieda for CST8333 [3].
+*
+* Student Name:     Chloe Lee-Hone
+* Student Number:   041023578
+* Course:           CST8333_350: Programming Language Research Project
+* Professor:        Reg Dyer
+* Date:             05/06/2023
+*
+* References:
+* [1]   T. B. of C. Secretariat and T. B. S. of C. Open Government, Open Government Licence - Canada. http://open.canada.ca/en/open-government-licence-canada (accessed May 11, 2023).
+* [2]	T. B. of C. Secretariat and Open Government Portal, Vegetables in cold and common storage, Oct. 10, 2008. https://open.canada.ca/data/en/dataset/473f9524-45f8-47d0-9a12-537bb7704089 (accessed May 16, 2023).
+* [3]	S. Pieda, CST8333 19F Practical Project 2 Example Layered. Algonquin College, Algonquin College, Jun. 07, 2022. [Online]. Available: https://brightspace.algonquincollege.com/d2l/le/content/543581/viewContent/8322468/View
+*/
+
+#include "TextIndex.h"
+#include "ParallelRange.h"
+#include <algorithm>
+#include <iterator>
+#include <unordered_set>
+#include <utility>
+
+/** @brief The number of characters in a trigram */
+static constexpr std::size_t TRIGRAM_LENGTH = 3;
+
+/**
+ * @brief Lowercases an ASCII letter. Other bytes, including those of accented letters, are left as they are.
+ * @param character the character
+ * @return the lowercased character
+*/
+static char foldCharacter(char character) {
+	return character >= 'A' && character <= 'Z' ? static_cast<char>(character - 'A' + 'a') : character;
+}
+
+/**
+ * @brief Creates an empty index
+ * @param column the column to index
+*/
+TextIndex::TextIndex(RecordColumn column) : column{ column } {}
+
+/**
+ * @brief Compares a value with a piece of text the way a search does, ignoring the case of ASCII letters
+ * @param value the value
+ * @param text the text to look for
+ * @param match whether the text may appear anywhere in the value or only at its start
+ * @return true if the value matches
+*/
+bool TextIndex::isMatch(std::string_view value, std::string_view text, TextMatch match) {
+	auto isSameCharacter = [](char first, char second) { return foldCharacter(first) == foldCharacter(second); };
+	if (match == TextMatch::Prefix) {
+		return value.size() >= text.size() && std::equal(text.begin(), text.end(), value.begin(), isSameCharacter);
+	}
+	return std::search(value.begin(), value.end(), text.begin(), text.end(), isSameCharacter) != value.end();
+}
+
+/** @return the text's distinct trigrams, with ASCII letters lowercased, in ascending order */
+std::vector<TextIndex::Trigram> TextIndex::trigramsOf(std::string_view text) {
+	std::vector<Trigram> trigrams{};
+	if (text.size() < TRIGRAM_LENGTH) {
+		return trigrams;
+	}
+	trigrams.reserve(text.size() - TRIGRAM_LENGTH + 1);
+	for (std::size_t start = 0; start + TRIGRAM_LENGTH <= text.size(); start++) {
+		Trigram trigram{ 0 };
+		for (std::size_t i = 0; i < TRIGRAM_LENGTH; i++) {
+			trigram = (trigram << 8) | static_cast<unsigned char>(foldCharacter(text[start + i]));
+		}
+		trigrams.push_back(trigram);
+	}
+	std::sort(trigrams.begin(), trigrams.end());
+	trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+	return trigrams;
+}
+
+/**
+ * @brief Replaces the index's contents with the distinct values of every row. The values are gathered and split into trigrams
+ * on separate threads, each building its share of the trigram lists.
+ * @param recordList the records to index
+*/
+void TextIndex::build(const std::vector<RecordDTO> &recordList) {
+	TextIndex::values.clear();
+	TextIndex::valueIds.clear();
+	TextIndex::partitions.clear();
+
+	// Each chunk finds its own distinct values, which are merged in chunk order so ids follow the rows
+	std::vector<std::vector<std::string_view>> chunkValues(parallelChunkCount(recordList.size()));
+	forEachChunk(recordList.size(), [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+		std::unordered_set<std::string_view> seen{};
+		for (std::size_t row = begin; row < end; row++) {
+			std::string_view value = recordList[row].get(TextIndex::column);
+			if (seen.insert(value).second) {
+				chunkValues[chunk].push_back(value);
+			}
+		}
+	});
+	for (const std::vector<std::string_view> &found : chunkValues) {
+		for (std::string_view value : found) {
+			if (TextIndex::valueIds.emplace(std::string{ value }, static_cast<ValueId>(TextIndex::values.size())).second) {
+				TextIndex::values.emplace_back(value);
+			}
+		}
+	}
+
+	using Entry = std::pair<Trigram, ValueId>;
+	TextIndex::partitions.resize(parallelChunkCount(TextIndex::values.size()));
+	forEachPartition<Entry>(TextIndex::values.size(), [&](std::size_t id, auto &add) {
+		for (Trigram trigram : trigramsOf(TextIndex::values[id])) {
+			add(trigram, Entry{ trigram, static_cast<ValueId>(id) });
+		}
+	}, [&](std::size_t partition, std::vector<Entry> &entries) {
+		for (const Entry &entry : entries) {
+			TextIndex::partitions[partition][entry.first].push_back(entry.second);
+		}
+	});
+}
+
+/**
+ * @brief Learns a value, such as the new value of an edit. Does nothing if the value is already known.
+ * @param value the value
+*/
+void TextIndex::addValue(std::string_view value) {
+	ValueId id = static_cast<ValueId>(TextIndex::values.size());
+	if (!TextIndex::valueIds.emplace(std::string{ value }, id).second) {
+		return;
+	}
+	TextIndex::values.emplace_back(value);
+
+	if (TextIndex::partitions.empty()) {
+		TextIndex::partitions.resize(1);
+	}
+	for (Trigram trigram : trigramsOf(value)) {
+		TextIndex::partitions[trigram % TextIndex::partitions.size()][trigram].push_back(id);
+	}
+}
+
+/**
+ * @brief Finds the known values that match a piece of text
+ * @param text the text to look for
+ * @param match whether the text may appear anywhere in a value or only at its start
+ * @return the matching values, valid while the index exists
+*/
+std::vector<std::string_view> TextIndex::findValues(std::string_view text, TextMatch match) const {
+	std::vector<std::string_view> found{};
+	if (text.size() < TRIGRAM_LENGTH) {
+		for (const std::string &value : TextIndex::values) {
+			if (isMatch(value, text, match)) found.emplace_back(value);
+		}
+		return found;
+	}
+
+	// Intersect the trigrams' value lists, shortest first, so the candidates shrink as fast as possible
+	std::vector<const std::vector<ValueId> *> lists{};
+	for (Trigram trigram : trigramsOf(text)) {
+		const auto &partition = TextIndex::partitions[trigram % TextIndex::partitions.size()];
+		auto listed = partition.find(trigram);
+		if (listed == partition.end()) {
+			return found;
+		}
+		lists.push_back(&listed->second);
+	}
+	std::sort(lists.begin(), lists.end(), [](const std::vector<ValueId> *first, const std::vector<ValueId> *second) { return first->size() < second->size(); });
+
+	std::vector<ValueId> candidates = *lists.front();
+	std::vector<ValueId> remaining{};
+	for (std::size_t i = 1; i < lists.size() && !candidates.empty(); i++) {
+		remaining.clear();
+		std::set_intersection(candidates.begin(), candidates.end(), lists[i]->begin(), lists[i]->end(), std::back_inserter(remaining));
+		std::swap(candidates, remaining);
+	}
+
+	// Sharing every trigram does not prove the text occurs, or occurs at the start, so each candidate is checked
+	for (ValueId id : candidates) {
+		if (isMatch(TextIndex::values[id], text, match)) found.emplace_back(TextIndex::values[id]);
+	}
+	return found;
+}
+
+TEST_CASE("Test that a trigram index finds values by partial text in any case") {
+	std::vector<RecordDTO> recordList(40000);
+	const char *provinces[] = { "British Columbia", "Ontario", "New Brunswick", "Prince Edward Island" };
+	for (std::size_t row = 0; row < recordList.size(); row++) {
+		recordList[row].setGeo(provinces[row % 4]);
+	}
+
+	TextIndex textIndex{ RecordColumn::Geo };
+	textIndex.build(recordList);
+	CHECK(textIndex.valueCount() == 4);
+
+	std::vector<std::string_view> found = textIndex.findValues("bRiT", TextMatch::Contains);
+	REQUIRE(found.size() == 1);
+	CHECK(found[0] == "British Columbia");
+	/* "Brunswick" shares the trigram "bru" with no other value, but "sland" only appears at the end of one value */
+	CHECK(textIndex.findValues("island", TextMatch::Contains).size() == 1);
+	CHECK(textIndex.findValues("island", TextMatch::Prefix).empty());
+	CHECK(textIndex.findValues("New B", TextMatch::Prefix).size() == 1);
+	/* Text shorter than a trigram is compared with every value */
+	CHECK(textIndex.findValues("r", TextMatch::Contains).size() == 4);
+	CHECK(textIndex.findValues("On", TextMatch::Prefix).size() == 1);
+	CHECK(textIndex.findValues("Yukon", TextMatch::Contains).empty());
+
+	textIndex.addValue("Brittany");
+	textIndex.addValue("Brittany");
+	CHECK(textIndex.valueCount() == 5);
+	CHECK(textIndex.findValues("brit", TextMatch::Prefix).size() == 2);
+	CHECK(TextIndex::isMatch("British Columbia", "COLUMBIA", TextMatch::Contains));
+}
@@ -0,0 +1,109 @@
+/**
+* @file				TextIndex.h
+* @author			Chloe Lee-Hone<leeh0002@algonquinlive.com>
+* @version			1.0
+* @section			Header file for TextIndex class, a trigram index that finds a column's values by partial text.
+*					This project contains information licensed under the Open Government Licence  Canada [1][2]. Code structure was informed by the provided example written by Stanley Pieda for CST8333 [3].
+*
+* Student Name:     Chloe Lee-Hone
+* Student Number:   041023578
+* Course:           CST8333_350: Programming Language Research Project
+* Professor:        Reg Dyer
+* Date:             05/06/2023
+*
+* References:
+* [1]   T. B. of C. Secretariat and T. B. S. of C. Open Government, Open Government Licence - Canada. http://open.canada.ca/en/open-government-licence-canada (accessed May 11, 2023).
+* [2]	T. B. of C. Secretariat and Open Government Portal, Vegetables in cold and common storage, Oct. 10, 2008. https://open.canada.ca/data/en/dataset/473f9524-45f8-47d0-9a12-537bb7704089 (accessed May 16, 2023).
+* [3]	S. Pieda, CST8333 19F Practical Project 2 Example Layered. Algonquin College, Algonquin College, Jun. 07, 2022. [Online]. Available: https://brightspace.algonquincollege.com/d2l/le/content/543581/viewContent/8322468/View
+*/
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "RecordColumn.h"
+#include "RecordDTO.h"
+#include "doctest.h"
+
+#ifndef TEXT_INDEX_H
+#define TEXT_INDEX_H
+
+/** @brief How searched text must appear in a value. Both ignore the case of ASCII letters. */
+enum class TextMatch { Contains, Prefix };
+
+/**
+ * @brief Finds the values of one column that contain a piece of text, such as "brit" for British Columbia. Every distinct value is
+ * split into trigrams, its runs of three characters, and each trigram lists the values it occurs in. A search intersects the
+ * lists of the text's trigrams, so only values holding all of them are compared with the text. Text shorter than a trigram is
+ * compared with every distinct value.
+ *
+ * The index holds values, not rows: RecordService turns the matching values into rows with the column's RecordIndex. A column has
+ * far fewer distinct values than rows, and the index only has to learn values it has not seen, since, as in RecordIndex, values are never removed.
+*/
+class TextIndex
+{
+public:
+	/** @brief A distinct value's position in the order the index learned it */
+	using ValueId = std::uint32_t;
+
+	/**
+	 * @brief Creates an empty index
+	 * @param column the column to index
+	*/
+	explicit TextIndex(RecordColumn column);
+
+	/** @return the indexed column */
+	RecordColumn getColumn() const { return column; }
+
+	/**
+	 * @brief Replaces the index's contents with the distinct values of every row. The values are gathered and split into trigrams
+	 * on separate threads, each building its share of the trigram lists.
+	 * @param recordList the records to index
+	*/
+	void build(const std::vector<RecordDTO> &recordList);
+
+	/**
+	 * @brief Learns a value, such as the new value of an edit. Does nothing if the value is already known.
+	 * @param value the value
+	*/
+	void addValue(std::string_view value);
+
+	/**
+	 * @brief Finds the known values that match a piece of text
+	 * @param text the text to look for
+	 * @param match whether the text may appear anywhere in a value or only at its start
+	 * @return the matching values, valid while the index exists
+	*/
+	std::vector<std::string_view> findValues(std::string_view text, TextMatch match) const;
+
+	/** @return the number of distinct values the index knows */
+	std::size_t valueCount() const { return values.size(); }
+
+	/**
+	 * @brief Compares a value with a piece of text the way a search does, ignoring the case of ASCII letters
+	 * @param value the value
+	 * @param text the text to look for
+	 * @param match whether the text may appear anywhere in the value or only at its start
+	 * @return true if the value matches
+	*/
+	static bool isMatch(std::string_view value, std::string_view text, TextMatch match);
+
+private:
+	/** @brief Three characters, each lowercased, packed into the low 24 bits */
+	using Trigram = std::uint32_t;
+
+	RecordColumn column;
+	/** @brief the distinct values, in the order they were learned. A deque, so the views findValues() returns stay valid as values are added. */
+	std::deque<std::string> values{};
+	std::unordered_map<std::string, ValueId> valueIds{};
+	/** @brief partitions[trigram % size] maps each trigram to the ascending ids of the values containing it */
+	std::vector<std::unordered_map<Trigram, std::vector<ValueId>>> partitions{};
+
+	/** @return the text's distinct trigrams, with ASCII letters lowercased, in ascending order */
+	static std::vector<Trigram> trigramsOf(std::string_view text);
+};
+#endif // !TEXT_INDEX_H
@@ -0,0 +1,422 @@
+/**
+* @file				TimeSeries.cpp
+* @author			Chloe Lee-Hone<leeh0002@algonquinlive.com>
+* @version			1.0
+* @section			This file contains the TimeSeries class used by RecordService to keep each VECTOR series' points together in date order.
+*					This project contains information licensed under the Open Government Licence  Canada [1][2]. Code structure was informed by the provided example written by Stanley Pieda for CST8333 [3].
+*
+* Student Name:     Chloe Lee-Hone
+* Student Number:   041023578
+* Course:           CST8333_350: Programming Language Research Project
+* Professor:        Reg Dyer
+* Date:             05/06/2023
+*
+* References:
+* [1]   T. B. of C. Secretariat and T. B. S. of C. Open Government, Open Government Licence - Canada. http://open.canada.ca/en/open-government-licence-canada (accessed May 11, 2023).
+* [2]	T. B. of C. Secretariat and Open Government Portal, Vegetables in cold and common storage, Oct. 10, 2008. https://open.canada.ca/data/en/dataset/473f9524-45f8-47d0-9a12-537bb7704089 (accessed May 16, 2023).
+* [3]	S. Pieda, CST8333 19F Practical Project 2 Example Layered. Algonquin College, Algonquin College, Jun. 07, 2022. [Online]. Available: https://brightspace.algonquincollege.com/d2l/le/content/543581/viewContent/8322468/View
+*/
+
+#include "TimeSeries.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include "ParallelRange.h"
+#include "doctest.h"
+
+/** @brief The number of months in a year, and so the distance between a month and the same month a year earlier */
+static constexpr std::int32_t MONTHS_PER_YEAR = 12;
+
+/**
+ * @brief Splits the series into the chunks forEachChunk() would make of their points, moved to the nearest series boundary,
+ * and calls work(firstSeries, endSeries, chunk) for each chunk on its own thread. Every series lands in exactly one chunk.
+ * @param starts where each series' points start, followed by the number of points
+ * @param work a callable taking (std::size_t firstSeries, std::size_t endSeries, std::size_t chunk)
+*/
+template <typename Work>
+static void forEachSeriesChunk(const std::vector<std::size_t> &starts, const Work &work) {
+	auto seriesAt = [&starts](std::size_t point) {
+		return static_cast<std::size_t>(std::lower_bound(starts.begin(), starts.end() - 1, point) - starts.begin());
+	};
+	forEachChunk(starts.back(), [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+		work(seriesAt(begin), seriesAt(end), chunk);
+	});
+}
+
+/**
+ * @brief Converts a REF_DATE to a month number
+ * @param refDate a date in YYYY-MM form
+ * @return year * 12 + (month - 1), or no value if the date is not in that form
+*/
+std::optional<std::int32_t> TimeSeries::toMonthNumber(std::string_view refDate) {
+	if (refDate.size() != 7 || refDate[4] != '-') {
+		return std::nullopt;
+	}
+	std::int32_t digits[6]{};
+	for (std::size_t i = 0, digit = 0; i < refDate.size(); i++) {
+		if (i == 4) continue;
+		if (refDate[i] < '0' || refDate[i] > '9') return std::nullopt;
+		digits[digit++] = refDate[i] - '0';
+	}
+
+	std::int32_t year = digits[0] * 1000 + digits[1] * 100 + digits[2] * 10 + digits[3];
+	std::int32_t month = digits[4] * 10 + digits[5];
+	if (month < 1 || month > MONTHS_PER_YEAR) {
+		return std::nullopt;
+	}
+	return year * MONTHS_PER_YEAR + (month - 1);
+}
+
+/**
+ * @brief Converts a month number back to a REF_DATE
+ * @param monthNumber a month number from toMonthNumber()
+ * @return the date in YYYY-MM form
+*/
+std::string TimeSeries::toRefDate(std::int32_t monthNumber) {
+	std::string year = std::to_string(monthNumber / MONTHS_PER_YEAR);
+	std::string month = std::to_string(monthNumber % MONTHS_PER_YEAR + 1);
+	return std::string(4 - std::min<std::size_t>(4, year.size()), '0') + year + "-" + (month.size() < 2 ? "0" : "") + month;
+}
+
+/**
+ * @brief Replaces the contents with the series of rowCount records. Dates and values are read in parallel, the points are
+ * laid out series by series with a counting pass, and then each series is put in date order on its own thread.
+ * @param recordList the records
+ * @param rowCount the number of records to include
+ * @param rowAt a callable taking a position below rowCount and returning its row in recordList
+*/
+template <typename RowAt>
+void TimeSeries::buildRows(const std::vector<RecordDTO> &recordList, std::size_t rowCount, const RowAt &rowAt) {
+	constexpr std::int32_t NO_MONTH = std::numeric_limits<std::int32_t>::min();
+	std::vector<std::int32_t> rowMonths(rowCount);
+	std::vector<double> rowValues(rowCount);
+
+	forEachChunk(rowCount, [&](std::size_t begin, std::size_t end, std::size_t) {
+		for (std::size_t i = begin; i < end; i++) {
+			const RecordDTO &record = recordList[rowAt(i)];
+			std::optional<std::int32_t> month = toMonthNumber(record.get<RecordColumn::RefDate>());
+			bool isInSeries = month && !record.get<RecordColumn::Vector>().empty();
+			rowMonths[i] = isInSeries ? *month : NO_MONTH;
+			rowValues[i] = readNumericValue(record.get<RecordColumn::Value>());
+		}
+	});
+
+	TimeSeries built{};
+	std::vector<std::size_t> rowSeries(rowCount);
+	std::vector<std::size_t> counts{};
+	for (std::size_t i = 0; i < rowCount; i++) {
+		if (rowMonths[i] == NO_MONTH) continue;
+		const RecordDTO &record = recordList[rowAt(i)];
+		auto [position, isNew] = built.positions.try_emplace(std::string{ record.get<RecordColumn::Vector>() }, built.names.size());
+		if (isNew) {
+			built.names.push_back(position->first);
+			counts.push_back(0);
+		}
+		rowSeries[i] = position->second;
+		counts[position->second]++;
+	}
+
+	for (std::size_t count : counts) {
+		built.starts.push_back(built.starts.back() + count);
+	}
+	built.months.resize(built.starts.back());
+	built.values.resize(built.starts.back());
+	built.rows.resize(built.starts.back());
+
+	// Points are placed in row order, so points with the same month stay in row order
+	std::vector<std::size_t> nextPoint(built.starts.begin(), built.starts.end() - 1);
+	for (std::size_t i = 0; i < rowCount; i++) {
+		if (rowMonths[i] == NO_MONTH) continue;
+		std::size_t point = nextPoint[rowSeries[i]]++;
+		built.months[point] = rowMonths[i];
+		built.values[point] = rowValues[i];
+		built.rows[point] = static_cast<RowId>(rowAt(i));
+	}
+
+	forEachSeriesChunk(built.starts, [&built](std::size_t firstSeries, std::size_t endSeries, std::size_t) {
+		for (std::size_t series = firstSeries; series < endSeries; series++) {
+			std::size_t begin = built.starts[series];
+			std::size_t end = built.starts[series + 1];
+			// The data set lists dates in order, so most series need no sorting
+			if (std::is_sorted(built.months.begin() + begin, built.months.begin() + end)) continue;
+
+			std::vector<std::size_t> order(end - begin);
+			std::iota(order.begin(), order.end(), begin);
+			std::stable_sort(order.begin(), order.end(), [&built](std::size_t first, std::size_t second) {
+				return built.months[first] < built.months[second];
+			});
+			std::vector<std::int32_t> sortedMonths{};
+			std::vector<double> sortedValues{};
+			std::vector<RowId> sortedRows{};
+			for (std::size_t point : order) {
+				sortedMonths.push_back(built.months[point]);
+				sortedValues.push_back(built.values[point]);
+				sortedRows.push_back(built.rows[point]);
+			}
+			std::copy(sortedMonths.begin(), sortedMonths.end(), built.months.begin() + begin);
+			std::copy(sortedValues.begin(), sortedValues.end(), built.values.begin() + begin);
+			std::copy(sortedRows.begin(), sortedRows.end(), built.rows.begin() + begin);
+		}
+	});
+
+	*this = std::move(built);
+}
+
+/**
+ * @brief Replaces the contents with one series per VECTOR in the records
+ * @param recordList the records, where row i is recordList[i]
+*/
+void TimeSeries::build(const std::vector<RecordDTO> &recordList) {
+	buildRows(recordList, recordList.size(), [](std::size_t i) { return i; });
+}
+
+/**
+ * @brief Replaces the contents with one series per VECTOR in the selected records, such as the live ones
+ * @param recordList the records
+ * @param rows the rows to include, in ascending order. Each point keeps its row in recordList.
+*/
+void TimeSeries::build(const std::vector<RecordDTO> &recordList, const std::vector<RowId> &rows) {
+	buildRows(recordList, rows.size(), [&rows](std::size_t i) { return rows[i]; });
+}
+
+/**
+ * @brief Finds a series by its VECTOR
+ * @param vector the series' VECTOR, such as v722342
+ * @return the series' number, or no value if no record has that VECTOR
+*/
+std::optional<std::size_t> TimeSeries::findSeries(std::string_view vector) const {
+	auto position = positions.find(std::string{ vector });
+	if (position == positions.end()) {
+		return std::nullopt;
+	}
+	return position->second;
+}
+
+/**
+ * @brief Returns every point of a series
+ * @param series a series number below seriesCount()
+ * @return the series' points in date order
+*/
+TimeSeries::Slice TimeSeries::getSeries(std::size_t series) const {
+	std::size_t begin = starts[series];
+	return Slice{ months.data() + begin, values.data() + begin, rows.empty() ? nullptr : rows.data() + begin, starts[series + 1] - begin };
+}
+
+/**
+ * @brief Returns a series' points from one month to another, found by binary search
+ * @param series a series number below seriesCount()
+ * @param fromMonth the first month wanted
+ * @param toMonth the last month wanted
+ * @return the points in the range, in date order
+*/
+TimeSeries::Slice TimeSeries::slice(std::size_t series, std::int32_t fromMonth, std::int32_t toMonth) const {
+	Slice whole = getSeries(series);
+	const std::int32_t *first = std::lower_bound(whole.months, whole.months + whole.size, fromMonth);
+	const std::int32_t *last = std::upper_bound(first, whole.months + whole.size, toMonth);
+	std::size_t offset = static_cast<std::size_t>(first - whole.months);
+	return Slice{ first, whole.values + offset, whole.rows ? whole.rows + offset : nullptr, static_cast<std::size_t>(last - first) };
+}
+
+/**
+ * @brief Builds a new TimeSeries by transforming each series. Series are split into chunks of similar point counts, and each
+ * chunk is transformed on its own thread.
+ * @param transform a callable taking (Slice series, std::vector<std::int32_t> &months, std::vector<double> &values) that appends the new series' points
+ * @return the transformed series, with the same names
+*/
+template <typename Transform>
+TimeSeries TimeSeries::transformEach(const Transform &transform) const {
+	struct ChunkPoints {
+		std::vector<std::size_t> sizes{};
+		std::vector<std::int32_t> months{};
+		std::vector<double> values{};
+	};
+	std::vector<ChunkPoints> chunks(parallelChunkCount(pointCount()));
+
+	forEachSeriesChunk(starts, [&](std::size_t firstSeries, std::size_t endSeries, std::size_t chunk) {
+		ChunkPoints &points = chunks[chunk];
+		for (std::size_t series = firstSeries; series < endSeries; series++) {
+			std::size_t sizeBefore = points.months.size();
+			transform(getSeries(series), points.months, points.values);
+			points.sizes.push_back(points.months.size() - sizeBefore);
+		}
+	});
+
+	// Chunks hold consecutive series, so appending them in chunk order keeps the series numbers
+	TimeSeries transformed{};
+	transformed.names = names;
+	transformed.positions = positions;
+	for (ChunkPoints &points : chunks) {
+		for (std::size_t size : points.sizes) {
+			transformed.starts.push_back(transformed.starts.back() + size);
+		}
+		transformed.months.insert(transformed.months.end(), points.months.begin(), points.months.end());
+		transformed.values.insert(transformed.values.end(), points.values.begin(), points.values.end());
+	}
+	return transformed;
+}
+
+/**
+ * @brief Averages each point with the points of the months before it in the window. A running sum moves along the series,
+ * so each point costs the same however long the window is.
+ * @param windowMonths the window's length in months, including the point's own month
+ * @return the same points with averaged values, or NaN where the window holds no numbers
+ * @throws std::invalid_argument if the window is not at least one month long
+*/
+TimeSeries TimeSeries::rollingMean(int windowMonths) const {
+	if (windowMonths <= 0) {
+		throw std::invalid_argument("A rolling window must be at least one month long.");
+	}
+	return transformEach([windowMonths](Slice series, std::vector<std::int32_t> &newMonths, std::vector<double> &newValues) {
+		double sum{ 0 };
+		std::size_t count{ 0 };
+		std::size_t first{ 0 };
+
+		for (std::size_t i = 0; i < series.size; i++) {
+			if (!std::isnan(series.values[i])) {
+				sum += series.values[i];
+				count++;
+			}
+			for (; series.months[first] <= series.months[i] - windowMonths; first++) {
+				if (!std::isnan(series.values[first])) {
+					sum -= series.values[first];
+					count--;
+				}
+			}
+			newMonths.push_back(series.months[i]);
+			newValues.push_back(count == 0 ? std::numeric_limits<double>::quiet_NaN() : sum / count);
+		}
+	});
+}
+
+/**
+ * @brief Subtracts from each point the value of the same month a year earlier. A second position trails the first by a year,
+ * so the whole series is one pass.
+ * @return the same points with their year-over-year change, or NaN where either value is missing
+*/
+TimeSeries TimeSeries::yearOverYear() const {
+	return transformEach([](Slice series, std::vector<std::int32_t> &newMonths, std::vector<double> &newValues) {
+		std::size_t previous{ 0 };
+
+		for (std::size_t i = 0; i < series.size; i++) {
+			std::int32_t yearEarlier = series.months[i] - MONTHS_PER_YEAR;
+			while (previous < i && series.months[previous] < yearEarlier) {
+				previous++;
+			}
+			bool hasYearEarlier = previous < i && series.months[previous] == yearEarlier;
+			newMonths.push_back(series.months[i]);
+			newValues.push_back(hasYearEarlier ? series.values[i] - series.values[previous] : std::numeric_limits<double>::quiet_NaN());
+		}
+	});
+}
+
+/**
+ * @brief Totals each series' points by quarter or by year. Points are in date order, so each period is one run of points.
+ * @param period the period to total by. Each point is dated at the first month of its period.
+ * @param function Sum, Count, Min, Max or Average
+ * @return one point per period that has points
+*/
+TimeSeries TimeSeries::resample(Period period, AggregateFunction function) const {
+	if (function == AggregateFunction::CountDistinct) {
+		throw std::invalid_argument("Series can only be resampled with Sum, Count, Min, Max or Average.");
+	}
+	std::int32_t periodLength = static_cast<std::int32_t>(period);
+
+	return transformEach([periodLength, function](Slice series, std::vector<std::int32_t> &newMonths, std::vector<double> &newValues) {
+		for (std::size_t i = 0; i < series.size;) {
+			std::int32_t periodStart = series.months[i] - series.months[i] % periodLength;
+			double sum{ 0 };
+			double min{ std::numeric_limits<double>::infinity() };
+			double max{ -std::numeric_limits<double>::infinity() };
+			std::size_t count{ 0 };
+
+			for (; i < series.size && series.months[i] < periodStart + periodLength; i++) {
+				if (std::isnan(series.values[i])) continue;
+				sum += series.values[i];
+				min = std::min(min, series.values[i]);
+				max = std::max(max, series.values[i]);
+				count++;
+			}
+
+			double total{ std::numeric_limits<double>::quiet_NaN() };
+			if (function == AggregateFunction::Count) total = static_cast<double>(count);
+			else if (count == 0) total = std::numeric_limits<double>::quiet_NaN();
+			else if (function == AggregateFunction::Sum) total = sum;
+			else if (function == AggregateFunction::Min) total = min;
+			else if (function == AggregateFunction::Max) total = max;
+			else total = sum / count;
+
+			newMonths.push_back(periodStart);
+			newValues.push_back(total);
+		}
+	});
+}
+
+TEST_CASE("Test that series are kept in date order and sliced by date") {
+	std::vector<RecordDTO> recordList(6);
+	const char *dates[] = { "1971-02", "1970-01", "1970-12", "1971-01", "1970-02", "bad" };
+	const char *values[] = { "50", "10", "", "20", "30", "99" };
+	for (std::size_t row = 0; row < recordList.size(); row++) {
+		recordList[row].setRefDate(dates[row]);
+		recordList[row].setValue(values[row]);
+		recordList[row].setVector(row % 2 == 0 ? "v1" : "v2");
+	}
+
+	TimeSeries timeSeries{};
+	timeSeries.build(recordList);
+	REQUIRE(timeSeries.seriesCount() == 2);
+	CHECK(timeSeries.pointCount() == 5);
+	CHECK(TimeSeries::toRefDate(*TimeSeries::toMonthNumber("1970-12")) == "1970-12");
+	CHECK_FALSE(TimeSeries::toMonthNumber("1970-13").has_value());
+
+	/* v1 holds rows 0, 2 and 4, in date order 1970-02, 1970-12, 1971-02 */
+	std::size_t v1 = *timeSeries.findSeries("v1");
+	TimeSeries::Slice points = timeSeries.getSeries(v1);
+	REQUIRE(points.size == 3);
+	CHECK(points.rows[0] == 4);
+	CHECK(points.rows[2] == 0);
+
+	TimeSeries::Slice lateOnes = timeSeries.slice(v1, *TimeSeries::toMonthNumber("1970-06"), *TimeSeries::toMonthNumber("1971-12"));
+	REQUIRE(lateOnes.size == 2);
+	CHECK(lateOnes.rows[0] == 2);
+
+	/* 1971-02 (50) minus 1970-02 (30); 1970-12 is empty, so its window mean is the 1970-02 value alone */
+	TimeSeries changes = timeSeries.yearOverYear();
+	TimeSeries means = timeSeries.rollingMean(12);
+	CHECK(std::isnan(changes.getSeries(v1).values[0]));
+	CHECK(changes.getSeries(v1).values[2] == 20);
+	CHECK(means.getSeries(v1).values[1] == 30);
+	CHECK(means.getSeries(v1).values[2] == 50);
+	CHECK_THROWS_AS(timeSeries.rollingMean(0), std::invalid_argument);
+}
+
+TEST_CASE("Test that resampling many series in parallel matches per-series totals") {
+	std::vector<RecordDTO> recordList{};
+	for (int month = 0; month < 120; month++) {
+		for (int series = 0; series < 300; series++) {
+			RecordDTO record{};
+			record.setVector("v" + std::to_string(series));
+			record.setRefDate(TimeSeries::toRefDate(1970 * 12 + month));
+			record.setValue(std::to_string(series + month));
+			recordList.push_back(std::move(record));
+		}
+	}
+
+	TimeSeries timeSeries{};
+	timeSeries.build(recordList);
+	TimeSeries quarterly = timeSeries.resample(TimeSeries::Period::Quarter, AggregateFunction::Sum);
+	TimeSeries annual = timeSeries.resample(TimeSeries::Period::Year, AggregateFunction::Average);
+
+	REQUIRE(quarterly.seriesCount() == 300);
+	TimeSeries::Slice v7Quarters = quarterly.getSeries(*quarterly.findSeries("v7"));
+	REQUIRE(v7Quarters.size == 40);
+	/* The second quarter holds months 3, 4 and 5 */
+	CHECK(TimeSeries::toRefDate(v7Quarters.months[1]) == "1970-04");
+	CHECK(v7Quarters.values[1] == (7 + 3) + (7 + 4) + (7 + 5));
+
+	TimeSeries::Slice v299Years = annual.getSeries(*annual.findSeries("v299"));
+	REQUIRE(v299Years.size == 10);
+	CHECK(v299Years.values[9] == doctest::Approx(299 + 108 + 5.5));
+}
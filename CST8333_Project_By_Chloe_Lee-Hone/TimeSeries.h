@@ -0,0 +1,170 @@
+/**
+* @file				TimeSeries.h
+* @author			Chloe Lee-Hone<leeh0002@algonquinlive.com>
+* @version			1.0
+* @section			Header file for the TimeSeries class, which keeps each VECTOR series' points together in date order.
+*					This project contains information licensed under the Open Government Licence  Canada [1][2]. Code structure was informed by the provided example written by Stanley Pieda for CST8333 [3].
+*
+* Student Name:     Chloe Lee-Hone
+* Student Number:   041023578
+* Course:           CST8333_350: Programming Language Research Project
+* Professor:        Reg Dyer
+* Date:             05/06/2023
+*
+* References:
+* [1]   T. B. of C. Secretariat and T. B. S. of C. Open Government, Open Government Licence - Canada. http://open.canada.ca/en/open-government-licence-canada (accessed May 11, 2023).
+* [2]	T. B. of C. Secretariat and Open Government Portal, Vegetables in cold and common storage, Oct. 10, 2008. https://open.canada.ca/data/en/dataset/473f9524-45f8-47d0-9a12-537bb7704089 (accessed May 16, 2023).
+* [3]	S. Pieda, CST8333 19F Practical Project 2 Example Layered. Algonquin College, Algonquin College, Jun. 07, 2022. [Online]. Available: https://brightspace.algonquincollege.com/d2l/le/content/543581/viewContent/8322468/View
+*/
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "RecordAggregator.h"
+#include "RecordDTO.h"
+#include "RecordIndex.h"
+#include "doctest.h"
+
+#ifndef TIME_SERIES_H
+#define TIME_SERIES_H
+
+/**
+ * @brief A series-oriented copy of the records' dates and values. Each StatCan series, identified by its VECTOR, keeps its
+ * (month, value) points next to each other in date order, so a date range is found by binary search and the transforms below
+ * run as tight loops over plain arrays. The arrays hold every series back to back; series i covers points [starts[i], starts[i + 1]).
+ *
+ * Months are counted as year * 12 + (month - 1), so consecutive months differ by one. Rows whose REF_DATE is not in YYYY-MM
+ * form, or whose VECTOR is empty, belong to no series. An empty or non-numeric VALUE is kept as NaN, and transforms skip it.
+*/
+class TimeSeries
+{
+public:
+	using RowId = RecordIndex::RowId;
+
+	/** @brief The periods resample() can total months into. The value is the period's length in months. */
+	enum class Period { Quarter = 3, Year = 12 };
+
+	/** @brief A run of one series' points. Points into the TimeSeries, so it is only valid while the TimeSeries is unchanged. */
+	struct Slice {
+		const std::int32_t *months;
+		const double *values;
+		/** @brief the record each point came from, or nullptr for a series made by a transform */
+		const RowId *rows;
+		std::size_t size;
+	};
+
+	/**
+	 * @brief Converts a REF_DATE to a month number
+	 * @param refDate a date in YYYY-MM form
+	 * @return year * 12 + (month - 1), or no value if the date is not in that form
+	*/
+	static std::optional<std::int32_t> toMonthNumber(std::string_view refDate);
+
+	/**
+	 * @brief Converts a month number back to a REF_DATE
+	 * @param monthNumber a month number from toMonthNumber()
+	 * @return the date in YYYY-MM form
+	*/
+	static std::string toRefDate(std::int32_t monthNumber);
+
+	/**
+	 * @brief Replaces the contents with one series per VECTOR in the records
+	 * @param recordList the records, where row i is recordList[i]
+	*/
+	void build(const std::vector<RecordDTO> &recordList);
+
+	/**
+	 * @brief Replaces the contents with one series per VECTOR in the selected records, such as the live ones
+	 * @param recordList the records
+	 * @param rows the rows to include, in ascending order. Each point keeps its row in recordList.
+	*/
+	void build(const std::vector<RecordDTO> &recordList, const std::vector<RowId> &rows);
+
+	/** @return the number of series */
+	std::size_t seriesCount() const { return names.size(); }
+
+	/** @return the number of points across every series */
+	std::size_t pointCount() const { return months.size(); }
+
+	/** @return a series' VECTOR */
+	const std::string &getSeriesName(std::size_t series) const { return names[series]; }
+
+	/**
+	 * @brief Finds a series by its VECTOR
+	 * @param vector the series' VECTOR, such as v722342
+	 * @return the series' number, or no value if no record has that VECTOR
+	*/
+	std::optional<std::size_t> findSeries(std::string_view vector) const;
+
+	/**
+	 * @brief Returns every point of a series
+	 * @param series a series number below seriesCount()
+	 * @return the series' points in date order
+	*/
+	Slice getSeries(std::size_t series) const;
+
+	/**
+	 * @brief Returns a series' points from one month to another, found by binary search
+	 * @param series a series number below seriesCount()
+	 * @param fromMonth the first month wanted
+	 * @param toMonth the last month wanted
+	 * @return the points in the range, in date order
+	*/
+	Slice slice(std::size_t series, std::int32_t fromMonth, std::int32_t toMonth) const;
+
+	/**
+	 * @brief Averages each point with the points of the months before it in the window. Every series is transformed in parallel.
+	 * @param windowMonths the window's length in months, including the point's own month
+	 * @return the same points with averaged values, or NaN where the window holds no numbers
+	 * @throws std::invalid_argument if the window is not at least one month long
+	*/
+	TimeSeries rollingMean(int windowMonths) const;
+
+	/**
+	 * @brief Subtracts from each point the value of the same month a year earlier. Every series is transformed in parallel.
+	 * @return the same points with their year-over-year change, or NaN where either value is missing
+	*/
+	TimeSeries yearOverYear() const;
+
+	/**
+	 * @brief Totals each series' points by quarter or by year. Every series is transformed in parallel.
+	 * @param period the period to total by. Each point is dated at the first month of its period.
+	 * @param function Sum, Count, Min, Max or Average
+	 * @return one point per period that has points
+	*/
+	TimeSeries resample(Period period, AggregateFunction function) const;
+
+private:
+	/** @brief each series' VECTOR */
+	std::vector<std::string> names{};
+	/** @brief where each series' points start, followed by pointCount() */
+	std::vector<std::size_t> starts{ 0 };
+	std::vector<std::int32_t> months{};
+	std::vector<double> values{};
+	/** @brief the record each point came from. Empty for a series made by a transform. */
+	std::vector<RowId> rows{};
+	/** @brief maps each VECTOR to its series number */
+	std::unordered_map<std::string, std::size_t> positions{};
+
+	/**
+	 * @brief Builds a new TimeSeries by transforming each series. Series are split into chunks of similar point counts, and each
+	 * chunk is transformed on its own thread.
+	 * @param transform a callable taking (Slice series, std::vector<std::int32_t> &months, std::vector<double> &values) that appends the new series' points
+	 * @return the transformed series, with the same names
+	*/
+	template <typename Transform>
+	TimeSeries transformEach(const Transform &transform) const;
+
+	/**
+	 * @brief Replaces the contents with the series of rowCount records
+	 * @param rowAt a callable taking a position below rowCount and returning its row in recordList
+	*/
+	template <typename RowAt>
+	void buildRows(const std::vector<RecordDTO> &recordList, std::size_t rowCount, const RowAt &rowAt);
+};
+#endif // !TIME_SERIES_H
@@ -0,0 +1,189 @@
+/**
+* @file				UniqueKey.cpp
+* @author			Chloe Lee-Hone<leeh0002@algonquinlive.com>
+* @version			1.0
+* @section			This file contains the UniqueKey class, a hash index that keeps a combination of columns unique and reports records that share it.
+*					This project contains information licensed under the Open Government Licence  Canada [1][2]. Code structure was informed by the provided example written by Stanley Pieda for CST8333 [3].
+*
+* Student Name:     Chloe Lee-Hone
+* Student Number:   041023578
+* Course:           CST8333_350: Programming Language Research Project
+* Professor:        Reg Dyer
+* Date:             05/06/2023
+*
+* References:
+* [1]   T. B. of C. Secretariat and T. B. S. of C. Open Government, Open Government Licence - Canada. http://open.canada.ca/en/open-government-licence-canada (accessed May 11, 2023).
+* [2]	T. B. of C. Secretariat and Open Government Portal, Vegetables in cold and common storage, Oct. 10, 2008. https://open.canada.ca/data/en/dataset/473f9524-45f8-47d0-9a12-537bb7704089 (accessed May 16, 2023).
+* [3]	S. Pieda, CST8333 19F Practical Project 2 Example Layered. Algonquin College, Algonquin College, Jun. 07, 2022. [Online]. Available: https://brightspace.algonquincollege.com/d2l/le/content/543581/viewContent/8322468/View
+*/
+
+#include "UniqueKey.h"
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include "ParallelRange.h"
+#include "doctest.h"
+
+/**
+ * @brief Creates an empty constraint
+ * @param columns the columns whose values together must be unique
+ * @throws std::invalid_argument if no column is given
+*/
+UniqueKey::UniqueKey(std::vector<RecordColumn> columns) : columns{ std::move(columns) } {
+	if (UniqueKey::columns.empty()) {
+		throw std::invalid_argument("A unique key needs at least one column.");
+	}
+}
+
+/**
+ * @brief Checks whether a column is part of the key
+ * @param column the column
+ * @return true if changing the column changes the key
+*/
+bool UniqueKey::covers(RecordColumn column) const {
+	return std::find(UniqueKey::columns.begin(), UniqueKey::columns.end(), column) != UniqueKey::columns.end();
+}
+
+/**
+ * @brief Builds a record's key
+ * @param record the record
+ * @return the key columns' values, joined by a separator that does not occur in the data
+*/
+std::string UniqueKey::keyOf(const RecordDTO &record) const {
+	std::string key{};
+	for (std::size_t i = 0; i < UniqueKey::columns.size(); i++) {
+		if (i > 0) key.push_back(KEY_SEPARATOR);
+		key.append(record.get(UniqueKey::columns[i]));
+	}
+	return key;
+}
+
+/**
+ * @brief Builds the key a record would have after one column is changed
+ * @param record the record
+ * @param column the changed column
+ * @param newValue the column's new value
+ * @return the changed record's key
+*/
+std::string UniqueKey::keyOf(const RecordDTO &record, RecordColumn column, std::string_view newValue) const {
+	std::string key{};
+	for (std::size_t i = 0; i < UniqueKey::columns.size(); i++) {
+		if (i > 0) key.push_back(KEY_SEPARATOR);
+		key.append(UniqueKey::columns[i] == column ? newValue : record.get(UniqueKey::columns[i]));
+	}
+	return key;
+}
+
+/**
+ * @brief Formats a key for messages, such as "REF_DATE 1976-01, VECTOR v108237"
+ * @param key a key built by keyOf()
+ * @return the key's columns and values
+*/
+std::string UniqueKey::describe(const std::string &key) const {
+	std::string description{};
+	std::size_t begin{ 0 };
+	for (std::size_t i = 0; i < UniqueKey::columns.size(); i++) {
+		std::size_t end = std::min(key.find(KEY_SEPARATOR, begin), key.size());
+		if (i > 0) description.append(", ");
+		description.append(columnInfo(UniqueKey::columns[i]).header).append(" ").append(key, begin, end - begin);
+		begin = end + 1;
+	}
+	return description;
+}
+
+/**
+ * @brief Finds the record holding a key
+ * @param key the key
+ * @return the record's id, or NO_RECORD
+*/
+UniqueKey::RecordId UniqueKey::find(const std::string &key) const {
+	auto owner = UniqueKey::owners.find(key);
+	return owner == UniqueKey::owners.end() ? NO_RECORD : owner->second;
+}
+
+/**
+ * @brief Records that a record holds a key. A key that is already held keeps its record.
+ * @param key the key
+ * @param recordId the record's id
+*/
+void UniqueKey::insert(std::string key, RecordId recordId) {
+	UniqueKey::owners.emplace(std::move(key), recordId);
+}
+
+/**
+ * @brief Releases a key if the given record holds it
+ * @param key the key
+ * @param recordId the record's id
+*/
+void UniqueKey::erase(const std::string &key, RecordId recordId) {
+	auto owner = UniqueKey::owners.find(key);
+	if (owner != UniqueKey::owners.end() && owner->second == recordId) {
+		UniqueKey::owners.erase(owner);
+	}
+}
+
+/**
+ * @brief Finds every key that more than one record holds. Chunks of the rows are hashed on separate threads into one
+ * partition per thread, then each partition is grouped on its own thread, so no two threads share a hash map.
+ * @param recordList the records
+ * @param rows the slots to check, in ascending order
+ * @return one entry per duplicated key, ordered by the key's first slot
+*/
+std::vector<UniqueKey::Duplicate> UniqueKey::findDuplicates(const std::vector<RecordDTO> &recordList, const std::vector<RowId> &rows) const {
+	using Entry = std::pair<std::string, RowId>;
+	std::vector<std::vector<Duplicate>> partitionDuplicates(parallelChunkCount(rows.size()));
+	forEachPartition<Entry>(rows.size(), [&](std::size_t position, auto &add) {
+		std::string key = keyOf(recordList[rows[position]]);
+		std::size_t hash = std::hash<std::string>{}(key);
+		add(hash, Entry{ std::move(key), rows[position] });
+	}, [&](std::size_t partition, std::vector<Entry> &entries) {
+		std::unordered_map<std::string, std::vector<RowId>> groups{};
+		for (Entry &entry : entries) {
+			groups[std::move(entry.first)].push_back(entry.second);
+		}
+		for (auto &group : groups) {
+			if (group.second.size() > 1) {
+				partitionDuplicates[partition].push_back(Duplicate{ group.first, std::move(group.second) });
+			}
+		}
+	});
+
+	std::vector<Duplicate> duplicates{};
+	for (std::vector<Duplicate> &found : partitionDuplicates) {
+		std::move(found.begin(), found.end(), std::back_inserter(duplicates));
+	}
+	std::sort(duplicates.begin(), duplicates.end(), [](const Duplicate &first, const Duplicate &second) { return first.rows.front() < second.rows.front(); });
+	return duplicates;
+}
+
+TEST_CASE("Test that the unique key finds owners and duplicates") {
+	UniqueKey uniqueKey{ { RecordColumn::RefDate, RecordColumn::Vector } };
+	std::vector<RecordDTO> recordList{};
+	for (int i = 0; i < 40000; i++) {
+		RecordDTO record{};
+		record.setRefDate("2020-0" + std::to_string(1 + i % 3));
+		record.setVector("v" + std::to_string(i / 3));
+		recordList.push_back(record);
+	}
+	recordList[39999].setVector("v1");
+	recordList[20000].setVector("v1");
+	recordList[20000].setRefDate("2020-03");
+
+	std::vector<UniqueKey::RowId> rows(recordList.size());
+	for (UniqueKey::RowId row = 0; row < rows.size(); row++) rows[row] = row;
+	std::vector<UniqueKey::Duplicate> duplicates = uniqueKey.findDuplicates(recordList, rows);
+	REQUIRE(duplicates.size() == 2);
+	CHECK(duplicates[0].rows == std::vector<UniqueKey::RowId>{ 3, 39999 });
+	CHECK(duplicates[1].rows == std::vector<UniqueKey::RowId>{ 5, 20000 });
+	CHECK(uniqueKey.describe(duplicates[1].key) == "REF_DATE 2020-03, VECTOR v1");
+
+	uniqueKey.insert(uniqueKey.keyOf(recordList[0]), 10);
+	CHECK(uniqueKey.find(uniqueKey.keyOf(recordList[0])) == 10);
+	CHECK(uniqueKey.find(uniqueKey.keyOf(recordList[1])) == UniqueKey::NO_RECORD);
+	CHECK(uniqueKey.find(uniqueKey.keyOf(recordList[1], RecordColumn::RefDate, "2020-01")) == 10);
+	uniqueKey.erase(uniqueKey.keyOf(recordList[0]), 11);
+	CHECK(uniqueKey.size() == 1);
+	uniqueKey.erase(uniqueKey.keyOf(recordList[0]), 10);
+	CHECK(uniqueKey.size() == 0);
+}
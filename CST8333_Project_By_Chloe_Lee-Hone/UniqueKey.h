@@ -0,0 +1,138 @@
+/**
+* @file				UniqueKey.h
+* @author			Chloe Lee-Hone<leeh0002@algonquinlive.com>
+* @version			1.0
+* @section			Header file for the UniqueKey class, a hash index that keeps a combination of columns unique and reports records that share it.
+*					This project contains information licensed under the Open Government Licence  Canada [1][2]. Code structure was informed by the provided example written by Stanley Pieda for CST8333 [3].
+*
+* Student Name:     Chloe Lee-Hone
+* Student Number:   041023578
+* Course:           CST8333_350: Programming Language Research Project
+* Professor:        Reg Dyer
+* Date:             05/06/2023
+*
+* References:
+* [1]   T. B. of C. Secretariat and T. B. S. of C. Open Government, Open Government Licence - Canada. http://open.canada.ca/en/open-government-licence-canada (accessed May 11, 2023).
+* [2]	T. B. of C. Secretariat and Open Government Portal, Vegetables in cold and common storage, Oct. 10, 2008. https://open.canada.ca/data/en/dataset/473f9524-45f8-47d0-9a12-537bb7704089 (accessed May 16, 2023).
+* [3]	S. Pieda, CST8333 19F Practical Project 2 Example Layered. Algonquin College, Algonquin College, Jun. 07, 2022. [Online]. Available: https://brightspace.algonquincollege.com/d2l/le/content/543581/viewContent/8322468/View
+*/
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "RecordColumn.h"
+#include "RecordDTO.h"
+#include "RecordIndex.h"
+#include "doctest.h"
+
+#ifndef UNIQUE_KEY_H
+#define UNIQUE_KEY_H
+
+/**
+ * @brief A unique constraint on a combination of columns, such as REF_DATE and VECTOR. A hash map from each key to the
+ * record that holds it answers "is this key taken?" in O(1), so RecordService can refuse a duplicate before it is stored.
+*/
+class UniqueKey
+{
+public:
+	/** @brief The same id as RecordService::RecordId */
+	using RecordId = std::uint64_t;
+	using RowId = RecordIndex::RowId;
+
+	/** @brief Returned by find() when no record holds a key */
+	static constexpr RecordId NO_RECORD = std::numeric_limits<RecordId>::max();
+
+	/** @brief Records that share a key */
+	struct Duplicate {
+		/** @brief the shared key, as built by keyOf() */
+		std::string key;
+		/** @brief the records' slots, in ascending order */
+		std::vector<RowId> rows;
+	};
+
+	/**
+	 * @brief Creates an empty constraint
+	 * @param columns the columns whose values together must be unique
+	 * @throws std::invalid_argument if no column is given
+	*/
+	explicit UniqueKey(std::vector<RecordColumn> columns);
+
+	/** @return the key's columns */
+	const std::vector<RecordColumn> &getColumns() const { return columns; }
+
+	/**
+	 * @brief Checks whether a column is part of the key
+	 * @param column the column
+	 * @return true if changing the column changes the key
+	*/
+	bool covers(RecordColumn column) const;
+
+	/**
+	 * @brief Builds a record's key
+	 * @param record the record
+	 * @return the key columns' values, joined by a separator that does not occur in the data
+	*/
+	std::string keyOf(const RecordDTO &record) const;
+
+	/**
+	 * @brief Builds the key a record would have after one column is changed
+	 * @param record the record
+	 * @param column the changed column
+	 * @param newValue the column's new value
+	 * @return the changed record's key
+	*/
+	std::string keyOf(const RecordDTO &record, RecordColumn column, std::string_view newValue) const;
+
+	/**
+	 * @brief Formats a key for messages, such as "REF_DATE 1976-01, VECTOR v108237"
+	 * @param key a key built by keyOf()
+	 * @return the key's columns and values
+	*/
+	std::string describe(const std::string &key) const;
+
+	/**
+	 * @brief Finds the record holding a key
+	 * @param key the key
+	 * @return the record's id, or NO_RECORD
+	*/
+	RecordId find(const std::string &key) const;
+
+	/**
+	 * @brief Records that a record holds a key. A key that is already held keeps its record.
+	 * @param key the key
+	 * @param recordId the record's id
+	*/
+	void insert(std::string key, RecordId recordId);
+
+	/**
+	 * @brief Releases a key if the given record holds it
+	 * @param key the key
+	 * @param recordId the record's id
+	*/
+	void erase(const std::string &key, RecordId recordId);
+
+	/** @brief Releases every key */
+	void clear() { owners.clear(); }
+
+	/** @return the number of keys held */
+	std::size_t size() const { return owners.size(); }
+
+	/**
+	 * @brief Finds every key that more than one record holds. Chunks of the rows are hashed on separate threads into one
+	 * partition per thread, then each partition is grouped on its own thread, so no two threads share a hash map.
+	 * @param recordList the records
+	 * @param rows the slots to check, in ascending order
+	 * @return one entry per duplicated key, ordered by the key's first slot
+	*/
+	std::vector<Duplicate> findDuplicates(const std::vector<RecordDTO> &recordList, const std::vector<RowId> &rows) const;
+
+private:
+	std::vector<RecordColumn> columns{};
+	std::unordered_map<std::string, RecordId> owners{};
+};
+#endif // !UNIQUE_KEY_H